@@ -28,7 +28,7 @@ static int log_config_event(const struct event_header *eh, char *buf,
 			event->event_id);
 }
 
-EVENT_TYPE_DEFINE(config_event,
-		  IS_ENABLED(CONFIG_DESKTOP_INIT_LOG_CONFIG_EVENT),
-		  log_config_event,
-		  NULL);
+EVENT_TYPE_DYNDATA_DEFINE(config_event,
+			  IS_ENABLED(CONFIG_DESKTOP_INIT_LOG_CONFIG_EVENT),
+			  log_config_event,
+			  NULL);
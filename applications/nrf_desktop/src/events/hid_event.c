@@ -58,10 +58,10 @@ EVENT_INFO_DEFINE(hid_report_event,
 		  profile_hid_report_event);
 
 
-EVENT_TYPE_DEFINE(hid_report_event,
-		  IS_ENABLED(CONFIG_DESKTOP_INIT_LOG_HID_REPORT_EVENT),
-		  log_hid_report_event,
-		  &hid_report_event_info);
+EVENT_TYPE_DYNDATA_DEFINE(hid_report_event,
+			  IS_ENABLED(CONFIG_DESKTOP_INIT_LOG_HID_REPORT_EVENT),
+			  log_hid_report_event,
+			  &hid_report_event_info);
 
 static int log_hid_report_subscriber_event(const struct event_header *eh,
 					      char *buf, size_t buf_len)
@@ -313,6 +313,20 @@ int bt_gatt_dm_continue(struct bt_gatt_dm *dm, void *context);
  */
 int bt_gatt_dm_data_release(struct bt_gatt_dm *dm);
 
+/** @brief Remove the cached attribute database of a peer.
+ *
+ * The attribute database of a bonded peer is cached when
+ * CONFIG_BT_GATT_DM_CACHE is enabled. The cached databases of removed bonds
+ * are deleted when the discovery is next started for a bonded peer. Call
+ * this function to delete the cached database of a peer right away.
+ *
+ * @param[in] peer Identity address of the peer.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int bt_gatt_dm_cache_clear(const bt_addr_le_t *peer);
+
 /** @brief Print service discovery data.
  *
  * This function prints GATT attributes that belong to the discovered service.
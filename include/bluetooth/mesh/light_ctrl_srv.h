@@ -116,8 +116,33 @@ struct bt_mesh_light_ctrl_srv_reg_cfg {
 struct bt_mesh_light_ctrl_srv_reg {
 	/** Regulator step timer */
 	struct k_work_delayable timer;
+#if CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG_FIXED
+	/** Internal integral sum, with 8 fractional bits. */
+	int32_t i;
+	/** Fixed-point coefficients, converted from the configuration. */
+	struct {
+		int32_t kiu;
+		int32_t kid;
+		int32_t kpu;
+		int32_t kpd;
+	} k;
+	/** Precomputed target illuminance fade. */
+	struct {
+		/** Initial illuminance (in centilux). */
+		uint32_t init;
+		/** Target illuminance (in centilux). */
+		uint32_t end;
+		/** Fade duration (in milliseconds). */
+		uint32_t duration;
+		/** Illuminance change per millisecond, with 16 fractional
+		 *  bits.
+		 */
+		int64_t slope;
+	} fade;
+#else
 	/** Internal integral sum. */
 	float i;
+#endif
 	/** Previous output */
 	uint16_t prev;
 	/** Regulator configuration */
@@ -27,6 +27,18 @@ extern "C" {
 #define CONFIG_BT_MESH_SCENES_MAX 0
 #endif
 
+#ifndef CONFIG_BT_MESH_SCENE_SRV_MODELS_MAX
+#define CONFIG_BT_MESH_SCENE_SRV_MODELS_MAX 0
+#endif
+
+#ifndef CONFIG_BT_MESH_SCENE_SRV_CACHE_COUNT
+#define CONFIG_BT_MESH_SCENE_SRV_CACHE_COUNT 0
+#endif
+
+#ifndef CONFIG_BT_MESH_SCENE_SRV_CACHE_SIZE
+#define CONFIG_BT_MESH_SCENE_SRV_CACHE_SIZE 0
+#endif
+
 /** @def BT_MESH_SCENE_ENTRY_SIG
  *
  *  @brief Scene entry type definition for SIG models
@@ -67,12 +79,50 @@ struct bt_mesh_scene_srv;
 						 _srv),                        \
 			 &_bt_mesh_scene_setup_srv_cb)
 
+/** @cond INTERNAL_HIDDEN */
+
+/** Model with scene data, controlled by a Scene Server. */
+struct bt_mesh_scene_srv_mod {
+	/** Composition data model pointer. */
+	struct bt_mesh_model *mod;
+	/** Scene entry of the model. */
+	const struct bt_mesh_scene_entry *entry;
+};
+
+/** Stored pages of a recently used scene. */
+struct bt_mesh_scene_srv_cache {
+	/** Scene number, or @ref BT_MESH_SCENE_NONE if the entry is unused. */
+	uint16_t scene;
+	/** Length of the cached pages. */
+	uint16_t len;
+	/** Last use of the entry, for eviction. */
+	uint32_t used;
+	/** Cached pages. */
+	uint8_t data[CONFIG_BT_MESH_SCENE_SRV_CACHE_SIZE];
+};
+
+/** @endcond */
+
+/** Scene recall statistics. */
+struct bt_mesh_scene_srv_stats {
+	/** Number of scenes recalled from the scene cache. */
+	uint32_t cache_hits;
+	/** Number of scenes recalled from persistent storage. */
+	uint32_t cache_misses;
+	/** Duration of the last scene recall in microseconds. */
+	uint32_t recall_us;
+	/** Duration of the longest scene recall in microseconds. */
+	uint32_t recall_max_us;
+};
+
 /** Scene Server model instance */
 struct bt_mesh_scene_srv {
 	/** All known scenes. */
 	uint16_t all[CONFIG_BT_MESH_SCENES_MAX];
 	/** Number of known scenes. */
 	uint16_t count;
+	/** Scene recall statistics. */
+	struct bt_mesh_scene_srv_stats stats;
 
 	/** @cond INTERNAL_HIDDEN */
 
@@ -86,6 +136,22 @@ struct bt_mesh_scene_srv {
 	/** Largest number of pages used to store SIG model scene data. */
 	uint8_t sigpages;
 
+	/** Models with scene data, SIG models first. */
+	struct bt_mesh_scene_srv_mod mods[CONFIG_BT_MESH_SCENE_SRV_MODELS_MAX];
+	/** Number of SIG models in the model list. */
+	uint8_t sigmods;
+	/** Number of vendor models in the model list. */
+	uint8_t vndmods;
+	/** Whether the model list has been built. */
+	bool mods_valid;
+
+	/** Recently used scenes. */
+	struct bt_mesh_scene_srv_cache cache[CONFIG_BT_MESH_SCENE_SRV_CACHE_COUNT];
+	/** Cache entry filled while loading a scene. */
+	struct bt_mesh_scene_srv_cache *cache_fill;
+	/** Cache use counter. */
+	uint32_t cache_seq;
+
 	/** Linked list node for Scene Server list */
 	sys_snode_t n;
 
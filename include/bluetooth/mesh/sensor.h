@@ -368,9 +368,6 @@ struct bt_mesh_sensor {
 		/** Sensor threshold specification. */
 		struct bt_mesh_sensor_threshold threshold;
 
-		/** Linked list node. */
-		sys_snode_t node;
-
 		/** The previously published sensor value. */
 		struct sensor_value prev;
 
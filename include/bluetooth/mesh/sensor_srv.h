@@ -61,8 +61,8 @@ struct bt_mesh_sensor_srv;
 struct bt_mesh_sensor_srv {
 	/** Sensors owned by this server. */
 	struct bt_mesh_sensor *const *sensor_array;
-	/** Ordered linked list of sensors. */
-	sys_slist_t sensors;
+	/** Sensors sorted by their Device Property ID. */
+	struct bt_mesh_sensor *sensors[CONFIG_BT_MESH_SENSOR_SRV_SENSORS_MAX];
 	/** Publish sequence counter */
 	uint16_t seq;
 	/** Number of sensors. */
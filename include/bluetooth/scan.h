@@ -543,6 +543,40 @@ int bt_scan_blocklist_device_add(const bt_addr_le_t *addr);
  */
 void bt_scan_blocklist_clear(void);
 
+/**@brief Advertising report deduplication statistics.
+ */
+struct bt_scan_dedup_stats {
+	/** Number of received advertising reports. */
+	uint32_t reports;
+
+	/** Number of reports suppressed because they were
+	 *  already received from the device.
+	 */
+	uint32_t suppressed;
+
+	/** Number of cache entries replaced by another device or payload. */
+	uint32_t evicted;
+};
+
+/**@brief Get the advertising report deduplication statistics.
+ *
+ * @details The hit rate of the deduplication cache is the number of
+ *          suppressed reports divided by the number of received reports.
+ *
+ * @param[out] stats Statistics.
+ *
+ * @retval 0 If the operation was successful. Otherwise, a (negative) error
+ *	     code is returned.
+ */
+int bt_scan_dedup_stats_get(struct bt_scan_dedup_stats *stats);
+
+/**@brief Clear the advertising report deduplication cache.
+ *
+ * @details Use this function to forward the next report of every device,
+ *          and to reset the deduplication statistics.
+ */
+void bt_scan_dedup_clear(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,23 @@
 extern "C" {
 #endif
 
+/** Length of a SHA-256 digest. */
+#define DFU_TARGET_MCUBOOT_DIGEST_LEN 32
+
+/** @brief Digests of the blocks of an MCUboot image file.
+ *
+ * Used to detect a corrupted block as soon as it is received, instead of
+ * when the whole image has been received.
+ */
+struct dfu_target_mcuboot_manifest {
+	/** Size of each block. The last block may be shorter. */
+	size_t block_size;
+	/** Number of blocks in the file. */
+	size_t block_cnt;
+	/** SHA-256 digest of each block. */
+	const uint8_t (*digest)[DFU_TARGET_MCUBOOT_DIGEST_LEN];
+};
+
 /**
  * @brief Find correct MCUBoot update file path entry in space separated string.
  *
@@ -49,6 +66,21 @@ int dfu_ctx_mcuboot_set_b1_file(const char *file, bool s0_active,
  */
 int dfu_target_mcuboot_set_buf(uint8_t *buf, size_t len);
 
+/**
+ * @brief Set the block digests of the next image.
+ *
+ * Must be called before @ref dfu_target_mcuboot_init. The manifest is not
+ * copied and must remain valid until the image is done.
+ * Requires @option{CONFIG_DFU_TARGET_MCUBOOT_VERIFY}.
+ *
+ * @param[in] manifest Block digests of the image file, or NULL to only
+ *		       verify the image against its SHA-256 TLV.
+ *
+ * @retval 0 If successful, negative errno otherwise.
+ */
+int dfu_target_mcuboot_manifest_set(
+	const struct dfu_target_mcuboot_manifest *manifest);
+
 /**
  * @brief See if data in buf indicates MCUBoot style upgrade.
  *
@@ -81,7 +113,9 @@ int dfu_target_mcuboot_offset_get(size_t *offset);
  * @param[in] buf Pointer to data that should be written.
  * @param[in] len Length of data to write.
  *
- * @return 0 on success, negative errno otherwise.
+ * @retval 0 on success, negative errno otherwise.
+ * @retval -EBADMSG If @option{CONFIG_DFU_TARGET_MCUBOOT_VERIFY} is set and
+ *		    the data does not match the image hash or the manifest.
  */
 int dfu_target_mcuboot_write(const void *const buf, size_t len);
 
@@ -90,7 +124,10 @@ int dfu_target_mcuboot_write(const void *const buf, size_t len);
 
  * @param[in] successful Indicate whether the firmware was successfully recived.
  *
- * @return 0 on success, negative errno otherwise.
+ * @retval 0 on success, negative errno otherwise.
+ * @retval -EBADMSG If @option{CONFIG_DFU_TARGET_MCUBOOT_VERIFY} is set and
+ *		    the image does not match its SHA-256 TLV. The upgrade is
+ *		    not scheduled.
  */
 int dfu_target_mcuboot_done(bool successful);
 
@@ -82,6 +82,10 @@ int dfu_target_stream_offset_get(size_t *offset);
 /**
  * @brief Write a chunk of firmware data.
  *
+ * If `CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND` is set, the data is queued and
+ * written to flash in the background. An error while writing is then returned
+ * by a later call to this function or to @ref dfu_target_stream_done.
+ *
  * @param[in] buf Pointer to data that should be written.
  * @param[in] len Length of data to write.
  *
@@ -89,6 +93,17 @@ int dfu_target_stream_offset_get(size_t *offset);
  */
 int dfu_target_stream_write(const uint8_t *buf, size_t len);
 
+/**
+ * @brief Discard the written data and start the stream over from offset 0.
+ *
+ * The data that is buffered or queued for writing is dropped, and the saved
+ * progress is deleted. The flash pages are erased again as the stream is
+ * written.
+ *
+ * @return Non-negative value on success, negative errno otherwise.
+ */
+int dfu_target_stream_reset(void);
+
 /**
  * @brief De-initialize resources and finalize stream flash write if successful.
 
@@ -54,6 +54,28 @@ extern "C" {
 #define SUBS_PRIO_COUNT (SUBS_PRIO_MAX - SUBS_PRIO_MIN + 1)
 
 
+/** @brief Event execution class.
+ *
+ * Events of every execution class are processed in FIFO order by a separate
+ * work queue. Events of a higher class are not delayed by events of a lower
+ * class. Execution classes are used only if
+ * CONFIG_EVENT_MANAGER_EXEC_CLASSES is enabled.
+ */
+enum event_exec_class {
+	/** Events processed by a dedicated high priority work queue. */
+	EVENT_EXEC_CLASS_HIGH,
+
+	/** Events processed by the system work queue. */
+	EVENT_EXEC_CLASS_NORMAL,
+
+	/** Events processed by a dedicated low priority work queue. */
+	EVENT_EXEC_CLASS_LOW,
+
+	/** Number of execution classes. */
+	EVENT_EXEC_CLASS_COUNT
+};
+
+
 /** @brief Event header.
  *
  * When defining an event structure, the event header
@@ -65,6 +87,11 @@ struct event_header {
 
 	/** Pointer to the event type object. */
 	const struct event_type *type_id;
+
+#ifdef CONFIG_EVENT_MANAGER_EXEC_CLASS_STATS
+	/** Event submission time, in cycles. */
+	uint32_t submit_time;
+#endif
 };
 
 
@@ -144,6 +171,21 @@ struct event_type {
 
 	/** Logging and formatting information. */
 	const struct event_info *ev_info;
+
+	/** Memory slab used to allocate events of this type or NULL if
+	 *  events are allocated from the system heap. */
+	struct k_mem_slab *mem_slab;
+
+	/** Execution class of this event type. */
+	enum event_exec_class exec_class;
+
+	/** Function to coalesce an event of this type with a queued event
+	 *  or NULL if events of this type are not coalescable. */
+	bool (*coalesce_fn)(struct event_header *queued,
+			    const struct event_header *eh);
+
+	/** Number of coalesced events of this type. */
+	uint32_t *coalesced_cnt;
 };
 
 
@@ -258,7 +300,74 @@ extern const struct event_type __stop_event_types[];
  * @param ev_info_struct   Data structure describing the event type.
  */
 #define EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct) \
-	_EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct)
+	_EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct, \
+			   EVENT_EXEC_CLASS_NORMAL)
+
+
+/** Define an event type with dynamic data size.
+ *
+ * This macro works like @ref EVENT_TYPE_DEFINE, but it must be used for
+ * event types declared with @ref EVENT_TYPE_DYNDATA_DECLARE. Events with
+ * dynamic data are always allocated from the system heap, so no memory slab
+ * is defined for them.
+ *
+ * @param ename     	   Name of the event.
+ * @param init_log_en	   Bool indicating if the event is logged
+ *                         by default.
+ * @param log_fn  	   Function to stringify an event of this type.
+ * @param ev_info_struct   Data structure describing the event type.
+ */
+#define EVENT_TYPE_DYNDATA_DEFINE(ename, init_log_en, log_fn, ev_info_struct) \
+	_EVENT_TYPE_DYNDATA_DEFINE(ename, init_log_en, log_fn, ev_info_struct, \
+				   EVENT_EXEC_CLASS_NORMAL)
+
+
+/** Define an event type with a given execution class.
+ *
+ * This macro works like @ref EVENT_TYPE_DEFINE, but the defined event type
+ * is processed in the given execution class.
+ *
+ * @param ename     	   Name of the event.
+ * @param init_log_en	   Bool indicating if the event is logged
+ *                         by default.
+ * @param log_fn  	   Function to stringify an event of this type.
+ * @param ev_info_struct   Data structure describing the event type.
+ * @param exec_class	   Execution class (see @ref event_exec_class).
+ */
+#define EVENT_TYPE_EXEC_CLASS_DEFINE(ename, init_log_en, log_fn, ev_info_struct, \
+				     exec_class) \
+	_EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct, exec_class)
+
+
+/** Define a coalescable event type.
+ *
+ * This macro works like @ref EVENT_TYPE_EXEC_CLASS_DEFINE, but the defined
+ * event type is coalescable. When an event of this type is submitted, while
+ * the Event Manager still holds events of the same type that were not yet
+ * processed, the coalescing function is called for every such queued event.
+ * If the function returns true, the submitted event was merged into
+ * the queued event and it is freed instead of being added to the queue.
+ *
+ * The coalescing function is called with interrupts locked. It should
+ * compare the event keys (if any) and update the data of the queued event.
+ * It must not block and must not submit events.
+ *
+ * Events are coalesced only if CONFIG_EVENT_MANAGER_EVENT_COALESCING is
+ * enabled.
+ *
+ * @param ename     	   Name of the event.
+ * @param init_log_en	   Bool indicating if the event is logged
+ *                         by default.
+ * @param log_fn  	   Function to stringify an event of this type.
+ * @param ev_info_struct   Data structure describing the event type.
+ * @param exec_class	   Execution class (see @ref event_exec_class).
+ * @param coalesce_fn	   Function to coalesce an event of this type into
+ *			   a queued event of this type.
+ */
+#define EVENT_TYPE_COALESCABLE_DEFINE(ename, init_log_en, log_fn, ev_info_struct, \
+				      exec_class, coalesce_fn) \
+	_EVENT_TYPE_COALESCABLE_DEFINE(ename, init_log_en, log_fn, ev_info_struct, \
+				       exec_class, coalesce_fn)
 
 
 /** Verify if an event ID is valid.
@@ -289,6 +398,17 @@ void _event_submit(struct event_header *eh);
 #define EVENT_SUBMIT(event) _event_submit(&event->header)
 
 
+/** Free an event that was allocated, but not submitted.
+ *
+ * Submitted events are freed by the Event Manager after they are processed.
+ * This function must be used only to release an event that is not going to
+ * be submitted.
+ *
+ * @param eh  Pointer to the event header element in the event object.
+ */
+void event_manager_free(struct event_header *eh);
+
+
 /** Initialize the Event Manager.
  *
  * @retval 0 If the operation was successful.
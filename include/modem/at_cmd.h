@@ -54,6 +54,24 @@ enum at_cmd_state {
  */
 typedef void (*at_cmd_handler_t)(const char *response);
 
+/**
+ * @typedef at_cmd_complete_handler_t
+ *
+ * Handler reporting the completion of a command submitted with
+ * at_cmd_submit(). The handler is called exactly once for every submitted
+ * command, and commands complete in the order they were submitted.
+ *
+ * @param response  Null terminated string containing the modem response,
+ *                  without the final result code. NULL if the command could
+ *                  not be written or the response could not be read.
+ * @param state     State of the command, as returned by at_cmd_write().
+ * @param code      Return code of the command, as returned by at_cmd_write().
+ * @param user_data User data provided when the command was submitted.
+ */
+typedef void (*at_cmd_complete_handler_t)(const char *response,
+					  enum at_cmd_state state, int code,
+					  void *user_data);
+
 /**@brief Initialize or recover the AT command driver.
  *
  * @return Zero on success, non-zero otherwise.
@@ -132,6 +150,38 @@ int at_cmd_write(const char *const cmd,
 		 size_t buf_len,
 		 enum at_cmd_state *state);
 
+/**
+ * @brief Function to submit an AT command without waiting for the response
+ *
+ * The command is added to the command queue and the function returns
+ * immediately. Commands are written to the modem one after another by the
+ * AT command driver as soon as the previous command completes, so a sequence
+ * of commands, such as the modem configuration at boot, can be submitted at
+ * once instead of waiting for each response in turn.
+ *
+ * The number of submitted commands pending completion is limited by
+ * the CONFIG_AT_CMD_SUBMIT_QUEUE_LEN option.
+ *
+ * @param cmd       Pointer to null terminated AT command string. The command
+ *                  is copied, the string does not need to be kept.
+ * @param handler   Handler called when the command completes.
+ * @param user_data User data passed to the handler.
+ *
+ * @note The handler function runs from at_cmd's thread, or from the calling
+ *       thread if the command cannot be written to the modem. It must not
+ *       call at_cmd_write, as that would lead to a deadlock, but it can
+ *       submit further commands.
+ *
+ * @retval 0 If the command was submitted.
+ * @retval -EINVAL is returned if the command or the handler is invalid.
+ * @retval -EAGAIN is returned if too many commands are pending completion.
+ * @retval -ENOMEM is returned if the command could not be copied.
+ * @retval -EHOSTDOWN is returned if the Modem library is shutdown.
+ */
+int at_cmd_submit(const char *const cmd,
+		  at_cmd_complete_handler_t handler,
+		  void *user_data);
+
 /**
  * @brief Function to set AT command global notification handler
  *
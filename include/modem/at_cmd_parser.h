@@ -106,6 +106,103 @@ int at_parser_max_params_from_str(const char *at_params_str,
 int at_parser_params_from_str(const char *at_params_str, char **next_param_str,
 			      struct at_param_list *const list);
 
+/**
+ * @brief Handler called by the streaming parser for every complete line.
+ *
+ * @param err       Result of parsing the line, see
+ *                  @ref at_parser_params_from_str. -ENOBUFS if the line did
+ *                  not fit in the line buffer and was dropped.
+ * @param list      Parameters parsed from the line. Valid only during
+ *                  the handler call.
+ * @param user_data User data provided to @ref at_parser_init.
+ */
+typedef void (*at_parser_handler_t)(int err, struct at_param_list *list,
+				    void *user_data);
+
+/**
+ * @brief Streaming AT response parser.
+ *
+ * All parser state is kept in this structure, so multiple parsers can be
+ * used from different threads at the same time. Members are private and
+ * should not be accessed directly.
+ */
+struct at_parser {
+	/** Buffer used to collect a response line. */
+	char *buf;
+	/** Size of the line buffer. */
+	size_t buf_size;
+	/** Number of characters in the line buffer. */
+	size_t len;
+	/** The current line did not fit in the line buffer. */
+	bool overflow;
+	/** List where parameters of a line are stored. */
+	struct at_param_list *list;
+	/** Handler called for every complete line. */
+	at_parser_handler_t handler;
+	/** User data passed to the handler. */
+	void *user_data;
+};
+
+/**
+ * @brief Initialize a streaming AT response parser.
+ *
+ * The streaming parser accepts a response in chunks of any size, for
+ * example as received from the modem. Every complete line of the response
+ * is parsed into @p list and passed to @p handler. Empty lines are skipped.
+ * Responses where a parameter spans multiple lines, such as SMS PDUs, must be
+ * parsed with @ref at_parser_params_from_str.
+ *
+ * @param parser    Parser to initialize.
+ * @param list      Initialized parameter list where parameters of a line
+ *                  are stored.
+ * @param buf       Buffer used to collect a line. Must fit the longest line,
+ *                  including the line terminator and a null terminator.
+ * @param buf_size  Size of @p buf.
+ * @param handler   Handler called for every parsed line.
+ * @param user_data User data passed to @p handler.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL One or more of the supplied parameters are invalid.
+ */
+int at_parser_init(struct at_parser *parser, struct at_param_list *list,
+		   char *buf, size_t buf_size, at_parser_handler_t handler,
+		   void *user_data);
+
+/**
+ * @brief Feed a chunk of an AT response to a streaming parser.
+ *
+ * The handler is called from this function for every line completed by
+ * @p data. A line is completed by a line feed. The characters received after
+ * the last line feed are kept until more data is fed, or until
+ * @ref at_parser_flush is called.
+ *
+ * @param parser Initialized parser.
+ * @param data   Chunk of the response. Does not need to be null-terminated.
+ * @param len    Length of @p data.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL One or more of the supplied parameters are invalid.
+ */
+int at_parser_feed(struct at_parser *parser, const char *data, size_t len);
+
+/**
+ * @brief Complete a line that is not terminated by a line feed.
+ *
+ * Passes the characters received after the last line feed to the handler as
+ * a complete line. Should be called at the end of a response, whose last line
+ * may not be terminated. Does nothing if no characters are pending.
+ *
+ * @param parser Initialized parser.
+ */
+void at_parser_flush(struct at_parser *parser);
+
+/**
+ * @brief Discard a partially received line.
+ *
+ * @param parser Initialized parser.
+ */
+void at_parser_reset(struct at_parser *parser);
+
 enum at_cmd_type {
 	/** Unknown command, indicates that the actual command type could not
 	 *  be resolved.
@@ -78,6 +78,54 @@ int at_notif_register_handler(void *context, at_notif_handler_t handler);
  */
 int at_notif_deregister_handler(void *context, at_notif_handler_t handler);
 
+/**
+ * @brief Function to register AT command notification handler for
+ *        notifications with a given prefix
+ *
+ * The handler is called only for notifications starting with @p prefix,
+ * for example "+CEREG" or "%CESQ". The prefix of a notification is the text
+ * preceding the first colon, space or line break. Handlers registered for a
+ * prefix are looked up by the hash of the prefix, so registering many of them
+ * does not increase the dispatch time of unrelated notifications.
+ *
+ * Handlers registered for all notifications are called before the handlers
+ * registered for a prefix.
+ *
+ * @note  If the same combination of context, prefix and handler exists in the
+ *        memory, then the request will be ignored and command execution will
+ *        be regarded as finished successfully.
+ *
+ * @param context Pointer to context provided by the module which has
+ *                registered the handler.
+ * @param prefix  Null terminated notification prefix. If NULL or empty, the
+ *                handler receives all notifications, as with
+ *                @ref at_notif_register_handler().
+ * @param handler Pointer to a received notification handler function of type
+ *                @ref at_notif_handler_t.
+ *
+ * @retval 0            If command execution was successful.
+ * @retval -ENOBUFS     If memory cannot be allocated.
+ * @retval -EINVAL      If handler is a NULL pointer or prefix is invalid.
+ */
+int at_notif_register_prefix_handler(void *context, const char *prefix,
+				     at_notif_handler_t handler);
+
+/**
+ * @brief Function to de-register AT command notification handler registered
+ *        for notifications with a given prefix
+ *
+ * @param context Pointer to context provided by the module which has
+ *                registered the handler.
+ * @param prefix  Notification prefix the handler was registered with.
+ * @param handler Pointer to a received notification handler function of type
+ *                @ref at_notif_handler_t.
+ *
+ * @retval 0            If command execution was successful.
+ * @retval -EINVAL      If handler is a NULL pointer.
+ */
+int at_notif_deregister_prefix_handler(void *context, const char *prefix,
+				       at_notif_handler_t handler);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -26,6 +26,7 @@
 #ifndef AT_PARAMS_H__
 #define AT_PARAMS_H__
 
+#include <stdbool.h>
 #include <zephyr/types.h>
 
 #ifdef __cplusplus
@@ -72,6 +73,8 @@ struct at_param {
 struct at_param_list {
 	size_t param_count;
 	struct at_param *params;
+	/** String and array parameters reference external memory. */
+	bool zero_copy;
 };
 
 /**
@@ -90,6 +93,30 @@ struct at_param_list {
  */
 int at_params_list_init(struct at_param_list *list, size_t max_params_count);
 
+/**
+ * @brief Create a zero-copy list of parameters.
+ *
+ * Works like @ref at_params_list_init, but string and array parameters are
+ * not copied to the heap. Instead, they reference the memory they were put
+ * from. When used with the AT command parser, the parameters reference
+ * the parsed response buffer, so the buffer must stay valid and unchanged
+ * until the parameters are read or the list is cleared. Array parameters
+ * are converted to numbers when they are read.
+ *
+ * Parameters of a zero-copy list are read with the same functions as
+ * parameters of a regular list. Arrays of numbers cannot be put in
+ * a zero-copy list with @ref at_params_array_put.
+ *
+ * @param[in] list Parameter list to initialize.
+ * @param[in] max_params_count Maximum number of element that the list can
+ * store.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_params_list_init_zero_copy(struct at_param_list *list,
+				  size_t max_params_count);
+
 /**
  * @brief Clear/reset all parameter types and values.
  *
@@ -129,6 +156,8 @@ int at_params_int_put(const struct at_param_list *list, size_t index, int64_t va
  *
  * The parameter string value is copied and added to the list as a
  * null-terminated string. If a parameter exists at this index, it is replaced.
+ * In a zero-copy list, the string is referenced instead of being copied and
+ * it is not null-terminated.
  *
  * @param[in] list    Parameter list.
  * @param[in] index   Index in the list where to put the parameter.
@@ -158,6 +187,7 @@ int at_params_string_put(const struct at_param_list *list, size_t index,
  * @param[in] array_len In bytes (must currently be divisible by 4)
  *
  * @retval 0 If the operation was successful.
+ * @retval -ENOTSUP If the list is a zero-copy list.
  *           Otherwise, a (negative) error code is returned.
  */
 int at_params_array_put(const struct at_param_list *list, size_t index,
@@ -126,6 +126,91 @@ struct download_client_cfg {
 typedef int (*download_client_callback_t)(
 	const struct download_client_evt *event);
 
+/**
+ * @brief HTTP response header parser state.
+ *
+ * The header is parsed incrementally, as it is received,
+ * and each byte of the header is examined only once.
+ */
+struct download_http_hdr {
+	/** Offset up to which the response has been parsed. */
+	size_t scan;
+	/** Offset of the header line being received. */
+	size_t line;
+	/** HTTP status code, zero until the status line is received. */
+	unsigned int status;
+	/** Value of the Content-Length field. */
+	size_t content_length;
+	/** First byte position of the Content-Range field. */
+	size_t range_start;
+	/** Last byte position of the Content-Range field. */
+	size_t range_end;
+	/** Complete length of the Content-Range field, zero if unknown. */
+	size_t range_total;
+	/** The response has a Content-Length field. */
+	bool has_content_length;
+	/** The response has a Content-Range field. */
+	bool has_content_range;
+	/** The server closes the connection after the response. */
+	bool connection_close;
+	/** The response body uses the chunked transfer coding. */
+	bool chunked;
+};
+
+/**
+ * @brief Range request stream, used when downloading over
+ *        parallel connections.
+ */
+struct download_stream {
+	/** Socket descriptor. */
+	int fd;
+	/** Response buffer, holds the fragment once the header is parsed. */
+	char buf[CONFIG_DOWNLOAD_CLIENT_BUF_SIZE];
+	/** Buffer offset. */
+	size_t offset;
+	/** Whether the HTTP header has been parsed. */
+	bool has_header;
+	/** Offset of the requested fragment in the file. */
+	size_t from;
+	/** Length of the requested fragment. */
+	size_t len;
+	/** Stream state. */
+	uint8_t state;
+	/** Number of retries for the requested fragment. */
+	uint8_t retries;
+	/** Response header parser. */
+	struct download_http_hdr hdr;
+};
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW)
+/**
+ * @brief CoAP block request, used when downloading with
+ *        several outstanding block-wise requests.
+ */
+struct download_coap_block {
+	/** Block payload. */
+	uint8_t buf[16 << CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE];
+	/** Offset of the block in the file. */
+	size_t off;
+	/** Number of bytes received. */
+	size_t len;
+	/** Number of bytes in the block. */
+	size_t size;
+	/** Time of the last transmission of the request, in milliseconds. */
+	int64_t sent;
+	/** Message ID of the request. */
+	uint16_t id;
+	/** Token of the request. */
+	uint8_t token[8];
+	/** Block size exponent (SZX) of the request. */
+	uint8_t szx;
+	/** Block state. */
+	uint8_t state;
+	/** Number of retransmissions of the request. */
+	uint8_t retries;
+};
+#endif
+
 /**
  * @brief Download client instance.
  */
@@ -159,13 +244,61 @@ struct download_client {
 		bool has_header;
 		/** The server has closed the connection. */
 		bool connection_close;
+		/** Response header parser. */
+		struct download_http_hdr hdr;
+		/** Number of body bytes of the current response
+		 * that have not been received yet.
+		 */
+		size_t body_remaining;
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINING)
+		/** The next fragment has been requested already. */
+		bool pipelined;
+		/** Buffer for the pipelined request. */
+		char request[CONFIG_DOWNLOAD_CLIENT_MAX_HOSTNAME_SIZE +
+			     CONFIG_DOWNLOAD_CLIENT_MAX_FILENAME_SIZE + 128];
+#endif
 	} http;
 
 	struct {
 		/** CoAP block context. */
 		struct coap_block_context block_ctx;
+#if defined(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW)
+		/** Outstanding block requests. */
+		struct download_coap_block
+			window[CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE];
+#endif
 	} coap;
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_RANGE_STREAMS)
+	/** Parallel range request streams. */
+	struct download_stream streams[CONFIG_DOWNLOAD_CLIENT_RANGE_STREAM_CNT];
+#endif
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_FRAGMENT_QUEUE)
+	struct {
+		/** Fragment buffers. */
+		char buf[CONFIG_DOWNLOAD_CLIENT_FRAGMENT_QUEUE_LEN]
+			[CONFIG_DOWNLOAD_CLIENT_BUF_SIZE];
+		/** Length of the fragment in each buffer. */
+		size_t len[CONFIG_DOWNLOAD_CLIENT_FRAGMENT_QUEUE_LEN];
+		/** Index of the next buffer to fill. */
+		size_t head;
+		/** Error returned by the application for a fragment. */
+		int err;
+		/** Buffers free to fill. */
+		struct k_sem free;
+		/** Buffers ready to be handed to the application. */
+		struct k_sem ready;
+		/** Internal fragment thread ID. */
+		k_tid_t tid;
+		/** Internal fragment thread. */
+		struct k_thread thread;
+		/* Internal fragment thread stack. */
+		K_THREAD_STACK_MEMBER(thread_stack,
+			CONFIG_DOWNLOAD_CLIENT_FRAGMENT_QUEUE_STACK_SIZE);
+	} frag_queue;
+#endif
+
 	/** Internal thread ID. */
 	k_tid_t tid;
 	/** Internal download thread. */
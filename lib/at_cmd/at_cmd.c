@@ -39,6 +39,8 @@ struct cmd_item  {
 	char *cmd;			/* Pointer to 0-terminated command */
 	char *resp;			/* Pointer to response buffer */
 	at_cmd_handler_t callback;	/* Callback to execute on result */
+	at_cmd_complete_handler_t complete; /* Callback to execute on completion */
+	void *user_data;		/* User data for completion callback */
 	size_t resp_size;		/* Size of response buffer */
 	enum at_cmd_flags flags;	/* Flags describing the request */
 };
@@ -57,6 +59,8 @@ static k_tid_t socket_tid;
 static struct k_thread socket_thread;
 static at_cmd_handler_t notification_handler;
 static atomic_t shutdown_mode;
+/* Number of submitted commands not completed yet */
+static atomic_t submitted_cnt;
 
 /* Mutex to guard the at_cmd init from simultaneous entry. */
 static K_MUTEX_DEFINE(at_cmd_init_mutex);
@@ -178,6 +182,18 @@ static inline int at_write(const char *const cmd)
 	return 0;
 }
 
+/* Report the completion of a submitted command */
+static void notify_complete(const struct cmd_item *cmd, const char *resp,
+			    const struct resp_item *ret)
+{
+	if (cmd->complete == NULL) {
+		return;
+	}
+
+	atomic_dec(&submitted_cnt);
+	cmd->complete(resp, ret->state, ret->code, cmd->user_data);
+}
+
 /* Clear the current command safely */
 static void complete_cmd(void)
 {
@@ -220,6 +236,7 @@ static void load_cmd_and_write(void)
 			if (current_cmd.flags & AT_CMD_SYNC) {
 				k_msgq_put(&response_sync, &resp, K_FOREVER);
 			}
+			notify_complete(&current_cmd, NULL, &resp);
 			complete_cmd();
 		}
 	} while (ret != 0);
@@ -232,6 +249,7 @@ static void socket_thread_fn(void *arg1, void *arg2, void *arg3)
 	static size_t payload_len;
 	static struct resp_item ret;
 	static char buf[CONFIG_AT_CMD_RESPONSE_MAX_LEN];
+	const char *resp;
 
 	ARG_UNUSED(arg1);
 	ARG_UNUSED(arg2);
@@ -249,6 +267,7 @@ static void socket_thread_fn(void *arg1, void *arg2, void *arg3)
 		/* Initialize the response */
 		ret.code  = 0;
 		ret.state = AT_CMD_OK;
+		resp = NULL;
 
 		/* Handle possible socket-level errors */
 
@@ -302,6 +321,7 @@ static void socket_thread_fn(void *arg1, void *arg2, void *arg3)
 		LOG_DBG("at_cmd_rx %d bytes, %s", bytes_read, log_strdup(buf));
 
 		payload_len = get_return_code(buf, bytes_read, &ret);
+		resp = buf;
 
 		/* Verify the buffer size if provided, and copy the message */
 		if (current_cmd.cmd != NULL &&
@@ -334,6 +354,9 @@ next:
 
 		/* We have now handled a command if it was not a notification */
 		if (ret.state != AT_CMD_NOTIFICATION) {
+			if (current_cmd.cmd != NULL) {
+				notify_complete(&current_cmd, resp, &ret);
+			}
 			complete_cmd();
 		}
 	}
@@ -367,6 +390,7 @@ int at_cmd_write_with_callback(const char *const cmd,
 
 	command.resp = NULL;
 	command.callback = handler;
+	command.complete = NULL;
 	command.flags = AT_CMD_BUF_CMD;
 
 	ret = k_msgq_put(&commands, &command, K_FOREVER);
@@ -414,6 +438,7 @@ int at_cmd_write(const char *const cmd,
 	command.resp = buf;
 	command.resp_size = buf_len;
 	command.callback = NULL;
+	command.complete = NULL;
 	command.flags = AT_CMD_SYNC;
 
 	/* Ensure we get our own AT response, not an old one */
@@ -442,6 +467,58 @@ int at_cmd_write(const char *const cmd,
 	return ret.code;
 }
 
+int at_cmd_submit(const char *const cmd,
+		  at_cmd_complete_handler_t handler,
+		  void *user_data)
+{
+	struct cmd_item command;
+	int ret;
+
+	if (atomic_get(&shutdown_mode) == 1) {
+		return -EHOSTDOWN;
+	}
+
+	if (handler == NULL) {
+		LOG_ERR("handler is NULL");
+		return -EINVAL;
+	}
+
+	if (check_cmd(cmd)) {
+		LOG_ERR("Invalid command");
+		return -EINVAL;
+	}
+
+	/* Reserve a slot among the submitted commands */
+	if (atomic_inc(&submitted_cnt) >= CONFIG_AT_CMD_SUBMIT_QUEUE_LEN) {
+		atomic_dec(&submitted_cnt);
+		return -EAGAIN;
+	}
+
+	command.cmd = k_malloc(strlen(cmd) + 1);
+	if (command.cmd == NULL) {
+		atomic_dec(&submitted_cnt);
+		return -ENOMEM;
+	}
+	strcpy(command.cmd, cmd);
+
+	command.resp = NULL;
+	command.callback = NULL;
+	command.complete = handler;
+	command.user_data = user_data;
+	command.flags = AT_CMD_BUF_CMD;
+
+	ret = k_msgq_put(&commands, &command, K_NO_WAIT);
+	if (ret) {
+		LOG_ERR("Could not enqueue cmd, error %d", ret);
+		k_free(command.cmd);
+		atomic_dec(&submitted_cnt);
+		return -EAGAIN;
+	}
+
+	load_cmd_and_write();
+	return 0;
+}
+
 void at_cmd_set_notification_handler(at_cmd_handler_t handler)
 {
 	LOG_DBG("Setting notification handler to %p", handler);
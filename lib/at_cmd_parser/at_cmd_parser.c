@@ -15,8 +15,6 @@
 #include <modem/at_cmd_parser.h>
 #include "at_utils.h"
 
-#define AT_CMD_MAX_ARRAY_SIZE 32
-
 #define AT_CMD_CGEV_LEN         5
 #define AT_CMD_CPIN_LEN         5
 #define AT_CMD_SHORTSWVER_LEN   11
@@ -37,20 +35,25 @@ enum at_parser_state {
 	CLAC,
 };
 
-static enum at_parser_state state;
-
-static bool set_type_string;
+/* Parser state. Kept on the stack of the parsing thread, so parsing
+ * can be done from multiple threads at the same time.
+ */
+struct parser_state {
+	enum at_parser_state state;
+	bool set_type_string;
+};
 
-static inline void set_new_state(enum at_parser_state new_state)
+static inline void set_new_state(struct parser_state *ps,
+				 enum at_parser_state new_state)
 {
-	state = new_state;
+	ps->state = new_state;
 }
 
-static inline void reset_state(void)
+static inline void reset_state(struct parser_state *ps)
 {
-	state = IDLE;
+	ps->state = IDLE;
 
-	set_type_string = false;
+	ps->set_type_string = false;
 }
 
 static inline void skip_command_prefix(const char **cmd)
@@ -80,7 +83,8 @@ static inline bool check_response_for_forced_string(const char *tmpstr)
 	return retval;
 }
 
-static int at_parse_detect_type(const char **str, int index)
+static int at_parse_detect_type(struct parser_state *ps, const char **str,
+				int index)
 {
 	const char *tmpstr = *str;
 
@@ -88,29 +92,29 @@ static int at_parse_detect_type(const char **str, int index)
 		/* Only first parameter in the string can be
 		 * notification ID, (eg +CEREG:)
 		 */
-		set_new_state(NOTIFICATION);
+		set_new_state(ps, NOTIFICATION);
 
 		/* Check for responses we know need to be strings */
-		set_type_string = check_response_for_forced_string(tmpstr);
+		ps->set_type_string = check_response_for_forced_string(tmpstr);
 
-	} else if (set_type_string) {
-		set_new_state(STRING);
+	} else if (ps->set_type_string) {
+		set_new_state(ps, STRING);
 	} else if ((index > 0) && is_clac(tmpstr)) {
 		/* Next, check if we deal with CLAC response (eg AT+, AT%)
 		 * NOTE - need to go back to index 0 and parse as CLAC state
 		 * NOTE - AT+CLAC always returns more than one line
 		 */
-		set_new_state(CLAC);
+		set_new_state(ps, CLAC);
 		return -2;
 	} else if ((index == 0) && is_command(tmpstr)) {
 		/* Next, check if we deal with command (eg AT+CCLK) */
-		set_new_state(COMMAND);
+		set_new_state(ps, COMMAND);
 	} else if (index == 0) {
 		/* If the string start without an notification
 		 * ID, we treat the whole string as one string
 		 * parameter
 		 */
-		set_new_state(STRING);
+		set_new_state(ps, STRING);
 	} else if ((index > 0) && is_notification(*tmpstr)) {
 		/* If notifications is detected later in the
 		 * string we should stop parsing and return
@@ -119,15 +123,15 @@ static int at_parse_detect_type(const char **str, int index)
 		*str = tmpstr;
 		return -1;
 	} else if (is_number(*tmpstr)) {
-		set_new_state(NUMBER);
+		set_new_state(ps, NUMBER);
 
 	} else if (is_dblquote(*tmpstr)) {
-		set_new_state(QUOTED_STRING);
+		set_new_state(ps, QUOTED_STRING);
 		tmpstr++;
 	} else if (is_array_start(*tmpstr)) {
-		set_new_state(ARRAY);
+		set_new_state(ps, ARRAY);
 		tmpstr++;
-	} else if (is_lfcr(*tmpstr) && (state == NUMBER)) {
+	} else if (is_lfcr(*tmpstr) && (ps->state == NUMBER)) {
 		/* If \n or \r is detected in the string and the
 		 * previous param was a number we assume the
 		 * next parameter is PDU data
@@ -137,14 +141,14 @@ static int at_parse_detect_type(const char **str, int index)
 			tmpstr++;
 		}
 
-		set_new_state(SMS_PDU);
-	} else if (is_lfcr(*tmpstr) && (state == OPTIONAL)) {
-		set_new_state(OPTIONAL);
+		set_new_state(ps, SMS_PDU);
+	} else if (is_lfcr(*tmpstr) && (ps->state == OPTIONAL)) {
+		set_new_state(ps, OPTIONAL);
 	} else if (is_separator(*tmpstr)) {
 		/* If a separator is detected we have detected
 		 * and empty optional parameter
 		 */
-		set_new_state(OPTIONAL);
+		set_new_state(ps, OPTIONAL);
 	} else {
 		/* The rule set is exhausted, and cannot
 		 * continue. Break the loop and return an error
@@ -157,7 +161,8 @@ static int at_parse_detect_type(const char **str, int index)
 	return 0;
 }
 
-static int at_parse_process_element(const char **str, int index,
+static int at_parse_process_element(struct parser_state *ps,
+				    const char **str, int index,
 				    struct at_param_list *const list)
 {
 	const char *tmpstr = *str;
@@ -166,7 +171,7 @@ static int at_parse_process_element(const char **str, int index,
 		return -1;
 	}
 
-	if (state == NOTIFICATION) {
+	if (ps->state == NOTIFICATION) {
 		const char *start_ptr = tmpstr++;
 
 		while (is_valid_notification_char(*tmpstr)) {
@@ -175,7 +180,7 @@ static int at_parse_process_element(const char **str, int index,
 
 		at_params_string_put(list, index, start_ptr,
 				     tmpstr - start_ptr);
-	} else if (state == COMMAND) {
+	} else if (ps->state == COMMAND) {
 		const char *start_ptr = tmpstr;
 
 		skip_command_prefix(&tmpstr);
@@ -195,10 +200,10 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-	} else if (state == OPTIONAL) {
+	} else if (ps->state == OPTIONAL) {
 		at_params_empty_put(list, index);
 
-	} else if (state == STRING) {
+	} else if (ps->state == STRING) {
 		const char *start_ptr = tmpstr;
 
 		while (!is_lfcr(*tmpstr) && !is_terminated(*tmpstr)) {
@@ -208,8 +213,11 @@ static int at_parse_process_element(const char **str, int index,
 		at_params_string_put(list, index, start_ptr,
 				     tmpstr - start_ptr);
 
-		tmpstr++;
-	} else if (state == QUOTED_STRING) {
+		/* The last line of a response may not be terminated. */
+		if (!is_terminated(*tmpstr)) {
+			tmpstr++;
+		}
+	} else if (ps->state == QUOTED_STRING) {
 		const char *start_ptr = tmpstr;
 
 		while (!is_dblquote(*tmpstr) && !is_terminated(*tmpstr)) {
@@ -220,45 +228,31 @@ static int at_parse_process_element(const char **str, int index,
 				     tmpstr - start_ptr);
 
 		tmpstr++;
-	} else if (state == ARRAY) {
-		char *next;
-		size_t i = 0;
-		uint32_t tmparray[AT_CMD_MAX_ARRAY_SIZE];
-
-		tmparray[i++] = (uint32_t)strtoul(tmpstr, &next, 10);
-		tmpstr = next;
-
-		while (!is_array_stop(*tmpstr) && !is_terminated(*tmpstr)) {
-			if (is_separator(*tmpstr)) {
-				tmparray[i++] =
-					(uint32_t)strtoul(++tmpstr, &next, 10);
-
-				if (strlen(tmpstr) == strlen(next)) {
-					break;
-				} else {
-					tmpstr = next;
-				}
-
-			} else {
-				tmpstr++;
-			}
-
-			if (i == AT_CMD_MAX_ARRAY_SIZE) {
-				break;
-			}
+	} else if (ps->state == ARRAY) {
+		if (list->zero_copy) {
+			const char *start_ptr = tmpstr;
+
+			at_parse_array(&tmpstr, NULL, AT_CMD_MAX_ARRAY_SIZE);
+			at_params_array_view_put(list, index, start_ptr,
+						 tmpstr - start_ptr);
+		} else {
+			uint32_t tmparray[AT_CMD_MAX_ARRAY_SIZE];
+			size_t i = at_parse_array(&tmpstr, tmparray,
+						  AT_CMD_MAX_ARRAY_SIZE);
+
+			at_params_array_put(list, index, tmparray,
+					    i * sizeof(uint32_t));
 		}
 
-		at_params_array_put(list, index, tmparray, i * sizeof(uint32_t));
-
 		tmpstr++;
-	} else if (state == NUMBER) {
+	} else if (ps->state == NUMBER) {
 		char *next;
 		int64_t value = (int64_t)strtoll(tmpstr, &next, 10);
 
 		tmpstr = next;
 
 		at_params_int_put(list, index, value);
-	} else if (state == SMS_PDU) {
+	} else if (ps->state == SMS_PDU) {
 		const char *start_ptr = tmpstr;
 
 		while (isxdigit((int)*tmpstr)) {
@@ -267,7 +261,7 @@ static int at_parse_process_element(const char **str, int index,
 
 		at_params_string_put(list, index, start_ptr,
 				     tmpstr - start_ptr);
-	} else if (state == CLAC) {
+	} else if (ps->state == CLAC) {
 		const char *start_ptr = tmpstr;
 
 		while (!is_terminated(*tmpstr)) {
@@ -294,15 +288,16 @@ static int at_parse_param(const char **at_params_str,
 	const char *str = *at_params_str;
 	bool oversized = false;
 	int ret;
+	struct parser_state ps;
 
-	reset_state();
+	reset_state(&ps);
 
 	while ((!is_terminated(*str)) && (index < max_params)) {
 		if (isspace((int)*str)) {
 			str++;
 		}
 
-		ret = at_parse_detect_type(&str, index);
+		ret = at_parse_detect_type(&ps, &str, index);
 		if (ret == -1) {
 			break;
 		}
@@ -312,7 +307,7 @@ static int at_parse_param(const char **at_params_str,
 			index = 0;
 		}
 
-		if (at_parse_process_element(&str, index, list) == -1) {
+		if (at_parse_process_element(&ps, &str, index, list) == -1) {
 			break;
 		}
 
@@ -327,11 +322,11 @@ static int at_parse_param(const char **at_params_str,
 					break;
 				}
 
-				if (at_parse_detect_type(&str, index) == -1) {
+				if (at_parse_detect_type(&ps, &str, index) == -1) {
 					break;
 				}
 
-				if (at_parse_process_element(&str, index,
+				if (at_parse_process_element(&ps, &str, index,
 							     list) == -1) {
 					break;
 				}
@@ -404,6 +399,98 @@ int at_parser_max_params_from_str(const char *at_params_str,
 	return err;
 }
 
+int at_parser_init(struct at_parser *parser, struct at_param_list *list,
+		   char *buf, size_t buf_size, at_parser_handler_t handler,
+		   void *user_data)
+{
+	if (parser == NULL || list == NULL || list->params == NULL ||
+	    buf == NULL || buf_size < 2 || handler == NULL) {
+		return -EINVAL;
+	}
+
+	parser->buf = buf;
+	parser->buf_size = buf_size;
+	parser->list = list;
+	parser->handler = handler;
+	parser->user_data = user_data;
+
+	at_parser_reset(parser);
+
+	return 0;
+}
+
+void at_parser_reset(struct at_parser *parser)
+{
+	parser->len = 0;
+	parser->overflow = false;
+}
+
+static void at_parser_line_complete(struct at_parser *parser)
+{
+	int err;
+	size_t i = 0;
+
+	if (parser->overflow) {
+		parser->handler(-ENOBUFS, parser->list, parser->user_data);
+		return;
+	}
+
+	parser->buf[parser->len] = '\0';
+
+	while (is_lfcr(parser->buf[i])) {
+		i++;
+	}
+
+	if (is_terminated(parser->buf[i])) {
+		/* Empty line. */
+		return;
+	}
+
+	err = at_parser_params_from_str(&parser->buf[i], NULL, parser->list);
+	parser->handler(err, parser->list, parser->user_data);
+}
+
+int at_parser_feed(struct at_parser *parser, const char *data, size_t len)
+{
+	if (parser == NULL || parser->buf == NULL || data == NULL) {
+		return -EINVAL;
+	}
+
+	while (len > 0) {
+		const char *eol = memchr(data, '\n', len);
+		size_t chunk_len = (eol != NULL) ? (eol - data + 1) : len;
+
+		/* Leave room for the null terminator. */
+		if (!parser->overflow &&
+		    (parser->len + chunk_len < parser->buf_size)) {
+			memcpy(&parser->buf[parser->len], data, chunk_len);
+			parser->len += chunk_len;
+		} else {
+			parser->overflow = true;
+		}
+
+		if (eol != NULL) {
+			at_parser_line_complete(parser);
+			at_parser_reset(parser);
+		}
+
+		data += chunk_len;
+		len -= chunk_len;
+	}
+
+	return 0;
+}
+
+void at_parser_flush(struct at_parser *parser)
+{
+	if ((parser->len == 0) && !parser->overflow) {
+		return;
+	}
+
+	at_parser_line_complete(parser);
+	at_parser_reset(parser);
+}
+
 enum at_cmd_type at_parser_cmd_type_get(const char *at_cmd)
 {
 	enum at_cmd_type type;
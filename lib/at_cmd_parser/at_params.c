@@ -13,6 +13,7 @@
 #include <kernel.h>
 
 #include <modem/at_params.h>
+#include "at_utils.h"
 
 /* Internal function. Parameter cannot be null. */
 static void at_param_init(struct at_param *param)
@@ -23,19 +24,32 @@ static void at_param_init(struct at_param *param)
 	memset(param, 0, sizeof(struct at_param));
 }
 
-/* Internal function. Parameter cannot be null. */
-static void at_param_clear(struct at_param *param)
+/* Internal function. Parameters cannot be null. */
+static void at_param_clear(const struct at_param_list *list,
+			   struct at_param *param)
 {
 	__ASSERT(param != NULL, "Parameter cannot be NULL.");
 
-	if ((param->type == AT_PARAM_TYPE_STRING) ||
-	    (param->type == AT_PARAM_TYPE_ARRAY)) {
+	if (!list->zero_copy &&
+	    ((param->type == AT_PARAM_TYPE_STRING) ||
+	     (param->type == AT_PARAM_TYPE_ARRAY))) {
 		k_free(param->value.str_val);
 	}
 
 	param->value.int_val = 0;
 }
 
+/* Internal function. Parameters cannot be null.
+ * Parse array referenced by a parameter of a zero-copy list.
+ */
+static size_t at_param_array_view_parse(const struct at_param *param,
+					uint32_t *array)
+{
+	const char *str = param->value.str_val;
+
+	return at_parse_array(&str, array, AT_CMD_MAX_ARRAY_SIZE);
+}
+
 /* Internal function. Parameter cannot be null. */
 static struct at_param *at_params_get(const struct at_param_list *list,
 				      size_t index)
@@ -51,13 +65,17 @@ static struct at_param *at_params_get(const struct at_param_list *list,
 	return &param[index];
 }
 
-/* Internal function. Parameter cannot be null. */
-static size_t at_param_size(const struct at_param *param)
+/* Internal function. Parameters cannot be null. */
+static size_t at_param_size(const struct at_param_list *list,
+			    const struct at_param *param)
 {
 	__ASSERT(param != NULL, "Parameter cannot be NULL.");
 
 	if (param->type == AT_PARAM_TYPE_NUM_INT) {
 		return sizeof(uint64_t);
+	} else if ((param->type == AT_PARAM_TYPE_ARRAY) && list->zero_copy) {
+		return at_param_array_view_parse(param, NULL) *
+		       sizeof(uint32_t);
 	} else if ((param->type == AT_PARAM_TYPE_STRING) ||
 		   (param->type == AT_PARAM_TYPE_ARRAY)) {
 		return param->size;
@@ -66,7 +84,8 @@ static size_t at_param_size(const struct at_param *param)
 	return 0;
 }
 
-int at_params_list_init(struct at_param_list *list, size_t max_params_count)
+static int at_params_list_alloc(struct at_param_list *list,
+				size_t max_params_count, bool zero_copy)
 {
 	if (list == NULL) {
 		return -EINVAL;
@@ -79,9 +98,21 @@ int at_params_list_init(struct at_param_list *list, size_t max_params_count)
 	}
 
 	list->param_count = max_params_count;
+	list->zero_copy = zero_copy;
 	return 0;
 }
 
+int at_params_list_init(struct at_param_list *list, size_t max_params_count)
+{
+	return at_params_list_alloc(list, max_params_count, false);
+}
+
+int at_params_list_init_zero_copy(struct at_param_list *list,
+				  size_t max_params_count)
+{
+	return at_params_list_alloc(list, max_params_count, true);
+}
+
 void at_params_list_clear(struct at_param_list *list)
 {
 	if (list == NULL || list->params == NULL) {
@@ -91,7 +122,7 @@ void at_params_list_clear(struct at_param_list *list)
 	for (size_t i = 0; i < list->param_count; ++i) {
 		struct at_param *params = list->params;
 
-		at_param_clear(&params[i]);
+		at_param_clear(list, &params[i]);
 		at_param_init(&params[i]);
 	}
 }
@@ -121,7 +152,7 @@ int at_params_empty_put(const struct at_param_list *list, size_t index)
 		return -EINVAL;
 	}
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 
 	param->type = AT_PARAM_TYPE_EMPTY;
 	param->value.int_val = 0;
@@ -141,7 +172,7 @@ int at_params_int_put(const struct at_param_list *list, size_t index, int64_t va
 		return -EINVAL;
 	}
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 
 	param->type = AT_PARAM_TYPE_NUM_INT;
 	param->value.int_val = value;
@@ -161,6 +192,15 @@ int at_params_string_put(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
+	if (list->zero_copy) {
+		at_param_clear(list, param);
+		param->size = str_len;
+		param->type = AT_PARAM_TYPE_STRING;
+		param->value.str_val = (char *)str;
+
+		return 0;
+	}
+
 	char *param_value = (char *)k_malloc(str_len + 1);
 
 	if (param_value == NULL) {
@@ -169,7 +209,7 @@ int at_params_string_put(const struct at_param_list *list, size_t index,
 
 	memcpy(param_value, str, str_len);
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 	param->size = str_len;
 	param->type = AT_PARAM_TYPE_STRING;
 	param->value.str_val = param_value;
@@ -184,6 +224,10 @@ int at_params_array_put(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
+	if (list->zero_copy) {
+		return -ENOTSUP;
+	}
+
 	struct at_param *param = at_params_get(list, index);
 
 	if (param == NULL) {
@@ -198,7 +242,7 @@ int at_params_array_put(const struct at_param_list *list, size_t index,
 
 	memcpy(param_value, array, array_len);
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 	param->size = array_len;
 	param->type = AT_PARAM_TYPE_ARRAY;
 	param->value.array_val = param_value;
@@ -206,6 +250,28 @@ int at_params_array_put(const struct at_param_list *list, size_t index,
 	return 0;
 }
 
+int at_params_array_view_put(const struct at_param_list *list, size_t index,
+			     const char *str, size_t str_len)
+{
+	if (list == NULL || list->params == NULL || str == NULL ||
+	    !list->zero_copy) {
+		return -EINVAL;
+	}
+
+	struct at_param *param = at_params_get(list, index);
+
+	if (param == NULL) {
+		return -EINVAL;
+	}
+
+	at_param_clear(list, param);
+	param->size = str_len;
+	param->type = AT_PARAM_TYPE_ARRAY;
+	param->value.str_val = (char *)str;
+
+	return 0;
+}
+
 int at_params_size_get(const struct at_param_list *list, size_t index,
 		       size_t *len)
 {
@@ -219,7 +285,7 @@ int at_params_size_get(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
-	*len = at_param_size(param);
+	*len = at_param_size(list, param);
 	return 0;
 }
 
@@ -364,7 +430,7 @@ int at_params_string_get(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
-	size_t param_len = at_param_size(param);
+	size_t param_len = at_param_size(list, param);
 
 	if (*len < param_len) {
 		return -ENOMEM;
@@ -394,13 +460,17 @@ int at_params_array_get(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
-	size_t param_len = at_param_size(param);
+	size_t param_len = at_param_size(list, param);
 
 	if (*len < param_len) {
 		return -ENOMEM;
 	}
 
-	memcpy(array, param->value.array_val, param_len);
+	if (list->zero_copy) {
+		at_param_array_view_parse(param, array);
+	} else {
+		memcpy(array, param->value.array_val, param_len);
+	}
 	*len = param_len;
 
 	return 0;
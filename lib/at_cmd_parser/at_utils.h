@@ -18,6 +18,7 @@
 
 #include <zephyr/types.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <ctype.h>
 
 #define AT_PARAM_SEPARATOR ','
@@ -29,6 +30,7 @@
 #define AT_STANDARD_NOTIFICATION_PREFIX '+'
 #define AT_PROP_NOTIFICATION_PREFX '%'
 #define AT_CUSTOM_COMMAND_PREFX '#'
+#define AT_CMD_MAX_ARRAY_SIZE 32
 
 /**
  * @brief Check if character is a notification start character
@@ -300,6 +302,83 @@ static bool is_clac(const char *str)
 
 	return true;
 }
+/**
+ * @brief Parse an array of numbers
+ *
+ * Numbers are parsed until the array stop character, the end of the string
+ * or @p max_cnt numbers. If the array contains compound values, only
+ * the leading numeric part of the value is converted.
+ *
+ * @param[in,out] str     Pointer to the first character after the array
+ *                        start character. Updated to point to the character
+ *                        at which parsing stopped.
+ * @param[out]    array   Array to store the numbers in, or NULL to only
+ *                        count the numbers.
+ * @param[in]     max_cnt Maximum number of numbers to parse.
+ *
+ * @return Number of parsed numbers.
+ */
+static inline size_t at_parse_array(const char **str, uint32_t *array,
+				    size_t max_cnt)
+{
+	const char *tmpstr = *str;
+	char *next;
+	size_t i = 0;
+	uint32_t val;
+
+	val = (uint32_t)strtoul(tmpstr, &next, 10);
+	if (array) {
+		array[i] = val;
+	}
+	i++;
+	tmpstr = next;
+
+	while (!is_array_stop(*tmpstr) && !is_terminated(*tmpstr) &&
+	       (i < max_cnt)) {
+		if (is_separator(*tmpstr)) {
+			tmpstr++;
+			val = (uint32_t)strtoul(tmpstr, &next, 10);
+			if (array) {
+				array[i] = val;
+			}
+			i++;
+
+			if (next == tmpstr) {
+				/* No digits found. */
+				break;
+			}
+
+			tmpstr = next;
+		} else {
+			tmpstr++;
+		}
+	}
+
+	*str = tmpstr;
+
+	return i;
+}
+
+struct at_param_list;
+
+/**
+ * @brief Add an array parameter that references its text representation
+ *
+ * Used by the parser for zero-copy parameter lists. The numbers are parsed
+ * from the referenced text when the parameter is read.
+ *
+ * @param[in] list    Zero-copy parameter list.
+ * @param[in] index   Index in the list where to put the parameter.
+ * @param[in] str     Pointer to the first character after the array start
+ *                    character.
+ * @param[in] str_len Length of the array text.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_params_array_view_put(const struct at_param_list *list, size_t index,
+			     const char *str, size_t str_len);
+
 /** @} */
 
 #endif /* AT_UTILS_H__ */
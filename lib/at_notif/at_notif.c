@@ -7,6 +7,7 @@
 #include <logging/log.h>
 #include <zephyr.h>
 #include <stdio.h>
+#include <string.h>
 #include <init.h>
 #include <modem/at_cmd.h>
 #include <modem/at_notif.h>
@@ -14,6 +15,14 @@
 
 LOG_MODULE_REGISTER(at_notif, CONFIG_AT_NOTIF_LOG_LEVEL);
 
+#define PREFIX_TABLE_SIZE CONFIG_AT_NOTIF_PREFIX_TABLE_SIZE
+
+BUILD_ASSERT((PREFIX_TABLE_SIZE & (PREFIX_TABLE_SIZE - 1)) == 0,
+	     "Prefix table size must be a power of two");
+
+/* Characters terminating the prefix of a notification. */
+#define PREFIX_DELIMITERS ": \r\n"
+
 static K_MUTEX_DEFINE(list_mtx);
 
 /**@brief Link list element for notification handler. */
@@ -21,23 +30,64 @@ struct notif_handler {
 	sys_snode_t        node;
 	void               *ctx;
 	at_notif_handler_t handler;
+	uint32_t           prefix_hash;
+	size_t             prefix_len;
+	char               prefix[];
 };
 
+/* Handlers receiving all notifications. */
 static sys_slist_t handler_list;
+/* Handlers receiving notifications with a given prefix, indexed by the hash
+ * of the prefix.
+ */
+static sys_slist_t prefix_table[PREFIX_TABLE_SIZE];
 static bool initialized;
 
+/**@brief Compute the FNV-1a hash of a notification prefix. */
+static uint32_t prefix_hash(const char *prefix, size_t len)
+{
+	uint32_t hash = 2166136261U;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= (uint8_t)prefix[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/**@brief Get the list holding the handlers for a given prefix hash. */
+static sys_slist_t *handler_list_get(size_t prefix_len, uint32_t hash)
+{
+	if (prefix_len == 0) {
+		return &handler_list;
+	}
+
+	return &prefix_table[hash & (PREFIX_TABLE_SIZE - 1)];
+}
+
+static bool prefix_match(const struct notif_handler *node,
+			 const char *prefix, size_t len, uint32_t hash)
+{
+	return (node->prefix_hash == hash) &&
+	       (node->prefix_len == len) &&
+	       ((len == 0) || (memcmp(node->prefix, prefix, len) == 0));
+}
+
 /**
  * @brief Find the handler from the notification list.
  *
  * @return The node or NULL if not found and its previous node in @p prev_out.
  */
-static struct notif_handler *find_node(struct notif_handler **prev_out,
-	void *ctx, at_notif_handler_t handler)
+static struct notif_handler *find_node(sys_slist_t *list,
+	struct notif_handler **prev_out, void *ctx, at_notif_handler_t handler,
+	const char *prefix, size_t prefix_len, uint32_t hash)
 {
 	struct notif_handler *prev = NULL, *curr, *tmp;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&handler_list, curr, tmp, node) {
-		if (curr->ctx == ctx && curr->handler == handler) {
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(list, curr, tmp, node) {
+		if (curr->ctx == ctx && curr->handler == handler &&
+		    prefix_match(curr, prefix, prefix_len, hash)) {
 			*prev_out = prev;
 			return curr;
 		}
@@ -47,44 +97,60 @@ static struct notif_handler *find_node(struct notif_handler **prev_out,
 }
 
 /**@brief Add the handler in the notification list if not already present. */
-static int append_notif_handler(void *ctx, at_notif_handler_t handler)
+static int append_notif_handler(void *ctx, const char *prefix,
+				at_notif_handler_t handler)
 {
 	struct notif_handler *to_ins;
+	size_t prefix_len = (prefix != NULL) ? strlen(prefix) : 0;
+	uint32_t hash = prefix_hash(prefix, prefix_len);
+	sys_slist_t *list = handler_list_get(prefix_len, hash);
 
 	k_mutex_lock(&list_mtx, K_FOREVER);
 
 	/* Check if handler is already registered. */
-	if (find_node(&to_ins, ctx, handler) != NULL) {
+	if (find_node(list, &to_ins, ctx, handler, prefix, prefix_len,
+		      hash) != NULL) {
 		LOG_DBG("Handler already registered. Nothing to do");
 		k_mutex_unlock(&list_mtx);
 		return 0;
 	}
 
 	/* Allocate memory and fill. */
-	to_ins = (struct notif_handler *)k_malloc(sizeof(struct notif_handler));
+	to_ins = (struct notif_handler *)k_malloc(sizeof(struct notif_handler) +
+						  prefix_len + 1);
 	if (to_ins == NULL) {
 		k_mutex_unlock(&list_mtx);
 		return -ENOBUFS;
 	}
 	memset(to_ins, 0, sizeof(struct notif_handler));
-	to_ins->ctx     = ctx;
-	to_ins->handler = handler;
+	to_ins->ctx         = ctx;
+	to_ins->handler     = handler;
+	to_ins->prefix_hash = hash;
+	to_ins->prefix_len  = prefix_len;
+	if (prefix_len > 0) {
+		memcpy(to_ins->prefix, prefix, prefix_len);
+	}
+	to_ins->prefix[prefix_len] = '\0';
 
 	/* Insert handler in the list. */
-	sys_slist_append(&handler_list, &to_ins->node);
+	sys_slist_append(list, &to_ins->node);
 	k_mutex_unlock(&list_mtx);
 	return 0;
 }
 
 /**@brief Remove the handler from the notification list if registered. */
-static int remove_notif_handler(void *ctx, at_notif_handler_t handler)
+static int remove_notif_handler(void *ctx, const char *prefix,
+				at_notif_handler_t handler)
 {
 	struct notif_handler *curr, *prev = NULL;
+	size_t prefix_len = (prefix != NULL) ? strlen(prefix) : 0;
+	uint32_t hash = prefix_hash(prefix, prefix_len);
+	sys_slist_t *list = handler_list_get(prefix_len, hash);
 
 	k_mutex_lock(&list_mtx, K_FOREVER);
 
 	/* Check if the handler is registered before removing it. */
-	curr = find_node(&prev, ctx, handler);
+	curr = find_node(list, &prev, ctx, handler, prefix, prefix_len, hash);
 	if (curr == NULL) {
 		LOG_WRN("Handler not registered. Nothing to do");
 		k_mutex_unlock(&list_mtx);
@@ -92,7 +158,7 @@ static int remove_notif_handler(void *ctx, at_notif_handler_t handler)
 	}
 
 	/* Remove the handler from the list. */
-	sys_slist_remove(&handler_list, &prev->node, &curr->node);
+	sys_slist_remove(list, &prev->node, &curr->node);
 	k_free(curr);
 
 	k_mutex_unlock(&list_mtx);
@@ -103,6 +169,9 @@ static int remove_notif_handler(void *ctx, at_notif_handler_t handler)
 static void notif_dispatch(const char *response)
 {
 	struct notif_handler *curr, *tmp;
+	const char *prefix = response + strspn(response, "\r\n");
+	size_t prefix_len = strcspn(prefix, PREFIX_DELIMITERS);
+	uint32_t hash = prefix_hash(prefix, prefix_len);
 
 	k_mutex_lock(&list_mtx, K_FOREVER);
 
@@ -113,6 +182,21 @@ static void notif_dispatch(const char *response)
 			(uint32_t)curr->handler);
 		curr->handler(curr->ctx, response);
 	}
+
+	/* Dispatch notifications to the handlers registered for the prefix */
+	if (prefix_len > 0) {
+		sys_slist_t *list = handler_list_get(prefix_len, hash);
+
+		SYS_SLIST_FOR_EACH_CONTAINER_SAFE(list, curr, tmp, node) {
+			if (!prefix_match(curr, prefix, prefix_len, hash)) {
+				continue;
+			}
+			LOG_DBG(" - ctx=0x%08X, handler=0x%08X, prefix=%s",
+				(uint32_t)curr->ctx, (uint32_t)curr->handler,
+				log_strdup(curr->prefix));
+			curr->handler(curr->ctx, response);
+		}
+	}
 	LOG_DBG("Done");
 
 	k_mutex_unlock(&list_mtx);
@@ -131,6 +215,9 @@ static int module_init(const struct device *dev)
 
 	LOG_DBG("Initialization");
 	sys_slist_init(&handler_list);
+	for (size_t i = 0; i < ARRAY_SIZE(prefix_table); i++) {
+		sys_slist_init(&prefix_table[i]);
+	}
 	at_cmd_set_notification_handler(notif_dispatch);
 	return 0;
 }
@@ -141,6 +228,17 @@ int at_notif_init(void)
 }
 
 int at_notif_register_handler(void *context, at_notif_handler_t handler)
+{
+	return at_notif_register_prefix_handler(context, NULL, handler);
+}
+
+int at_notif_deregister_handler(void *context, at_notif_handler_t handler)
+{
+	return at_notif_deregister_prefix_handler(context, NULL, handler);
+}
+
+int at_notif_register_prefix_handler(void *context, const char *prefix,
+				     at_notif_handler_t handler)
 {
 	if (!initialized) {
 		LOG_ERR("Module not initialized yet");
@@ -151,10 +249,16 @@ int at_notif_register_handler(void *context, at_notif_handler_t handler)
 			(uint32_t)context, (uint32_t)handler);
 		return -EINVAL;
 	}
-	return append_notif_handler(context, handler);
+	if ((prefix != NULL) &&
+	    (prefix[strcspn(prefix, PREFIX_DELIMITERS)] != '\0')) {
+		LOG_ERR("Invalid prefix %s", log_strdup(prefix));
+		return -EINVAL;
+	}
+	return append_notif_handler(context, prefix, handler);
 }
 
-int at_notif_deregister_handler(void *context, at_notif_handler_t handler)
+int at_notif_deregister_prefix_handler(void *context, const char *prefix,
+				       at_notif_handler_t handler)
 {
 	if (!initialized) {
 		LOG_ERR("Module not initialized yet");
@@ -165,7 +269,7 @@ int at_notif_deregister_handler(void *context, at_notif_handler_t handler)
 			(uint32_t)context, (uint32_t)handler);
 		return -EINVAL;
 	}
-	return remove_notif_handler(context, handler);
+	return remove_notif_handler(context, prefix, handler);
 }
 
 #ifdef CONFIG_AT_NOTIF_SYS_INIT
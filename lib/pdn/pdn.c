@@ -161,11 +161,19 @@ int pdn_init(void)
 		pdn_contexts[i].context_id = CID_UNASSIGNED;
 	}
 
-	err = at_notif_register_handler(NULL, at_notif_handler);
+	err = at_notif_register_prefix_handler(NULL, "+CNEC_ESM",
+					       at_notif_handler);
 	if (err) {
 		return err;
 	}
 
+	err = at_notif_register_prefix_handler(NULL, "+CGEV", at_notif_handler);
+	if (err) {
+		(void)at_notif_deregister_prefix_handler(NULL, "+CNEC_ESM",
+							 at_notif_handler);
+		return err;
+	}
+
 	has_init = true;
 	return 0;
 }
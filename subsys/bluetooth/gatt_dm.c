@@ -9,6 +9,12 @@
 #include <logging/log.h>
 
 #include <bluetooth/gatt_dm.h>
+#include <sys/byteorder.h>
+
+#if CONFIG_BT_GATT_DM_CACHE
+#include <bluetooth/conn.h>
+#include "gatt_dm_cache.h"
+#endif
 
 LOG_MODULE_REGISTER(bt_gatt_dm, CONFIG_BT_GATT_DM_LOG_LEVEL);
 
@@ -18,6 +24,13 @@ LOG_MODULE_REGISTER(bt_gatt_dm, CONFIG_BT_GATT_DM_LOG_LEVEL);
 
 #define DATA_ALIGN 4U
 
+/* Every attribute interns at most one UUID, the search UUID is the extra one.
+ * The UUID set is at most half full, so that a lookup only probes a few
+ * slots.
+ */
+#define UUID_MAX_CNT (CONFIG_BT_GATT_DM_MAX_ATTRS + 1)
+#define UUID_SET_SIZE (2 * UUID_MAX_CNT + 1)
+
 /* They are placed in data_chunk without padding, so they must be aligned */
 BUILD_ASSERT(sizeof(struct bt_gatt_service_val) % DATA_ALIGN == 0);
 BUILD_ASSERT(sizeof(struct bt_gatt_chrc) % DATA_ALIGN == 0);
@@ -58,8 +71,35 @@ struct bt_gatt_dm {
 	/* The used length of the current chunk */
 	size_t cur_chunk_len;
 
+	/* Interned UUIDs, each stored once in the data chunks */
+	const struct bt_uuid *uuids[UUID_MAX_CNT];
+	/* Number of interned UUIDs */
+	size_t uuid_cnt;
+	/* Hash set of the interned UUIDs, holding indexes to uuids plus one */
+	uint16_t uuid_set[UUID_SET_SIZE];
+	/* Index of the first characteristic with the interned UUID as its
+	 * value UUID, or 0 if there is none.
+	 */
+	uint16_t first_chrc[UUID_MAX_CNT];
+
 	/* The pointer to callback structure */
 	const struct bt_gatt_dm_cb *callback;
+
+#if CONFIG_BT_GATT_DM_CACHE
+	/* Database Hash read parameters */
+	struct bt_gatt_read_params hash_read_params;
+	/* Reports the service found in the cache */
+	struct k_work cache_work;
+	/* The service found in the cache */
+	struct gatt_dm_cache_svc cache_svc;
+	/* Result of the cache lookup */
+	int cache_err;
+	/* The cache record of the peer is open */
+	bool cache_open;
+	/* Service UUID and start handle of the discovery from the peer */
+	const struct bt_uuid *search_uuid;
+	uint16_t search_start;
+#endif
 };
 
 /* Currently only one instance is supported */
@@ -104,6 +144,13 @@ static void *user_data_alloc(struct bt_gatt_dm *dm,
 	return user_data_loc;
 }
 
+static void uuid_set_clear(struct bt_gatt_dm *dm)
+{
+	memset(dm->uuid_set, 0, sizeof(dm->uuid_set));
+	memset(dm->first_chrc, 0, dm->uuid_cnt * sizeof(dm->first_chrc[0]));
+	dm->uuid_cnt = 0;
+}
+
 static void svc_attr_memory_release(struct bt_gatt_dm *dm)
 {
 	sys_snode_t *node;
@@ -122,6 +169,7 @@ static void svc_attr_memory_release(struct bt_gatt_dm *dm)
 	}
 
 	dm->cur_chunk_len = 0;
+	uuid_set_clear(dm);
 }
 
 /* Returns size of UUID structure with padding for memory alignment */
@@ -140,14 +188,148 @@ static size_t get_uuid_size(const struct bt_uuid *uuid)
 	}
 }
 
+static uint32_t uuid_hash_data(const uint8_t *data, size_t len)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261U;
+
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ data[i]) * 16777619U;
+	}
+
+	return hash;
+}
+
+/* Hashes a UUID so that the 16-bit, 32-bit and 128-bit forms of a UUID that
+ * is an alias of the Bluetooth Base UUID get the same hash, as they are equal
+ * for bt_uuid_cmp().
+ */
+static uint32_t uuid_hash(const struct bt_uuid *uuid)
+{
+	static const uint8_t base_uuid[] = {
+		0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80,
+		0x00, 0x10, 0x00, 0x00
+	};
+	const uint8_t *val;
+	uint32_t key;
+
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		key = BT_UUID_16(uuid)->val;
+		break;
+	case BT_UUID_TYPE_32:
+		key = BT_UUID_32(uuid)->val;
+		break;
+	default:
+		val = BT_UUID_128(uuid)->val;
+		if (memcmp(val, base_uuid, sizeof(base_uuid)) != 0) {
+			return uuid_hash_data(val, sizeof(BT_UUID_128(uuid)->val));
+		}
+
+		key = sys_get_le32(&val[sizeof(base_uuid)]);
+		break;
+	}
+
+	return uuid_hash_data((const uint8_t *)&key, sizeof(key));
+}
+
+/* Returns the slot of the UUID in the set of interned UUIDs. The slot is
+ * empty if the UUID is not interned.
+ */
+static size_t uuid_slot_find(const struct bt_gatt_dm *dm,
+			     const struct bt_uuid *uuid)
+{
+	size_t slot = uuid_hash(uuid) % ARRAY_SIZE(dm->uuid_set);
+
+	while (dm->uuid_set[slot]) {
+		if (!bt_uuid_cmp(uuid, dm->uuids[dm->uuid_set[slot] - 1])) {
+			break;
+		}
+
+		slot = (slot + 1) % ARRAY_SIZE(dm->uuid_set);
+	}
+
+	return slot;
+}
+
+/* Returns the index of the interned UUID equal to the given one, storing
+ * it in dm->data_chunk if it is not interned yet. Equal UUIDs share the
+ * storage, and can be compared by their pointers.
+ */
+static int uuid_intern(struct bt_gatt_dm *dm, const struct bt_uuid *uuid)
+{
+	if (!uuid) {
+		LOG_ERR("Uninitialized UUID.");
+		return -EINVAL;
+	}
+
+	size_t slot = uuid_slot_find(dm, uuid);
+
+	if (dm->uuid_set[slot]) {
+		return dm->uuid_set[slot] - 1;
+	}
+
+	if (dm->uuid_cnt >= ARRAY_SIZE(dm->uuids)) {
+		LOG_ERR("No space for a UUID.");
+		return -ENOMEM;
+	}
+
+	size_t size = get_uuid_size(uuid);
+	void *buffer = user_data_alloc(dm, size);
+
+	if (!buffer) {
+		LOG_ERR("No space for a UUID.");
+		return -ENOMEM;
+	}
+
+	memcpy(buffer, uuid, size);
+
+	dm->uuids[dm->uuid_cnt++] = buffer;
+	dm->uuid_set[slot] = dm->uuid_cnt;
+
+	return dm->uuid_cnt - 1;
+}
+
+static struct bt_uuid *uuid_store(struct bt_gatt_dm *dm,
+				  const struct bt_uuid *uuid)
+{
+	int idx = uuid_intern(dm, uuid);
+
+	return (idx < 0) ? NULL : (struct bt_uuid *)dm->uuids[idx];
+}
+
+/* Stores the value UUID of a characteristic and indexes the characteristic
+ * by it, for bt_gatt_dm_char_by_uuid(). The characteristics are processed
+ * in handle order, so the first one with a given UUID is indexed.
+ */
+static int chrc_uuid_store(struct bt_gatt_dm *dm,
+			   const struct bt_gatt_dm_attr *attr_chrc,
+			   struct bt_gatt_chrc *chrc)
+{
+	int idx = uuid_intern(dm, chrc->uuid);
+
+	if (idx < 0) {
+		return idx;
+	}
+
+	chrc->uuid = dm->uuids[idx];
+
+	if (!dm->first_chrc[idx]) {
+		dm->first_chrc[idx] = attr_chrc - dm->attrs;
+	}
+
+	return 0;
+}
+
 /** @brief Stores attribute in bt_gatt_dm instance.
  *
- * This function stores attr at dm->attrs array. Its UUID is stored in
- * dm->data_chunk. The Discovery Manager attribute does not contain
- * a pointer to the context data. This data could be either
- * bt_gatt_service_val or bt_gatt_chrc. It is assumed that attribute context
- * data (if any) is always placed before its UUID data. For this purpose,
- * an additional buffer is allocated by this function and used later.
+ * This function stores attr at dm->attrs array. The Discovery Manager
+ * attribute does not contain a pointer to the context data. This data could
+ * be either bt_gatt_service_val or bt_gatt_chrc. It is assumed that attribute
+ * context data (if any) is always placed before its UUID data. For this
+ * purpose, an additional buffer is allocated by this function and used later,
+ * followed by a copy of the UUID. The UUIDs of the other attributes are
+ * interned.
  *
  * @param[in] dm             Discovery instance
  * @param[in] attr           Service attribute
@@ -160,6 +342,7 @@ static struct bt_gatt_dm_attr *attr_store(struct bt_gatt_dm *dm,
 					  size_t additional_len)
 {
 	struct bt_gatt_dm_attr *cur_attr;
+	struct bt_uuid *uuid;
 
 	LOG_DBG("Attr store, pos: %zu, handle: %"PRIu16,
 		dm->cur_attr_id,
@@ -169,45 +352,33 @@ static struct bt_gatt_dm_attr *attr_store(struct bt_gatt_dm *dm,
 		return NULL;
 	}
 
-	size_t uuid_size = get_uuid_size(attr->uuid);
-	uint8_t *attr_data = user_data_alloc(dm, additional_len + uuid_size);
+	if (additional_len) {
+		size_t uuid_size = get_uuid_size(attr->uuid);
+		uint8_t *attr_data = user_data_alloc(dm,
+						     additional_len + uuid_size);
 
-	if (!attr_data) {
-		LOG_ERR("No space for attribute data.");
-		return NULL;
+		if (!attr_data) {
+			LOG_ERR("No space for attribute data.");
+			return NULL;
+		}
+
+		uuid = (struct bt_uuid *)&attr_data[additional_len];
+		memcpy(uuid, attr->uuid, uuid_size);
+	} else {
+		uuid = uuid_store(dm, attr->uuid);
+		if (!uuid) {
+			return NULL;
+		}
 	}
 
 	cur_attr = &dm->attrs[(dm->cur_attr_id)++];
 	cur_attr->handle = attr->handle;
 	cur_attr->perm = attr->perm;
-	cur_attr->uuid = (struct bt_uuid *)&attr_data[additional_len];
-
-	memcpy(cur_attr->uuid, attr->uuid, uuid_size);
+	cur_attr->uuid = uuid;
 
 	return cur_attr;
 }
 
-static struct bt_uuid *uuid_store(struct bt_gatt_dm *dm,
-				  const struct bt_uuid *uuid)
-{
-	if (!uuid) {
-		LOG_ERR("Uninitialized UUID.");
-		return NULL;
-	}
-
-	size_t size = get_uuid_size(uuid);
-	void *buffer = user_data_alloc(dm, size);
-
-	if (!buffer) {
-		LOG_ERR("No space for a UUID.");
-		return NULL;
-	}
-
-	memcpy(buffer, uuid, size);
-
-	return (struct bt_uuid *)buffer;
-}
-
 static struct bt_gatt_dm_attr *attr_find_by_handle(
 	struct bt_gatt_dm *dm,
 	uint16_t handle)
@@ -266,6 +437,25 @@ static void discovery_complete_error(struct bt_gatt_dm *dm, int err)
 	}
 }
 
+static void cache_service_store(struct bt_gatt_dm *dm)
+{
+#if CONFIG_BT_GATT_DM_CACHE
+	if (dm->cache_open) {
+		(void)gatt_dm_cache_store(dm->search_uuid, dm->search_start,
+					  dm->attrs, dm->cur_attr_id);
+	}
+#endif
+}
+
+static void cache_service_not_found(struct bt_gatt_dm *dm)
+{
+#if CONFIG_BT_GATT_DM_CACHE
+	if (dm->cache_open) {
+		gatt_dm_cache_not_found(dm->search_uuid, dm->search_start);
+	}
+#endif
+}
+
 static uint8_t discovery_process_service(struct bt_gatt_dm *dm,
 				      const struct bt_gatt_attr *attr,
 				      struct bt_gatt_discover_params *params)
@@ -273,6 +463,7 @@ static uint8_t discovery_process_service(struct bt_gatt_dm *dm,
 	int err;
 
 	if (!attr) {
+		cache_service_not_found(dm);
 		discovery_complete_not_found(dm);
 		return BT_GATT_ITER_STOP;
 	}
@@ -353,6 +544,7 @@ static uint8_t discovery_process_attribute(struct bt_gatt_dm *dm,
 				discovery_complete_error(dm, err);
 			}
 		} else {
+			cache_service_store(dm);
 			discovery_complete(dm);
 		}
 		return BT_GATT_ITER_STOP;
@@ -388,6 +580,7 @@ static uint8_t discovery_process_characteristic(
 	struct bt_gatt_chrc *cur_gatt_chrc;
 
 	if (!attr) {
+		cache_service_store(dm);
 		discovery_complete(dm);
 		return BT_GATT_ITER_STOP;
 	}
@@ -407,8 +600,7 @@ static uint8_t discovery_process_characteristic(
 	__ASSERT_NO_MSG(cur_gatt_chrc != NULL);
 
 	memcpy(cur_gatt_chrc, gatt_chrc, sizeof(*cur_gatt_chrc));
-	cur_gatt_chrc->uuid = uuid_store(dm, cur_gatt_chrc->uuid);
-	if (!cur_gatt_chrc->uuid) {
+	if (chrc_uuid_store(dm, cur_attr, cur_gatt_chrc)) {
 		discovery_complete_error(dm, -ENOMEM);
 		return BT_GATT_ITER_STOP;
 	}
@@ -453,6 +645,184 @@ static uint8_t discovery_callback(struct bt_conn *conn,
 	return BT_GATT_ITER_STOP;
 }
 
+#if CONFIG_BT_GATT_DM_CACHE
+/* Stores an attribute read from the cache, with its service or
+ * characteristic declaration value.
+ */
+static struct bt_gatt_dm_attr *cached_attr_store(struct bt_gatt_dm *dm,
+						 const struct bt_gatt_attr *attr)
+{
+	struct bt_gatt_dm_attr *cur_attr;
+
+	if ((bt_uuid_cmp(attr->uuid, BT_UUID_GATT_PRIMARY) == 0) ||
+	    (bt_uuid_cmp(attr->uuid, BT_UUID_GATT_SECONDARY) == 0)) {
+		struct bt_gatt_service_val *service_val;
+
+		cur_attr = attr_store(dm, attr, sizeof(*service_val));
+		if (!cur_attr) {
+			return NULL;
+		}
+
+		service_val = bt_gatt_dm_attr_service_val(cur_attr);
+		memcpy(service_val, attr->user_data, sizeof(*service_val));
+		service_val->uuid = uuid_store(dm, service_val->uuid);
+
+		return service_val->uuid ? cur_attr : NULL;
+	}
+
+	if (bt_uuid_cmp(attr->uuid, BT_UUID_GATT_CHRC) == 0) {
+		struct bt_gatt_chrc *gatt_chrc;
+
+		cur_attr = attr_store(dm, attr, sizeof(*gatt_chrc));
+		if (!cur_attr) {
+			return NULL;
+		}
+
+		gatt_chrc = bt_gatt_dm_attr_chrc_val(cur_attr);
+		memcpy(gatt_chrc, attr->user_data, sizeof(*gatt_chrc));
+
+		return chrc_uuid_store(dm, cur_attr, gatt_chrc) ? NULL : cur_attr;
+	}
+
+	return attr_store(dm, attr, 0);
+}
+
+static void cache_work_handler(struct k_work *work)
+{
+	struct bt_gatt_dm *dm = CONTAINER_OF(work, struct bt_gatt_dm,
+					     cache_work);
+	struct gatt_dm_cache_attr attr;
+	int err;
+
+	if (dm->cache_err) {
+		discovery_complete_not_found(dm);
+		return;
+	}
+
+	while ((err = gatt_dm_cache_attr_get(&dm->cache_svc, &attr)) == 0) {
+		if (!cached_attr_store(dm, &attr.attr)) {
+			LOG_ERR("Not enough memory for cached attribute"
+				" at handle %u.",
+				attr.attr.handle);
+			discovery_complete_error(dm, -ENOMEM);
+			return;
+		}
+	}
+
+	if (err != -ENOENT) {
+		discovery_complete_error(dm, err);
+		return;
+	}
+
+	LOG_DBG("Service read from cache");
+
+	/* As after the discovery from the peer, for bt_gatt_dm_continue */
+	dm->discover_params.uuid = NULL;
+	dm->discover_params.start_handle = dm->attrs[0].handle + 1;
+	dm->discover_params.end_handle = dm->cache_svc.end_handle;
+	discovery_complete(dm);
+}
+#endif /* CONFIG_BT_GATT_DM_CACHE */
+
+/* Looks up the service in the cache, or discovers it from the peer */
+static int discovery_start(struct bt_gatt_dm *dm)
+{
+#if CONFIG_BT_GATT_DM_CACHE
+	if (dm->cache_open) {
+		dm->cache_err = gatt_dm_cache_find(dm->discover_params.uuid,
+						   dm->discover_params.start_handle,
+						   &dm->cache_svc);
+		if (dm->cache_err != -ENODATA) {
+			k_work_submit(&dm->cache_work);
+			return 0;
+		}
+	}
+
+	dm->search_uuid = dm->discover_params.uuid;
+	dm->search_start = dm->discover_params.start_handle;
+#endif
+
+	return bt_gatt_discover(dm->conn, &dm->discover_params);
+}
+
+#if CONFIG_BT_GATT_DM_CACHE
+static bool cache_peer_get(struct bt_conn *conn, bt_addr_le_t *peer)
+{
+	struct bt_conn_info info;
+
+	if (bt_conn_get_info(conn, &info) || (info.type != BT_CONN_TYPE_LE)) {
+		return false;
+	}
+
+	/* Only bonded peers are known by a stable identity address */
+	if (!bt_addr_le_is_bonded(info.id, info.le.dst)) {
+		return false;
+	}
+
+	bt_addr_le_copy(peer, info.le.dst);
+
+	return true;
+}
+
+static uint8_t db_hash_read_cb(struct bt_conn *conn, uint8_t att_err,
+			       struct bt_gatt_read_params *params,
+			       const void *data, uint16_t length)
+{
+	struct bt_gatt_dm *dm = CONTAINER_OF(params, struct bt_gatt_dm,
+					     hash_read_params);
+	bt_addr_le_t peer;
+	int err;
+
+	if (!att_err && data && (length == GATT_DM_CACHE_HASH_LEN) &&
+	    cache_peer_get(conn, &peer)) {
+		dm->cache_open = !gatt_dm_cache_open(&peer, data);
+	} else {
+		LOG_DBG("No Database Hash, ATT error: 0x%02x", att_err);
+	}
+
+	err = discovery_start(dm);
+	if (err) {
+		LOG_ERR("Discover failed, error: %d.", err);
+		discovery_complete_error(dm, err);
+	}
+
+	return BT_GATT_ITER_STOP;
+}
+
+/* Reads the Database Hash of a bonded peer before the discovery.
+ * Returns true if the discovery is started when the read completes.
+ */
+static bool db_hash_read(struct bt_gatt_dm *dm)
+{
+	static const struct bt_uuid_16 db_hash_uuid =
+		BT_UUID_INIT_16(BT_UUID_GATT_DB_HASH_VAL);
+	struct bt_gatt_read_params *params = &dm->hash_read_params;
+	bt_addr_le_t peer;
+	int err;
+
+	dm->cache_open = false;
+	k_work_init(&dm->cache_work, cache_work_handler);
+
+	if (!cache_peer_get(dm->conn, &peer)) {
+		return false;
+	}
+
+	params->func = db_hash_read_cb;
+	params->handle_count = 0;
+	params->by_uuid.start_handle = 0x0001;
+	params->by_uuid.end_handle = 0xffff;
+	params->by_uuid.uuid = &db_hash_uuid.uuid;
+
+	err = bt_gatt_read(dm->conn, params);
+	if (err) {
+		LOG_WRN("Database Hash read failed, error: %d.", err);
+		return false;
+	}
+
+	return true;
+}
+#endif /* CONFIG_BT_GATT_DM_CACHE */
+
 struct bt_gatt_service_val *bt_gatt_dm_attr_service_val(
 	const struct bt_gatt_dm_attr *attr)
 {
@@ -513,18 +883,16 @@ const struct bt_gatt_dm_attr *bt_gatt_dm_char_by_uuid(
 	const struct bt_gatt_dm *dm,
 	const struct bt_uuid *uuid)
 {
-	const struct bt_gatt_dm_attr *curr = NULL;
-
-	while ((curr = bt_gatt_dm_char_next(dm, curr)) != NULL) {
-		struct bt_gatt_chrc *chrc = bt_gatt_dm_attr_chrc_val(curr);
+	size_t slot = uuid_slot_find(dm, uuid);
+	uint16_t idx;
 
-		__ASSERT_NO_MSG(chrc != NULL);
-		if (!bt_uuid_cmp(uuid, chrc->uuid)) {
-			return curr;
-		}
+	if (!dm->uuid_set[slot]) {
+		return NULL;
 	}
 
-	return NULL;
+	idx = dm->first_chrc[dm->uuid_set[slot] - 1];
+
+	return idx ? &dm->attrs[idx] : NULL;
 }
 
 const struct bt_gatt_dm_attr *bt_gatt_dm_attr_by_handle(
@@ -559,9 +927,18 @@ const struct bt_gatt_dm_attr *bt_gatt_dm_desc_by_uuid(
 	const struct bt_uuid *uuid)
 {
 	const struct bt_gatt_dm_attr *curr = attr_chrc;
+	size_t slot = uuid_slot_find(dm, uuid);
+	const struct bt_uuid *desc_uuid;
+
+	/* A UUID that is not interned is not used by any descriptor */
+	if (!dm->uuid_set[slot]) {
+		return NULL;
+	}
+
+	desc_uuid = dm->uuids[dm->uuid_set[slot] - 1];
 
 	while ((curr = bt_gatt_dm_desc_next(dm, curr)) != NULL) {
-		if (!bt_uuid_cmp(uuid, curr->uuid)) {
+		if (curr->uuid == desc_uuid) {
 			break;
 		}
 	}
@@ -612,6 +989,7 @@ int bt_gatt_dm_start(struct bt_conn *conn,
 	dm->cur_attr_id = 0;
 	sys_slist_init(&dm->chunk_list);
 	dm->cur_chunk_len = 0;
+	uuid_set_clear(dm);
 
 	dm->discover_params.uuid = svc_uuid ? uuid_store(dm, svc_uuid) : NULL;
 	dm->discover_params.func = discovery_callback;
@@ -619,7 +997,13 @@ int bt_gatt_dm_start(struct bt_conn *conn,
 	dm->discover_params.end_handle = 0xffff;
 	dm->discover_params.type = BT_GATT_DISCOVER_PRIMARY;
 
-	err = bt_gatt_discover(conn, &dm->discover_params);
+#if CONFIG_BT_GATT_DM_CACHE
+	if (db_hash_read(dm)) {
+		return 0;
+	}
+#endif
+
+	err = discovery_start(dm);
 	if (err) {
 		LOG_ERR("Discover failed, error: %d.", err);
 		atomic_clear_bit(dm->state_flags, STATE_ATTRS_LOCKED);
@@ -660,7 +1044,7 @@ int bt_gatt_dm_continue(struct bt_gatt_dm *dm, void *context)
 	dm->discover_params.end_handle = 0xffff;
 	dm->discover_params.type = BT_GATT_DISCOVER_PRIMARY;
 
-	err = bt_gatt_discover(dm->conn, &dm->discover_params);
+	err = discovery_start(dm);
 	if (err) {
 		LOG_ERR("Discover failed, error: %d.", err);
 		atomic_clear_bit(dm->state_flags, STATE_ATTRS_LOCKED);
@@ -0,0 +1,686 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <sys/byteorder.h>
+#include <sys/util.h>
+#include <bluetooth/bluetooth.h>
+#include <settings/settings.h>
+#include <logging/log.h>
+
+#include "gatt_dm_cache.h"
+
+LOG_MODULE_DECLARE(bt_gatt_dm, CONFIG_BT_GATT_DM_LOG_LEVEL);
+
+#define SETTINGS_SUBTREE "bt_gatt_dm"
+/* Subtree, separator, address and address type */
+#define SETTINGS_KEY_LEN (sizeof(SETTINGS_SUBTREE) + 1 + 12 + 3)
+/* Number of records of removed bonds deleted in one settings pass */
+#define PURGE_BATCH 4
+
+/* The record of a peer starts with the Database Hash and the end handle of
+ * the walk, followed by the services. The walk is the range of handles,
+ * starting from 0x0001, in which all primary services are cached.
+ */
+#define RECORD_HDR_LEN (GATT_DM_CACHE_HASH_LEN + sizeof(uint16_t))
+#define WALK_END_POS GATT_DM_CACHE_HASH_LEN
+
+/* Each service is followed by its attributes, starting with the service
+ * declaration. An attribute is encoded as its handle, permissions and type,
+ * followed by the service UUID for a service declaration, or by the UUID,
+ * properties and value handle for a characteristic declaration.
+ * A UUID is encoded as its length followed by its value.
+ */
+struct cache_svc_hdr {
+	uint16_t start;
+	uint16_t end;
+	uint8_t attr_cnt;
+	/* Length of the encoded attributes */
+	uint16_t len;
+} __packed;
+
+static struct {
+	bt_addr_le_t peer;
+	char key[SETTINGS_KEY_LEN];
+	bool open;
+	/* The record has changed since it was saved */
+	bool dirty;
+	/* Records of removed bonds must be deleted */
+	bool purge;
+} cache;
+
+/* Records of removed bonds found in one settings pass */
+struct purge_batch {
+	bt_addr_le_t peers[PURGE_BATCH];
+	size_t cnt;
+};
+
+NET_BUF_SIMPLE_DEFINE_STATIC(record, CONFIG_BT_GATT_DM_CACHE_SIZE);
+
+/* Protects the record from being changed while it is saved */
+static K_MUTEX_DEFINE(cache_lock);
+
+static void cache_work_handler(struct k_work *work);
+
+/* The settings are written from the system workqueue, and not from the
+ * Bluetooth RX thread that runs the discovery callbacks.
+ */
+static K_WORK_DEFINE(cache_work, cache_work_handler);
+
+static void key_build(char *key, const bt_addr_le_t *peer)
+{
+	const uint8_t *a = peer->a.val;
+
+	snprintk(key, SETTINGS_KEY_LEN,
+		 SETTINGS_SUBTREE "/%02x%02x%02x%02x%02x%02x%u",
+		 a[5], a[4], a[3], a[2], a[1], a[0], peer->type);
+}
+
+static uint16_t walk_end_get(void)
+{
+	return sys_get_le16(&record.data[WALK_END_POS]);
+}
+
+static bool is_svc_decl(const struct bt_uuid *uuid)
+{
+	return !bt_uuid_cmp(uuid, BT_UUID_GATT_PRIMARY) ||
+	       !bt_uuid_cmp(uuid, BT_UUID_GATT_SECONDARY);
+}
+
+static size_t uuid_encoded_len(const struct bt_uuid *uuid)
+{
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		return 1 + BT_UUID_SIZE_16;
+	case BT_UUID_TYPE_32:
+		return 1 + BT_UUID_SIZE_32;
+	case BT_UUID_TYPE_128:
+		return 1 + BT_UUID_SIZE_128;
+	default:
+		return 0;
+	}
+}
+
+static void uuid_encode(struct net_buf_simple *buf, const struct bt_uuid *uuid)
+{
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		net_buf_simple_add_u8(buf, BT_UUID_SIZE_16);
+		net_buf_simple_add_le16(buf, BT_UUID_16(uuid)->val);
+		break;
+	case BT_UUID_TYPE_32:
+		net_buf_simple_add_u8(buf, BT_UUID_SIZE_32);
+		net_buf_simple_add_le32(buf, BT_UUID_32(uuid)->val);
+		break;
+	case BT_UUID_TYPE_128:
+		net_buf_simple_add_u8(buf, BT_UUID_SIZE_128);
+		net_buf_simple_add_mem(buf, BT_UUID_128(uuid)->val,
+				       BT_UUID_SIZE_128);
+		break;
+	}
+}
+
+static int uuid_decode(struct net_buf_simple *buf,
+		       union gatt_dm_cache_uuid *uuid)
+{
+	uint8_t len;
+
+	if (buf->len < 1) {
+		return -EINVAL;
+	}
+
+	len = net_buf_simple_pull_u8(buf);
+	if (buf->len < len ||
+	    !bt_uuid_create(&uuid->uuid, net_buf_simple_pull_mem(buf, len),
+			    len)) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* Returns the encoded length of an attribute, or 0 if it cannot be cached */
+static size_t attr_encoded_len(const struct bt_gatt_dm_attr *attr)
+{
+	const struct bt_gatt_service_val *svc_val;
+	const struct bt_gatt_chrc *chrc_val;
+	size_t type_len = uuid_encoded_len(attr->uuid);
+	size_t value_len = 0;
+
+	if (!type_len) {
+		return 0;
+	}
+
+	svc_val = bt_gatt_dm_attr_service_val(attr);
+	chrc_val = bt_gatt_dm_attr_chrc_val(attr);
+
+	if (svc_val) {
+		value_len = uuid_encoded_len(svc_val->uuid);
+		if (!value_len) {
+			return 0;
+		}
+	} else if (chrc_val) {
+		value_len = uuid_encoded_len(chrc_val->uuid);
+		if (!value_len) {
+			return 0;
+		}
+		value_len += sizeof(uint8_t) + sizeof(uint16_t);
+	}
+
+	return sizeof(uint16_t) + sizeof(uint8_t) + type_len + value_len;
+}
+
+static void attr_encode(struct net_buf_simple *buf,
+			const struct bt_gatt_dm_attr *attr)
+{
+	const struct bt_gatt_service_val *svc_val;
+	const struct bt_gatt_chrc *chrc_val;
+
+	net_buf_simple_add_le16(buf, attr->handle);
+	net_buf_simple_add_u8(buf, attr->perm);
+	uuid_encode(buf, attr->uuid);
+
+	svc_val = bt_gatt_dm_attr_service_val(attr);
+	chrc_val = bt_gatt_dm_attr_chrc_val(attr);
+
+	if (svc_val) {
+		uuid_encode(buf, svc_val->uuid);
+	} else if (chrc_val) {
+		uuid_encode(buf, chrc_val->uuid);
+		net_buf_simple_add_u8(buf, chrc_val->properties);
+		net_buf_simple_add_le16(buf, chrc_val->value_handle);
+	}
+}
+
+static struct cache_svc_hdr *svc_next(struct cache_svc_hdr *prev)
+{
+	uint8_t *next;
+
+	if (prev) {
+		next = (uint8_t *)(prev + 1) + sys_le16_to_cpu(prev->len);
+	} else {
+		next = record.data + RECORD_HDR_LEN;
+	}
+
+	if (next + sizeof(*prev) > record.data + record.len) {
+		return NULL;
+	}
+
+	return (struct cache_svc_hdr *)next;
+}
+
+static void svc_attrs_get(struct cache_svc_hdr *hdr,
+			  struct gatt_dm_cache_svc *svc)
+{
+	svc->end_handle = sys_le16_to_cpu(hdr->end);
+	net_buf_simple_init_with_data(&svc->attrs, hdr + 1,
+				      sys_le16_to_cpu(hdr->len));
+}
+
+/* Checks that a loaded record can be decoded */
+static bool record_check(void)
+{
+	struct cache_svc_hdr *hdr = NULL;
+	struct gatt_dm_cache_svc svc;
+	struct gatt_dm_cache_attr attr;
+	uint8_t *end = record.data + RECORD_HDR_LEN;
+
+	while ((hdr = svc_next(hdr)) != NULL) {
+		end = (uint8_t *)(hdr + 1) + sys_le16_to_cpu(hdr->len);
+		if (end > record.data + record.len) {
+			return false;
+		}
+
+		svc_attrs_get(hdr, &svc);
+		for (size_t i = 0; i < hdr->attr_cnt; i++) {
+			if (gatt_dm_cache_attr_get(&svc, &attr)) {
+				return false;
+			}
+		}
+
+		if (svc.attrs.len) {
+			return false;
+		}
+	}
+
+	return end == record.data + record.len;
+}
+
+static void record_reset(const uint8_t *db_hash)
+{
+	net_buf_simple_reset(&record);
+	net_buf_simple_add_mem(&record, db_hash, GATT_DM_CACHE_HASH_LEN);
+	net_buf_simple_add_le16(&record, 0x0000);
+}
+
+/* Must be called with cache_lock held */
+static int record_save(void)
+{
+	int err;
+
+	cache.dirty = false;
+
+	err = settings_save_one(cache.key, record.data, record.len);
+	if (err) {
+		LOG_WRN("Cannot save the cached database: %d", err);
+	}
+
+	return err;
+}
+
+/* Must be called with cache_lock held */
+static void record_save_defer(void)
+{
+	cache.dirty = true;
+	k_work_submit(&cache_work);
+}
+
+static bool is_bonded(const bt_addr_le_t *peer)
+{
+	for (uint8_t id = 0; id < CONFIG_BT_ID_MAX; id++) {
+		if (bt_addr_le_is_bonded(id, peer)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Parses the settings key of a record, relative to the subtree */
+static int key_parse(const char *key, bt_addr_le_t *peer)
+{
+	uint8_t a[sizeof(peer->a.val)];
+
+	if (settings_name_next(key, NULL) != 2 * sizeof(a) + 1 ||
+	    hex2bin(key, 2 * sizeof(a), a, sizeof(a)) != sizeof(a) ||
+	    key[2 * sizeof(a)] < '0' || key[2 * sizeof(a)] > '9') {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < sizeof(a); i++) {
+		peer->a.val[i] = a[sizeof(a) - 1 - i];
+	}
+
+	peer->type = key[2 * sizeof(a)] - '0';
+
+	return 0;
+}
+
+static int record_purge_find(const char *key, size_t len,
+			     settings_read_cb read_cb, void *cb_arg,
+			     void *param)
+{
+	struct purge_batch *batch = param;
+	bt_addr_le_t peer;
+
+	if (batch->cnt == ARRAY_SIZE(batch->peers)) {
+		return 0;
+	}
+
+	if (!key_parse(key, &peer) && !is_bonded(&peer)) {
+		bt_addr_le_copy(&batch->peers[batch->cnt++], &peer);
+	}
+
+	return 0;
+}
+
+/* Deletes the records of the peers that are no longer bonded. The records
+ * are deleted after each settings pass, not while the settings are loaded.
+ */
+static void records_purge(void)
+{
+	struct purge_batch batch;
+	char key[SETTINGS_KEY_LEN];
+	int err;
+
+	do {
+		batch.cnt = 0;
+
+		err = settings_load_subtree_direct(SETTINGS_SUBTREE,
+						   record_purge_find, &batch);
+		if (err) {
+			LOG_WRN("Cannot load the cached databases: %d", err);
+			return;
+		}
+
+		for (size_t i = 0; i < batch.cnt; i++) {
+			LOG_DBG("Deleting the cached database of a removed "
+				"bond");
+
+			k_mutex_lock(&cache_lock, K_FOREVER);
+
+			if (cache.open &&
+			    !bt_addr_le_cmp(&batch.peers[i], &cache.peer)) {
+				cache.open = false;
+				cache.dirty = false;
+			}
+
+			k_mutex_unlock(&cache_lock);
+
+			key_build(key, &batch.peers[i]);
+			err = settings_delete(key);
+			if (err) {
+				LOG_WRN("Cannot delete the cached database: %d",
+					err);
+				return;
+			}
+		}
+	} while (batch.cnt == ARRAY_SIZE(batch.peers));
+}
+
+static void cache_work_handler(struct k_work *work)
+{
+	bool purge;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (cache.dirty) {
+		(void)record_save();
+	}
+
+	purge = cache.purge;
+	cache.purge = false;
+
+	k_mutex_unlock(&cache_lock);
+
+	if (purge) {
+		records_purge();
+	}
+}
+
+static int record_load(const char *key, size_t len, settings_read_cb read_cb,
+		       void *cb_arg, void *param)
+{
+	const char *next;
+	ssize_t rc;
+
+	/* Only the exact key */
+	if (settings_name_next(key, &next)) {
+		return 0;
+	}
+
+	net_buf_simple_reset(&record);
+
+	if (len > net_buf_simple_tailroom(&record)) {
+		LOG_WRN("Cached database too large: %zu", len);
+		return 0;
+	}
+
+	rc = read_cb(cb_arg, record.data, len);
+	if (rc < 0) {
+		LOG_WRN("Cannot read the cached database: %zd", rc);
+		return 0;
+	}
+
+	record.len = rc;
+
+	return 0;
+}
+
+int gatt_dm_cache_open(const bt_addr_le_t *peer, const uint8_t *db_hash)
+{
+	int err;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (cache.open && !bt_addr_le_cmp(peer, &cache.peer) &&
+	    !memcmp(record.data, db_hash, GATT_DM_CACHE_HASH_LEN)) {
+		k_mutex_unlock(&cache_lock);
+		return 0;
+	}
+
+	/* The record of another peer is replaced */
+	if (cache.dirty) {
+		(void)record_save();
+	}
+
+	cache.open = false;
+	key_build(cache.key, peer);
+	net_buf_simple_reset(&record);
+
+	err = settings_load_subtree_direct(cache.key, record_load, NULL);
+	if (err) {
+		LOG_WRN("Cannot load the cached database: %d", err);
+		net_buf_simple_reset(&record);
+	}
+
+	if (record.len < RECORD_HDR_LEN ||
+	    memcmp(record.data, db_hash, GATT_DM_CACHE_HASH_LEN) ||
+	    !record_check()) {
+		if (record.len) {
+			LOG_DBG("Cached database outdated");
+		}
+		record_reset(db_hash);
+	}
+
+	bt_addr_le_copy(&cache.peer, peer);
+	cache.open = true;
+
+	/* Bonds may have been removed since the records were stored */
+	cache.purge = true;
+	k_work_submit(&cache_work);
+
+	k_mutex_unlock(&cache_lock);
+
+	return 0;
+}
+
+int gatt_dm_cache_find(const struct bt_uuid *uuid, uint16_t start_handle,
+		       struct gatt_dm_cache_svc *svc)
+{
+	struct cache_svc_hdr *hdr = NULL;
+	struct cache_svc_hdr *found = NULL;
+	struct gatt_dm_cache_svc decl;
+	struct gatt_dm_cache_attr attr;
+	uint16_t walk_end;
+
+	if (!cache.open) {
+		return -ENODATA;
+	}
+
+	walk_end = walk_end_get();
+
+	while ((hdr = svc_next(hdr)) != NULL) {
+		uint16_t start = sys_le16_to_cpu(hdr->start);
+
+		if (found && start > sys_le16_to_cpu(found->start)) {
+			continue;
+		}
+
+		if (uuid) {
+			/* Services are cached either as the first one with
+			 * their UUID, or inside the walk, which then also
+			 * holds all services before them.
+			 */
+			svc_attrs_get(hdr, &decl);
+			if (gatt_dm_cache_attr_get(&decl, &attr) ||
+			    bt_uuid_cmp(uuid, attr.value.svc.uuid)) {
+				continue;
+			}
+		} else if (start < start_handle || start > walk_end) {
+			continue;
+		}
+
+		found = hdr;
+	}
+
+	if (!found) {
+		return (walk_end == 0xffff) ? -ENOENT : -ENODATA;
+	}
+
+	svc_attrs_get(found, svc);
+
+	return 0;
+}
+
+int gatt_dm_cache_attr_get(struct gatt_dm_cache_svc *svc,
+			   struct gatt_dm_cache_attr *attr)
+{
+	struct net_buf_simple *buf = &svc->attrs;
+
+	if (!buf->len) {
+		return -ENOENT;
+	}
+
+	memset(attr, 0, sizeof(*attr));
+
+	if (buf->len < sizeof(uint16_t) + sizeof(uint8_t)) {
+		return -EINVAL;
+	}
+
+	attr->attr.handle = net_buf_simple_pull_le16(buf);
+	attr->attr.perm = net_buf_simple_pull_u8(buf);
+	attr->attr.uuid = &attr->type.uuid;
+
+	if (uuid_decode(buf, &attr->type)) {
+		return -EINVAL;
+	}
+
+	if (is_svc_decl(attr->attr.uuid)) {
+		if (uuid_decode(buf, &attr->value_uuid)) {
+			return -EINVAL;
+		}
+
+		attr->value.svc.uuid = &attr->value_uuid.uuid;
+		attr->value.svc.end_handle = svc->end_handle;
+		attr->attr.user_data = &attr->value.svc;
+	} else if (!bt_uuid_cmp(attr->attr.uuid, BT_UUID_GATT_CHRC)) {
+		if (uuid_decode(buf, &attr->value_uuid) ||
+		    buf->len < sizeof(uint8_t) + sizeof(uint16_t)) {
+			return -EINVAL;
+		}
+
+		attr->value.chrc.uuid = &attr->value_uuid.uuid;
+		attr->value.chrc.properties = net_buf_simple_pull_u8(buf);
+		attr->value.chrc.value_handle = net_buf_simple_pull_le16(buf);
+		attr->attr.user_data = &attr->value.chrc;
+	}
+
+	return 0;
+}
+
+/* Must be called with cache_lock held */
+static int record_store(const struct bt_uuid *uuid, uint16_t start_handle,
+			const struct bt_gatt_service_val *svc_val,
+			const struct bt_gatt_dm_attr *attrs, size_t attr_cnt)
+{
+	struct cache_svc_hdr *hdr = NULL;
+	uint16_t walk_end;
+	bool walk;
+
+	walk_end = walk_end_get();
+	walk = !uuid && (start_handle == walk_end + 1);
+
+	if (!uuid && !walk) {
+		/* It could not be found in the cache */
+		return 0;
+	}
+
+	while ((hdr = svc_next(hdr)) != NULL) {
+		if (sys_le16_to_cpu(hdr->start) == attrs[0].handle) {
+			break;
+		}
+	}
+
+	if (!hdr) {
+		size_t len = 0;
+
+		for (size_t i = 0; i < attr_cnt; i++) {
+			size_t attr_len = attr_encoded_len(&attrs[i]);
+
+			if (!attr_len ||
+			    (i > 0 && bt_gatt_dm_attr_service_val(&attrs[i]))) {
+				return -EINVAL;
+			}
+
+			len += attr_len;
+		}
+
+		if (net_buf_simple_tailroom(&record) < sizeof(*hdr) + len) {
+			LOG_WRN("No space to cache the service at handle %u",
+				attrs[0].handle);
+			return -ENOMEM;
+		}
+
+		hdr = net_buf_simple_add(&record, sizeof(*hdr));
+		hdr->start = sys_cpu_to_le16(attrs[0].handle);
+		hdr->end = sys_cpu_to_le16(svc_val->end_handle);
+		hdr->attr_cnt = attr_cnt;
+		hdr->len = sys_cpu_to_le16(len);
+
+		for (size_t i = 0; i < attr_cnt; i++) {
+			attr_encode(&record, &attrs[i]);
+		}
+	}
+
+	if (walk) {
+		sys_put_le16(svc_val->end_handle, &record.data[WALK_END_POS]);
+	}
+
+	record_save_defer();
+
+	return 0;
+}
+
+int gatt_dm_cache_store(const struct bt_uuid *uuid, uint16_t start_handle,
+			const struct bt_gatt_dm_attr *attrs, size_t attr_cnt)
+{
+	const struct bt_gatt_service_val *svc_val;
+	int err;
+
+	if (!attr_cnt || attr_cnt > UINT8_MAX) {
+		return -EINVAL;
+	}
+
+	svc_val = bt_gatt_dm_attr_service_val(&attrs[0]);
+	if (!svc_val) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	err = cache.open ? record_store(uuid, start_handle, svc_val, attrs,
+					attr_cnt) : -EINVAL;
+	k_mutex_unlock(&cache_lock);
+
+	return err;
+}
+
+void gatt_dm_cache_not_found(const struct bt_uuid *uuid,
+			     uint16_t start_handle)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (cache.open && !uuid && start_handle == walk_end_get() + 1) {
+		sys_put_le16(0xffff, &record.data[WALK_END_POS]);
+		record_save_defer();
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
+
+int bt_gatt_dm_cache_clear(const bt_addr_le_t *peer)
+{
+	char key[SETTINGS_KEY_LEN];
+
+	if (!peer) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	/* A pending save must not restore the record */
+	if (cache.open && !bt_addr_le_cmp(peer, &cache.peer)) {
+		cache.open = false;
+		cache.dirty = false;
+	}
+
+	k_mutex_unlock(&cache_lock);
+
+	key_build(key, peer);
+
+	return settings_delete(key);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BT_GATT_DM_CACHE_H_
+#define BT_GATT_DM_CACHE_H_
+
+#include <net/buf.h>
+#include <bluetooth/addr.h>
+#include <bluetooth/gatt_dm.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Length of the Database Hash characteristic value */
+#define GATT_DM_CACHE_HASH_LEN 16
+
+/* Storage for any type of UUID */
+union gatt_dm_cache_uuid {
+	struct bt_uuid uuid;
+	struct bt_uuid_16 u16;
+	struct bt_uuid_32 u32;
+	struct bt_uuid_128 u128;
+};
+
+/* Cached service found by gatt_dm_cache_find() */
+struct gatt_dm_cache_svc {
+	/* Last handle of the service */
+	uint16_t end_handle;
+	/* Encoded attributes that are not read yet */
+	struct net_buf_simple attrs;
+};
+
+/* Attribute read from a cached service. The attribute points to the other
+ * members of this structure, as the attributes passed to
+ * bt_gatt_discover_func_t do.
+ */
+struct gatt_dm_cache_attr {
+	struct bt_gatt_attr attr;
+	union gatt_dm_cache_uuid type;
+	union gatt_dm_cache_uuid value_uuid;
+	union {
+		struct bt_gatt_service_val svc;
+		struct bt_gatt_chrc chrc;
+	} value;
+};
+
+/* Open the cache record of a peer with the given Database Hash. The record
+ * is loaded from settings. A stored record with another hash is discarded.
+ * The records of peers that are no longer bonded are deleted from the system
+ * workqueue.
+ */
+int gatt_dm_cache_open(const bt_addr_le_t *peer, const uint8_t *db_hash);
+
+/* Find the first primary service with the given UUID, or the first primary
+ * service starting at or after start_handle if uuid is NULL.
+ *
+ * Returns 0 if the service is cached, -ENOENT if it is known that there is
+ * no such service, and -ENODATA if it must be discovered from the peer.
+ */
+int gatt_dm_cache_find(const struct bt_uuid *uuid, uint16_t start_handle,
+		       struct gatt_dm_cache_svc *svc);
+
+/* Read the next attribute of a service found by gatt_dm_cache_find(),
+ * starting with the service declaration. Returns -ENOENT after the last
+ * attribute.
+ */
+int gatt_dm_cache_attr_get(struct gatt_dm_cache_svc *svc,
+			   struct gatt_dm_cache_attr *attr);
+
+/* Store a service discovered from the peer with the given search UUID and
+ * start handle. The first attribute must be the service declaration.
+ * The record is saved to settings from the system workqueue.
+ */
+int gatt_dm_cache_store(const struct bt_uuid *uuid, uint16_t start_handle,
+			const struct bt_gatt_dm_attr *attrs, size_t attr_cnt);
+
+/* Record that the peer has no primary service for the given search UUID and
+ * start handle.
+ */
+void gatt_dm_cache_not_found(const struct bt_uuid *uuid,
+			     uint16_t start_handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BT_GATT_DM_CACHE_H_ */
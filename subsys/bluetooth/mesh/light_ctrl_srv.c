@@ -314,11 +314,6 @@ static uint16_t light_get(struct bt_mesh_light_ctrl_srv *srv)
 
 #if CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG
 
-static float sensor_to_float(struct sensor_value *val)
-{
-	return val->val1 + val->val2 / 1000000.0f;
-}
-
 static void lux_get(struct bt_mesh_light_ctrl_srv *srv,
 		    struct sensor_value *lux)
 {
@@ -341,6 +336,110 @@ static void lux_get(struct bt_mesh_light_ctrl_srv *srv,
 	from_centi_lux(centi_lux, lux);
 }
 
+#if CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG_FIXED
+
+/* The fixed-point coefficients are in 2^-24 light levels per centilux: */
+#define REG_K_SHIFT 24
+/* Number of fractional bits in the integral sum: */
+#define REG_I_SHIFT 8
+/* Upper bound of the regulator coefficient properties: */
+#define REG_K_MAX 1000.0f
+
+static int32_t reg_coeff(float k, float scale)
+{
+	return CLAMP(k, 0.0f, REG_K_MAX) * scale;
+}
+
+static void reg_coeff_update(struct bt_mesh_light_ctrl_srv *srv)
+{
+	/* The integral coefficients are applied once per step, so the step
+	 * interval is included in their scale:
+	 */
+	const float kp_scale = BIT(REG_K_SHIFT) / 100.0f;
+	const float ki_scale = (kp_scale * REG_INT) / MSEC_PER_SEC;
+
+	srv->reg.k.kiu = reg_coeff(srv->reg.cfg.kiu, ki_scale);
+	srv->reg.k.kid = reg_coeff(srv->reg.cfg.kid, ki_scale);
+	srv->reg.k.kpu = reg_coeff(srv->reg.cfg.kpu, kp_scale);
+	srv->reg.k.kpd = reg_coeff(srv->reg.cfg.kpd, kp_scale);
+}
+
+static uint32_t lux_get_centi(struct bt_mesh_light_ctrl_srv *srv)
+{
+	if (!is_enabled(srv)) {
+		return 0;
+	}
+
+	uint32_t end = to_centi_lux(&srv->reg.cfg.lux[srv->state]);
+
+	if (!atomic_test_bit(&srv->flags, FLAG_TRANSITION) ||
+	    !srv->fade.duration) {
+		return end;
+	}
+
+	uint32_t init = to_centi_lux(&srv->fade.initial_lux);
+
+	/* The fade is linear, so the slope only has to be recomputed when
+	 * the fade parameters change:
+	 */
+	if (init != srv->reg.fade.init || end != srv->reg.fade.end ||
+	    srv->fade.duration != srv->reg.fade.duration) {
+		srv->reg.fade.init = init;
+		srv->reg.fade.end = end;
+		srv->reg.fade.duration = srv->fade.duration;
+		srv->reg.fade.slope = (((int64_t)end - init) << 16) /
+				      srv->fade.duration;
+	}
+
+	return init + ((srv->reg.fade.slope * curr_fade_time(srv)) >> 16);
+}
+
+static uint16_t reg_update(struct bt_mesh_light_ctrl_srv *srv)
+{
+	uint32_t target = lux_get_centi(srv);
+	int32_t error = target - to_centi_lux(&srv->ambient_lux);
+
+	/* Accuracy should be in percent and both up and down: */
+	int32_t accuracy = (srv->reg.cfg.accuracy * target) / (2 * 100);
+
+	int32_t input;
+	if (error > accuracy) {
+		input = error - accuracy;
+	} else if (error < -accuracy) {
+		input = error + accuracy;
+	} else {
+		input = 0;
+	}
+
+	int32_t kp, ki;
+	if (input >= 0) {
+		kp = srv->reg.k.kpu;
+		ki = srv->reg.k.kiu;
+	} else {
+		kp = srv->reg.k.kpd;
+		ki = srv->reg.k.kid;
+	}
+
+	int64_t i = srv->reg.i +
+		    (((int64_t)input * ki) >> (REG_K_SHIFT - REG_I_SHIFT));
+	srv->reg.i = CLAMP(i, 0, (int64_t)UINT16_MAX << REG_I_SHIFT);
+
+	int64_t p = ((int64_t)input * kp) >> (REG_K_SHIFT - REG_I_SHIFT);
+
+	return CLAMP((srv->reg.i + p) >> REG_I_SHIFT, 0, UINT16_MAX);
+}
+
+#else
+
+static void reg_coeff_update(struct bt_mesh_light_ctrl_srv *srv)
+{
+}
+
+static float sensor_to_float(struct sensor_value *val)
+{
+	return val->val1 + val->val2 / 1000000.0f;
+}
+
 static float lux_getf(struct bt_mesh_light_ctrl_srv *srv)
 {
 	if (!is_enabled(srv)) {
@@ -359,6 +458,43 @@ static float lux_getf(struct bt_mesh_light_ctrl_srv *srv)
 	return to_centi_lux(&srv->reg.cfg.lux[srv->state]) / 100.0f;
 }
 
+static uint16_t reg_update(struct bt_mesh_light_ctrl_srv *srv)
+{
+	float target = lux_getf(srv);
+	float ambient = sensor_to_float(&srv->ambient_lux);
+	float error = target - ambient;
+
+	/* Accuracy should be in percent and both up and down: */
+	float accuracy = (srv->reg.cfg.accuracy * target) / (2 * 100.0f);
+
+	float input;
+	if (error > accuracy) {
+		input = error - accuracy;
+	} else if (error < -accuracy) {
+		input = error + accuracy;
+	} else {
+		input = 0.0f;
+	}
+
+	float kp, ki;
+	if (input >= 0) {
+		kp = srv->reg.cfg.kpu;
+		ki = srv->reg.cfg.kiu;
+	} else {
+		kp = srv->reg.cfg.kpd;
+		ki = srv->reg.cfg.kid;
+	}
+
+	srv->reg.i += (input * ki) * ((float)REG_INT / (float)MSEC_PER_SEC);
+	srv->reg.i = CLAMP(srv->reg.i, 0, UINT16_MAX);
+
+	float p = input * kp;
+
+	return CLAMP(srv->reg.i + p, 0, UINT16_MAX);
+}
+
+#endif
+
 #else
 
 static void lux_get(struct bt_mesh_light_ctrl_srv *srv,
@@ -527,36 +663,7 @@ static void reg_step(struct k_work *work)
 
 	k_work_reschedule(&srv->reg.timer, K_MSEC(REG_INT));
 
-	float target = lux_getf(srv);
-	float ambient = sensor_to_float(&srv->ambient_lux);
-	float error = target - ambient;
-
-	/* Accuracy should be in percent and both up and down: */
-	float accuracy = (srv->reg.cfg.accuracy * target) / (2 * 100.0f);
-
-	float input;
-	if (error > accuracy) {
-		input = error - accuracy;
-	} else if (error < -accuracy) {
-		input = error + accuracy;
-	} else {
-		input = 0.0f;
-	}
-
-	float kp, ki;
-	if (input >= 0) {
-		kp = srv->reg.cfg.kpu;
-		ki = srv->reg.cfg.kiu;
-	} else {
-		kp = srv->reg.cfg.kpd;
-		ki = srv->reg.cfg.kid;
-	}
-
-	srv->reg.i += (input * ki) * ((float)REG_INT / (float)MSEC_PER_SEC);
-	srv->reg.i = CLAMP(srv->reg.i, 0, UINT16_MAX);
-
-	float p = input * kp;
-	uint16_t output = CLAMP(srv->reg.i + p, 0, UINT16_MAX);
+	uint16_t output = reg_update(srv);
 
 	/* The regulator output is always in linear format. We'll convert to
 	 * the configured representation again before calling the Lightness
@@ -574,6 +681,10 @@ static void reg_step(struct k_work *work)
 		atomic_set_bit(&srv->flags, FLAG_REGULATOR);
 		light_set(srv, light_to_repr(output, LINEAR), 0);
 	} else if (atomic_test_and_clear_bit(&srv->flags, FLAG_REGULATOR)) {
+		/* Forget the previous output, so the regulator takes over
+		 * again even if its next output is the same:
+		 */
+		srv->reg.prev = lvl;
 		light_set(srv, light_to_repr(lvl, LINEAR), 0);
 	}
 }
@@ -1185,26 +1296,27 @@ static int prop_set(struct net_buf_simple *buf,
 	/* Regulator coefficients are raw IEEE-754 floats, pull them straight
 	 * from the buffer instead of using sensor to decode them:
 	 */
+	float *coeff = NULL;
+
 	switch (id) {
 	case BT_MESH_LIGHT_CTRL_COEFF_KID:
-		memcpy(&srv->reg.cfg.kid,
-		       net_buf_simple_pull_mem(buf, sizeof(float)),
-		       sizeof(float));
-		return 0;
+		coeff = &srv->reg.cfg.kid;
+		break;
 	case BT_MESH_LIGHT_CTRL_COEFF_KIU:
-		memcpy(&srv->reg.cfg.kiu,
-		       net_buf_simple_pull_mem(buf, sizeof(float)),
-		       sizeof(float));
-		return 0;
+		coeff = &srv->reg.cfg.kiu;
+		break;
 	case BT_MESH_LIGHT_CTRL_COEFF_KPD:
-		memcpy(&srv->reg.cfg.kpd,
-		       net_buf_simple_pull_mem(buf, sizeof(float)),
-		       sizeof(float));
-		return 0;
+		coeff = &srv->reg.cfg.kpd;
+		break;
 	case BT_MESH_LIGHT_CTRL_COEFF_KPU:
-		memcpy(&srv->reg.cfg.kpu,
-		       net_buf_simple_pull_mem(buf, sizeof(float)),
+		coeff = &srv->reg.cfg.kpu;
+		break;
+	}
+
+	if (coeff) {
+		memcpy(coeff, net_buf_simple_pull_mem(buf, sizeof(float)),
 		       sizeof(float));
+		reg_coeff_update(srv);
 		return 0;
 	}
 #endif
@@ -1454,6 +1566,7 @@ static void scene_recall(struct bt_mesh_model *model, const uint8_t data[],
 	srv->cfg = scene->cfg;
 #if CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG
 	srv->reg.cfg = scene->reg;
+	reg_coeff_update(srv);
 #endif
 	if (scene->enabled) {
 		ctrl_enable(srv);
@@ -1520,6 +1633,7 @@ static int light_ctrl_srv_init(struct bt_mesh_model *model)
 
 #if CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG
 	k_work_init_delayable(&srv->reg.timer, reg_step);
+	reg_coeff_update(srv);
 #endif
 
 	srv->pub.msg = &srv->pub_buf;
@@ -1702,6 +1816,7 @@ static int lc_setup_srv_settings_set(struct bt_mesh_model *model,
 
 #if CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG
 	srv->reg.cfg = data.reg_cfg;
+	reg_coeff_update(srv);
 #endif
 
 	return 0;
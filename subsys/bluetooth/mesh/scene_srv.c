@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <bluetooth/mesh/models.h>
 #include <sys/byteorder.h>
 #include "model_utils.h"
@@ -27,6 +28,14 @@ struct __packed scene_data {
 	uint8_t data[];
 };
 
+/* Stored page of scene data in a scene cache entry */
+struct __packed scene_cache_page {
+	uint8_t vnd;
+	uint8_t page;
+	uint16_t len;
+	uint8_t data[];
+};
+
 static sys_slist_t scene_servers;
 
 static char *scene_path(char *buf, uint16_t scene, bool vnd, uint8_t page)
@@ -276,41 +285,48 @@ static uint16_t *scene_find(struct bt_mesh_scene_srv *srv, uint16_t scene)
 	return NULL;
 }
 
-static void entry_recover(struct bt_mesh_scene_srv *srv, bool vnd,
-			  const struct scene_data *data)
+static const struct bt_mesh_scene_srv_mod *
+mod_find(const struct bt_mesh_scene_srv *srv, bool vnd,
+	 const struct scene_data *data)
 {
-	const struct bt_mesh_elem *elem = &bt_mesh_comp_get()->elem[data->elem_idx];
-	const size_t overhead = vnd ? VND_MODEL_SCENE_DATA_OVERHEAD : 0;
-	const struct bt_mesh_scene_entry *entry;
-	struct bt_mesh_model *mod;
+	int start = vnd ? srv->sigmods : 0;
+	int end = start + (vnd ? srv->vndmods : srv->sigmods);
 
-	if (vnd) {
-		mod = bt_mesh_model_find_vnd(elem, sys_get_le16(data->data), data->id);
-	} else {
-		mod = bt_mesh_model_find(elem, data->id);
-	}
+	for (int i = start; i < end; i++) {
+		const struct bt_mesh_model *mod = srv->mods[i].mod;
 
-	if (!mod) {
-		BT_WARN("No model @%s", bt_hex(&data->elem_idx, vnd ? 5 : 3));
-		return;
-	}
+		if (mod->elem_idx != data->elem_idx) {
+			continue;
+		}
 
-	/* MeshMDL1.0.1, section 5.1.3.1.1:
-	 * If a model is extending another model, the extending model shall determine
-	 * the Stored with Scene behavior of that model.
-	 */
-	if (bt_mesh_model_is_extended(mod)) {
-		return;
+		if (vnd ? (mod->vnd.id == data->id &&
+			   mod->vnd.company == sys_get_le16(data->data)) :
+			  mod->id == data->id) {
+			return &srv->mods[i];
+		}
 	}
 
-	entry = entry_find(mod, vnd);
-	if (!entry) {
-		BT_WARN("No scene entry for %s", bt_hex(&data->elem_idx, vnd ? 5 : 3));
+	return NULL;
+}
+
+static void entry_recover(struct bt_mesh_scene_srv *srv, bool vnd,
+			  const struct scene_data *data)
+{
+	const size_t overhead = vnd ? VND_MODEL_SCENE_DATA_OVERHEAD : 0;
+	const struct bt_mesh_scene_srv_mod *mod;
+
+	/* Models that are extended by other models, and models without scene
+	 * entries aren't in the model list.
+	 */
+	mod = mod_find(srv, vnd, data);
+	if (!mod) {
+		BT_WARN("No scene entry for %s",
+			bt_hex(&data->elem_idx, vnd ? 5 : 3));
 		return;
 	}
 
-	entry->recall(mod, &data->data[overhead], data->len - overhead,
-		      &srv->transition);
+	mod->entry->recall(mod->mod, &data->data[overhead],
+			   data->len - overhead, &srv->transition);
 }
 
 static void page_recover(struct bt_mesh_scene_srv *srv, bool vnd,
@@ -364,12 +380,128 @@ static ssize_t entry_store(struct bt_mesh_model *mod,
 	return sizeof(struct scene_data) + data->len;
 }
 
+static struct bt_mesh_scene_srv_cache *cache_get(struct bt_mesh_scene_srv *srv,
+					       uint16_t scene)
+{
+	for (int i = 0; i < ARRAY_SIZE(srv->cache); i++) {
+		if (srv->cache[i].scene == scene) {
+			srv->cache[i].used = ++srv->cache_seq;
+			return &srv->cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+/** Get an empty cache entry for the given scene, evicting the least recently
+ *  used scene if needed.
+ */
+static struct bt_mesh_scene_srv_cache *
+cache_alloc(struct bt_mesh_scene_srv *srv, uint16_t scene)
+{
+	struct bt_mesh_scene_srv_cache *cache = NULL;
+
+	for (int i = 0; i < ARRAY_SIZE(srv->cache); i++) {
+		if (srv->cache[i].scene == scene) {
+			cache = &srv->cache[i];
+			break;
+		}
+
+		if (!cache || srv->cache[i].scene == BT_MESH_SCENE_NONE ||
+		    (cache->scene != BT_MESH_SCENE_NONE &&
+		     srv->cache[i].used < cache->used)) {
+			cache = &srv->cache[i];
+		}
+	}
+
+	if (cache) {
+		cache->scene = scene;
+		cache->len = 0;
+		cache->used = ++srv->cache_seq;
+	}
+
+	return cache;
+}
+
+static void cache_drop(struct bt_mesh_scene_srv *srv, uint16_t scene)
+{
+	for (int i = 0; i < ARRAY_SIZE(srv->cache); i++) {
+		if (srv->cache[i].scene == scene) {
+			srv->cache[i].scene = BT_MESH_SCENE_NONE;
+		}
+	}
+}
+
+static struct scene_cache_page *
+cache_page_find(struct bt_mesh_scene_srv_cache *cache, bool vnd, uint8_t page)
+{
+	for (struct scene_cache_page *it = (void *)&cache->data[0];
+	     it < (struct scene_cache_page *)&cache->data[cache->len];
+	     it = (struct scene_cache_page *)&it->data[it->len]) {
+		if (it->vnd == vnd && it->page == page) {
+			return it;
+		}
+	}
+
+	return NULL;
+}
+
+/** @brief Update a page of a cached scene.
+ *
+ *  If the page doesn't fit in the cache entry, the entry is dropped.
+ *
+ *  @param cache Cache entry, or NULL.
+ *  @param vnd   Whether the page holds vendor model data.
+ *  @param page  Page number.
+ *  @param buf   Page data.
+ *  @param len   Length of the page data.
+ *
+ *  @return Whether the cache entry already held the same page data.
+ */
+static bool cache_page_update(struct bt_mesh_scene_srv_cache *cache, bool vnd,
+			      uint8_t page, const uint8_t buf[], size_t len)
+{
+	struct scene_cache_page *it;
+
+	if (!cache || cache->scene == BT_MESH_SCENE_NONE) {
+		return false;
+	}
+
+	it = cache_page_find(cache, vnd, page);
+	if (it) {
+		uint8_t *next = &it->data[it->len];
+
+		if (it->len == len && !memcmp(it->data, buf, len)) {
+			return true;
+		}
+
+		memmove(it, next, &cache->data[cache->len] - next);
+		cache->len -= next - (uint8_t *)it;
+	}
+
+	if (cache->len + sizeof(*it) + len > sizeof(cache->data)) {
+		BT_DBG("Scene 0x%x doesn't fit in the cache", cache->scene);
+		cache->scene = BT_MESH_SCENE_NONE;
+		return false;
+	}
+
+	it = (struct scene_cache_page *)&cache->data[cache->len];
+	it->vnd = vnd;
+	it->page = page;
+	it->len = len;
+	memcpy(it->data, buf, len);
+	cache->len += sizeof(*it) + len;
+
+	return false;
+}
+
 /** Store a single page of the Scene.
  *
  *  To accommodate large scene data, each scene is stored in pages of up to 256
- *  bytes.
+ *  bytes. Pages that are unchanged in the cached scene aren't written.
  */
-static void page_store(struct bt_mesh_scene_srv *srv, uint16_t scene,
+static void page_store(struct bt_mesh_scene_srv *srv,
+		       struct bt_mesh_scene_srv_cache *cache, uint16_t scene,
 		       uint8_t page, bool vnd, uint8_t buf[], size_t len)
 {
 	char path[9];
@@ -378,9 +510,15 @@ static void page_store(struct bt_mesh_scene_srv *srv, uint16_t scene,
 	scene_path(path, scene, vnd, page);
 	update_page_count(srv, vnd, page);
 
+	if (cache_page_update(cache, vnd, page, buf, len)) {
+		BT_DBG("Unchanged %s", log_strdup(path));
+		return;
+	}
+
 	err = bt_mesh_model_data_store(srv->model, false, path, buf, len);
 	if (err) {
 		BT_ERR("Failed storing %s: %d", log_strdup(path), err);
+		cache_drop(srv, scene);
 	}
 }
 
@@ -415,57 +553,11 @@ static uint16_t srv_elem_end(const struct bt_mesh_scene_srv *srv)
 	return end;
 }
 
-static void scene_recall_complete_mod(struct bt_mesh_scene_srv *srv, struct bt_mesh_model *models,
-				      int model_count, bool vnd)
-{
-	for (int j = 0; j < model_count; j++) {
-		const struct bt_mesh_scene_entry *entry;
-		struct bt_mesh_model *mod = &models[j];
-
-		if (mod == srv->model) {
-			continue;
-		}
-
-		/* MeshMDL1.0.1, section 5.1.3.1.1:
-		 * If a model is extending another model, the extending
-		 * model shall determine the Stored with Scene behavior
-		 * of that model.
-		 */
-		if (bt_mesh_model_is_extended(mod)) {
-			continue;
-		}
-
-		entry = entry_find(mod, vnd);
-		if (!entry || !entry->recall_complete) {
-			continue;
-		}
-
-		entry->recall_complete(mod);
-	}
-}
-
-static void scene_recall_complete(struct bt_mesh_scene_srv *srv)
+static int mods_add(struct bt_mesh_scene_srv *srv, bool vnd, uint8_t start)
 {
 	const struct bt_mesh_comp *comp = bt_mesh_comp_get();
 	uint16_t elem_end = srv_elem_end(srv);
-
-	for (int i = srv->model->elem_idx; i < elem_end; i++) {
-		const struct bt_mesh_elem *elem = &comp->elem[i];
-
-		scene_recall_complete_mod(srv, elem->models, elem->model_count, false);
-		scene_recall_complete_mod(srv, elem->vnd_models, elem->vnd_model_count, true);
-	}
-}
-
-static void scene_store_mod(struct bt_mesh_scene_srv *srv, uint16_t scene,
-			    bool vnd)
-{
-	const size_t data_overhead = sizeof(struct scene_data) + (vnd ? 2 : 0);
-	const struct bt_mesh_comp *comp = bt_mesh_comp_get();
-	uint16_t elem_end = srv_elem_end(srv);
-	uint8_t buf[SCENE_PAGE_SIZE];
-	uint8_t page = 0;
-	size_t len = 0;
+	uint8_t count = 0;
 
 	for (int i = srv->model->elem_idx; i < elem_end; i++) {
 		const struct bt_mesh_elem *elem = &comp->elem[i];
@@ -475,7 +567,6 @@ static void scene_store_mod(struct bt_mesh_scene_srv *srv, uint16_t scene,
 		for (int j = 0; j < model_count; j++) {
 			const struct bt_mesh_scene_entry *entry;
 			struct bt_mesh_model *mod = &models[j];
-			ssize_t size;
 
 			if (mod == srv->model) {
 				continue;
@@ -495,18 +586,99 @@ static void scene_store_mod(struct bt_mesh_scene_srv *srv, uint16_t scene,
 				continue;
 			}
 
-			if (len + data_overhead + entry->maxlen >= SCENE_PAGE_SIZE) {
-				page_store(srv, scene, page++, vnd, buf, len);
-				len = 0;
+			/* Leaving out a model would silently break its scenes,
+			 * so the composition data must fit:
+			 */
+			__ASSERT(start + count < ARRAY_SIZE(srv->mods),
+				 "Increase CONFIG_BT_MESH_SCENE_SRV_MODELS_MAX");
+			if (start + count == ARRAY_SIZE(srv->mods)) {
+				BT_ERR("No room for %s:%u:%u",
+				       vnd ? "vnd" : "sig", mod->elem_idx,
+				       mod->mod_idx);
+				return -ENOMEM;
 			}
 
-			size = entry_store(mod, entry, vnd, &buf[len]);
-			len += MAX(0, size);
+			srv->mods[start + count].mod = mod;
+			srv->mods[start + count].entry = entry;
+			count++;
 		}
 	}
 
+	return count;
+}
+
+/** @brief Build the list of models with scene data.
+ *
+ *  The list can only be built once all models have been initialized, as the
+ *  model extensions and the other Scene Servers must be known.
+ *
+ *  @retval 0 The list is built.
+ *  @retval -ENOMEM The models don't fit in the list.
+ */
+static int mods_build(struct bt_mesh_scene_srv *srv)
+{
+	int sigmods, vndmods;
+
+	if (srv->mods_valid) {
+		return 0;
+	}
+
+	sigmods = mods_add(srv, false, 0);
+	if (sigmods < 0) {
+		return sigmods;
+	}
+
+	vndmods = mods_add(srv, true, sigmods);
+	if (vndmods < 0) {
+		return vndmods;
+	}
+
+	srv->sigmods = sigmods;
+	srv->vndmods = vndmods;
+	srv->mods_valid = true;
+
+	BT_DBG("%u SIG and %u vendor models", srv->sigmods, srv->vndmods);
+
+	return 0;
+}
+
+static void scene_recall_complete(struct bt_mesh_scene_srv *srv)
+{
+	for (int i = 0; i < srv->sigmods + srv->vndmods; i++) {
+		const struct bt_mesh_scene_entry *entry = srv->mods[i].entry;
+
+		if (entry->recall_complete) {
+			entry->recall_complete(srv->mods[i].mod);
+		}
+	}
+}
+
+static void scene_store_mod(struct bt_mesh_scene_srv *srv,
+			    struct bt_mesh_scene_srv_cache *cache,
+			    uint16_t scene, bool vnd)
+{
+	const size_t data_overhead = sizeof(struct scene_data) + (vnd ? 2 : 0);
+	int start = vnd ? srv->sigmods : 0;
+	int end = start + (vnd ? srv->vndmods : srv->sigmods);
+	uint8_t buf[SCENE_PAGE_SIZE];
+	uint8_t page = 0;
+	size_t len = 0;
+
+	for (int i = start; i < end; i++) {
+		const struct bt_mesh_scene_entry *entry = srv->mods[i].entry;
+		ssize_t size;
+
+		if (len + data_overhead + entry->maxlen >= SCENE_PAGE_SIZE) {
+			page_store(srv, cache, scene, page++, vnd, buf, len);
+			len = 0;
+		}
+
+		size = entry_store(srv->mods[i].mod, entry, vnd, &buf[len]);
+		len += MAX(0, size);
+	}
+
 	if (len) {
-		page_store(srv, scene, page, vnd, buf, len);
+		page_store(srv, cache, scene, page, vnd, buf, len);
 	}
 }
 
@@ -514,6 +686,12 @@ static enum bt_mesh_scene_status scene_store(struct bt_mesh_scene_srv *srv,
 					     uint16_t scene)
 {
 	uint16_t *existing = scene_find(srv, scene);
+	struct bt_mesh_scene_srv_cache *cache;
+
+	/* Scenes can't be stored without the data of all models: */
+	if (mods_build(srv)) {
+		return BT_MESH_SCENE_REGISTER_FULL;
+	}
 
 	if (!existing) {
 		if (srv->count == ARRAY_SIZE(srv->all)) {
@@ -524,8 +702,14 @@ static enum bt_mesh_scene_status scene_store(struct bt_mesh_scene_srv *srv,
 		srv->all[srv->count++] = scene;
 	}
 
-	scene_store_mod(srv, scene, false);
-	scene_store_mod(srv, scene, true);
+	/* Without a cached copy of the scene, all pages are written: */
+	cache = cache_get(srv, scene);
+	if (!cache) {
+		cache = cache_alloc(srv, scene);
+	}
+
+	scene_store_mod(srv, cache, scene, false);
+	scene_store_mod(srv, cache, scene, true);
 
 	srv->next = scene;
 	return BT_MESH_SCENE_SUCCESS;
@@ -537,6 +721,8 @@ static void scene_delete(struct bt_mesh_scene_srv *srv, uint16_t *scene)
 
 	BT_DBG("0x%x", *scene);
 
+	cache_drop(srv, *scene);
+
 	for (int i = 0; i < srv->sigpages; i++) {
 		scene_path(path, *scene, false, i);
 		(void)bt_mesh_model_data_store(srv->model, false, path, NULL, 0);
@@ -727,11 +913,25 @@ static int scene_srv_set(struct bt_mesh_model *model, const char *path,
 	size = read_cb(cb_arg, &buf, sizeof(buf));
 	if (size < 0) {
 		BT_ERR("Failed loading scene 0x%x", scene);
+
+		/* The settings subsystem doesn't pass the error on to the
+		 * recall, so the incomplete scene must not be cached:
+		 */
+		if (srv->cache_fill && srv->cache_fill->scene == scene) {
+			srv->cache_fill->scene = BT_MESH_SCENE_NONE;
+			srv->cache_fill = NULL;
+		}
+
 		return -EINVAL;
 	}
 
 	BT_DBG("0x%x: %s", scene, bt_hex(buf, size));
 	page_recover(srv, vnd, buf, size);
+
+	if (srv->cache_fill && srv->cache_fill->scene == scene) {
+		(void)cache_page_update(srv->cache_fill, vnd, page, buf, size);
+	}
+
 	return 0;
 }
 
@@ -798,9 +998,21 @@ void bt_mesh_scene_invalidate(struct bt_mesh_model *mod)
 	srv->next = BT_MESH_SCENE_NONE;
 }
 
+static void cache_recover(struct bt_mesh_scene_srv *srv,
+			  const struct bt_mesh_scene_srv_cache *cache)
+{
+	for (const struct scene_cache_page *it = (const void *)&cache->data[0];
+	     it < (const struct scene_cache_page *)&cache->data[cache->len];
+	     it = (const struct scene_cache_page *)&it->data[it->len]) {
+		page_recover(srv, it->vnd, it->data, it->len);
+	}
+}
+
 int bt_mesh_scene_srv_set(struct bt_mesh_scene_srv *srv, uint16_t scene,
 			  struct bt_mesh_model_transition *transition)
 {
+	uint32_t start = k_cycle_get_32();
+	struct bt_mesh_scene_srv_cache *cache;
 	int32_t transition_time;
 	char path[25];
 	int err;
@@ -815,6 +1027,11 @@ int bt_mesh_scene_srv_set(struct bt_mesh_scene_srv *srv, uint16_t scene,
 		return -ENOENT;
 	}
 
+	err = mods_build(srv);
+	if (err) {
+		return err;
+	}
+
 	srv->prev = current_scene(srv, k_uptime_get());
 
 	transition_time = bt_mesh_model_transition_time(transition);
@@ -829,16 +1046,44 @@ int bt_mesh_scene_srv_set(struct bt_mesh_scene_srv *srv, uint16_t scene,
 
 	srv->next = scene;
 
-	sprintf(path, "bt/mesh/s/%x/data/%x",
-		(srv->model->elem_idx << 8) | srv->model->mod_idx, scene);
+	cache = cache_get(srv, scene);
+	if (cache) {
+		cache_recover(srv, cache);
+		err = 0;
+	} else {
+		sprintf(path, "bt/mesh/s/%x/data/%x",
+			(srv->model->elem_idx << 8) | srv->model->mod_idx,
+			scene);
+
+		BT_DBG("Loading %s", log_strdup(path));
 
-	BT_DBG("Loading %s", log_strdup(path));
+		/* The loaded pages are added to the cache in scene_srv_set() */
+		srv->cache_fill = cache_alloc(srv, scene);
+		err = settings_load_subtree(path);
+		if (err) {
+			cache_drop(srv, scene);
+		}
+
+		srv->cache_fill = NULL;
+	}
 
-	err = settings_load_subtree(path);
 	if (!err) {
 		scene_recall_complete(srv);
 	}
 
+	if (cache) {
+		srv->stats.cache_hits++;
+	} else {
+		srv->stats.cache_misses++;
+	}
+
+	srv->stats.recall_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	srv->stats.recall_max_us = MAX(srv->stats.recall_max_us,
+				       srv->stats.recall_us);
+
+	BT_DBG("Recalled 0x%x in %u us (%s)", scene, srv->stats.recall_us,
+	       cache ? "cached" : "loaded");
+
 	return err;
 }
 
@@ -18,19 +18,31 @@
 #define LOG_MODULE_NAME bt_mesh_sensor_srv
 #include "common/log.h"
 
-#define SENSOR_FOR_EACH(_list, _node)                                          \
-	SYS_SLIST_FOR_EACH_CONTAINER(_list, _node, state.node)
+#define SENSOR_FOR_EACH(_srv, _sensor)                                         \
+	for (uint8_t _i = 0; (_i < (_srv)->sensor_count) &&                    \
+			     ((_sensor) = (_srv)->sensors[_i]);                \
+	     ++_i)
 
 static struct bt_mesh_sensor *sensor_get(struct bt_mesh_sensor_srv *srv,
 					 uint16_t id)
 {
-	struct bt_mesh_sensor *sensor;
+	size_t lo = 0;
+	size_t hi = srv->sensor_count;
+
+	/* The sensors are sorted by ID in sensor_srv_init() */
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		struct bt_mesh_sensor *sensor = srv->sensors[mid];
 
-	SENSOR_FOR_EACH(&srv->sensors, sensor)
-	{
 		if (sensor->type->id == id) {
 			return sensor;
 		}
+
+		if (sensor->type->id < id) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
 	}
 
 	return NULL;
@@ -48,7 +60,7 @@ static void store_timeout(struct k_work *work)
 				    BT_MESH_SENSOR_MSG_MAXLEN_CADENCE_STATUS));
 
 	for (int i = 0; i < srv->sensor_count; ++i) {
-		const struct bt_mesh_sensor *s = srv->sensor_array[i];
+		const struct bt_mesh_sensor *s = srv->sensors[i];
 		int err;
 
 		net_buf_simple_add_le16(&buf, s->type->id);
@@ -152,7 +164,7 @@ static void handle_descriptor_get(struct bt_mesh_model *model,
 		goto respond;
 	}
 
-	SENSOR_FOR_EACH(&srv->sensors, sensor) {
+	SENSOR_FOR_EACH(srv, sensor) {
 		BT_DBG("Reporting ID 0x%04x", sensor->type->id);
 
 		if (net_buf_simple_tailroom(&rsp) < (8 + BT_MESH_MIC_SHORT)) {
@@ -199,7 +211,7 @@ static void handle_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
 		goto respond;
 	}
 
-	SENSOR_FOR_EACH(&srv->sensors, sensor) {
+	SENSOR_FOR_EACH(srv, sensor) {
 		buf_status_add(sensor, ctx, &rsp);
 	}
 
@@ -742,22 +754,76 @@ static uint16_t min_int_get(const struct bt_mesh_sensor *sensor,
 	return ceiling_fraction(min_int, pub_int);
 }
 
+/** Sensor value added to a publication by pub_msg_add(). */
+struct pub_entry {
+	/** Encoded length of the value, or 0 if the value wasn't added. */
+	uint8_t len;
+	/** Whether the value is due for publication. */
+	bool due;
+};
+
+/** @brief Get the size of the TransMIC of a publication.
+ *
+ *  Publications are sent segmented if they're too long for an unsegmented
+ *  message, or if the publish parameters request a reliable transmission.
+ *  The transport layer uses the 64-bit TransMIC for segmented messages if it
+ *  fits in the SDU.
+ *
+ *  @param pub Publish parameters.
+ *  @param len Length of the access payload, including the opcode.
+ *
+ *  @return The TransMIC size in bytes.
+ */
+static uint8_t pub_mic_size(const struct bt_mesh_model_pub *pub, size_t len)
+{
+	if ((pub->send_rel || len > BT_MESH_SDU_UNSEG_MAX) &&
+	    (len + BT_MESH_MIC_LONG <= BT_MESH_TX_SDU_MAX)) {
+		return BT_MESH_MIC_LONG;
+	}
+
+	return BT_MESH_MIC_SHORT;
+}
+
+/** @brief Get the number of network PDUs needed to send a publication.
+ *
+ *  @param pub Publish parameters.
+ *  @param len Length of the access payload, including the opcode.
+ *
+ *  @return The number of segments needed to send the access payload.
+ */
+static uint8_t pub_pdu_count(const struct bt_mesh_model_pub *pub, size_t len)
+{
+	if (!pub->send_rel && len <= BT_MESH_SDU_UNSEG_MAX) {
+		return 1;
+	}
+
+	return ceiling_fraction(len + pub_mic_size(pub, len),
+				BT_MESH_APP_SEG_SDU_MAX);
+}
+
 /** @brief Conditionally add a sensor value to a publication.
  *
- *  A sensor message will be added to the publication if its minimum interval
- *  has expired and the value is outside its delta threshold or the
- *  publication interval has expired.
+ *  A sensor value is due for publication if its minimum interval has expired
+ *  and the value is outside its delta threshold or the publication interval
+ *  has expired.
+ *
+ *  If @option{CONFIG_BT_MESH_SENSOR_SRV_PUB_ALIGN} is enabled, values whose
+ *  minimum interval has expired are added to the publication even if they
+ *  aren't due. pub_msg_fill() removes the ones that would need an extra
+ *  segment.
  *
  *  @param srv         Server sending the publication.
  *  @param s           Sensor to add data of.
  *  @param period_div  Server's original period divisor.
  *  @param base_period Server's original base period.
+ *  @param entry       Entry to fill with the added value.
  */
 static void pub_msg_add(struct bt_mesh_sensor_srv *srv,
 			struct bt_mesh_sensor *s, uint8_t period_div,
-			uint32_t base_period)
+			uint32_t base_period, struct pub_entry *entry)
 {
 	uint16_t min_int = min_int_get(s, period_div, base_period);
+	uint16_t len = srv->pub.msg->len;
 	int err;
 
 	if (srv->seq - s->state.seq < min_int) {
@@ -774,23 +840,99 @@ static void pub_msg_add(struct bt_mesh_sensor_srv *srv,
 	bool delta_triggered = bt_mesh_sensor_delta_threshold(s, value);
 	uint16_t interval = pub_int_get(s, period_div);
 
-	if (!delta_triggered && srv->seq - s->state.seq < interval) {
+	entry->due = (delta_triggered || srv->seq - s->state.seq >= interval);
+	if (!entry->due && !IS_ENABLED(CONFIG_BT_MESH_SENSOR_SRV_PUB_ALIGN)) {
 		return;
 	}
 
 	err = sensor_status_encode(srv->pub.msg, s, value);
 	if (err) {
+		srv->pub.msg->len = len;
 		return;
 	}
 
-	s->state.prev = value[0];
-	s->state.seq = srv->seq;
+	entry->len = srv->pub.msg->len - len;
+
+	if (entry->due) {
+		s->state.prev = value[0];
+		s->state.seq = srv->seq;
+	}
+}
+
+/** @brief Fill the last segment of a publication with values that aren't due.
+ *
+ *  Keeps the values added by pub_msg_add() that aren't due yet if they fit in
+ *  the publication without adding a segment, and removes the others. Sending
+ *  a value early aligns its publication interval with the values that are
+ *  due, so that fewer publications are needed later.
+ *
+ *  @param srv     Server sending the publication.
+ *  @param entries Entries filled by pub_msg_add(), in sensor order.
+ *  @param start   Length of the publication before the first sensor value.
+ */
+static void pub_msg_fill(struct bt_mesh_sensor_srv *srv,
+			 const struct pub_entry *entries, uint16_t start)
+{
+	struct sensor_value value[CONFIG_BT_MESH_SENSOR_CHANNELS_MAX];
+	struct net_buf_simple *msg = srv->pub.msg;
+	size_t len = start;
+	uint16_t offset = start;
+	uint8_t pdu_count;
+
+	for (int i = 0; i < srv->sensor_count; ++i) {
+		if (entries[i].due) {
+			len += entries[i].len;
+		}
+	}
+
+	pdu_count = pub_pdu_count(&srv->pub, len);
+
+	for (int i = 0; i < srv->sensor_count; ++i) {
+		struct bt_mesh_sensor *s = srv->sensors[i];
+		uint8_t *data = &msg->data[offset];
+
+		if (!entries[i].len) {
+			continue;
+		}
+
+		if (entries[i].due) {
+			offset += entries[i].len;
+			continue;
+		}
+
+		if (len > start &&
+		    pub_pdu_count(&srv->pub, len + entries[i].len) ==
+			    pdu_count) {
+			struct net_buf_simple buf;
+			uint16_t id;
+			uint8_t size;
+
+			/* The previously published value is read back from the
+			 * publication, as the sampled value isn't kept.
+			 */
+			net_buf_simple_init_with_data(&buf, data,
+						      entries[i].len);
+			sensor_status_id_decode(&buf, &size, &id);
+			if (!sensor_value_decode(&buf, s->type, value)) {
+				s->state.prev = value[0];
+			}
+
+			s->state.seq = srv->seq;
+			len += entries[i].len;
+			offset += entries[i].len;
+			continue;
+		}
+
+		memmove(data, data + entries[i].len,
+			msg->len - offset - entries[i].len);
+		msg->len -= entries[i].len;
+	}
 }
 
 static int update_handler(struct bt_mesh_model *model)
 {
 	struct bt_mesh_sensor_srv *srv = model->user_data;
-	struct bt_mesh_sensor *s;
+	struct pub_entry entries[CONFIG_BT_MESH_SENSOR_SRV_SENSORS_MAX] = {};
 
 	bt_mesh_model_msg_init(srv->pub.msg, BT_MESH_SENSOR_OP_STATUS);
 
@@ -806,9 +948,10 @@ static int update_handler(struct bt_mesh_model *model)
 
 	uint32_t base_period = bt_mesh_model_pub_period_get(model);
 
-	SENSOR_FOR_EACH(&srv->sensors, s)
-	{
-		pub_msg_add(srv, s, period_div, base_period);
+	for (int i = 0; i < srv->sensor_count; ++i) {
+		struct bt_mesh_sensor *s = srv->sensors[i];
+
+		pub_msg_add(srv, s, period_div, base_period, &entries[i]);
 
 		if (s->state.fast_pub) {
 			srv->pub.fast_period = true;
@@ -817,6 +960,10 @@ static int update_handler(struct bt_mesh_model *model)
 		}
 	}
 
+	if (IS_ENABLED(CONFIG_BT_MESH_SENSOR_SRV_PUB_ALIGN)) {
+		pub_msg_fill(srv, entries, original_len);
+	}
+
 	if (period_div != srv->pub.period_div) {
 		BT_DBG("New interval: %u",
 		       bt_mesh_model_pub_period_get(srv->model));
@@ -831,39 +978,39 @@ static int sensor_srv_init(struct bt_mesh_model *model)
 {
 	struct bt_mesh_sensor_srv *srv = model->user_data;
 
-	sys_slist_init(&srv->sensors);
-
 #if CONFIG_BT_SETTINGS
 	k_work_init_delayable(&srv->store_timer, store_timeout);
 #endif
 
-	/* Establish a sorted list of sensors, as this is a requirement when
-	 * sending multiple sensor values in one message.
+	/* Establish a sorted array of sensors, as this is a requirement when
+	 * sending multiple sensor values in one message, and allows looking
+	 * up sensors by ID with a binary search.
 	 */
-	uint16_t min_id = 0;
+	uint8_t count = 0;
 
-	for (int count = 0; count < srv->sensor_count; ++count) {
-		struct bt_mesh_sensor *best = NULL;
+	for (int i = 0; i < srv->sensor_count; ++i) {
+		struct bt_mesh_sensor *sensor = srv->sensor_array[i];
+		uint16_t id = sensor->type->id;
+		int j = count;
 
-		for (int j = 0; j < srv->sensor_count; ++j) {
-			if (srv->sensor_array[j]->type->id >= min_id &&
-			    (!best ||
-			     srv->sensor_array[j]->type->id < best->type->id)) {
-				best = srv->sensor_array[j];
-			}
+		while (j > 0 && srv->sensors[j - 1]->type->id >= id) {
+			j--;
 		}
 
-		if (!best) {
-			BT_ERR("Duplicate sensor ID");
-			srv->sensor_count = count;
-			break;
+		if (j < count && srv->sensors[j]->type->id == id) {
+			BT_ERR("Duplicate sensor ID 0x%04x", id);
+			continue;
 		}
 
-		sys_slist_append(&srv->sensors, &best->state.node);
-		BT_DBG("Sensor 0x%04x", best->type->id);
-		min_id = best->type->id + 1;
+		memmove(&srv->sensors[j + 1], &srv->sensors[j],
+			(count - j) * sizeof(srv->sensors[0]));
+		srv->sensors[j] = sensor;
+		count++;
+		BT_DBG("Sensor 0x%04x", sensor->type->id);
 	}
 
+	srv->sensor_count = count;
+
 	srv->seq = 1;
 
 	srv->model = model;
@@ -887,7 +1034,7 @@ static void sensor_srv_reset(struct bt_mesh_model *model)
 	net_buf_simple_reset(srv->setup_pub.msg);
 
 	for (int i = 0; i < srv->sensor_count; ++i) {
-		struct bt_mesh_sensor *s = srv->sensor_array[i];
+		struct bt_mesh_sensor *s = srv->sensors[i];
 
 		s->state.pub_div = 0;
 		s->state.min_int = 0;
@@ -24,9 +24,15 @@
 #define FORMAT(_name)                                                          \
 	const struct bt_mesh_sensor_format bt_mesh_sensor_format_##_name
 
-#define SENSOR_TYPE(name)                                                      \
-	const Z_STRUCT_SECTION_ITERABLE(bt_mesh_sensor_type,                   \
-					bt_mesh_sensor_##name)
+/* The section of each sensor type is named after its Device Property ID, so
+ * that the linker sorts the sensor types by ID for bt_mesh_sensor_type_get().
+ * All IDs are written as four digit hexadecimal numbers, which sort the same
+ * way as text and as numbers.
+ */
+#define SENSOR_TYPE(name, _id)                                                 \
+	const Z_DECL_ALIGN(struct bt_mesh_sensor_type) bt_mesh_sensor_##name   \
+		__in_section(_bt_mesh_sensor_type, static,                     \
+			     UTIL_CAT(_id, _##name)) __used
 
 #ifdef CONFIG_BT_MESH_SENSOR_LABELS
 
@@ -737,27 +743,29 @@ static const struct bt_mesh_sensor_channel voltage_stats[] = {
 /*******************************************************************************
  * Occupancy
  ******************************************************************************/
-SENSOR_TYPE(motion_sensed) = {
+SENSOR_TYPE(motion_sensed, BT_MESH_PROP_ID_MOTION_SENSED) = {
 	.id = BT_MESH_PROP_ID_MOTION_SENSED,
 	CHANNELS(CHANNEL("Motion sensed", percentage_8)),
 };
-SENSOR_TYPE(motion_threshold) = {
+SENSOR_TYPE(motion_threshold, BT_MESH_PROP_ID_MOTION_THRESHOLD) = {
 	.id = BT_MESH_PROP_ID_MOTION_THRESHOLD,
 	CHANNELS(CHANNEL("Motion threshold", percentage_8)),
 };
-SENSOR_TYPE(people_count) = {
+SENSOR_TYPE(people_count, BT_MESH_PROP_ID_PEOPLE_COUNT) = {
 	.id = BT_MESH_PROP_ID_PEOPLE_COUNT,
 	CHANNELS(CHANNEL("People count", count_16)),
 };
-SENSOR_TYPE(presence_detected) = {
+SENSOR_TYPE(presence_detected, BT_MESH_PROP_ID_PRESENCE_DETECTED) = {
 	.id = BT_MESH_PROP_ID_PRESENCE_DETECTED,
 	CHANNELS(CHANNEL("Presence detected", boolean)),
 };
-SENSOR_TYPE(time_since_motion_sensed) = {
+SENSOR_TYPE(time_since_motion_sensed,
+	    BT_MESH_PROP_ID_TIME_SINCE_MOTION_SENSED) = {
 	.id = BT_MESH_PROP_ID_TIME_SINCE_MOTION_SENSED,
 	CHANNELS(CHANNEL("Time since motion detected", time_second_16)),
 };
-SENSOR_TYPE(time_since_presence_detected) = {
+SENSOR_TYPE(time_since_presence_detected,
+	    BT_MESH_PROP_ID_TIME_SINCE_PRESENCE_DETECTED) = {
 	.id = BT_MESH_PROP_ID_TIME_SINCE_PRESENCE_DETECTED,
 	CHANNELS(CHANNEL("Time since presence detected", time_second_16)),
 };
@@ -765,14 +773,16 @@ SENSOR_TYPE(time_since_presence_detected) = {
 /*******************************************************************************
  * Ambient temperature
  ******************************************************************************/
-SENSOR_TYPE(avg_amb_temp_in_day) = {
+SENSOR_TYPE(avg_amb_temp_in_day,
+	    BT_MESH_PROP_ID_AVG_AMB_TEMP_IN_A_PERIOD_OF_DAY) = {
 	.id = BT_MESH_PROP_ID_AVG_AMB_TEMP_IN_A_PERIOD_OF_DAY,
 	.flags = BT_MESH_SENSOR_TYPE_FLAG_SERIES,
 	CHANNELS(CHANNEL("Temperature", temp_8),
 		 CHANNEL("Start time", time_decihour_8),
 		 CHANNEL("End time", time_decihour_8)),
 };
-SENSOR_TYPE(indoor_amb_temp_stat_values) = {
+SENSOR_TYPE(indoor_amb_temp_stat_values,
+	    BT_MESH_PROP_ID_INDOOR_AMB_TEMP_STAT_VALUES) = {
 	.id = BT_MESH_PROP_ID_INDOOR_AMB_TEMP_STAT_VALUES,
 	CHANNELS(CHANNEL("Avg", temp_8),
 		 CHANNEL("Standard deviation", temp_8),
@@ -780,7 +790,7 @@ SENSOR_TYPE(indoor_amb_temp_stat_values) = {
 		 CHANNEL("Max", temp_8),
 		 CHANNEL("Sensing duration", time_exp_8)),
 };
-SENSOR_TYPE(outdoor_stat_values) = {
+SENSOR_TYPE(outdoor_stat_values, BT_MESH_PROP_ID_OUTDOOR_STAT_VALUES) = {
 	.id = BT_MESH_PROP_ID_OUTDOOR_STAT_VALUES,
 	CHANNELS(CHANNEL("Avg", temp_8),
 		 CHANNEL("Standard deviation", temp_8),
@@ -788,23 +798,26 @@ SENSOR_TYPE(outdoor_stat_values) = {
 		 CHANNEL("Max", temp_8),
 		 CHANNEL("Sensing duration", time_exp_8)),
 };
-SENSOR_TYPE(present_amb_temp) = {
+SENSOR_TYPE(present_amb_temp, BT_MESH_PROP_ID_PRESENT_AMB_TEMP) = {
 	.id = BT_MESH_PROP_ID_PRESENT_AMB_TEMP,
 	CHANNELS(CHANNEL("Present ambient temperature", temp_8)),
 };
-SENSOR_TYPE(present_indoor_amb_temp) = {
+SENSOR_TYPE(present_indoor_amb_temp,
+	    BT_MESH_PROP_ID_PRESENT_INDOOR_AMB_TEMP) = {
 	.id = BT_MESH_PROP_ID_PRESENT_INDOOR_AMB_TEMP,
 	CHANNELS(CHANNEL("Present indoor ambient temperature", temp_8)),
 };
-SENSOR_TYPE(present_outdoor_amb_temp) = {
+SENSOR_TYPE(present_outdoor_amb_temp,
+	    BT_MESH_PROP_ID_PRESENT_OUTDOOR_AMB_TEMP) = {
 	.id = BT_MESH_PROP_ID_PRESENT_OUTDOOR_AMB_TEMP,
 	CHANNELS(CHANNEL("Present outdoor ambient temperature", temp_8)),
 };
-SENSOR_TYPE(desired_amb_temp) = {
+SENSOR_TYPE(desired_amb_temp, BT_MESH_PROP_ID_DESIRED_AMB_TEMP) = {
 	.id = BT_MESH_PROP_ID_DESIRED_AMB_TEMP,
 	CHANNELS(CHANNEL("Desired ambient temperature", temp_8)),
 };
-SENSOR_TYPE(precise_present_amb_temp) = {
+SENSOR_TYPE(precise_present_amb_temp,
+	    BT_MESH_PROP_ID_PRECISE_PRESENT_AMB_TEMP) = {
 	.id = BT_MESH_PROP_ID_PRECISE_PRESENT_AMB_TEMP,
 	CHANNELS(CHANNEL("Precise present ambient temperature", temp)),
 };
@@ -812,96 +825,104 @@ SENSOR_TYPE(precise_present_amb_temp) = {
 /*******************************************************************************
  * Environmental
  ******************************************************************************/
-SENSOR_TYPE(apparent_wind_direction) = {
+SENSOR_TYPE(apparent_wind_direction,
+	    BT_MESH_PROP_ID_APPARENT_WIND_DIRECTION) = {
 	.id = BT_MESH_PROP_ID_APPARENT_WIND_DIRECTION,
 	CHANNELS(CHANNEL("Apparent Wind Direction", direction_16)),
 };
-SENSOR_TYPE(apparent_wind_speed) = {
+SENSOR_TYPE(apparent_wind_speed, BT_MESH_PROP_ID_APPARENT_WIND_SPEED) = {
 	.id = BT_MESH_PROP_ID_APPARENT_WIND_SPEED,
 	CHANNELS(CHANNEL("Apparent Wind Speed", wind_speed)),
 };
-SENSOR_TYPE(dew_point) = {
+SENSOR_TYPE(dew_point, BT_MESH_PROP_ID_DEW_POINT) = {
 	.id = BT_MESH_PROP_ID_DEW_POINT,
 	CHANNELS(CHANNEL("Dew Point", temp_8_wide)),
 };
-SENSOR_TYPE(gust_factor) = {
+SENSOR_TYPE(gust_factor, BT_MESH_PROP_ID_GUST_FACTOR) = {
 	.id = BT_MESH_PROP_ID_GUST_FACTOR,
 	CHANNELS(CHANNEL("Gust Factor", gust_factor)),
 };
-SENSOR_TYPE(heat_index) = {
+SENSOR_TYPE(heat_index, BT_MESH_PROP_ID_HEAT_INDEX) = {
 	.id = BT_MESH_PROP_ID_HEAT_INDEX,
 	CHANNELS(CHANNEL("Heat Index", temp_8_wide)),
 };
-SENSOR_TYPE(present_amb_rel_humidity) = {
+SENSOR_TYPE(present_amb_rel_humidity,
+	    BT_MESH_PROP_ID_PRESENT_AMB_REL_HUMIDITY) = {
 	.id = BT_MESH_PROP_ID_PRESENT_AMB_REL_HUMIDITY,
 	CHANNELS(CHANNEL("Present ambient relative humidity", percentage_16)),
 };
-SENSOR_TYPE(present_amb_co2_concentration) = {
+SENSOR_TYPE(present_amb_co2_concentration,
+	    BT_MESH_PROP_ID_PRESENT_AMB_CO2_CONCENTRATION) = {
 	.id = BT_MESH_PROP_ID_PRESENT_AMB_CO2_CONCENTRATION,
 	CHANNELS(CHANNEL("Present ambient CO2 concentration",
 			 co2_concentration)),
 };
-SENSOR_TYPE(present_amb_voc_concentration) = {
+SENSOR_TYPE(present_amb_voc_concentration,
+	    BT_MESH_PROP_ID_PRESENT_AMB_VOC_CONCENTRATION) = {
 	.id = BT_MESH_PROP_ID_PRESENT_AMB_VOC_CONCENTRATION,
 	CHANNELS(CHANNEL("Present ambient VOC concentration",
 			 voc_concentration)),
 };
-SENSOR_TYPE(present_amb_noise) = {
+SENSOR_TYPE(present_amb_noise, BT_MESH_PROP_ID_PRESENT_AMB_NOISE) = {
 	.id = BT_MESH_PROP_ID_PRESENT_AMB_NOISE,
 	CHANNELS(CHANNEL("Present ambient noise", noise)),
 };
-SENSOR_TYPE(present_indoor_relative_humidity) = {
+SENSOR_TYPE(present_indoor_relative_humidity,
+	    BT_MESH_PROP_ID_PRESENT_INDOOR_RELATIVE_HUMIDITY) = {
 	.id = BT_MESH_PROP_ID_PRESENT_INDOOR_RELATIVE_HUMIDITY,
 	CHANNELS(CHANNEL("Humidity", percentage_16)),
 };
-SENSOR_TYPE(present_outdoor_relative_humidity) = {
+SENSOR_TYPE(present_outdoor_relative_humidity,
+	    BT_MESH_PROP_ID_PRESENT_OUTDOOR_RELATIVE_HUMIDITY) = {
 	.id = BT_MESH_PROP_ID_PRESENT_OUTDOOR_RELATIVE_HUMIDITY,
 	CHANNELS(CHANNEL("Humidity", percentage_16)),
 };
-SENSOR_TYPE(magnetic_declination) = {
+SENSOR_TYPE(magnetic_declination, BT_MESH_PROP_ID_MAGNETIC_DECLINATION) = {
 	.id = BT_MESH_PROP_ID_MAGNETIC_DECLINATION,
 	CHANNELS(CHANNEL("Magnetic Declination", direction_16)),
 };
-SENSOR_TYPE(magnetic_flux_density_2d) = {
+SENSOR_TYPE(magnetic_flux_density_2d,
+	    BT_MESH_PROP_ID_MAGNETIC_FLUX_DENSITY_2D) = {
 	.id = BT_MESH_PROP_ID_MAGNETIC_FLUX_DENSITY_2D,
 	CHANNELS(CHANNEL("X-axis", magnetic_flux_density),
 		 CHANNEL("Y-axis", magnetic_flux_density)),
 };
-SENSOR_TYPE(magnetic_flux_density_3d) = {
+SENSOR_TYPE(magnetic_flux_density_3d,
+	    BT_MESH_PROP_ID_MAGNETIC_FLUX_DENSITY_3D) = {
 	.id = BT_MESH_PROP_ID_MAGNETIC_FLUX_DENSITY_3D,
 	CHANNELS(CHANNEL("X-axis", magnetic_flux_density),
 		 CHANNEL("Y-axis", magnetic_flux_density),
 		 CHANNEL("Z-axis", magnetic_flux_density)),
 };
-SENSOR_TYPE(pollen_concentration) = {
+SENSOR_TYPE(pollen_concentration, BT_MESH_PROP_ID_POLLEN_CONCENTRATION) = {
 	.id = BT_MESH_PROP_ID_POLLEN_CONCENTRATION,
 	CHANNELS(CHANNEL("Pollen Concentration", pollen_concentration)),
 };
-SENSOR_TYPE(air_pressure) = {
+SENSOR_TYPE(air_pressure, BT_MESH_PROP_ID_AIR_PRESSURE) = {
 	.id = BT_MESH_PROP_ID_AIR_PRESSURE,
 	CHANNELS(CHANNEL("Pressure", pressure)),
 };
-SENSOR_TYPE(pressure) = {
+SENSOR_TYPE(pressure, BT_MESH_PROP_ID_PRESSURE) = {
 	.id = BT_MESH_PROP_ID_PRESSURE,
 	CHANNELS(CHANNEL("Pressure", pressure)),
 };
-SENSOR_TYPE(rainfall) = {
+SENSOR_TYPE(rainfall, BT_MESH_PROP_ID_RAINFALL) = {
 	.id = BT_MESH_PROP_ID_RAINFALL,
 	CHANNELS(CHANNEL("Rainfall", rainfall)),
 };
-SENSOR_TYPE(true_wind_direction) = {
+SENSOR_TYPE(true_wind_direction, BT_MESH_PROP_ID_TRUE_WIND_DIRECTION) = {
 	.id = BT_MESH_PROP_ID_TRUE_WIND_DIRECTION,
 	CHANNELS(CHANNEL("True Wind Direction", direction_16)),
 };
-SENSOR_TYPE(true_wind_speed) = {
+SENSOR_TYPE(true_wind_speed, BT_MESH_PROP_ID_TRUE_WIND_SPEED) = {
 	.id = BT_MESH_PROP_ID_TRUE_WIND_SPEED,
 	CHANNELS(CHANNEL("True Wind Speed", wind_speed)),
 };
-SENSOR_TYPE(uv_index) = {
+SENSOR_TYPE(uv_index, BT_MESH_PROP_ID_UV_INDEX) = {
 	.id = BT_MESH_PROP_ID_UV_INDEX,
 	CHANNELS(CHANNEL("UV Index", uv_index)),
 };
-SENSOR_TYPE(wind_chill) = {
+SENSOR_TYPE(wind_chill, BT_MESH_PROP_ID_WIND_CHILL) = {
 	.id = BT_MESH_PROP_ID_WIND_CHILL,
 	CHANNELS(CHANNEL("Wind Chill", temp_8_wide)),
 };
@@ -909,12 +930,13 @@ SENSOR_TYPE(wind_chill) = {
 /*******************************************************************************
  * Device operating temperature
  ******************************************************************************/
-SENSOR_TYPE(dev_op_temp_range_spec) = {
+SENSOR_TYPE(dev_op_temp_range_spec, BT_MESH_PROP_ID_DEV_OP_TEMP_RANGE_SPEC) = {
 	.id = BT_MESH_PROP_ID_DEV_OP_TEMP_RANGE_SPEC,
 	CHANNELS(CHANNEL("Min", temp),
 		 CHANNEL("Max", temp)),
 };
-SENSOR_TYPE(dev_op_temp_stat_values) = {
+SENSOR_TYPE(dev_op_temp_stat_values,
+	    BT_MESH_PROP_ID_DEV_OP_TEMP_STAT_VALUES) = {
 	.id = BT_MESH_PROP_ID_DEV_OP_TEMP_STAT_VALUES,
 	CHANNELS(CHANNEL("Avg", temp),
 		 CHANNEL("Standard deviation", temp),
@@ -922,12 +944,13 @@ SENSOR_TYPE(dev_op_temp_stat_values) = {
 		 CHANNEL("Max", temp),
 		 CHANNEL("Sensing duration", time_exp_8)),
 };
-SENSOR_TYPE(present_dev_op_temp) = {
+SENSOR_TYPE(present_dev_op_temp, BT_MESH_PROP_ID_PRESENT_DEV_OP_TEMP) = {
 	.id = BT_MESH_PROP_ID_PRESENT_DEV_OP_TEMP,
 	CHANNELS(CHANNEL("Temperature", temp)),
 };
 
-SENSOR_TYPE(rel_runtime_in_a_dev_op_temp_range) = {
+SENSOR_TYPE(rel_runtime_in_a_dev_op_temp_range,
+	    BT_MESH_PROP_ID_REL_RUNTIME_IN_A_DEV_OP_TEMP_RANGE) = {
 	.id = BT_MESH_PROP_ID_REL_RUNTIME_IN_A_DEV_OP_TEMP_RANGE,
 	.flags = BT_MESH_SENSOR_TYPE_FLAG_SERIES,
 	CHANNELS(CHANNEL("Relative value", percentage_8),
@@ -938,51 +961,55 @@ SENSOR_TYPE(rel_runtime_in_a_dev_op_temp_range) = {
 /*******************************************************************************
  * Electrical input
  ******************************************************************************/
-SENSOR_TYPE(avg_input_current) = {
+SENSOR_TYPE(avg_input_current, BT_MESH_PROP_ID_AVG_INPUT_CURRENT) = {
 	.id = BT_MESH_PROP_ID_AVG_INPUT_CURRENT,
 	CHANNELS(CHANNEL("Electric current value", electric_current),
 		 CHANNEL("Sensing duration", time_exp_8)),
 };
-SENSOR_TYPE(avg_input_voltage) = {
+SENSOR_TYPE(avg_input_voltage, BT_MESH_PROP_ID_AVG_INPUT_VOLTAGE) = {
 	.id = BT_MESH_PROP_ID_AVG_INPUT_VOLTAGE,
 	CHANNELS(CHANNEL("Voltage value", voltage),
 		 CHANNEL("Sensing duration", time_exp_8)),
 };
-SENSOR_TYPE(input_current_range_spec) = {
+SENSOR_TYPE(input_current_range_spec,
+	    BT_MESH_PROP_ID_INPUT_CURRENT_RANGE_SPEC) = {
 	.id = BT_MESH_PROP_ID_INPUT_CURRENT_RANGE_SPEC,
 	CHANNELS(CHANNEL("Min", electric_current),
 		 CHANNEL("Max", electric_current),
 		 CHANNEL("Typical electric current value", electric_current)),
 };
-SENSOR_TYPE(input_current_stat) = {
+SENSOR_TYPE(input_current_stat, BT_MESH_PROP_ID_INPUT_CURRENT_STAT) = {
 	.id = BT_MESH_PROP_ID_INPUT_CURRENT_STAT,
 	.channel_count = ARRAY_SIZE(electric_current_stats),
 	.channels = electric_current_stats,
 };
-SENSOR_TYPE(input_voltage_range_spec) = {
+SENSOR_TYPE(input_voltage_range_spec,
+	    BT_MESH_PROP_ID_INPUT_VOLTAGE_RANGE_SPEC) = {
 	.id = BT_MESH_PROP_ID_INPUT_VOLTAGE_RANGE_SPEC,
 	CHANNELS(CHANNEL("Min", voltage),
 		 CHANNEL("Max", voltage),
 		 CHANNEL("Typical voltage value", voltage)),
 };
-SENSOR_TYPE(input_voltage_stat) = {
+SENSOR_TYPE(input_voltage_stat, BT_MESH_PROP_ID_INPUT_VOLTAGE_STAT) = {
 	.id = BT_MESH_PROP_ID_INPUT_VOLTAGE_STAT,
 	.channel_count = ARRAY_SIZE(voltage_stats),
 	.channels = voltage_stats,
 };
-SENSOR_TYPE(present_input_current) = {
+SENSOR_TYPE(present_input_current, BT_MESH_PROP_ID_PRESENT_INPUT_CURRENT) = {
 	.id = BT_MESH_PROP_ID_PRESENT_INPUT_CURRENT,
 	CHANNELS(CHANNEL("Present input current", electric_current)),
 };
-SENSOR_TYPE(present_input_ripple_voltage) = {
+SENSOR_TYPE(present_input_ripple_voltage,
+	    BT_MESH_PROP_ID_PRESENT_INPUT_RIPPLE_VOLTAGE) = {
 	.id = BT_MESH_PROP_ID_PRESENT_INPUT_RIPPLE_VOLTAGE,
 	CHANNELS(CHANNEL("Present input ripple voltage", percentage_8)),
 };
-SENSOR_TYPE(present_input_voltage) = {
+SENSOR_TYPE(present_input_voltage, BT_MESH_PROP_ID_PRESENT_INPUT_VOLTAGE) = {
 	.id = BT_MESH_PROP_ID_PRESENT_INPUT_VOLTAGE,
 	CHANNELS(CHANNEL("Present input voltage", voltage)),
 };
-SENSOR_TYPE(rel_runtime_in_an_input_current_range) = {
+SENSOR_TYPE(rel_runtime_in_an_input_current_range,
+	    BT_MESH_PROP_ID_REL_RUNTIME_IN_AN_INPUT_CURRENT_RANGE) = {
 	.id = BT_MESH_PROP_ID_REL_RUNTIME_IN_AN_INPUT_CURRENT_RANGE,
 	.flags = BT_MESH_SENSOR_TYPE_FLAG_SERIES,
 	CHANNELS(CHANNEL("Relative runtime value", percentage_8),
@@ -990,7 +1017,8 @@ SENSOR_TYPE(rel_runtime_in_an_input_current_range) = {
 		 CHANNEL("Max", electric_current)),
 };
 
-SENSOR_TYPE(rel_runtime_in_an_input_voltage_range) = {
+SENSOR_TYPE(rel_runtime_in_an_input_voltage_range,
+	    BT_MESH_PROP_ID_REL_RUNTIME_IN_AN_INPUT_VOLTAGE_RANGE) = {
 	.id = BT_MESH_PROP_ID_REL_RUNTIME_IN_AN_INPUT_VOLTAGE_RANGE,
 	.flags = BT_MESH_SENSOR_TYPE_FLAG_SERIES,
 	CHANNELS(CHANNEL("Relative runtime value", percentage_8),
@@ -1001,56 +1029,61 @@ SENSOR_TYPE(rel_runtime_in_an_input_voltage_range) = {
 /*******************************************************************************
  * Energy management
  ******************************************************************************/
-SENSOR_TYPE(dev_power_range_spec) = {
+SENSOR_TYPE(dev_power_range_spec, BT_MESH_PROP_ID_DEV_POWER_RANGE_SPEC) = {
 	.id = BT_MESH_PROP_ID_DEV_POWER_RANGE_SPEC,
 	CHANNELS(CHANNEL("Min power value", power),
 		 CHANNEL("Typical power value", power),
 		 CHANNEL("Max power value", power)),
 };
-SENSOR_TYPE(present_dev_input_power) = {
+SENSOR_TYPE(present_dev_input_power,
+	    BT_MESH_PROP_ID_PRESENT_DEV_INPUT_POWER) = {
 	.id = BT_MESH_PROP_ID_PRESENT_DEV_INPUT_POWER,
 	CHANNELS(CHANNEL("Present device input power", power)),
 };
-SENSOR_TYPE(present_dev_op_efficiency) = {
+SENSOR_TYPE(present_dev_op_efficiency,
+	    BT_MESH_PROP_ID_PRESENT_DEV_OP_EFFICIENCY) = {
 	.id = BT_MESH_PROP_ID_PRESENT_DEV_OP_EFFICIENCY,
 	CHANNELS(CHANNEL("Present device operating efficiency", percentage_8)),
 };
-SENSOR_TYPE(tot_dev_energy_use) = {
+SENSOR_TYPE(tot_dev_energy_use, BT_MESH_PROP_ID_TOT_DEV_ENERGY_USE) = {
 	.id = BT_MESH_PROP_ID_TOT_DEV_ENERGY_USE,
 	CHANNELS(CHANNEL("Total device energy use", energy)),
 };
-SENSOR_TYPE(precise_tot_dev_energy_use) = {
+SENSOR_TYPE(precise_tot_dev_energy_use,
+	    BT_MESH_PROP_ID_PRECISE_TOT_DEV_ENERGY_USE) = {
 	.id = BT_MESH_PROP_ID_PRECISE_TOT_DEV_ENERGY_USE,
 	CHANNELS(CHANNEL("Total device energy use", energy32)),
 };
-SENSOR_TYPE(dev_energy_use_since_turn_on) = {
+SENSOR_TYPE(dev_energy_use_since_turn_on,
+	    BT_MESH_PROP_ID_DEV_ENERGY_USE_SINCE_TURN_ON) = {
 	.id = BT_MESH_PROP_ID_DEV_ENERGY_USE_SINCE_TURN_ON,
 	CHANNELS(CHANNEL("Device energy use since turn on", energy)),
 };
-SENSOR_TYPE(power_factor) = {
+SENSOR_TYPE(power_factor, BT_MESH_PROP_ID_POWER_FACTOR) = {
 	.id = BT_MESH_PROP_ID_POWER_FACTOR,
 	CHANNELS(CHANNEL("Cosine of the angle", cos_of_the_angle)),
 };
-SENSOR_TYPE(rel_dev_energy_use_in_a_period_of_day) = {
+SENSOR_TYPE(rel_dev_energy_use_in_a_period_of_day,
+	    BT_MESH_PROP_ID_REL_DEV_ENERGY_USE_IN_A_PERIOD_OF_DAY) = {
 	.id = BT_MESH_PROP_ID_REL_DEV_ENERGY_USE_IN_A_PERIOD_OF_DAY,
 	.flags = BT_MESH_SENSOR_TYPE_FLAG_SERIES,
 	CHANNELS(CHANNEL("Energy", energy),
 		 CHANNEL("Start time", time_decihour_8),
 		 CHANNEL("End time", time_decihour_8)),
 };
-SENSOR_TYPE(apparent_energy) = {
+SENSOR_TYPE(apparent_energy, BT_MESH_PROP_ID_APPARENT_ENERGY) = {
 	.id = BT_MESH_PROP_ID_APPARENT_ENERGY,
 	CHANNELS(CHANNEL("Apparent energy", apparent_energy32)),
 };
-SENSOR_TYPE(apparent_power) = {
+SENSOR_TYPE(apparent_power, BT_MESH_PROP_ID_APPARENT_POWER) = {
 	.id = BT_MESH_PROP_ID_APPARENT_POWER,
 	CHANNELS(CHANNEL("Apparent power", apparent_power)),
 };
-SENSOR_TYPE(active_energy_loadside) = {
+SENSOR_TYPE(active_energy_loadside, BT_MESH_PROP_ID_ACTIVE_ENERGY_LOADSIDE) = {
 	.id = BT_MESH_PROP_ID_ACTIVE_ENERGY_LOADSIDE,
 	CHANNELS(CHANNEL("Energy", energy32)),
 };
-SENSOR_TYPE(active_power_loadside) = {
+SENSOR_TYPE(active_power_loadside, BT_MESH_PROP_ID_ACTIVE_POWER_LOADSIDE) = {
 	.id = BT_MESH_PROP_ID_ACTIVE_POWER_LOADSIDE,
 	CHANNELS(CHANNEL("Power", power)),
 };
@@ -1058,78 +1091,89 @@ SENSOR_TYPE(active_power_loadside) = {
 /*******************************************************************************
  * Photometry
  ******************************************************************************/
-SENSOR_TYPE(present_amb_light_level) = {
+SENSOR_TYPE(present_amb_light_level,
+	    BT_MESH_PROP_ID_PRESENT_AMB_LIGHT_LEVEL) = {
 	.id = BT_MESH_PROP_ID_PRESENT_AMB_LIGHT_LEVEL,
 	CHANNELS(CHANNEL("Present ambient light level", illuminance)),
 };
-SENSOR_TYPE(initial_cie_1931_chromaticity_coords) = {
+SENSOR_TYPE(initial_cie_1931_chromaticity_coords,
+	    BT_MESH_PROP_ID_INITIAL_CIE_1931_CHROMATICITY_COORDS) = {
 	.id = BT_MESH_PROP_ID_INITIAL_CIE_1931_CHROMATICITY_COORDS,
 	CHANNELS(CHANNEL("Initial CIE 1931 chromaticity x-coordinate", chromaticity_coordinate),
 		 CHANNEL("Initial CIE 1931 chromaticity y-coordinate", chromaticity_coordinate)),
 };
-SENSOR_TYPE(present_cie_1931_chromaticity_coords) = {
+SENSOR_TYPE(present_cie_1931_chromaticity_coords,
+	    BT_MESH_PROP_ID_PRESENT_CIE_1931_CHROMATICITY_COORDS) = {
 	.id = BT_MESH_PROP_ID_PRESENT_CIE_1931_CHROMATICITY_COORDS,
 	CHANNELS(CHANNEL("Present CIE 1931 chromaticity x-coordinate", chromaticity_coordinate),
 		 CHANNEL("Present CIE 1931 chromaticity y-coordinate", chromaticity_coordinate)),
 };
-SENSOR_TYPE(initial_correlated_col_temp) = {
+SENSOR_TYPE(initial_correlated_col_temp,
+	    BT_MESH_PROP_ID_INITIAL_CORRELATED_COL_TEMP) = {
 	.id = BT_MESH_PROP_ID_INITIAL_CORRELATED_COL_TEMP,
 	CHANNELS(CHANNEL("Initial correlated color temperature",
 			 correlated_color_temp)),
 };
-SENSOR_TYPE(present_correlated_col_temp) = {
+SENSOR_TYPE(present_correlated_col_temp,
+	    BT_MESH_PROP_ID_PRESENT_CORRELATED_COL_TEMP) = {
 	.id = BT_MESH_PROP_ID_PRESENT_CORRELATED_COL_TEMP,
 	CHANNELS(CHANNEL("Present correlated color temperature",
 			 correlated_color_temp)),
 };
-SENSOR_TYPE(present_illuminance) = {
+SENSOR_TYPE(present_illuminance, BT_MESH_PROP_ID_PRESENT_ILLUMINANCE) = {
 	.id = BT_MESH_PROP_ID_PRESENT_ILLUMINANCE,
 	CHANNELS(CHANNEL("Present illuminance", illuminance)),
 };
-SENSOR_TYPE(initial_luminous_flux) = {
+SENSOR_TYPE(initial_luminous_flux, BT_MESH_PROP_ID_INITIAL_LUMINOUS_FLUX) = {
 	.id = BT_MESH_PROP_ID_INITIAL_LUMINOUS_FLUX,
 	CHANNELS(CHANNEL("Initial luminous flux", luminous_flux)),
 };
-SENSOR_TYPE(present_luminous_flux) = {
+SENSOR_TYPE(present_luminous_flux, BT_MESH_PROP_ID_PRESENT_LUMINOUS_FLUX) = {
 	.id = BT_MESH_PROP_ID_PRESENT_LUMINOUS_FLUX,
 	CHANNELS(CHANNEL("Present luminous flux", luminous_flux)),
 };
-SENSOR_TYPE(initial_planckian_distance) = {
+SENSOR_TYPE(initial_planckian_distance,
+	    BT_MESH_PROP_ID_INITIAL_PLANCKIAN_DISTANCE) = {
 	.id = BT_MESH_PROP_ID_INITIAL_PLANCKIAN_DISTANCE,
 	CHANNELS(CHANNEL("Initial planckian distance", chromatic_distance)),
 };
-SENSOR_TYPE(present_planckian_distance) = {
+SENSOR_TYPE(present_planckian_distance,
+	    BT_MESH_PROP_ID_PRESENT_PLANCKIAN_DISTANCE) = {
 	.id = BT_MESH_PROP_ID_PRESENT_PLANCKIAN_DISTANCE,
 	CHANNELS(CHANNEL("Present planckian distance", chromatic_distance)),
 };
-SENSOR_TYPE(rel_exposure_time_in_an_illuminance_range) = {
+SENSOR_TYPE(rel_exposure_time_in_an_illuminance_range,
+	    BT_MESH_PROP_ID_REL_EXPOSURE_TIME_IN_AN_ILLUMINANCE_RANGE) = {
 	.id = BT_MESH_PROP_ID_REL_EXPOSURE_TIME_IN_AN_ILLUMINANCE_RANGE,
 	.flags = BT_MESH_SENSOR_TYPE_FLAG_SERIES,
 	CHANNELS(CHANNEL("Relative value", percentage_8),
 		 CHANNEL("Min", illuminance),
 		 CHANNEL("Max", illuminance))
 };
-SENSOR_TYPE(tot_light_exposure_time) = {
+SENSOR_TYPE(tot_light_exposure_time,
+	    BT_MESH_PROP_ID_TOT_LIGHT_EXPOSURE_TIME) = {
 	.id = BT_MESH_PROP_ID_TOT_LIGHT_EXPOSURE_TIME,
 	CHANNELS(CHANNEL("Total light exposure time", time_hour_24)),
 };
-SENSOR_TYPE(lumen_maintenance_factor) = {
+SENSOR_TYPE(lumen_maintenance_factor,
+	    BT_MESH_PROP_ID_LUMEN_MAINTENANCE_FACTOR) = {
 	.id = BT_MESH_PROP_ID_LUMEN_MAINTENANCE_FACTOR,
 	CHANNELS(CHANNEL("Lumen maintenance factor", percentage_8)),
 };
-SENSOR_TYPE(luminous_efficacy) = {
+SENSOR_TYPE(luminous_efficacy, BT_MESH_PROP_ID_LUMINOUS_EFFICACY) = {
 	.id = BT_MESH_PROP_ID_LUMINOUS_EFFICACY,
 	CHANNELS(CHANNEL("Luminous efficacy", luminous_efficacy)),
 };
-SENSOR_TYPE(luminous_energy_since_turn_on) = {
+SENSOR_TYPE(luminous_energy_since_turn_on,
+	    BT_MESH_PROP_ID_LUMINOUS_ENERGY_SINCE_TURN_ON) = {
 	.id = BT_MESH_PROP_ID_LUMINOUS_ENERGY_SINCE_TURN_ON,
 	CHANNELS(CHANNEL("Luminous energy since turn on", luminous_energy)),
 };
-SENSOR_TYPE(luminous_exposure) = {
+SENSOR_TYPE(luminous_exposure, BT_MESH_PROP_ID_LUMINOUS_EXPOSURE) = {
 	.id = BT_MESH_PROP_ID_LUMINOUS_EXPOSURE,
 	CHANNELS(CHANNEL("Luminous exposure", luminous_exposure)),
 };
-SENSOR_TYPE(luminous_flux_range) = {
+SENSOR_TYPE(luminous_flux_range, BT_MESH_PROP_ID_LUMINOUS_FLUX_RANGE) = {
 	.id = BT_MESH_PROP_ID_LUMINOUS_FLUX_RANGE,
 	CHANNELS(CHANNEL("Min", luminous_flux),
 		 CHANNEL("Max", luminous_flux)),
@@ -1138,49 +1182,51 @@ SENSOR_TYPE(luminous_flux_range) = {
 /*******************************************************************************
  * Power supply output
  ******************************************************************************/
-SENSOR_TYPE(avg_output_current) = {
+SENSOR_TYPE(avg_output_current, BT_MESH_PROP_ID_AVG_OUTPUT_CURRENT) = {
 	.id = BT_MESH_PROP_ID_AVG_OUTPUT_CURRENT,
 	CHANNELS(CHANNEL("Electric current value", electric_current),
 		 CHANNEL("Sensing duration", time_exp_8)),
 };
-SENSOR_TYPE(avg_output_voltage) = {
+SENSOR_TYPE(avg_output_voltage, BT_MESH_PROP_ID_AVG_OUTPUT_VOLTAGE) = {
 	.id = BT_MESH_PROP_ID_AVG_OUTPUT_VOLTAGE,
 	CHANNELS(CHANNEL("Voltage value", voltage),
 		 CHANNEL("Sensing duration", time_exp_8)),
 };
-SENSOR_TYPE(output_current_range) = {
+SENSOR_TYPE(output_current_range, BT_MESH_PROP_ID_OUTPUT_CURRENT_RANGE) = {
 	.id = BT_MESH_PROP_ID_OUTPUT_CURRENT_RANGE,
 	CHANNELS(CHANNEL("Min", electric_current),
 		 CHANNEL("Max", electric_current)),
 };
-SENSOR_TYPE(output_current_stat) = {
+SENSOR_TYPE(output_current_stat, BT_MESH_PROP_ID_OUTPUT_CURRENT_STAT) = {
 	.id = BT_MESH_PROP_ID_OUTPUT_CURRENT_STAT,
 	.channel_count = ARRAY_SIZE(electric_current_stats),
 	.channels = electric_current_stats,
 };
-SENSOR_TYPE(output_ripple_voltage_spec) = {
+SENSOR_TYPE(output_ripple_voltage_spec,
+	    BT_MESH_PROP_ID_OUTPUT_RIPPLE_VOLTAGE_SPEC) = {
 	.id = BT_MESH_PROP_ID_OUTPUT_RIPPLE_VOLTAGE_SPEC,
 	CHANNELS(CHANNEL("Output ripple voltage", percentage_8)),
 };
-SENSOR_TYPE(output_voltage_range) = {
+SENSOR_TYPE(output_voltage_range, BT_MESH_PROP_ID_OUTPUT_VOLTAGE_RANGE) = {
 	.id = BT_MESH_PROP_ID_OUTPUT_VOLTAGE_RANGE,
 	CHANNELS(CHANNEL("Min", voltage),
 		 CHANNEL("Max", voltage)),
 };
-SENSOR_TYPE(output_voltage_stat) = {
+SENSOR_TYPE(output_voltage_stat, BT_MESH_PROP_ID_OUTPUT_VOLTAGE_STAT) = {
 	.id = BT_MESH_PROP_ID_OUTPUT_VOLTAGE_STAT,
 	.channel_count = ARRAY_SIZE(voltage_stats),
 	.channels = voltage_stats,
 };
-SENSOR_TYPE(present_output_current) = {
+SENSOR_TYPE(present_output_current, BT_MESH_PROP_ID_PRESENT_OUTPUT_CURRENT) = {
 	.id = BT_MESH_PROP_ID_PRESENT_OUTPUT_CURRENT,
 	CHANNELS(CHANNEL("Present output current", electric_current)),
 };
-SENSOR_TYPE(present_output_voltage) = {
+SENSOR_TYPE(present_output_voltage, BT_MESH_PROP_ID_PRESENT_OUTPUT_VOLTAGE) = {
 	.id = BT_MESH_PROP_ID_PRESENT_OUTPUT_VOLTAGE,
 	CHANNELS(CHANNEL("Present output voltage", voltage)),
 };
-SENSOR_TYPE(present_rel_output_ripple_voltage) = {
+SENSOR_TYPE(present_rel_output_ripple_voltage,
+	    BT_MESH_PROP_ID_PRESENT_REL_OUTPUT_RIPPLE_VOLTAGE) = {
 	.id = BT_MESH_PROP_ID_PRESENT_REL_OUTPUT_RIPPLE_VOLTAGE,
 	CHANNELS(CHANNEL("Output ripple voltage", percentage_8)),
 };
@@ -1188,11 +1234,12 @@ SENSOR_TYPE(present_rel_output_ripple_voltage) = {
 /*******************************************************************************
  * Warranty and service
  ******************************************************************************/
-SENSOR_TYPE(gain) = {
+SENSOR_TYPE(gain, BT_MESH_PROP_ID_SENSOR_GAIN) = {
 	.id = BT_MESH_PROP_ID_SENSOR_GAIN,
 	CHANNELS(CHANNEL("Sensor gain", coefficient)),
 };
-SENSOR_TYPE(rel_dev_runtime_in_a_generic_level_range) = {
+SENSOR_TYPE(rel_dev_runtime_in_a_generic_level_range,
+	    BT_MESH_PROP_ID_REL_DEV_RUNTIME_IN_A_GENERIC_LEVEL_RANGE) = {
 	.id = BT_MESH_PROP_ID_REL_DEV_RUNTIME_IN_A_GENERIC_LEVEL_RANGE,
 	.flags = BT_MESH_SENSOR_TYPE_FLAG_SERIES,
 	CHANNELS(CHANNEL("Relative value", percentage_8),
@@ -1204,10 +1251,27 @@ SENSOR_TYPE(rel_dev_runtime_in_a_generic_level_range) = {
 
 const struct bt_mesh_sensor_type *bt_mesh_sensor_type_get(uint16_t id)
 {
-	Z_STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+	extern const struct bt_mesh_sensor_type _bt_mesh_sensor_type_list_start[];
+	extern const struct bt_mesh_sensor_type _bt_mesh_sensor_type_list_end[];
+	size_t lo = 0;
+	size_t hi = _bt_mesh_sensor_type_list_end -
+		    _bt_mesh_sensor_type_list_start;
+
+	/* The sensor types are sorted by ID, see SENSOR_TYPE */
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		const struct bt_mesh_sensor_type *type =
+			&_bt_mesh_sensor_type_list_start[mid];
+
 		if (type->id == id) {
 			return type;
 		}
+
+		if (type->id < id) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
 	}
 
 	return NULL;
@@ -81,8 +81,8 @@ static void bt_conn_remote_update_ref(struct bt_conn *conn, int8_t value)
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	ser_encode_int(&ctx.encoder, value);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_REMOTE_UPDATE_REF_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_CONN_REMOTE_UPDATE_REF_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 static void bt_conn_ref_local(struct bt_conn *conn)
@@ -151,8 +151,10 @@ void bt_conn_foreach(int type, void (*func)(struct bt_conn *conn, void *data),
 	ser_encode_callback(&ctx.encoder, func);
 	ser_encode_uint(&ctx.encoder, (uintptr_t)data);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_FOREACH_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_CONN_FOREACH_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
+
+	cbkproxy_in_release(func);
 }
 
 struct bt_conn_lookup_addr_le_rpc_res {
@@ -182,8 +184,8 @@ struct bt_conn *bt_conn_lookup_addr_le(uint8_t id, const bt_addr_le_t *peer)
 	ser_encode_uint(&ctx.encoder, id);
 	ser_encode_buffer(&ctx.encoder, peer, sizeof(bt_addr_le_t));
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LOOKUP_ADDR_LE_RPC_CMD,
-				&ctx, bt_conn_lookup_addr_le_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_CONN_LOOKUP_ADDR_LE_RPC_CMD,
+			  &ctx, bt_conn_lookup_addr_le_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -215,8 +217,8 @@ static bool bt_conn_get_dst_out(const struct bt_conn *conn, bt_addr_le_t *dst)
 
 	result.dst = dst;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_GET_DST_OUT_RPC_CMD,
-				&ctx, bt_conn_get_dst_out_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_CONN_GET_DST_OUT_RPC_CMD,
+			  &ctx, bt_conn_get_dst_out_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -331,8 +333,8 @@ int bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info)
 	result.conn = (struct bt_conn *)conn;
 	result.info = info;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_GET_INFO_RPC_CMD,
-				&ctx, bt_conn_get_info_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_CONN_GET_INFO_RPC_CMD,
+			  &ctx, bt_conn_get_info_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -386,8 +388,8 @@ int bt_conn_get_remote_info(struct bt_conn *conn,
 	result.conn = conn;
 	result.remote_info = remote_info;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_GET_REMOTE_INFO_RPC_CMD,
-				&ctx, bt_conn_get_remote_info_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_CONN_GET_REMOTE_INFO_RPC_CMD,
+			  &ctx, bt_conn_get_remote_info_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -420,8 +422,8 @@ int bt_conn_le_param_update(struct bt_conn *conn,
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	bt_le_conn_param_enc(&ctx.encoder, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_PARAM_UPDATE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_CONN_LE_PARAM_UPDATE_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -446,8 +448,8 @@ int bt_conn_le_data_len_update(struct bt_conn *conn,
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	bt_conn_le_data_len_param_enc(&ctx.encoder, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_DATA_LEN_UPDATE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_CONN_LE_DATA_LEN_UPDATE_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -473,8 +475,8 @@ int bt_conn_le_phy_update(struct bt_conn *conn,
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	bt_conn_le_phy_param_enc(&ctx.encoder, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_PHY_UPDATE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_CONN_LE_PHY_UPDATE_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -492,8 +494,8 @@ int bt_conn_disconnect(struct bt_conn *conn, uint8_t reason)
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	ser_encode_uint(&ctx.encoder, reason);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_DISCONNECT_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_CONN_DISCONNECT_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -545,8 +547,8 @@ int bt_conn_le_create(const bt_addr_le_t *peer,
 
 	result.conn = conn;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_CREATE_RPC_CMD,
-				&ctx, bt_conn_le_create_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_CONN_LE_CREATE_RPC_CMD,
+			  &ctx, bt_conn_le_create_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -564,8 +566,8 @@ int bt_conn_le_create_auto(const struct bt_conn_le_create_param *create_param,
 	bt_conn_le_create_param_enc(&ctx.encoder, create_param);
 	bt_le_conn_param_enc(&ctx.encoder, conn_param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_LE_CREATE_AUTO_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_CONN_LE_CREATE_AUTO_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -578,8 +580,8 @@ int bt_conn_create_auto_stop(void)
 
 	NRF_RPC_CBOR_ALLOC(ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CREATE_AUTO_STOP_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_CONN_CREATE_AUTO_STOP_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -605,8 +607,8 @@ int bt_le_set_auto_conn(const bt_addr_le_t *addr,
 		bt_le_conn_param_enc(&ctx.encoder, param);
 	}
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SET_AUTO_CONN_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_SET_AUTO_CONN_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -625,8 +627,8 @@ int bt_conn_set_security(struct bt_conn *conn, bt_security_t sec)
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	ser_encode_uint(&ctx.encoder, (uint32_t)sec);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_SET_SECURITY_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_CONN_SET_SECURITY_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -654,8 +656,8 @@ bt_security_t bt_conn_get_security(struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_GET_SECURITY_RPC_CMD,
-				&ctx, bt_conn_get_security_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_CONN_GET_SECURITY_RPC_CMD,
+			  &ctx, bt_conn_get_security_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -670,8 +672,8 @@ uint8_t bt_conn_enc_key_size(struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_ENC_KEY_SIZE_RPC_CMD,
-				&ctx, ser_rsp_decode_u8, &result);
+	bt_rpc_cmd_no_err(BT_CONN_ENC_KEY_SIZE_RPC_CMD,
+			  &ctx, ser_rsp_decode_u8, &result);
 
 	return result;
 }
@@ -1043,8 +1045,8 @@ static void bt_conn_cb_register_on_remote(void)
 
 	NRF_RPC_CBOR_ALLOC(ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CB_REGISTER_ON_REMOTE_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_CONN_CB_REGISTER_ON_REMOTE_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_conn_cb_register(struct bt_conn_cb *cb)
@@ -1072,8 +1074,8 @@ void bt_set_bondable(bool enable)
 
 	ser_encode_bool(&ctx.encoder, enable);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_SET_BONDABLE_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_SET_BONDABLE_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_set_oob_data_flag(bool enable)
@@ -1085,8 +1087,8 @@ void bt_set_oob_data_flag(bool enable)
 
 	ser_encode_bool(&ctx.encoder, enable);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_SET_OOB_DATA_FLAG_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_SET_OOB_DATA_FLAG_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 #if !defined(CONFIG_BT_SMP_SC_PAIR_ONLY)
@@ -1109,8 +1111,8 @@ int bt_le_oob_set_legacy_tk(struct bt_conn *conn, const uint8_t *tk)
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	ser_encode_buffer(&ctx.encoder, tk, tk_size);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_OOB_SET_LEGACY_TK_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_OOB_SET_LEGACY_TK_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1164,8 +1166,8 @@ int bt_le_oob_set_sc_data(struct bt_conn *conn,
 		bt_le_oob_sc_data_enc(&ctx.encoder, oobd_remote);
 	}
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_OOB_SET_SC_DATA_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_OOB_SET_SC_DATA_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1217,8 +1219,8 @@ int bt_le_oob_get_sc_data(struct bt_conn *conn,
 	result.oobd_local = oobd_local;
 	result.oobd_remote = oobd_remote;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_OOB_GET_SC_DATA_RPC_CMD,
-				&ctx, bt_le_oob_get_sc_data_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_LE_OOB_GET_SC_DATA_RPC_CMD,
+			  &ctx, bt_le_oob_get_sc_data_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -1235,8 +1237,8 @@ int bt_passkey_set(unsigned int passkey)
 
 	ser_encode_uint(&ctx.encoder, passkey);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_PASSKEY_SET_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_PASSKEY_SET_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1514,8 +1516,8 @@ int bt_conn_auth_cb_register_on_remote(uint16_t flags)
 
 	ser_encode_uint(&ctx.encoder, flags);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_CB_REGISTER_ON_REMOTE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_CONN_AUTH_CB_REGISTER_ON_REMOTE_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1557,8 +1559,8 @@ int bt_conn_auth_passkey_entry(struct bt_conn *conn, unsigned int passkey)
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	ser_encode_uint(&ctx.encoder, passkey);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_PASSKEY_ENTRY_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_CONN_AUTH_PASSKEY_ENTRY_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1573,8 +1575,8 @@ int bt_conn_auth_cancel(struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_CANCEL_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_CONN_AUTH_CANCEL_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1589,8 +1591,8 @@ int bt_conn_auth_passkey_confirm(struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_PASSKEY_CONFIRM_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_CONN_AUTH_PASSKEY_CONFIRM_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1605,8 +1607,8 @@ int bt_conn_auth_pairing_confirm(struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_AUTH_PAIRING_CONFIRM_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_CONN_AUTH_PAIRING_CONFIRM_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -55,8 +55,8 @@ static void bt_rpc_get_check_list(uint8_t *data, size_t size)
 	result.size = size;
 	result.data = data;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GET_CHECK_LIST_RPC_CMD,
-				&ctx, bt_rpc_get_check_list_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_RPC_GET_CHECK_LIST_RPC_CMD,
+			  &ctx, bt_rpc_get_check_list_rpc_rsp, &result);
 }
 
 static void validate_config(void)
@@ -89,6 +89,9 @@ static void bt_ready_cb_t_callback_rpc_handler(CborValue *value, void *handler_d
 
 	callback_slot(err);
 
+	/* The ready callback is called only once */
+	cbkproxy_in_release(callback_slot);
+
 	return;
 decoding_error:
 	report_decoding_error(BT_READY_CB_T_CALLBACK_RPC_EVT, handler_data);
@@ -110,8 +113,12 @@ int bt_enable(bt_ready_cb_t cb)
 
 	ser_encode_callback(&ctx.encoder, cb);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ENABLE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_ENABLE_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
+
+	if (result) {
+		cbkproxy_in_release(cb);
+	}
 
 	return result;
 }
@@ -135,8 +142,8 @@ int bt_set_name(const char *name)
 
 	ser_encode_str(&ctx.encoder, name, name_strlen);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_SET_NAME_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_SET_NAME_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 #else
@@ -178,8 +185,8 @@ static bool bt_get_name_out(char *name, size_t size)
 	result.size = size;
 	result.name = name;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_GET_NAME_OUT_RPC_CMD,
-				&ctx, bt_get_name_out_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_GET_NAME_OUT_RPC_CMD,
+			  &ctx, bt_get_name_out_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -232,8 +239,8 @@ void bt_id_get(bt_addr_le_t *addrs, size_t *count)
 	result.count = count;
 	result.addrs = addrs;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ID_GET_RPC_CMD,
-				&ctx, bt_id_get_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_ID_GET_RPC_CMD,
+			  &ctx, bt_id_get_rpc_rsp, &result);
 }
 
 struct bt_id_create_rpc_res {
@@ -275,8 +282,8 @@ int bt_id_create(bt_addr_le_t *addr, uint8_t *irk)
 	result.addr = addr;
 	result.irk = irk;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ID_CREATE_RPC_CMD,
-				&ctx, bt_id_create_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_ID_CREATE_RPC_CMD,
+			  &ctx, bt_id_create_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -321,8 +328,8 @@ int bt_id_reset(uint8_t id, bt_addr_le_t *addr, uint8_t *irk)
 	result.addr = addr;
 	result.irk = irk;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ID_RESET_RPC_CMD,
-				&ctx, bt_id_reset_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_ID_RESET_RPC_CMD,
+			  &ctx, bt_id_reset_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -337,8 +344,8 @@ int bt_id_delete(uint8_t id)
 
 	ser_encode_uint(&ctx.encoder, id);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_ID_DELETE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_ID_DELETE_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -380,13 +387,23 @@ void bt_le_scan_param_enc(CborEncoder *encoder, const struct bt_le_scan_param *d
 	ser_encode_uint(encoder, data->window_coded);
 }
 
+/* With SER_DECODE_IN_PLACE, the buffer data is not copied, so the received
+ * packet must be released only after the buffer is processed.
+ */
 void net_buf_simple_dec(struct ser_scratchpad *scratchpad, struct net_buf_simple *data)
 {
 	CborValue *value = scratchpad->value;
+	size_t len;
 
-	data->len = ser_decode_buffer_size(value);
-	data->data = ser_decode_buffer_into_scratchpad(scratchpad);
-	data->size = data->len;
+	if (SER_DECODE_IN_PLACE) {
+		data->data = (uint8_t *)ser_decode_buffer_in_place(value, &len);
+	} else {
+		len = ser_decode_buffer_size(value);
+		data->data = ser_decode_buffer_into_scratchpad(scratchpad);
+	}
+
+	data->len = len;
+	data->size = len;
 	data->__buf = data->data;
 }
 
@@ -409,12 +426,21 @@ static void bt_le_scan_cb_t_callback_rpc_handler(CborValue *value, void *handler
 	net_buf_simple_dec(&scratchpad, &buf);
 	callback_slot = (bt_le_scan_cb_t *)ser_decode_callback_call(value);
 
-	if (!ser_decoding_done_and_check(value)) {
+	if (!ser_decode_valid(value)) {
+		ser_decoding_done_and_check(value);
 		goto decoding_error;
 	}
 
+	if (!SER_DECODE_IN_PLACE) {
+		ser_decoding_done_and_check(value);
+	}
+
 	callback_slot(addr, rssi, adv_type, &buf);
 
+	if (SER_DECODE_IN_PLACE) {
+		ser_decoding_done_and_check(value);
+	}
+
 	ser_rsp_send_void();
 
 	return;
@@ -495,8 +521,8 @@ int bt_le_adv_start(const struct bt_le_adv_param *param,
 		bt_data_enc(&ctx.encoder, &sd[i]);
 	}
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_ADV_START_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_ADV_START_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -535,8 +561,8 @@ int bt_le_adv_update_data(const struct bt_data *ad, size_t ad_len,
 		bt_data_enc(&ctx.encoder, &sd[i]);
 	}
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_ADV_UPDATE_DATA_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_ADV_UPDATE_DATA_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -549,8 +575,8 @@ int bt_le_adv_stop(void)
 
 	NRF_RPC_CBOR_ALLOC(ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_ADV_STOP_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_ADV_STOP_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -669,6 +695,21 @@ NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, bt_le_ext_adv_cb_scanned_callback,
 
 static const size_t bt_le_ext_adv_cb_buf_size = 15;
 
+/* Callbacks of the created advertising sets, released when a set is deleted */
+static struct {
+	struct bt_le_ext_adv *adv;
+	const struct bt_le_ext_adv_cb *cb;
+} ext_adv_cbs[CONFIG_BT_EXT_ADV_MAX_ADV_SET];
+
+static void bt_le_ext_adv_cb_release(const struct bt_le_ext_adv_cb *cb)
+{
+	if (cb) {
+		cbkproxy_in_release(cb->sent);
+		cbkproxy_in_release(cb->connected);
+		cbkproxy_in_release(cb->scanned);
+	}
+}
+
 void bt_le_ext_adv_cb_enc(CborEncoder *encoder, const struct bt_le_ext_adv_cb *data)
 {
 	ser_encode_callback(encoder, data->sent);
@@ -718,8 +759,20 @@ int bt_le_ext_adv_create(const struct bt_le_adv_param *param,
 
 	result.adv = adv;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_CREATE_RPC_CMD,
-				&ctx, bt_le_ext_adv_create_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_LE_EXT_ADV_CREATE_RPC_CMD,
+			  &ctx, bt_le_ext_adv_create_rpc_rsp, &result);
+
+	if (result.result == 0) {
+		for (size_t i = 0; i < ARRAY_SIZE(ext_adv_cbs); i++) {
+			if (!ext_adv_cbs[i].adv) {
+				ext_adv_cbs[i].adv = *adv;
+				ext_adv_cbs[i].cb = cb;
+				break;
+			}
+		}
+	} else {
+		bt_le_ext_adv_cb_release(cb);
+	}
 
 	return result.result;
 }
@@ -743,8 +796,8 @@ int bt_le_ext_adv_start(struct bt_le_ext_adv *adv,
 	ser_encode_uint(&ctx.encoder, (uintptr_t)adv);
 	bt_le_ext_adv_start_param_enc(&ctx.encoder, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_START_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_EXT_ADV_START_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -760,8 +813,8 @@ int bt_le_ext_adv_stop(struct bt_le_ext_adv *adv)
 
 	ser_encode_uint(&ctx.encoder, (uintptr_t)adv);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_STOP_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_EXT_ADV_STOP_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -803,8 +856,8 @@ int bt_le_ext_adv_set_data(struct bt_le_ext_adv *adv,
 		bt_data_enc(&ctx.encoder, &sd[i]);
 	}
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_SET_DATA_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_EXT_ADV_SET_DATA_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -827,8 +880,8 @@ int bt_le_ext_adv_update_param(struct bt_le_ext_adv *adv,
 	ser_encode_uint(&ctx.encoder, (uintptr_t)adv);
 	bt_le_adv_param_enc(&ctx.encoder, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_UPDATE_PARAM_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_EXT_ADV_UPDATE_PARAM_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -843,8 +896,21 @@ int bt_le_ext_adv_delete(struct bt_le_ext_adv *adv)
 
 	ser_encode_uint(&ctx.encoder, (uintptr_t)adv);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_DELETE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_EXT_ADV_DELETE_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
+
+	if (result) {
+		return result;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(ext_adv_cbs); i++) {
+		if (ext_adv_cbs[i].adv == adv) {
+			bt_le_ext_adv_cb_release(ext_adv_cbs[i].cb);
+			ext_adv_cbs[i].adv = NULL;
+			ext_adv_cbs[i].cb = NULL;
+			break;
+		}
+	}
 
 	return result;
 }
@@ -859,8 +925,8 @@ uint8_t bt_le_ext_adv_get_index(struct bt_le_ext_adv *adv)
 
 	ser_encode_uint(&ctx.encoder, (uintptr_t)adv);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_GET_INDEX_RPC_CMD,
-				&ctx, ser_rsp_decode_u8, &result);
+	bt_rpc_cmd_no_err(BT_LE_EXT_ADV_GET_INDEX_RPC_CMD,
+			  &ctx, ser_rsp_decode_u8, &result);
 
 	return result;
 }
@@ -884,8 +950,8 @@ int bt_le_ext_adv_get_info(const struct bt_le_ext_adv *adv,
 	ser_encode_uint(&ctx.encoder, (uintptr_t)adv);
 	bt_le_ext_adv_info_enc(&ctx.encoder, info);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_GET_INFO_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_EXT_ADV_GET_INFO_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -917,8 +983,8 @@ int bt_le_ext_adv_oob_get_local(struct bt_le_ext_adv *adv,
 
 	result.oob = oob;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_OOB_GET_LOCAL_RPC_CMD,
-				&ctx, bt_le_ext_adv_oob_get_local_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_LE_EXT_ADV_OOB_GET_LOCAL_RPC_CMD,
+			  &ctx, bt_le_ext_adv_oob_get_local_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -945,8 +1011,8 @@ int bt_le_per_adv_set_param(struct bt_le_ext_adv *adv,
 	ser_encode_uint(&ctx.encoder, (uintptr_t)adv);
 	bt_le_per_adv_param_enc(&ctx.encoder, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SET_PARAM_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_SET_PARAM_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -974,8 +1040,8 @@ int bt_le_per_adv_set_data(const struct bt_le_ext_adv *adv,
 		bt_data_enc(&ctx.encoder, &ad[i]);
 	}
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SET_DATA_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_SET_DATA_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -990,8 +1056,8 @@ int bt_le_per_adv_start(struct bt_le_ext_adv *adv)
 
 	ser_encode_uint(&ctx.encoder, (uintptr_t)adv);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_START_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_START_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1006,8 +1072,8 @@ int bt_le_per_adv_stop(struct bt_le_ext_adv *adv)
 
 	ser_encode_uint(&ctx.encoder, (uintptr_t)adv);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_STOP_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_STOP_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1027,8 +1093,8 @@ int bt_le_per_adv_set_info_transfer(const struct bt_le_ext_adv *adv,
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	ser_encode_uint(&ctx.encoder, service_data);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SET_INFO_TRANSFER_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_SET_INFO_TRANSFER_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1046,8 +1112,8 @@ uint8_t bt_le_per_adv_sync_get_index(struct bt_le_per_adv_sync *per_adv_sync)
 
 	ser_encode_uint(&ctx.encoder, (uintptr_t)per_adv_sync);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_GET_INDEX_RPC_CMD,
-				&ctx, ser_rsp_decode_u8, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_SYNC_GET_INDEX_RPC_CMD,
+			  &ctx, ser_rsp_decode_u8, &result);
 
 	return result;
 }
@@ -1100,8 +1166,8 @@ int bt_le_per_adv_sync_create(const struct bt_le_per_adv_sync_param *param,
 
 	result.out_sync = out_sync;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_CREATE_RPC_CMD,
-				&ctx, bt_le_per_adv_sync_create_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_SYNC_CREATE_RPC_CMD,
+			  &ctx, bt_le_per_adv_sync_create_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -1116,8 +1182,8 @@ int bt_le_per_adv_sync_delete(struct bt_le_per_adv_sync *per_adv_sync)
 
 	ser_encode_uint(&ctx.encoder, (uintptr_t)per_adv_sync);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_DELETE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_SYNC_DELETE_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1131,8 +1197,8 @@ void bt_le_per_adv_sync_cb_register_on_remote(void)
 
 	NRF_RPC_CBOR_ALLOC(ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_CB_REGISTER_ON_REMOTE_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_SYNC_CB_REGISTER_ON_REMOTE_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_le_per_adv_sync_cb_register(struct bt_le_per_adv_sync_cb *cb)
@@ -1158,8 +1224,8 @@ int bt_le_per_adv_sync_recv_enable(struct bt_le_per_adv_sync *per_adv_sync)
 
 	ser_encode_uint(&ctx.encoder, (uintptr_t)per_adv_sync);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_RECV_ENABLE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_SYNC_RECV_ENABLE_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1174,8 +1240,8 @@ int bt_le_per_adv_sync_recv_disable(struct bt_le_per_adv_sync *per_adv_sync)
 
 	ser_encode_uint(&ctx.encoder, (uintptr_t)per_adv_sync);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_RECV_DISABLE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_SYNC_RECV_DISABLE_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1195,8 +1261,8 @@ int bt_le_per_adv_sync_transfer(const struct bt_le_per_adv_sync *per_adv_sync,
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	ser_encode_uint(&ctx.encoder, service_data);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_TRANSFER_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_SYNC_TRANSFER_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1222,8 +1288,8 @@ int bt_le_per_adv_sync_transfer_subscribe(
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	bt_le_per_adv_sync_transfer_param_enc(&ctx.encoder, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_TRANSFER_SUBSCRIBE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_SYNC_TRANSFER_SUBSCRIBE_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1238,8 +1304,8 @@ int bt_le_per_adv_sync_transfer_unsubscribe(const struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_SYNC_TRANSFER_UNSUBSCRIBE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_SYNC_TRANSFER_UNSUBSCRIBE_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1258,8 +1324,8 @@ int bt_le_per_adv_list_add(const bt_addr_le_t *addr, uint8_t sid)
 	ser_encode_buffer(&ctx.encoder, addr, sizeof(bt_addr_le_t));
 	ser_encode_uint(&ctx.encoder, sid);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_LIST_ADD_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_LIST_ADD_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1277,8 +1343,8 @@ int bt_le_per_adv_list_remove(const bt_addr_le_t *addr, uint8_t sid)
 	ser_encode_buffer(&ctx.encoder, addr, sizeof(bt_addr_le_t));
 	ser_encode_uint(&ctx.encoder, sid);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_LIST_REMOVE_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_LIST_REMOVE_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1291,8 +1357,8 @@ int bt_le_per_adv_list_clear(void)
 
 	NRF_RPC_CBOR_ALLOC(ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_PER_ADV_LIST_CLEAR_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_PER_ADV_LIST_CLEAR_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1445,12 +1511,21 @@ static void per_adv_sync_cb_recv_rpc_handler(CborValue *value, void *handler_dat
 	bt_le_per_adv_sync_recv_info_dec(&scratchpad, &info);
 	net_buf_simple_dec(&scratchpad, &buf);
 
-	if (!ser_decoding_done_and_check(value)) {
+	if (!ser_decode_valid(value)) {
+		ser_decoding_done_and_check(value);
 		goto decoding_error;
 	}
 
+	if (!SER_DECODE_IN_PLACE) {
+		ser_decoding_done_and_check(value);
+	}
+
 	per_adv_sync_cb_recv(sync, &info, &buf);
 
+	if (SER_DECODE_IN_PLACE) {
+		ser_decoding_done_and_check(value);
+	}
+
 	ser_rsp_send_void();
 
 	return;
@@ -1500,6 +1575,9 @@ NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, per_adv_sync_cb_state_changed,
 #endif /* defined(CONFIG_BT_PER_ADV_SYNC) */
 
 #if defined(CONFIG_BT_OBSERVER)
+/* Scan callback, released when scanning is stopped */
+static bt_le_scan_cb_t *scan_cb;
+
 int bt_le_scan_start(const struct bt_le_scan_param *param, bt_le_scan_cb_t cb)
 {
 	struct nrf_rpc_cbor_ctx ctx;
@@ -1513,8 +1591,14 @@ int bt_le_scan_start(const struct bt_le_scan_param *param, bt_le_scan_cb_t cb)
 	bt_le_scan_param_enc(&ctx.encoder, param);
 	ser_encode_callback(&ctx.encoder, cb);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SCAN_START_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_SCAN_START_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
+
+	if (result) {
+		cbkproxy_in_release(cb);
+	} else {
+		scan_cb = cb;
+	}
 
 	return result;
 }
@@ -1527,8 +1611,13 @@ int bt_le_scan_stop(void)
 
 	NRF_RPC_CBOR_ALLOC(ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SCAN_STOP_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_SCAN_STOP_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
+
+	if (result == 0) {
+		cbkproxy_in_release(scan_cb);
+		scan_cb = NULL;
+	}
 
 	return result;
 }
@@ -1576,12 +1665,21 @@ static void bt_le_scan_cb_recv_rpc_handler(CborValue *value, void *handler_data)
 	bt_le_scan_recv_info_dec(&scratchpad, &info);
 	net_buf_simple_dec(&scratchpad, &buf);
 
-	if (!ser_decoding_done_and_check(value)) {
+	if (!ser_decode_valid(value)) {
+		ser_decoding_done_and_check(value);
 		goto decoding_error;
 	}
 
+	if (!SER_DECODE_IN_PLACE) {
+		ser_decoding_done_and_check(value);
+	}
+
 	bt_le_scan_cb_recv(&info, &buf);
 
+	if (SER_DECODE_IN_PLACE) {
+		ser_decoding_done_and_check(value);
+	}
+
 	ser_rsp_send_void();
 
 	return;
@@ -1620,8 +1718,8 @@ static void bt_le_scan_cb_register_on_remote(void)
 
 	NRF_RPC_CBOR_ALLOC(ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SCAN_CB_REGISTER_ON_REMOTE_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_LE_SCAN_CB_REGISTER_ON_REMOTE_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_le_scan_cb_register(struct bt_le_scan_cb *cb)
@@ -1651,8 +1749,8 @@ int bt_le_whitelist_add(const bt_addr_le_t *addr)
 
 	ser_encode_buffer(&ctx.encoder, addr, sizeof(bt_addr_le_t));
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_WHITELIST_ADD_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_WHITELIST_ADD_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1670,8 +1768,8 @@ int bt_le_whitelist_rem(const bt_addr_le_t *addr)
 
 	ser_encode_buffer(&ctx.encoder, addr, sizeof(bt_addr_le_t));
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_WHITELIST_REM_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_WHITELIST_REM_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1685,8 +1783,8 @@ int bt_le_whitelist_clear(void)
 
 	NRF_RPC_CBOR_ALLOC(ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_WHITELIST_CLEAR_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_WHITELIST_CLEAR_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1710,8 +1808,8 @@ int bt_le_set_chan_map(uint8_t chan_map[5])
 
 	ser_encode_buffer(&ctx.encoder, chan_map, chan_map_size);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SET_CHAN_MAP_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_LE_SET_CHAN_MAP_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1773,8 +1871,8 @@ int bt_le_oob_get_local(uint8_t id, struct bt_le_oob *oob)
 
 	result.oob = oob;
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_OOB_GET_LOCAL_RPC_CMD,
-				&ctx, bt_le_oob_get_local_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_LE_OOB_GET_LOCAL_RPC_CMD,
+			  &ctx, bt_le_oob_get_local_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -1846,8 +1944,8 @@ int bt_unpair(uint8_t id, const bt_addr_le_t *addr)
 	ser_encode_uint(&ctx.encoder, id);
 	ser_encode_buffer(&ctx.encoder, addr, sizeof(bt_addr_le_t));
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_UNPAIR_RPC_CMD,
-				&ctx, ser_rsp_decode_i32, &result);
+	bt_rpc_cmd_no_err(BT_UNPAIR_RPC_CMD,
+			  &ctx, ser_rsp_decode_i32, &result);
 
 	return result;
 }
@@ -1899,7 +1997,9 @@ void bt_foreach_bond(uint8_t id, void (*func)(const struct bt_bond_info *info,
 	ser_encode_callback(&ctx.encoder, func);
 	ser_encode_uint(&ctx.encoder, (uintptr_t)user_data);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_FOREACH_BOND_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_FOREACH_BOND_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
+
+	cbkproxy_in_release(func);
 }
 #endif /* (defined(CONFIG_BT_CONN) && defined(CONFIG_BT_SMP)) */
@@ -49,6 +49,20 @@ static int serialization_init(const struct device *dev)
 SYS_INIT(serialization_init, POST_KERNEL, CONFIG_APPLICATION_INIT_PRIORITY);
 #endif /* CONFIG_BT_RPC_INITIALIZE_NRF_RPC */
 
+void bt_rpc_cmd_no_err(uint8_t cmd, struct nrf_rpc_cbor_ctx *ctx,
+		       nrf_rpc_cbor_handler_t handler, void *handler_data)
+{
+#if defined(CONFIG_BT_RPC_LATENCY_STATS)
+	uint32_t start = k_cycle_get_32();
+
+	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, cmd, ctx, handler, handler_data);
+
+	bt_rpc_latency_record(cmd, k_cycle_get_32() - start);
+#else
+	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, cmd, ctx, handler, handler_data);
+#endif
+}
+
 enum {
 	CHECK_ENTRY_FLAGS,
 	CHECK_ENTRY_UINT,
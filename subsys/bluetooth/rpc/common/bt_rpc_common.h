@@ -102,6 +102,8 @@ enum bt_rpc_cmd_from_cli_to_host {
 	BT_CONN_FOREACH_RPC_CMD,
 	BT_CONN_LOOKUP_ADDR_LE_RPC_CMD,
 	BT_CONN_GET_DST_OUT_RPC_CMD,
+	/* Number of client commands, must be the last entry */
+	BT_RPC_CMD_FROM_CLI_TO_HOST_CNT,
 };
 
 /** @brief Host commands IDs used in bluetooth API serialization.
@@ -141,6 +143,8 @@ enum bt_rpc_cmd_from_host_to_cli {
 	BT_RPC_AUTH_CB_PAIRING_COMPLETE_RPC_CMD,
 	BT_RPC_AUTH_CB_PAIRING_FAILED_RPC_CMD,
 	BT_CONN_FOREACH_CB_CALLBACK_RPC_CMD,
+	/* Number of host commands, must be the last entry */
+	BT_RPC_CMD_FROM_HOST_TO_CLI_CNT,
 };
 
 /** @brief Host events IDs used in bluetooth API serialization.
@@ -183,6 +187,66 @@ typedef void (*bt_le_ext_adv_cb_scanned)(struct bt_le_ext_adv *adv,
 
 NRF_RPC_GROUP_DECLARE(bt_rpc_grp);
 
+/** @brief Send a Bluetooth RPC command and wait for the response.
+ *
+ * Sends the command in the Bluetooth RPC group the same way as
+ * nrf_rpc_cbor_cmd_no_err(). If @option{CONFIG_BT_RPC_LATENCY_STATS} is
+ * enabled, the round-trip time of the command is recorded.
+ *
+ * @param[in] cmd Command ID.
+ * @param[in, out] ctx Context allocated with NRF_RPC_CBOR_ALLOC.
+ * @param[in] handler Response handler.
+ * @param[in] handler_data Opaque pointer passed to the response handler.
+ */
+void bt_rpc_cmd_no_err(uint8_t cmd, struct nrf_rpc_cbor_ctx *ctx,
+		       nrf_rpc_cbor_handler_t handler, void *handler_data);
+
+#if defined(CONFIG_BT_RPC_LATENCY_STATS)
+/** @brief Round-trip latency statistics of a command. */
+struct bt_rpc_latency_stats {
+	/** Number of recorded round trips. */
+	uint32_t cnt;
+	/** Longest round trip, in microseconds. */
+	uint32_t max_us;
+	/** Sum of all round trips, in microseconds. */
+	uint64_t total_us;
+	/** Number of round trips in each histogram bucket, see
+	 *  @ref bt_rpc_latency_bucket_bound.
+	 */
+	uint32_t buckets[CONFIG_BT_RPC_LATENCY_STATS_BUCKETS];
+};
+
+/** @brief Record the round-trip time of a command sent to the remote core.
+ *
+ * @param[in] cmd Command ID.
+ * @param[in] cycles Time from sending the command until its response was
+ *                   handled, in hardware clock cycles.
+ */
+void bt_rpc_latency_record(uint8_t cmd, uint32_t cycles);
+
+/** @brief Get the round-trip latency statistics of a command.
+ *
+ * @param[in] cmd Command ID.
+ * @param[out] stats Statistics of the command.
+ *
+ * @retval 0 The statistics were copied to @p stats.
+ * @retval -EINVAL The command ID is out of range.
+ */
+int bt_rpc_latency_get(uint8_t cmd, struct bt_rpc_latency_stats *stats);
+
+/** @brief Reset the round-trip latency statistics of all commands. */
+void bt_rpc_latency_reset(void);
+
+/** @brief Get the upper bound of a latency histogram bucket.
+ *
+ * @param[in] bucket Bucket index.
+ *
+ * @return Exclusive upper bound of the bucket in microseconds, or
+ *         UINT32_MAX for the last bucket, which has no upper bound.
+ */
+uint32_t bt_rpc_latency_bucket_bound(size_t bucket);
+#endif
+
 #if defined(CONFIG_BT_RPC_HOST)
 /** @brief Read configuration "check list" from the host.
  *
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <shell/shell.h>
+
+#include "bt_rpc_common.h"
+
+#if defined(CONFIG_BT_RPC_CLIENT)
+#define CMD_CNT BT_RPC_CMD_FROM_CLI_TO_HOST_CNT
+#else
+#define CMD_CNT BT_RPC_CMD_FROM_HOST_TO_CLI_CNT
+#endif
+
+/* Upper bound of the first histogram bucket. Each next bucket is twice as
+ * wide, the last one has no upper bound.
+ */
+#define BUCKET_FIRST_US CONFIG_BT_RPC_LATENCY_STATS_BUCKET_FIRST_US
+#define BUCKET_CNT CONFIG_BT_RPC_LATENCY_STATS_BUCKETS
+
+static struct bt_rpc_latency_stats latency_stats[CMD_CNT];
+
+static size_t bucket_get(uint32_t us)
+{
+	size_t i = 0;
+	uint64_t bound = BUCKET_FIRST_US;
+
+	while ((us >= bound) && (i < BUCKET_CNT - 1)) {
+		bound <<= 1;
+		i++;
+	}
+
+	return i;
+}
+
+void bt_rpc_latency_record(uint8_t cmd, uint32_t cycles)
+{
+	struct bt_rpc_latency_stats *stats;
+	uint32_t us = k_cyc_to_us_floor32(cycles);
+	unsigned int key;
+
+	if (cmd >= ARRAY_SIZE(latency_stats)) {
+		return;
+	}
+
+	stats = &latency_stats[cmd];
+
+	key = irq_lock();
+
+	stats->cnt++;
+	stats->total_us += us;
+	stats->max_us = MAX(stats->max_us, us);
+	stats->buckets[bucket_get(us)]++;
+
+	irq_unlock(key);
+}
+
+int bt_rpc_latency_get(uint8_t cmd, struct bt_rpc_latency_stats *stats)
+{
+	unsigned int key;
+
+	if (cmd >= ARRAY_SIZE(latency_stats)) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+	*stats = latency_stats[cmd];
+	irq_unlock(key);
+
+	return 0;
+}
+
+void bt_rpc_latency_reset(void)
+{
+	unsigned int key = irq_lock();
+
+	memset(latency_stats, 0, sizeof(latency_stats));
+	irq_unlock(key);
+}
+
+uint32_t bt_rpc_latency_bucket_bound(size_t bucket)
+{
+	if (bucket >= BUCKET_CNT - 1) {
+		return UINT32_MAX;
+	}
+
+	return MIN((uint64_t)BUCKET_FIRST_US << bucket, UINT32_MAX);
+}
+
+#if defined(CONFIG_SHELL)
+static int show_latency(const struct shell *shell, size_t argc, char **argv)
+{
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "Command latency (count, avg/max [us], histogram):\n");
+	shell_fprintf(shell, SHELL_NORMAL, "\t\t\t");
+
+	for (size_t i = 0; i < BUCKET_CNT - 1; i++) {
+		shell_fprintf(shell, SHELL_NORMAL, "<%u\t",
+			      bt_rpc_latency_bucket_bound(i));
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, ">=%u\n",
+		      bt_rpc_latency_bucket_bound(BUCKET_CNT - 2));
+
+	for (uint32_t cmd = 0; cmd < ARRAY_SIZE(latency_stats); cmd++) {
+		struct bt_rpc_latency_stats stats;
+
+		(void)bt_rpc_latency_get(cmd, &stats);
+
+		if (stats.cnt == 0) {
+			continue;
+		}
+
+		shell_fprintf(shell, SHELL_NORMAL, "%u:\t%u\t%u/%u\t",
+			      cmd, stats.cnt,
+			      (uint32_t)(stats.total_us / stats.cnt),
+			      stats.max_us);
+
+		for (size_t i = 0; i < BUCKET_CNT; i++) {
+			shell_fprintf(shell, SHELL_NORMAL, "%u%c",
+				      stats.buckets[i],
+				      (i < BUCKET_CNT - 1) ? '\t' : '\n');
+		}
+	}
+
+	return 0;
+}
+
+static int reset_latency(const struct shell *shell, size_t argc, char **argv)
+{
+	bt_rpc_latency_reset();
+
+	shell_fprintf(shell, SHELL_NORMAL, "Command latency reset\n");
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_bt_rpc,
+	SHELL_CMD_ARG(show_latency, NULL,
+		      "Show round-trip latency of sent commands",
+		      show_latency, 0, 0),
+	SHELL_CMD_ARG(reset_latency, NULL,
+		      "Reset round-trip latency of sent commands",
+		      reset_latency, 0, 0),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(bt_rpc, &sub_bt_rpc, "Bluetooth over RPC commands", NULL);
+#endif /* CONFIG_SHELL */
@@ -11,8 +11,6 @@
 
 #include "cbkproxy.h"
 
-static K_MUTEX_DEFINE(mutex);
-
 #if CONFIG_CBKPROXY_OUT_SLOTS > 0
 
 #if CONFIG_CBKPROXY_OUT_SLOTS > 16383
@@ -43,8 +41,15 @@ static K_MUTEX_DEFINE(mutex);
 #define TABLE_ENTRY4096 TABLE_ENTRY2048 TABLE_ENTRY2048
 #define TABLE_ENTRY8192 TABLE_ENTRY4096 TABLE_ENTRY4096
 
+static struct k_spinlock out_lock;
+
 static void *out_callbacks[CONFIG_CBKPROXY_OUT_SLOTS];
 
+/* Number of references to each output slot. A slot with no references can be
+ * bound to another handler.
+ */
+static uint32_t out_ref_cnt[CONFIG_CBKPROXY_OUT_SLOTS];
+
 __attribute__((naked))
 static void callback_jump_table_start(void)
 {
@@ -114,83 +119,231 @@ static void callback_jump_table_start(void)
 void *cbkproxy_out_get(int index, void *handler)
 {
 	uint32_t addr;
+	k_spinlock_key_t key;
 
 	if (index >= CONFIG_CBKPROXY_OUT_SLOTS || index < 0) {
 		return NULL;
-	} else if (!out_callbacks[index]) {
+	}
+
+	key = k_spin_lock(&out_lock);
+
+	if (out_ref_cnt[index] == 0) {
 		out_callbacks[index] = handler;
 	} else if (out_callbacks[index] != handler) {
+		k_spin_unlock(&out_lock, key);
 		return NULL;
 	}
 
+	out_ref_cnt[index]++;
+
+	k_spin_unlock(&out_lock, key);
+
 	addr = (uint32_t)(void *) &callback_jump_table_start;
 	addr += 8 * index;
 
 	return (void *) addr;
 }
 
+void cbkproxy_out_release(void *callback)
+{
+	uint32_t offset;
+	int index;
+	k_spinlock_key_t key;
+
+	offset = (uint32_t)callback - (uint32_t)(void *) &callback_jump_table_start;
+	index = offset / 8;
+
+	if (!callback || (offset % 8) || (index >= CONFIG_CBKPROXY_OUT_SLOTS)) {
+		return;
+	}
+
+	key = k_spin_lock(&out_lock);
+
+	/* The handler stays bound, so a late call still reaches it, but
+	 * the slot can be bound to another handler once it is unused.
+	 */
+	if (out_ref_cnt[index] > 0) {
+		out_ref_cnt[index]--;
+	}
+
+	k_spin_unlock(&out_lock, key);
+}
+
 #else
 void *cbkproxy_out_get(int index, void *handler)
 {
 	return NULL;
 }
+
+void cbkproxy_out_release(void *callback)
+{
+}
 #endif /* CONFIG_CBKPROXY_OUT_SLOTS > 0 */
 
 #if CONFIG_CBKPROXY_IN_SLOTS > 0
+
+/* Open addressing hash table that maps callbacks to input slots. It has
+ * twice as many entries as there are slots, so the probe sequences stay
+ * short even if all slots are in use. Entries hold the slot index plus one,
+ * zero marks an empty entry.
+ */
+#define IN_HASH_SIZE (2 * CONFIG_CBKPROXY_IN_SLOTS)
+
+static struct k_spinlock in_lock;
+
 static struct
 {
-	intptr_t callback;
-	uint16_t gt;
-	uint16_t lt;
+	uintptr_t callback;
+	uint32_t ref_cnt;
+	uint16_t next_released;
 } in_slots[CONFIG_CBKPROXY_IN_SLOTS];
 
+static uint16_t in_hash[IN_HASH_SIZE];
+
 static uint32_t next_free_in_slot;
 
-int cbkproxy_in_set(void *callback)
+/* List of released slots, linked by the slot index plus one */
+static uint16_t released_in_slots;
+
+static size_t in_hash_home(uintptr_t callback)
 {
-	int index = 0;
-	uint16_t *attach_to = NULL;
-	uintptr_t callback_int = (uintptr_t)callback;
+	/* Fibonacci hashing spreads the aligned function addresses, the
+	 * multiplication maps the result to the table size.
+	 */
+	uint32_t hash = (uint32_t)callback * 2654435761u;
+
+	return ((uint64_t)hash * IN_HASH_SIZE) >> 32;
+}
+
+static size_t in_hash_next(size_t pos)
+{
+	return (pos + 1 < IN_HASH_SIZE) ? pos + 1 : 0;
+}
+
+static uintptr_t in_hash_callback(size_t pos)
+{
+	return in_slots[in_hash[pos] - 1].callback;
+}
+
+/* Returns the hash table position of the callback, or of the empty entry
+ * where it would be inserted.
+ */
+static size_t in_hash_find(uintptr_t callback)
+{
+	size_t pos = in_hash_home(callback);
 
-	k_mutex_lock(&mutex, K_FOREVER);
+	while (in_hash[pos] && (in_hash_callback(pos) != callback)) {
+		pos = in_hash_next(pos);
+	}
+
+	return pos;
+}
+
+/* Removes the entry at the given position and moves the following entries of
+ * the probe sequence back, so that no tombstones are needed.
+ */
+static void in_hash_remove(size_t pos)
+{
+	size_t next = pos;
+
+	in_hash[pos] = 0;
+
+	while (true) {
+		size_t home;
+
+		next = in_hash_next(next);
+		if (!in_hash[next]) {
+			break;
+		}
+
+		home = in_hash_home(in_hash_callback(next));
 
-	if (next_free_in_slot == 0) {
-		attach_to = &in_slots[0].lt;
+		/* Move the entry if its home position is not cyclically
+		 * between the emptied position and its current position.
+		 */
+		if ((pos <= next) ? ((home <= pos) || (home > next)) :
+				    ((home <= pos) && (home > next))) {
+			in_hash[pos] = in_hash[next];
+			in_hash[next] = 0;
+			pos = next;
+		}
+	}
+}
+
+static int in_slot_alloc(void)
+{
+	int index;
+
+	if (released_in_slots) {
+		index = released_in_slots - 1;
+		released_in_slots = in_slots[index].next_released;
+	} else if (next_free_in_slot < CONFIG_CBKPROXY_IN_SLOTS) {
+		index = next_free_in_slot;
+		next_free_in_slot++;
 	} else {
-		do {
-			if (callback_int == in_slots[index].callback) {
-				attach_to = NULL;
-				break;
-			} else if (callback_int < in_slots[index].callback) {
-				attach_to = &in_slots[index].lt;
-			} else {
-				attach_to = &in_slots[index].gt;
-			}
-			index = *attach_to;
-		} while (index > 0);
+		index = -1;
 	}
 
-	if (attach_to) {
-		if (next_free_in_slot >= CONFIG_CBKPROXY_IN_SLOTS) {
-			index = -1;
-		} else {
-			index = next_free_in_slot;
-			next_free_in_slot++;
-			*attach_to = index;
+	return index;
+}
+
+int cbkproxy_in_set(void *callback)
+{
+	int index;
+	size_t pos;
+	uintptr_t callback_int = (uintptr_t)callback;
+	k_spinlock_key_t key = k_spin_lock(&in_lock);
+
+	pos = in_hash_find(callback_int);
+
+	if (in_hash[pos]) {
+		index = in_hash[pos] - 1;
+		in_slots[index].ref_cnt++;
+	} else {
+		index = in_slot_alloc();
+		if (index >= 0) {
 			in_slots[index].callback = callback_int;
-			in_slots[index].gt = 0;
-			in_slots[index].lt = 0;
+			in_slots[index].ref_cnt = 1;
+			in_hash[pos] = index + 1;
 		}
 	}
 
-	k_mutex_unlock(&mutex);
+	k_spin_unlock(&in_lock, key);
 
 	return index;
 }
 
+void cbkproxy_in_release(void *callback)
+{
+	size_t pos;
+	int index;
+	k_spinlock_key_t key = k_spin_lock(&in_lock);
+
+	pos = in_hash_find((uintptr_t)callback);
+
+	if (!callback || !in_hash[pos]) {
+		goto exit;
+	}
+
+	index = in_hash[pos] - 1;
+
+	if (--in_slots[index].ref_cnt > 0) {
+		goto exit;
+	}
+
+	in_hash_remove(pos);
+
+	in_slots[index].callback = 0;
+	in_slots[index].next_released = released_in_slots;
+	released_in_slots = index + 1;
+
+exit:
+	k_spin_unlock(&in_lock, key);
+}
+
 void *cbkproxy_in_get(int index)
 {
-	if ((index >= next_free_in_slot) || (index < 0)) {
+	if ((index >= CONFIG_CBKPROXY_IN_SLOTS) || (index < 0)) {
 		return NULL;
 	}
 
@@ -203,6 +356,10 @@ int cbkproxy_in_set(void *callback)
 	return -1;
 }
 
+void cbkproxy_in_release(void *callback)
+{
+}
+
 void *cbkproxy_in_get(int index)
 {
 	return NULL;
@@ -104,16 +104,30 @@
  *                 by the @ref CBKPROXY_HANDLER macro.
  * @returns        Pointer to function that calls provided handler using
  *                 provided slot index. The pointer has to be casted to
- *                 the same type as handler. NULL when index is too high or
- *                 the function was called again with the same index, but
- *                 different handler.
+ *                 the same type as handler. NULL when index is too high,
+ *                 or when the slot is in use by a different handler.
+ *
+ * Each call takes a reference to the slot, which must be released with
+ * @ref cbkproxy_out_release when the callback will not be called any more.
+ * A slot with no references can be bound to a different handler, because
+ * the remote side may reuse a released input slot for another callback.
  */
 void *cbkproxy_out_get(int index, void *handler);
 
+/** @brief Releases output callback proxy.
+ *
+ * Drops a reference taken by @ref cbkproxy_out_get.
+ *
+ * @param callback Callback proxy returned by @ref cbkproxy_out_get.
+ *                 NULL is ignored.
+ */
+void cbkproxy_out_release(void *callback);
+
 /** @brief Sets input callback proxy.
  *
  * Calling the function again with the same callback parameter will not
- * allocate new slot, but it will return previously allocated.
+ * allocate new slot, but it will return previously allocated and increment
+ * its reference count.
  *
  * @param callback Callback function.
  *
@@ -121,6 +135,17 @@ void *cbkproxy_out_get(int index, void *handler);
  */
 int cbkproxy_in_set(void *callback);
 
+/** @brief Releases input callback proxy.
+ *
+ * Decrements the reference count of the slot allocated for the callback by
+ * @ref cbkproxy_in_set. The slot is freed for other callbacks when the count
+ * drops to zero, so it must be released only if the remote side will not
+ * call the callback any more.
+ *
+ * @param callback Callback function.
+ */
+void cbkproxy_in_release(void *callback);
+
 /** @brief Gets input callback proxy.
  *
  * @param      index     Slot index.
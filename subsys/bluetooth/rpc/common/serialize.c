@@ -5,6 +5,7 @@
  */
 
 #include <nrf_rpc_cbor.h>
+#include <tinycbor/cbor_buf_reader.h>
 
 #include "cbkproxy.h"
 #include "serialize.h"
@@ -457,6 +458,71 @@ error_exit:
 	return NULL;
 }
 
+/* TinyCBOR has no API returning a pointer to the string data, so the in-place
+ * decoder relies on the nRF RPC packets being parsed from a cbor_buf_reader
+ * and on the layout of the parser state. Check that layout at build time.
+ */
+#define SER_TYPE_CHECK(expr, type) __builtin_types_compatible_p(__typeof__(expr), type)
+
+BUILD_ASSERT(SER_TYPE_CHECK(((CborParser *)0)->d, struct cbor_decoder_reader *),
+	     "TinyCBOR parser does not use a decoder reader");
+BUILD_ASSERT(SER_TYPE_CHECK(((struct cbor_buf_reader *)0)->r, struct cbor_decoder_reader),
+	     "TinyCBOR buffer reader does not embed a decoder reader");
+BUILD_ASSERT(SER_TYPE_CHECK(((struct cbor_buf_reader *)0)->buffer, const uint8_t *),
+	     "TinyCBOR buffer reader does not expose its buffer");
+BUILD_ASSERT(SER_TYPE_CHECK(((CborValue *)0)->offset, int),
+	     "TinyCBOR value does not hold a reader offset");
+
+const void *ser_decode_buffer_in_place(CborValue *value, size_t *size)
+{
+	CborError err = CborErrorIllegalType;
+	const struct cbor_buf_reader *reader;
+	size_t len;
+
+	*size = 0;
+
+	if (is_decoder_invalid(value)) {
+		return NULL;
+	}
+
+	if (cbor_value_is_byte_string(value)) {
+		/* Only a string of known length is contiguous in the packet */
+		err = cbor_value_get_string_length(value, &len);
+		if (err != CborNoError) {
+			goto error_exit;
+		}
+
+		err = cbor_value_advance(value);
+		if (err != CborNoError) {
+			goto error_exit;
+		}
+
+		/* The string data ends where the next value starts */
+		reader = CONTAINER_OF(value->parser->d, struct cbor_buf_reader, r);
+		if ((value->offset < 0) || ((size_t)value->offset < len) ||
+		    (value->offset > reader->r.message_size)) {
+			err = CborErrorUnexpectedEOF;
+			goto error_exit;
+		}
+
+		*size = len;
+
+		return &reader->buffer[value->offset - len];
+
+	} else if (cbor_value_is_null(value)) {
+		err = cbor_value_advance_fixed(value);
+		if (err != CborNoError) {
+			goto error_exit;
+		}
+
+		return NULL;
+	}
+
+error_exit:
+	ser_decoder_invalid(value, err);
+	return NULL;
+}
+
 void *ser_decode_buffer_into_scratchpad(struct ser_scratchpad *scratchpad)
 {
 	CborValue *value = scratchpad->value;
@@ -250,6 +250,35 @@ void *ser_decode_buffer(CborValue *value, void *buffer, size_t buffer_size);
  */
 size_t ser_decode_buffer_size(CborValue *value);
 
+/** @brief Decode buffers passed to callbacks in place.
+ *
+ * Set if the transport holds received packets until they are released,
+ * without blocking its receive thread. Otherwise, a packet must be released
+ * before calling a callback that may call other remote procedures, so
+ * the buffers passed to it must be copied to the scratchpad.
+ */
+#define SER_DECODE_IN_PLACE IS_ENABLED(CONFIG_NRF_RPC_TR_RPMSG_HOLD_RX_BUF)
+
+/** @brief Decode a buffer without copying it.
+ *
+ * The returned pointer refers to the buffer data in the received packet,
+ * so it is valid only until @ref ser_decoding_done_and_check is called.
+ * Use it for large buffers that are only passed to a callback: check
+ * the decoded values with @ref ser_decode_valid, call the callback and
+ * release the packet after the callback returns.
+ *
+ * The callback can only call other remote procedures if the transport
+ * holds the packet without blocking its receive thread, see
+ * @ref SER_DECODE_IN_PLACE.
+ *
+ * @param[in]  value Value parsed from the CBOR stream.
+ * @param[out] size Decoded buffer size.
+ *
+ * @retval Pointer to the buffer data in the received packet.
+ *         NULL if a null value was decoded.
+ */
+const void *ser_decode_buffer_in_place(CborValue *value, size_t *size);
+
 /** @brief Decode buffer into a scratchpad.
  *
  * @param[in] scratchpad Pointer to the scratchpad.
@@ -292,6 +321,17 @@ void *ser_decode_callback_call(CborValue *value);
  */
 void ser_decoder_invalid(CborValue *value, CborError err);
 
+/** @brief Check if all values were decoded successfully so far. Unlike
+ *         @ref ser_decoding_done_and_check, this function does not release
+ *         the received packet.
+ *
+ * @param[in] value Value parsed from the CBOR stream.
+ *
+ * @retval True if decoding is valid.
+ *         Otherwise, false will be returned.
+ */
+bool ser_decode_valid(CborValue *value);
+
 /** @brief Signalize that decoding is done. Use this function when you finish decoding of the
  *         received serialized packet.
  *
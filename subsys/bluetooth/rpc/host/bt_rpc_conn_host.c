@@ -110,8 +110,8 @@ static inline void bt_conn_foreach_cb_callback(struct bt_conn *conn, void *data,
 	ser_encode_uint(&ctx.encoder, (uintptr_t)data);
 	ser_encode_callback_call(&ctx.encoder, callback_slot);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_FOREACH_CB_CALLBACK_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_CONN_FOREACH_CB_CALLBACK_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 CBKPROXY_HANDLER(bt_conn_foreach_cb_encoder, bt_conn_foreach_cb_callback,
@@ -132,11 +132,13 @@ static void bt_conn_foreach_rpc_handler(CborValue *value, void *handler_data)
 	}
 
 	bt_conn_foreach(type, func, data);
+	cbkproxy_out_release(func);
 
 	ser_rsp_send_void();
 
 	return;
 decoding_error:
+	cbkproxy_out_release(func);
 	report_decoding_error(BT_CONN_FOREACH_RPC_CMD, handler_data);
 }
 
@@ -732,8 +734,8 @@ static void bt_conn_cb_connected_call(struct bt_conn *conn, uint8_t err)
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	ser_encode_uint(&ctx.encoder, err);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CB_CONNECTED_CALL_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_CONN_CB_CONNECTED_CALL_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 static void bt_conn_cb_disconnected_call(struct bt_conn *conn, uint8_t reason)
@@ -746,8 +748,8 @@ static void bt_conn_cb_disconnected_call(struct bt_conn *conn, uint8_t reason)
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	ser_encode_uint(&ctx.encoder, reason);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CB_DISCONNECTED_CALL_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_CONN_CB_DISCONNECTED_CALL_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 static bool bt_conn_cb_le_param_req_call(struct bt_conn *conn, struct bt_le_conn_param *param)
@@ -761,8 +763,8 @@ static bool bt_conn_cb_le_param_req_call(struct bt_conn *conn, struct bt_le_conn
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	bt_le_conn_param_enc(&ctx.encoder, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CB_LE_PARAM_REQ_CALL_RPC_CMD,
-				&ctx, ser_rsp_decode_bool, &result);
+	bt_rpc_cmd_no_err(BT_CONN_CB_LE_PARAM_REQ_CALL_RPC_CMD,
+			  &ctx, ser_rsp_decode_bool, &result);
 
 	return result;
 }
@@ -780,8 +782,8 @@ static void bt_conn_cb_le_param_updated_call(struct bt_conn *conn, uint16_t inte
 	ser_encode_uint(&ctx.encoder, latency);
 	ser_encode_uint(&ctx.encoder, timeout);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CB_LE_PARAM_UPDATED_CALL_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_CONN_CB_LE_PARAM_UPDATED_CALL_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 #if defined(CONFIG_BT_SMP)
@@ -800,8 +802,8 @@ static void bt_conn_cb_identity_resolved_call(struct bt_conn *conn, const bt_add
 	ser_encode_buffer(&ctx.encoder, rpa, sizeof(bt_addr_le_t));
 	ser_encode_buffer(&ctx.encoder, identity, sizeof(bt_addr_le_t));
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CB_IDENTITY_RESOLVED_CALL_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_CONN_CB_IDENTITY_RESOLVED_CALL_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 static void bt_conn_cb_security_changed_call(struct bt_conn *conn, bt_security_t level,
@@ -816,8 +818,8 @@ static void bt_conn_cb_security_changed_call(struct bt_conn *conn, bt_security_t
 	ser_encode_uint(&ctx.encoder, (uint32_t)level);
 	ser_encode_uint(&ctx.encoder, (uint32_t)err);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CB_SECURITY_CHANGED_CALL_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_CONN_CB_SECURITY_CHANGED_CALL_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 #endif /* defined(CONFIG_BT_SMP) */
 
@@ -836,8 +838,8 @@ static void bt_conn_cb_remote_info_available_call(struct bt_conn *conn,
 
 	bt_conn_remote_info_enc(&ctx.encoder, remote_info);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CB_REMOTE_INFO_AVAILABLE_CALL_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_CONN_CB_REMOTE_INFO_AVAILABLE_CALL_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 #endif /* defined(CONFIG_BT_REMOTE_INFO) */
 
@@ -852,8 +854,8 @@ static void bt_conn_cb_le_phy_updated_call(struct bt_conn *conn, struct bt_conn_
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	bt_conn_le_phy_info_enc(&ctx.encoder, param);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CB_LE_PHY_UPDATED_CALL_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_CONN_CB_LE_PHY_UPDATED_CALL_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 #endif /* defined(CONFIG_BT_USER_PHY_UPDATE) */
 
@@ -869,8 +871,8 @@ static void bt_conn_cb_le_data_len_updated_call(struct bt_conn *conn,
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	bt_conn_le_data_len_info_enc(&ctx.encoder, info);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_CB_LE_DATA_LEN_UPDATED_CALL_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_CONN_CB_LE_DATA_LEN_UPDATED_CALL_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 #endif /* defined(CONFIG_BT_USER_DATA_LEN_UPDATE) */
 
@@ -1164,8 +1166,8 @@ enum bt_security_err bt_rpc_auth_cb_pairing_accept(struct bt_conn *conn,
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	bt_conn_pairing_feat_enc(&ctx.encoder, feat);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_AUTH_CB_PAIRING_ACCEPT_RPC_CMD,
-				&ctx, bt_rpc_auth_cb_pairing_accept_rpc_rsp, &result);
+	bt_rpc_cmd_no_err(BT_RPC_AUTH_CB_PAIRING_ACCEPT_RPC_CMD,
+			  &ctx, bt_rpc_auth_cb_pairing_accept_rpc_rsp, &result);
 
 	return result.result;
 }
@@ -1181,8 +1183,8 @@ void bt_rpc_auth_cb_passkey_display(struct bt_conn *conn, unsigned int passkey)
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	ser_encode_uint(&ctx.encoder, passkey);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_AUTH_CB_PASSKEY_DISPLAY_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_RPC_AUTH_CB_PASSKEY_DISPLAY_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_rpc_auth_cb_passkey_entry(struct bt_conn *conn)
@@ -1194,8 +1196,8 @@ void bt_rpc_auth_cb_passkey_entry(struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_AUTH_CB_PASSKEY_ENTRY_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_RPC_AUTH_CB_PASSKEY_ENTRY_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_rpc_auth_cb_passkey_confirm(struct bt_conn *conn, unsigned int passkey)
@@ -1208,8 +1210,8 @@ void bt_rpc_auth_cb_passkey_confirm(struct bt_conn *conn, unsigned int passkey)
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	ser_encode_uint(&ctx.encoder, passkey);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_AUTH_CB_PASSKEY_CONFIRM_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_RPC_AUTH_CB_PASSKEY_CONFIRM_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_rpc_auth_cb_oob_data_request(struct bt_conn *conn, struct bt_conn_oob_info *info)
@@ -1224,8 +1226,8 @@ void bt_rpc_auth_cb_oob_data_request(struct bt_conn *conn, struct bt_conn_oob_in
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	ser_encode_buffer(&ctx.encoder, info, sizeof(struct bt_conn_oob_info));
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_AUTH_CB_OOB_DATA_REQUEST_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_RPC_AUTH_CB_OOB_DATA_REQUEST_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_rpc_auth_cb_cancel(struct bt_conn *conn)
@@ -1237,8 +1239,8 @@ void bt_rpc_auth_cb_cancel(struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_AUTH_CB_CANCEL_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_RPC_AUTH_CB_CANCEL_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_rpc_auth_cb_pairing_confirm(struct bt_conn *conn)
@@ -1250,8 +1252,8 @@ void bt_rpc_auth_cb_pairing_confirm(struct bt_conn *conn)
 
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_AUTH_CB_PAIRING_CONFIRM_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_RPC_AUTH_CB_PAIRING_CONFIRM_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_rpc_auth_cb_pairing_complete(struct bt_conn *conn, bool bonded)
@@ -1264,8 +1266,8 @@ void bt_rpc_auth_cb_pairing_complete(struct bt_conn *conn, bool bonded)
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	ser_encode_bool(&ctx.encoder, bonded);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_AUTH_CB_PAIRING_COMPLETE_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_RPC_AUTH_CB_PAIRING_COMPLETE_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_rpc_auth_cb_pairing_failed(struct bt_conn *conn, enum bt_security_err reason)
@@ -1278,8 +1280,8 @@ void bt_rpc_auth_cb_pairing_failed(struct bt_conn *conn, enum bt_security_err re
 	bt_rpc_encode_bt_conn(&ctx.encoder, conn);
 	ser_encode_uint(&ctx.encoder, (uint32_t)reason);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_AUTH_CB_PAIRING_FAILED_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_RPC_AUTH_CB_PAIRING_FAILED_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 static int bt_conn_auth_cb_register_on_remote(uint16_t flags)
@@ -59,12 +59,18 @@ NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, bt_rpc_get_check_list, BT_RPC_GET_CHECK_LIS
 			 bt_rpc_get_check_list_rpc_handler, NULL);
 
 
+/* Proxy of the ready callback, released when it is called */
+static bt_ready_cb_t ready_cb;
+
 static inline void bt_ready_cb_t_callback(int err,
 					  uint32_t callback_slot)
 {
 	struct nrf_rpc_cbor_ctx ctx;
 	size_t buffer_size_max = 8;
 
+	cbkproxy_out_release(ready_cb);
+	ready_cb = NULL;
+
 	NRF_RPC_CBOR_ALLOC(ctx, buffer_size_max);
 
 	ser_encode_int(&ctx.encoder, err);
@@ -87,12 +93,19 @@ static void bt_enable_rpc_handler(CborValue *value, void *handler_data)
 		goto decoding_error;
 	}
 
+	ready_cb = cb;
+
 	result = bt_enable(cb);
+	if (result) {
+		cbkproxy_out_release(cb);
+		ready_cb = NULL;
+	}
 
 	ser_rsp_send_int(result);
 
 	return;
 decoding_error:
+	cbkproxy_out_release(cb);
 	report_decoding_error(BT_ENABLE_RPC_CMD, handler_data);
 }
 
@@ -396,8 +409,8 @@ static inline void bt_le_scan_cb_t_callback(const bt_addr_le_t *addr,
 	net_buf_simple_enc(&ctx.encoder, buf);
 	ser_encode_callback_call(&ctx.encoder, callback_slot);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SCAN_CB_T_CALLBACK_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_LE_SCAN_CB_T_CALLBACK_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 
@@ -434,6 +447,7 @@ static void bt_le_adv_start_rpc_handler(CborValue *value, void *handler_data)
 	ad_len = ser_decode_uint(value);
 	ad = ser_scratchpad_add(&scratchpad, ad_len * sizeof(struct bt_data));
 	if (ad == NULL) {
+		nrf_rpc_cbor_decoding_done(value);
 		goto decoding_error;
 	}
 
@@ -444,6 +458,7 @@ static void bt_le_adv_start_rpc_handler(CborValue *value, void *handler_data)
 	sd_len = ser_decode_uint(value);
 	sd = ser_scratchpad_add(&scratchpad, sd_len * sizeof(struct bt_data));
 	if (sd == NULL) {
+		nrf_rpc_cbor_decoding_done(value);
 		goto decoding_error;
 	}
 
@@ -481,6 +496,7 @@ static void bt_le_adv_update_data_rpc_handler(CborValue *value, void *handler_da
 	ad_len = ser_decode_uint(value);
 	ad = ser_scratchpad_add(&scratchpad, ad_len * sizeof(struct bt_data));
 	if (ad == NULL) {
+		nrf_rpc_cbor_decoding_done(value);
 		goto decoding_error;
 	}
 
@@ -490,6 +506,7 @@ static void bt_le_adv_update_data_rpc_handler(CborValue *value, void *handler_da
 	sd_len = ser_decode_uint(value);
 	sd = ser_scratchpad_add(&scratchpad, sd_len * sizeof(struct bt_data));
 	if (sd == NULL) {
+		nrf_rpc_cbor_decoding_done(value);
 		goto decoding_error;
 	}
 
@@ -553,6 +570,19 @@ K_MEM_SLAB_DEFINE(bt_rpc_ext_adv_cb_cache,
 		  sizeof(void *));
 static struct bt_le_ext_adv_cb *ext_adv_cb_cache_map[CONFIG_BT_EXT_ADV_MAX_ADV_SET];
 
+static void ext_adv_cb_free(struct bt_le_ext_adv_cb *cb)
+{
+	if (!cb) {
+		return;
+	}
+
+	cbkproxy_out_release(cb->sent);
+	cbkproxy_out_release(cb->connected);
+	cbkproxy_out_release(cb->scanned);
+
+	k_mem_slab_free(&bt_rpc_ext_adv_cb_cache, (void **)&cb);
+}
+
 void bt_le_ext_adv_sent_info_enc(CborEncoder *encoder, const struct bt_le_ext_adv_sent_info *data)
 {
 	ser_encode_uint(encoder, data->num_sent);
@@ -602,8 +632,8 @@ void bt_le_ext_adv_cb_sent_callback(struct bt_le_ext_adv *adv,
 	bt_le_ext_adv_sent_info_enc(&ctx.encoder, info);
 	ser_encode_callback_call(&ctx.encoder, callback_slot);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_CB_SENT_CALLBACK_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_LE_EXT_ADV_CB_SENT_CALLBACK_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 CBKPROXY_HANDLER(bt_le_ext_adv_cb_sent_encoder, bt_le_ext_adv_cb_sent_callback,
@@ -624,8 +654,8 @@ void bt_le_ext_adv_cb_connected_callback(struct bt_le_ext_adv *adv,
 	bt_le_ext_adv_connected_info_enc(&ctx.encoder, info);
 	ser_encode_callback_call(&ctx.encoder, callback_slot);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_CB_CONNECTED_CALLBACK_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_LE_EXT_ADV_CB_CONNECTED_CALLBACK_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 CBKPROXY_HANDLER(bt_le_ext_adv_cb_connected_encoder,
@@ -653,8 +683,8 @@ void bt_le_ext_adv_cb_scanned_callback(struct bt_le_ext_adv *adv,
 	bt_le_ext_adv_scanned_info_enc(&ctx.encoder, info);
 	ser_encode_callback_call(&ctx.encoder, callback_slot);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_EXT_ADV_CB_SCANNED_CALLBACK_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_LE_EXT_ADV_CB_SCANNED_CALLBACK_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 CBKPROXY_HANDLER(bt_le_ext_adv_cb_scanned_encoder,
@@ -695,6 +725,9 @@ static void bt_le_ext_adv_create_rpc_handler(CborValue *value, void *handler_dat
 		ser_decode_skip(value);
 	} else {
 		result = k_mem_slab_alloc(&bt_rpc_ext_adv_cb_cache, (void **)&cb, K_NO_WAIT);
+		if (result == 0) {
+			bt_le_ext_adv_cb_dec(value, cb);
+		}
 	}
 
 	if (!ser_decoding_done_and_check(value)) {
@@ -709,7 +742,7 @@ static void bt_le_ext_adv_create_rpc_handler(CborValue *value, void *handler_dat
 		adv_index = bt_le_ext_adv_get_index(adv_data);
 		ext_adv_cb_cache_map[adv_index] = cb;
 	} else {
-		k_mem_slab_free(&bt_rpc_ext_adv_cb_cache, (void **)&cb);
+		ext_adv_cb_free(cb);
 	}
 
 	{
@@ -725,9 +758,7 @@ static void bt_le_ext_adv_create_rpc_handler(CborValue *value, void *handler_dat
 decoding_error:
 	report_decoding_error(BT_LE_EXT_ADV_CREATE_RPC_CMD, handler_data);
 
-	if (result == 0) {
-		k_mem_slab_free(&bt_rpc_ext_adv_cb_cache, (void **)&cb);
-	}
+	ext_adv_cb_free(cb);
 }
 
 NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, bt_le_ext_adv_create, BT_LE_EXT_ADV_CREATE_RPC_CMD,
@@ -804,6 +835,7 @@ static void bt_le_ext_adv_set_data_rpc_handler(CborValue *value, void *handler_d
 	ad_len = ser_decode_uint(value);
 	ad = ser_scratchpad_add(&scratchpad, ad_len * sizeof(struct bt_data));
 	if (ad == NULL) {
+		nrf_rpc_cbor_decoding_done(value);
 		goto decoding_error;
 	}
 
@@ -814,6 +846,7 @@ static void bt_le_ext_adv_set_data_rpc_handler(CborValue *value, void *handler_d
 	sd_len = ser_decode_uint(value);
 	sd = ser_scratchpad_add(&scratchpad, sd_len * sizeof(struct bt_data));
 	if (sd == NULL) {
+		nrf_rpc_cbor_decoding_done(value);
 		goto decoding_error;
 	}
 
@@ -871,7 +904,6 @@ static void bt_le_ext_adv_delete_rpc_handler(CborValue *value, void *handler_dat
 	int result;
 
 	size_t adv_index;
-	struct bt_le_ext_adv_cb *cb;
 
 	adv = (struct bt_le_ext_adv *)ser_decode_uint(value);
 
@@ -883,9 +915,9 @@ static void bt_le_ext_adv_delete_rpc_handler(CborValue *value, void *handler_dat
 
 	result = bt_le_ext_adv_delete(adv);
 
-	if (adv_index <= CONFIG_BT_EXT_ADV_MAX_ADV_SET) {
-		cb = ext_adv_cb_cache_map[adv_index];
-		k_mem_slab_free(&bt_rpc_ext_adv_cb_cache, (void **)&cb);
+	if ((result == 0) && (adv_index < CONFIG_BT_EXT_ADV_MAX_ADV_SET)) {
+		ext_adv_cb_free(ext_adv_cb_cache_map[adv_index]);
+		ext_adv_cb_cache_map[adv_index] = NULL;
 	}
 
 	ser_rsp_send_int(result);
@@ -991,6 +1023,9 @@ NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, bt_le_ext_adv_oob_get_local,
 #endif /* defined(CONFIG_BT_EXT_ADV) */
 
 #if defined(CONFIG_BT_OBSERVER)
+/* Proxy of the scan callback, released when scanning is stopped */
+static bt_le_scan_cb_t *scan_cb;
+
 static void bt_le_scan_start_rpc_handler(CborValue *value, void *handler_data)
 {
 	struct bt_le_scan_param param;
@@ -1005,11 +1040,17 @@ static void bt_le_scan_start_rpc_handler(CborValue *value, void *handler_data)
 	}
 
 	result = bt_le_scan_start(&param, cb);
+	if (result) {
+		cbkproxy_out_release(cb);
+	} else {
+		scan_cb = cb;
+	}
 
 	ser_rsp_send_int(result);
 
 	return;
 decoding_error:
+	cbkproxy_out_release(cb);
 	report_decoding_error(BT_LE_SCAN_START_RPC_CMD, handler_data);
 }
 
@@ -1023,6 +1064,10 @@ static void bt_le_scan_stop_rpc_handler(CborValue *value, void *handler_data)
 	nrf_rpc_cbor_decoding_done(value);
 
 	result = bt_le_scan_stop();
+	if (result == 0) {
+		cbkproxy_out_release(scan_cb);
+		scan_cb = NULL;
+	}
 
 	ser_rsp_send_int(result);
 }
@@ -1080,8 +1125,8 @@ void bt_le_scan_cb_recv(const struct bt_le_scan_recv_info *info,
 	bt_le_scan_recv_info_enc(&ctx.encoder, info);
 	net_buf_simple_enc(&ctx.encoder, buf);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SCAN_CB_RECV_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_LE_SCAN_CB_RECV_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_le_scan_cb_timeout(void)
@@ -1091,8 +1136,8 @@ void bt_le_scan_cb_timeout(void)
 
 	NRF_RPC_CBOR_ALLOC(ctx, buffer_size_max);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_LE_SCAN_CB_TIMEOUT_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_LE_SCAN_CB_TIMEOUT_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 static struct bt_le_scan_cb scan_cb = {
@@ -1298,8 +1343,8 @@ static inline void bt_foreach_bond_cb_callback(const struct bt_bond_info *info,
 	ser_encode_uint(&ctx.encoder, (uintptr_t)user_data);
 	ser_encode_callback_call(&ctx.encoder, callback_slot);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_FOREACH_BOND_CB_CALLBACK_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(BT_FOREACH_BOND_CB_CALLBACK_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 CBKPROXY_HANDLER(bt_foreach_bond_cb_encoder, bt_foreach_bond_cb_callback,
@@ -1320,11 +1365,13 @@ static void bt_foreach_bond_rpc_handler(CborValue *value, void *handler_data)
 	}
 
 	bt_foreach_bond(id, func, user_data);
+	cbkproxy_out_release(func);
 
 	ser_rsp_send_void();
 
 	return;
 decoding_error:
+	cbkproxy_out_release(func);
 	report_decoding_error(BT_FOREACH_BOND_RPC_CMD, handler_data);
 }
 
@@ -1445,6 +1492,7 @@ static void bt_le_per_adv_set_data_rpc_handler(CborValue *value, void *handler_d
 	ad_len = ser_decode_uint(value);
 	ad = ser_scratchpad_add(&scratchpad, ad_len * sizeof(struct bt_data));
 	if (ad == NULL) {
+		nrf_rpc_cbor_decoding_done(value);
 		goto decoding_error;
 	}
 
@@ -1821,8 +1869,8 @@ void per_adv_sync_cb_synced(struct bt_le_per_adv_sync *sync,
 	ser_encode_uint(&ctx.encoder, (uintptr_t)sync);
 	bt_le_per_adv_sync_synced_info_enc(&ctx.encoder, info);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, PER_ADV_SYNC_CB_SYNCED_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(PER_ADV_SYNC_CB_SYNCED_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 size_t bt_le_per_adv_sync_term_info_sp_size(const struct bt_le_per_adv_sync_term_info *data)
@@ -1867,8 +1915,8 @@ void per_adv_sync_cb_term(struct bt_le_per_adv_sync *sync,
 	ser_encode_uint(&ctx.encoder, (uintptr_t)sync);
 	bt_le_per_adv_sync_term_info_enc(&ctx.encoder, info);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, PER_ADV_SYNC_CB_TERM_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(PER_ADV_SYNC_CB_TERM_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 size_t bt_le_per_adv_sync_recv_info_sp_size(const struct bt_le_per_adv_sync_recv_info *data)
@@ -1920,8 +1968,8 @@ void per_adv_sync_cb_recv(struct bt_le_per_adv_sync *sync,
 	bt_le_per_adv_sync_recv_info_enc(&ctx.encoder, info);
 	net_buf_simple_enc(&ctx.encoder, buf);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, PER_ADV_SYNC_CB_RECV_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(PER_ADV_SYNC_CB_RECV_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 void bt_le_per_adv_sync_state_info_enc(CborEncoder *encoder,
@@ -1941,8 +1989,8 @@ void per_adv_sync_cb_state_changed(struct bt_le_per_adv_sync *sync,
 	ser_encode_uint(&ctx.encoder, (uintptr_t)sync);
 	bt_le_per_adv_sync_state_info_enc(&ctx.encoder, info);
 
-	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, PER_ADV_SYNC_CB_STATE_CHANGED_RPC_CMD,
-				&ctx, ser_rsp_decode_void, NULL);
+	bt_rpc_cmd_no_err(PER_ADV_SYNC_CB_STATE_CHANGED_RPC_CMD,
+			  &ctx, ser_rsp_decode_void, NULL);
 }
 
 static struct bt_le_per_adv_sync_cb per_adv_sync_cb = {
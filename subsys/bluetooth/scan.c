@@ -6,6 +6,7 @@
 
 #include <zephyr.h>
 #include <sys/byteorder.h>
+#include <stdlib.h>
 #include <string.h>
 #include <bluetooth/scan.h>
 
@@ -18,6 +19,16 @@ LOG_MODULE_REGISTER(nrf_bt_scan, CONFIG_BT_SCAN_LOG_LEVEL);
 	BT_SCAN_SHORT_NAME_FILTER | BT_SCAN_APPEARANCE_FILTER | \
 	BT_SCAN_UUID_FILTER | BT_SCAN_MANUFACTURER_DATA_FILTER)
 
+/* Size of the hash sets used to look up addresses and UUIDs. The sets are
+ * at most half full, so that a lookup only probes a few slots.
+ */
+#define FILTER_SET_SIZE(cnt) (2 * (cnt) + 1)
+
+/* Number of buckets of the prefix tables used to look up names and
+ * manufacturer data. The bucket is selected by the first byte of the data.
+ */
+#define PREFIX_BUCKET_CNT 16
+
 /* Scan filter mutex. */
 K_MUTEX_DEFINE(scan_mutex);
 
@@ -31,6 +42,9 @@ struct bt_scan_control {
 	/* Number of matched filters. */
 	uint8_t filter_match_cnt;
 
+	/* Types of the matched filters. */
+	uint8_t filter_match_mask;
+
 	/* Indicates whether at least one filter has been fitted. */
 	bool filter_match;
 
@@ -47,6 +61,15 @@ struct bt_scan_control {
 	struct bt_scan_filter_match filter_status;
 };
 
+/* Prefix table bucket. Filters in a bucket are chained in the order
+ * they were added, so the first match is also the first filter added.
+ * Entries are filter indexes plus one, zero ends the chain.
+ */
+struct prefix_bucket {
+	uint8_t head;
+	uint8_t tail;
+};
+
 /* Name filter structure.
  */
 struct bt_scan_name_filter {
@@ -55,6 +78,13 @@ struct bt_scan_name_filter {
 	 */
 	char target_name[CONFIG_BT_SCAN_NAME_CNT][CONFIG_BT_SCAN_NAME_MAX_LEN];
 
+	/* Length of the names. */
+	uint8_t len[CONFIG_BT_SCAN_NAME_CNT];
+
+	/* Names by their first character. */
+	struct prefix_bucket bucket[PREFIX_BUCKET_CNT];
+	uint8_t next[CONFIG_BT_SCAN_NAME_CNT];
+
 	/* Name filter counter. */
 	uint8_t cnt;
 
@@ -74,8 +104,15 @@ struct bt_scan_short_name_filter {
 
 		/* Minimum length of the short name. */
 		uint8_t min_len;
+
+		/* Length of the short name. */
+		uint8_t len;
 	} name[CONFIG_BT_SCAN_SHORT_NAME_CNT];
 
+	/* Short names by their first character. */
+	struct prefix_bucket bucket[PREFIX_BUCKET_CNT];
+	uint8_t next[CONFIG_BT_SCAN_SHORT_NAME_CNT];
+
 	/* Short name filter counter. */
 	uint8_t cnt;
 
@@ -89,6 +126,11 @@ struct bt_scan_addr_filter {
 	/* Addresses advertised by the peripherals. */
 	bt_addr_le_t target_addr[CONFIG_BT_SCAN_ADDRESS_CNT];
 
+	/* Hash set of the addresses. Entries are filter indexes plus one,
+	 * zero marks an empty slot.
+	 */
+	uint8_t set[FILTER_SET_SIZE(CONFIG_BT_SCAN_ADDRESS_CNT)];
+
 	/* Address filter counter. */
 	uint8_t cnt;
 
@@ -120,6 +162,20 @@ struct bt_scan_uuid_filter {
 	 */
 	struct bt_scan_uuid uuid[CONFIG_BT_SCAN_UUID_CNT];
 
+	/* 32-bit values of the UUIDs that are aliases of the Bluetooth
+	 * Base UUID, this includes all 16-bit and 32-bit UUIDs.
+	 */
+	uint32_t key[CONFIG_BT_SCAN_UUID_CNT];
+
+	/* Hash set of the UUIDs with a 32-bit value. Entries are filter
+	 * indexes plus one, zero marks an empty slot.
+	 */
+	uint8_t set[FILTER_SET_SIZE(CONFIG_BT_SCAN_UUID_CNT)];
+
+	/* Indexes of the other 128-bit UUIDs. */
+	uint8_t uuid_128[CONFIG_BT_SCAN_UUID_CNT];
+	uint8_t uuid_128_cnt;
+
 	/* UUID filter counter. */
 	uint8_t cnt;
 
@@ -155,6 +211,10 @@ struct bt_scan_manufacturer_data_filter {
 		uint8_t data_len;
 	} manufacturer_data[CONFIG_BT_SCAN_MANUFACTURER_DATA_CNT];
 
+	/* Manufacturer data by their first byte. */
+	struct prefix_bucket bucket[PREFIX_BUCKET_CNT];
+	uint8_t next[CONFIG_BT_SCAN_MANUFACTURER_DATA_CNT];
+
 	/* Name filter counter. */
 	uint8_t cnt;
 
@@ -194,6 +254,14 @@ struct bt_scan_filters {
 	 * matched to generate an event.
 	 */
 	bool all_mode;
+
+	/* Types of the enabled filters, updated when the filters are
+	 * enabled or disabled.
+	 */
+	uint8_t enabled_mask;
+
+	/* Number of the enabled filters. */
+	uint8_t enabled_cnt;
 };
 
 #if CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER
@@ -230,6 +298,47 @@ struct conn_blocklist {
 };
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
+#if CONFIG_BT_SCAN_DEDUP
+#define DEDUP_BUCKET_CNT MAX(CONFIG_BT_SCAN_DEDUP_CACHE_SIZE / 2, 1)
+
+/* Advertising report received recently. */
+struct dedup_entry {
+	/* Node of the least recently used list. */
+	sys_dnode_t lru_node;
+
+	/* Node of the hash bucket. */
+	sys_snode_t bucket_node;
+
+	/* Advertiser address. */
+	bt_addr_le_t addr;
+
+	/* Hash of the advertising data and report type. */
+	uint32_t hash;
+
+	/* Uptime when the report was last forwarded. */
+	uint32_t forwarded;
+
+	/* RSSI of the report last forwarded. */
+	int8_t rssi;
+};
+
+/* Advertising report deduplication cache. */
+struct dedup_cache {
+	struct dedup_entry entry[CONFIG_BT_SCAN_DEDUP_CACHE_SIZE];
+
+	/* Number of the used entries. */
+	uint8_t count;
+
+	/* Entries from the most to the least recently received. */
+	sys_dlist_t lru;
+
+	/* Entries by hash of the address and report. */
+	sys_slist_t bucket[DEDUP_BUCKET_CNT];
+
+	struct bt_scan_dedup_stats stats;
+};
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 /* Scanning module instance. Options for the different scanning modes.
  * This structure stores all module settings. It is used to enable
  * or disable scanning modes and to configure filters.
@@ -264,6 +373,11 @@ static struct bt_scan {
 	struct conn_blocklist blocklist;
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
+#if CONFIG_BT_SCAN_DEDUP
+	/* Advertising report deduplication cache. */
+	struct dedup_cache dedup;
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 } bt_scan;
 
 static sys_slist_t callback_list;
@@ -501,22 +615,80 @@ static void scan_connect_with_target(struct bt_scan_control *control,
 	}
 }
 
-static bool adv_addr_compare(const bt_addr_le_t *target_addr,
-			     struct bt_scan_control *control)
+static uint32_t filter_hash(const uint8_t *data, size_t len)
 {
-	const bt_addr_le_t *addr =
-			bt_scan.scan_filters.addr.target_addr;
-	uint8_t counter = bt_scan.scan_filters.addr.cnt;
+	/* FNV-1a */
+	uint32_t hash = 2166136261U;
 
-	for (size_t i = 0; i < counter; i++) {
-		if (bt_addr_le_cmp(target_addr, &addr[i]) == 0) {
-			control->filter_status.addr.addr = &addr[i];
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ data[i]) * 16777619U;
+	}
 
-			return true;
+	return hash;
+}
+
+static void filter_set_add(uint8_t *set, size_t size, uint32_t hash,
+			   uint8_t idx)
+{
+	size_t slot = hash % size;
+
+	/* The set is never full, see FILTER_SET_SIZE. */
+	while (set[slot]) {
+		slot = (slot + 1) % size;
+	}
+
+	set[slot] = idx + 1;
+}
+
+static void prefix_table_add(struct prefix_bucket *bucket, uint8_t *next,
+			     uint8_t first, uint8_t idx)
+{
+	struct prefix_bucket *b = &bucket[first % PREFIX_BUCKET_CNT];
+
+	next[idx] = 0;
+
+	if (b->tail) {
+		next[b->tail - 1] = idx + 1;
+	} else {
+		b->head = idx + 1;
+	}
+
+	b->tail = idx + 1;
+}
+
+static void filter_matched(struct bt_scan_control *control, uint8_t type)
+{
+	/* A filter type is counted once, even if it is matched by several
+	 * AD structures.
+	 */
+	if (!(control->filter_match_mask & type)) {
+		control->filter_match_mask |= type;
+		control->filter_match_cnt++;
+	}
+
+	control->filter_match = true;
+}
+
+static uint8_t addr_find(const bt_addr_le_t *target_addr)
+{
+	const struct bt_scan_addr_filter *addr_filter =
+			&bt_scan.scan_filters.addr;
+	size_t slot = filter_hash((const uint8_t *)target_addr,
+				  sizeof(*target_addr)) %
+		      ARRAY_SIZE(addr_filter->set);
+
+	while (addr_filter->set[slot]) {
+		uint8_t i = addr_filter->set[slot] - 1;
+
+		if (bt_addr_le_cmp(target_addr,
+				   &addr_filter->target_addr[i]) == 0) {
+			return i + 1;
 		}
+
+		slot = (slot + 1) % ARRAY_SIZE(addr_filter->set);
 	}
 
-	return false;
+	return 0;
 }
 
 static bool is_addr_filter_enabled(void)
@@ -527,22 +699,22 @@ static bool is_addr_filter_enabled(void)
 static void check_addr(struct bt_scan_control *control,
 		       const bt_addr_le_t *addr)
 {
-	if (is_addr_filter_enabled()) {
-		if (adv_addr_compare(addr, control)) {
-			control->filter_match_cnt++;
+	uint8_t i = addr_find(addr);
 
-			/* Information about the filters matched. */
-			control->filter_status.addr.match = true;
-			control->filter_match = true;
-		}
+	if (i) {
+		/* Information about the filters matched. */
+		control->filter_status.addr.addr =
+			&bt_scan.scan_filters.addr.target_addr[i - 1];
+		control->filter_status.addr.match = true;
+		filter_matched(control, BT_SCAN_ADDR_FILTER);
 	}
 }
 
 static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 {
 	char addr[BT_ADDR_LE_STR_LEN];
-	bt_addr_le_t *addr_filter =
-			bt_scan.scan_filters.addr.target_addr;
+	struct bt_scan_addr_filter *addr_filter =
+			&bt_scan.scan_filters.addr;
 	uint8_t counter = bt_scan.scan_filters.addr.cnt;
 
 	/* If no memory for filter. */
@@ -551,17 +723,19 @@ static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 	}
 
 	/* Check for duplicated filter. */
-	for (size_t i = 0; i < counter; i++) {
-		if (bt_addr_le_cmp(target_addr, &addr_filter[i]) == 0) {
-			return 0;
-		}
+	if (addr_find(target_addr)) {
+		return 0;
 	}
 
 	/* Add target address to filter. */
-	bt_addr_le_copy(&addr_filter[counter], target_addr);
+	bt_addr_le_copy(&addr_filter->target_addr[counter], target_addr);
+	filter_set_add(addr_filter->set, ARRAY_SIZE(addr_filter->set),
+		       filter_hash((const uint8_t *)target_addr,
+				   sizeof(*target_addr)),
+		       counter);
 
 	LOG_DBG("Filter set on address type %i",
-		addr_filter[counter].type);
+		addr_filter->target_addr[counter].type);
 
 	bt_addr_le_to_str(target_addr, addr, sizeof(addr));
 
@@ -575,34 +749,18 @@ static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 
 static bool adv_name_cmp(const uint8_t *data,
 			 uint8_t data_len,
-			 const char *target_name)
-{
-	return strncmp(target_name, data, data_len) == 0;
-}
-
-static bool adv_name_compare(const struct bt_data *data,
-			     struct bt_scan_control *control)
+			 const char *target_name,
+			 uint8_t target_len)
 {
-	struct bt_scan_name_filter const *name_filter =
-			&bt_scan.scan_filters.name;
-	uint8_t counter = bt_scan.scan_filters.name.cnt;
-	uint8_t data_len = data->data_len;
-
-	/* Compare the name found with the name filter. */
-	for (size_t i = 0; i < counter; i++) {
-		if (adv_name_cmp(data->data,
-				 data_len,
-				 name_filter->target_name[i])) {
-
-			control->filter_status.name.name =
-				name_filter->target_name[i];
-			control->filter_status.name.len = data_len;
-
-			return true;
-		}
+	/* The advertised name matches if it is a prefix of the target name,
+	 * or if it is the target name followed by a null character.
+	 */
+	if (data_len > target_len) {
+		return (data[target_len] == '\0') &&
+		       (memcmp(target_name, data, target_len) == 0);
 	}
 
-	return false;
+	return memcmp(target_name, data, data_len) == 0;
 }
 
 static inline bool is_name_filter_enabled(void)
@@ -613,19 +771,37 @@ static inline bool is_name_filter_enabled(void)
 static void name_check(struct bt_scan_control *control,
 		       const struct bt_data *data)
 {
-	if (is_name_filter_enabled()) {
-		if (adv_name_compare(data, control)) {
-			control->filter_match_cnt++;
+	const struct bt_scan_name_filter *name_filter =
+			&bt_scan.scan_filters.name;
+	uint8_t data_len = data->data_len;
+
+	if (data_len == 0) {
+		return;
+	}
 
+	/* Only the names starting with the same character can match. */
+	for (uint8_t i = name_filter->bucket[data->data[0] %
+					     PREFIX_BUCKET_CNT].head;
+	     i; i = name_filter->next[i - 1]) {
+		if (adv_name_cmp(data->data,
+				 data_len,
+				 name_filter->target_name[i - 1],
+				 name_filter->len[i - 1])) {
 			/* Information about the filters matched. */
+			control->filter_status.name.name =
+				name_filter->target_name[i - 1];
+			control->filter_status.name.len = data_len;
 			control->filter_status.name.match = true;
-			control->filter_match = true;
+			filter_matched(control, BT_SCAN_NAME_FILTER);
+
+			return;
 		}
 	}
 }
 
 static int scan_name_filter_add(const char *name)
 {
+	struct bt_scan_name_filter *name_filter = &bt_scan.scan_filters.name;
 	uint8_t counter = bt_scan.scan_filters.name.cnt;
 	size_t name_len;
 
@@ -643,14 +819,19 @@ static int scan_name_filter_add(const char *name)
 
 	/* Check for duplicated filter. */
 	for (size_t i = 0; i < counter; i++) {
-		if (!strcmp(bt_scan.scan_filters.name.target_name[i], name)) {
+		if ((name_filter->len[i] == name_len) &&
+		    !memcmp(name_filter->target_name[i], name, name_len)) {
 			return 0;
 		}
 	}
 
 	/* Add name to filter. */
-	memcpy(bt_scan.scan_filters.name.target_name[counter],
-	       name, name_len);
+	memset(name_filter->target_name[counter], 0,
+	       sizeof(name_filter->target_name[counter]));
+	memcpy(name_filter->target_name[counter], name, name_len);
+	name_filter->len[counter] = name_len;
+	prefix_table_add(name_filter->bucket, name_filter->next, name[0],
+			 counter);
 
 	bt_scan.scan_filters.name.cnt++;
 
@@ -659,60 +840,39 @@ static int scan_name_filter_add(const char *name)
 	return 0;
 }
 
-static bool adv_short_name_cmp(const uint8_t *data,
-			       uint8_t data_len,
-			       const char *target_name,
-			       uint8_t short_name_min_len)
+static inline bool is_short_name_filter_enabled(void)
 {
-	if ((data_len >= short_name_min_len) &&
-	    (strncmp(target_name, data, data_len) == 0)) {
-		return true;
-	}
-
-	return false;
+	return CONFIG_BT_SCAN_SHORT_NAME_CNT && bt_scan.scan_filters.short_name.enabled;
 }
 
-static bool adv_short_name_compare(const struct bt_data *data,
-				   struct bt_scan_control *control)
+static void short_name_check(struct bt_scan_control *control,
+			     const struct bt_data *data)
 {
 	const struct bt_scan_short_name_filter *name_filter =
 			&bt_scan.scan_filters.short_name;
-	uint8_t counter = bt_scan.scan_filters.short_name.cnt;
 	uint8_t data_len = data->data_len;
 
-	/* Compare the name found with the name filters. */
-	for (size_t i = 0; i < counter; i++) {
-		if (adv_short_name_cmp(data->data,
-				       data_len,
-				       name_filter->name[i].target_name,
-				       name_filter->name[i].min_len)) {
-
-			control->filter_status.short_name.name =
-				name_filter->name[i].target_name;
-			control->filter_status.short_name.len = data_len;
-
-			return true;
-		}
+	if (data_len == 0) {
+		return;
 	}
 
-	return false;
-}
-
-static inline bool is_short_name_filter_enabled(void)
-{
-	return CONFIG_BT_SCAN_SHORT_NAME_CNT && bt_scan.scan_filters.short_name.enabled;
-}
-
-static void short_name_check(struct bt_scan_control *control,
-			     const struct bt_data *data)
-{
-	if (is_short_name_filter_enabled()) {
-		if (adv_short_name_compare(data, control)) {
-			control->filter_match_cnt++;
-
+	/* Only the names starting with the same character can match. */
+	for (uint8_t i = name_filter->bucket[data->data[0] %
+					     PREFIX_BUCKET_CNT].head;
+	     i; i = name_filter->next[i - 1]) {
+		if ((data_len >= name_filter->name[i - 1].min_len) &&
+		    adv_name_cmp(data->data,
+				 data_len,
+				 name_filter->name[i - 1].target_name,
+				 name_filter->name[i - 1].len)) {
 			/* Information about the filters matched. */
+			control->filter_status.short_name.name =
+				name_filter->name[i - 1].target_name;
+			control->filter_status.short_name.len = data_len;
 			control->filter_status.short_name.match = true;
-			control->filter_match = true;
+			filter_matched(control, BT_SCAN_SHORT_NAME_FILTER);
+
+			return;
 		}
 	}
 }
@@ -740,17 +900,23 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 
 	/* Check for duplicated filter. */
 	for (size_t i = 0; i < counter; i++) {
-		if (!strcmp(short_name_filter->name[i].target_name,
-			    short_name->name)) {
+		if ((short_name_filter->name[i].len == name_len) &&
+		    !memcmp(short_name_filter->name[i].target_name,
+			    short_name->name, name_len)) {
 			return 0;
 		}
 	}
 
 	/* Add name to the filter. */
 	short_name_filter->name[counter].min_len = short_name->min_len;
+	short_name_filter->name[counter].len = name_len;
+	memset(short_name_filter->name[counter].target_name, 0,
+	       sizeof(short_name_filter->name[counter].target_name));
 	memcpy(short_name_filter->name[counter].target_name,
 	       short_name->name,
 	       name_len);
+	prefix_table_add(short_name_filter->bucket, short_name_filter->next,
+			 short_name->name[0], counter);
 
 	bt_scan.scan_filters.short_name.cnt++;
 
@@ -759,87 +925,70 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 	return 0;
 }
 
-static bool find_uuid(const uint8_t *data,
-		      uint8_t data_len,
-		      uint8_t uuid_type,
-		      const struct bt_scan_uuid *target_uuid)
+/* Gets the 32-bit value of a little-endian UUID that is an alias of the
+ * Bluetooth Base UUID. Such UUIDs are equal to their 16-bit or 32-bit
+ * form, see bt_uuid_cmp().
+ */
+static bool uuid_key_get(const uint8_t *data, uint8_t uuid_len,
+			 uint32_t *key)
 {
-	uint8_t uuid_len;
-
-	switch (uuid_type) {
-	case BT_UUID_TYPE_16:
-		uuid_len = sizeof(uint16_t);
-		break;
-
-	case BT_UUID_TYPE_32:
-		uuid_len = sizeof(uint32_t);
-		break;
+	static const uint8_t base_uuid[] = {
+		0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80,
+		0x00, 0x10, 0x00, 0x00
+	};
+
+	switch (uuid_len) {
+	case sizeof(uint16_t):
+		*key = sys_get_le16(data);
+		return true;
 
-	case BT_UUID_TYPE_128:
-		uuid_len = BT_SCAN_UUID_128_SIZE * sizeof(uint8_t);
-		break;
+	case sizeof(uint32_t):
+		*key = sys_get_le32(data);
+		return true;
 
 	default:
-		return false;
-	}
-
-	for (size_t i = 0; i < data_len; i += uuid_len) {
-		struct bt_uuid_128 uuid;
-
-		if (!bt_uuid_create(&uuid.uuid, &data[i], uuid_len)) {
+		if (memcmp(data, base_uuid, sizeof(base_uuid)) != 0) {
 			return false;
 		}
 
-		if (bt_uuid_cmp(&uuid.uuid, target_uuid->uuid) == 0) {
-			return true;
-		}
+		*key = sys_get_le32(&data[sizeof(base_uuid)]);
+		return true;
 	}
-
-	return false;
 }
 
-static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
-			     struct bt_scan_control *control)
+static uint8_t uuid_find(const uint8_t *data, uint8_t uuid_len)
 {
 	const struct bt_scan_uuid_filter *uuid_filter =
 			&bt_scan.scan_filters.uuid;
-	const bool all_filters_mode = bt_scan.scan_filters.all_mode;
-	const uint8_t counter = bt_scan.scan_filters.uuid.cnt;
-	uint8_t data_len = data->data_len;
-	uint8_t uuid_match_cnt = 0;
-
-	for (size_t i = 0; i < counter; i++) {
+	uint32_t key;
 
-		if (find_uuid(data->data, data_len, uuid_type,
-			      &uuid_filter->uuid[i])) {
-			control->filter_status.uuid.uuid[uuid_match_cnt] =
-				uuid_filter->uuid[i].uuid;
+	if (uuid_key_get(data, uuid_len, &key)) {
+		size_t slot = filter_hash((const uint8_t *)&key, sizeof(key)) %
+			      ARRAY_SIZE(uuid_filter->set);
 
-			uuid_match_cnt++;
+		while (uuid_filter->set[slot]) {
+			uint8_t i = uuid_filter->set[slot] - 1;
 
-			/* In the normal filter mode,
-			 * only one UUID is needed to match.
-			 */
-			if (!all_filters_mode) {
-				break;
+			if (uuid_filter->key[i] == key) {
+				return i + 1;
 			}
 
-		} else if (all_filters_mode) {
-			break;
+			slot = (slot + 1) % ARRAY_SIZE(uuid_filter->set);
 		}
+
+		return 0;
 	}
 
-	control->filter_status.uuid.count = uuid_match_cnt;
+	for (size_t i = 0; i < uuid_filter->uuid_128_cnt; i++) {
+		uint8_t idx = uuid_filter->uuid_128[i];
 
-	/* In the multifilter mode, all UUIDs must be found in
-	 * the advertisement packets.
-	 */
-	if ((all_filters_mode && (uuid_match_cnt == counter)) ||
-	    ((!all_filters_mode) && (uuid_match_cnt > 0))) {
-		return true;
+		if (memcmp(data, uuid_filter->uuid[idx].uuid_data.uuid_128.val,
+			   BT_SCAN_UUID_128_SIZE) == 0) {
+			return idx + 1;
+		}
 	}
 
-	return false;
+	return 0;
 }
 
 static bool is_uuid_filter_enabled(void)
@@ -849,26 +998,64 @@ static bool is_uuid_filter_enabled(void)
 
 static void uuid_check(struct bt_scan_control *control,
 		       const struct bt_data *data,
-		       uint8_t type)
+		       uint8_t uuid_len)
 {
-	if (is_uuid_filter_enabled()) {
-		if (adv_uuid_compare(data, type, control)) {
-			control->filter_match_cnt++;
+	const struct bt_scan_uuid_filter *uuid_filter =
+			&bt_scan.scan_filters.uuid;
+	const uint8_t counter = bt_scan.scan_filters.uuid.cnt;
+	bool found[MAX(CONFIG_BT_SCAN_UUID_CNT, 1)] = {0};
+	uint8_t found_cnt = 0;
 
-			/* Information about the filters matched. */
+	for (size_t i = 0; i + uuid_len <= data->data_len; i += uuid_len) {
+		uint8_t idx = uuid_find(&data->data[i], uuid_len);
+
+		if (!idx) {
+			continue;
+		}
+
+		/* In the normal filter mode,
+		 * only one UUID is needed to match.
+		 */
+		if (!bt_scan.scan_filters.all_mode) {
+			control->filter_status.uuid.uuid[0] =
+				uuid_filter->uuid[idx - 1].uuid;
+			control->filter_status.uuid.count = 1;
 			control->filter_status.uuid.match = true;
-			control->filter_match = true;
+			filter_matched(control, BT_SCAN_UUID_FILTER);
+
+			return;
+		}
+
+		if (!found[idx - 1]) {
+			found[idx - 1] = true;
+			found_cnt++;
 		}
 	}
+
+	/* In the multifilter mode, all UUIDs must be found in
+	 * the advertisement packets.
+	 */
+	if (bt_scan.scan_filters.all_mode && (found_cnt == counter)) {
+		for (size_t i = 0; i < counter; i++) {
+			control->filter_status.uuid.uuid[i] =
+				uuid_filter->uuid[i].uuid;
+		}
+
+		control->filter_status.uuid.count = counter;
+		control->filter_status.uuid.match = true;
+		filter_matched(control, BT_SCAN_UUID_FILTER);
+	}
 }
 
 static int scan_uuid_filter_add(struct bt_uuid *uuid)
 {
+	struct bt_scan_uuid_filter *filter = &bt_scan.scan_filters.uuid;
 	struct bt_scan_uuid *uuid_filter = bt_scan.scan_filters.uuid.uuid;
 	uint8_t counter = bt_scan.scan_filters.uuid.cnt;
 	struct bt_uuid_16 *uuid_16;
 	struct bt_uuid_32 *uuid_32;
 	struct bt_uuid_128 *uuid_128;
+	uint32_t key;
 
 	/* If no memory. */
 	if (counter >= CONFIG_BT_SCAN_UUID_CNT) {
@@ -890,6 +1077,7 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		uuid_filter[counter].uuid_data.uuid_16 = *uuid_16;
 		uuid_filter[counter].uuid =
 				(struct bt_uuid *)&uuid_filter[counter].uuid_data.uuid_16;
+		key = uuid_16->val;
 		break;
 
 	case BT_UUID_TYPE_32:
@@ -898,6 +1086,7 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		uuid_filter[counter].uuid_data.uuid_32 = *uuid_32;
 		uuid_filter[counter].uuid =
 				(struct bt_uuid *)&uuid_filter[counter].uuid_data.uuid_32;
+		key = uuid_32->val;
 		break;
 
 	case BT_UUID_TYPE_128:
@@ -906,12 +1095,24 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		uuid_filter[counter].uuid_data.uuid_128 = *uuid_128;
 		uuid_filter[counter].uuid =
 				(struct bt_uuid *)&uuid_filter[counter].uuid_data.uuid_128;
+
+		if (!uuid_key_get(uuid_128->val, BT_SCAN_UUID_128_SIZE,
+				  &key)) {
+			filter->uuid_128[filter->uuid_128_cnt++] = counter;
+			goto added;
+		}
 		break;
 
 	default:
 		return -EINVAL;
 	}
 
+	filter->key[counter] = key;
+	filter_set_add(filter->set, ARRAY_SIZE(filter->set),
+		       filter_hash((const uint8_t *)&key, sizeof(key)),
+		       counter);
+
+added:
 	bt_scan.scan_filters.uuid.cnt++;
 	LOG_DBG("Added filter on UUID type %x", uuid->type);
 
@@ -971,14 +1172,10 @@ static inline bool is_appearance_filter_enabled(void)
 static void appearance_check(struct bt_scan_control *control,
 			     const struct bt_data *data)
 {
-	if (is_appearance_filter_enabled()) {
-		if (adv_appearance_compare(data, control)) {
-			control->filter_match_cnt++;
-
-			/* Information about the filters matched. */
-			control->filter_status.appearance.match = true;
-			control->filter_match = true;
-		}
+	if (adv_appearance_compare(data, control)) {
+		/* Information about the filters matched. */
+		control->filter_status.appearance.match = true;
+		filter_matched(control, BT_SCAN_APPEARANCE_FILTER);
 	}
 }
 
@@ -1024,31 +1221,6 @@ static bool adv_manufacturer_data_cmp(const uint8_t *data,
 	return true;
 }
 
-static bool adv_manufacturer_data_compare(const struct bt_data *data,
-					  struct bt_scan_control *control)
-{
-	const struct bt_scan_manufacturer_data_filter *md_filter =
-		&bt_scan.scan_filters.manufacturer_data;
-	uint8_t counter = bt_scan.scan_filters.manufacturer_data.cnt;
-
-	/* Compare the name found with the name filter. */
-	for (size_t i = 0; i < counter; i++) {
-		if (adv_manufacturer_data_cmp(data->data,
-				data->data_len,
-				md_filter->manufacturer_data[i].data,
-				md_filter->manufacturer_data[i].data_len)) {
-
-			control->filter_status.manufacturer_data.data =
-				md_filter->manufacturer_data[i].data;
-			control->filter_status.manufacturer_data.len =
-				md_filter->manufacturer_data[i].data_len;
-
-			return true;
-		}
-	}
-
-	return false;
-}
 static inline bool is_manufacturer_data_filter_enabled(void)
 {
 	return CONFIG_BT_SCAN_MANUFACTURER_DATA_CNT &&
@@ -1058,13 +1230,31 @@ static inline bool is_manufacturer_data_filter_enabled(void)
 static void manufacturer_data_check(struct bt_scan_control *control,
 				    const struct bt_data *data)
 {
-	if (is_manufacturer_data_filter_enabled()) {
-		if (adv_manufacturer_data_compare(data, control)) {
-			control->filter_match_cnt++;
+	const struct bt_scan_manufacturer_data_filter *md_filter =
+		&bt_scan.scan_filters.manufacturer_data;
 
+	if (data->data_len == 0) {
+		return;
+	}
+
+	/* Only the filters starting with the same byte can match. */
+	for (uint8_t i = md_filter->bucket[data->data[0] %
+					   PREFIX_BUCKET_CNT].head;
+	     i; i = md_filter->next[i - 1]) {
+		if (adv_manufacturer_data_cmp(data->data,
+				data->data_len,
+				md_filter->manufacturer_data[i - 1].data,
+				md_filter->manufacturer_data[i - 1].data_len)) {
 			/* Information about the filters matched. */
+			control->filter_status.manufacturer_data.data =
+				md_filter->manufacturer_data[i - 1].data;
+			control->filter_status.manufacturer_data.len =
+				md_filter->manufacturer_data[i - 1].data_len;
 			control->filter_status.manufacturer_data.match = true;
-			control->filter_match = true;
+			filter_matched(control,
+				       BT_SCAN_MANUFACTURER_DATA_FILTER);
+
+			return;
 		}
 	}
 }
@@ -1102,6 +1292,8 @@ static int scan_manufacturer_data_filter_add(const struct bt_scan_manufacturer_d
 			manufacturer_data->data, manufacturer_data->data_len);
 	md_filter->manufacturer_data[counter].data_len =
 		manufacturer_data->data_len;
+	prefix_table_add(md_filter->bucket, md_filter->next,
+			 manufacturer_data->data[0], counter);
 
 	bt_scan.scan_filters.manufacturer_data.cnt++;
 
@@ -1110,6 +1302,144 @@ static int scan_manufacturer_data_filter_add(const struct bt_scan_manufacturer_d
 	return 0;
 }
 
+#if CONFIG_BT_SCAN_DEDUP
+static void dedup_cache_clear(void)
+{
+	struct dedup_cache *cache = &bt_scan.dedup;
+
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+
+	cache->count = 0;
+	sys_dlist_init(&cache->lru);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache->bucket); i++) {
+		sys_slist_init(&cache->bucket[i]);
+	}
+
+	k_mutex_unlock(&scan_mutex);
+}
+
+static sys_slist_t *dedup_bucket(const bt_addr_le_t *addr, uint32_t hash)
+{
+	struct dedup_cache *cache = &bt_scan.dedup;
+
+	hash ^= filter_hash((const uint8_t *)addr, sizeof(*addr));
+
+	return &cache->bucket[hash % ARRAY_SIZE(cache->bucket)];
+}
+
+static bool dedup_entry_expired(const struct dedup_entry *entry,
+				const struct bt_le_scan_recv_info *info,
+				uint32_t now)
+{
+	if (CONFIG_BT_SCAN_DEDUP_INTERVAL_MS &&
+	    ((now - entry->forwarded) >= CONFIG_BT_SCAN_DEDUP_INTERVAL_MS)) {
+		return true;
+	}
+
+	if (CONFIG_BT_SCAN_DEDUP_RSSI_DELTA &&
+	    (abs(info->rssi - entry->rssi) >= CONFIG_BT_SCAN_DEDUP_RSSI_DELTA)) {
+		return true;
+	}
+
+	return false;
+}
+
+/* Looks up the report in the cache, and adds it if it is not there.
+ * Returns true if the report must not be forwarded.
+ */
+static bool dedup_report_check(const struct bt_le_scan_recv_info *info,
+			       const struct net_buf_simple *ad)
+{
+	struct dedup_cache *cache = &bt_scan.dedup;
+	uint32_t now = k_uptime_get_32();
+	uint32_t hash = filter_hash(ad->data, ad->len) ^ info->adv_type;
+	sys_slist_t *bucket = dedup_bucket(info->addr, hash);
+	struct dedup_entry *entry;
+	bool suppress = false;
+
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+
+	cache->stats.reports++;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(bucket, entry, bucket_node) {
+		if ((entry->hash == hash) &&
+		    (bt_addr_le_cmp(&entry->addr, info->addr) == 0)) {
+			break;
+		}
+	}
+
+	if (entry) {
+		sys_dlist_remove(&entry->lru_node);
+		sys_dlist_prepend(&cache->lru, &entry->lru_node);
+
+		if (!dedup_entry_expired(entry, info, now)) {
+			cache->stats.suppressed++;
+			suppress = true;
+
+			goto out;
+		}
+	} else {
+		if (cache->count < ARRAY_SIZE(cache->entry)) {
+			entry = &cache->entry[cache->count++];
+		} else {
+			/* Replace the least recently received report. */
+			entry = SYS_DLIST_PEEK_TAIL_CONTAINER(&cache->lru,
+							      entry, lru_node);
+			sys_dlist_remove(&entry->lru_node);
+			sys_slist_find_and_remove(dedup_bucket(&entry->addr,
+							       entry->hash),
+						  &entry->bucket_node);
+			cache->stats.evicted++;
+		}
+
+		bt_addr_le_copy(&entry->addr, info->addr);
+		entry->hash = hash;
+		sys_dlist_prepend(&cache->lru, &entry->lru_node);
+		sys_slist_prepend(bucket, &entry->bucket_node);
+	}
+
+	entry->forwarded = now;
+	entry->rssi = info->rssi;
+
+out:
+	k_mutex_unlock(&scan_mutex);
+
+	return suppress;
+}
+
+int bt_scan_dedup_stats_get(struct bt_scan_dedup_stats *stats)
+{
+	if (!stats) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+	*stats = bt_scan.dedup.stats;
+	k_mutex_unlock(&scan_mutex);
+
+	return 0;
+}
+
+void bt_scan_dedup_clear(void)
+{
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+	dedup_cache_clear();
+	memset(&bt_scan.dedup.stats, 0, sizeof(bt_scan.dedup.stats));
+	k_mutex_unlock(&scan_mutex);
+}
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
+/* Forwards the next report of every device, so that it is checked against
+ * the changed filters or reported again after a scan restart.
+ */
+static void dedup_cache_invalidate(void)
+{
+#if CONFIG_BT_SCAN_DEDUP
+	dedup_cache_clear();
+#endif /* CONFIG_BT_SCAN_DEDUP */
+}
+
 static bool check_filter_mode(uint8_t mode)
 {
 	return (mode & MODE_CHECK) != 0;
@@ -1204,6 +1534,10 @@ int bt_scan_filter_add(enum bt_scan_filter_type type,
 		break;
 	}
 
+	if (!err) {
+		dedup_cache_invalidate();
+	}
+
 	k_mutex_unlock(&scan_mutex);
 
 	return err;
@@ -1216,18 +1550,24 @@ void bt_scan_filter_remove_all(void)
 	struct bt_scan_name_filter *name_filter =
 			&bt_scan.scan_filters.name;
 	name_filter->cnt = 0;
+	memset(name_filter->bucket, 0, sizeof(name_filter->bucket));
 
 	struct bt_scan_short_name_filter *short_name_filter =
 			&bt_scan.scan_filters.short_name;
 	short_name_filter->cnt = 0;
+	memset(short_name_filter->bucket, 0,
+	       sizeof(short_name_filter->bucket));
 
 	struct bt_scan_addr_filter *addr_filter =
 			&bt_scan.scan_filters.addr;
 	addr_filter->cnt = 0;
+	memset(addr_filter->set, 0, sizeof(addr_filter->set));
 
 	struct bt_scan_uuid_filter *uuid_filter =
 			&bt_scan.scan_filters.uuid;
 	uuid_filter->cnt = 0;
+	uuid_filter->uuid_128_cnt = 0;
+	memset(uuid_filter->set, 0, sizeof(uuid_filter->set));
 
 	struct bt_scan_appearance_filter *appearance_filter =
 			&bt_scan.scan_filters.appearance;
@@ -1236,10 +1576,41 @@ void bt_scan_filter_remove_all(void)
 	struct bt_scan_manufacturer_data_filter *manufacturer_data_filter =
 		&bt_scan.scan_filters.manufacturer_data;
 	manufacturer_data_filter->cnt = 0;
+	memset(manufacturer_data_filter->bucket, 0,
+	       sizeof(manufacturer_data_filter->bucket));
+
+	dedup_cache_invalidate();
 
 	k_mutex_unlock(&scan_mutex);
 }
 
+static void enabled_filters_update(void)
+{
+	struct bt_scan_filters *filters = &bt_scan.scan_filters;
+	const struct {
+		bool enabled;
+		uint8_t type;
+	} filter[] = {
+		{ is_addr_filter_enabled(), BT_SCAN_ADDR_FILTER },
+		{ is_name_filter_enabled(), BT_SCAN_NAME_FILTER },
+		{ is_short_name_filter_enabled(), BT_SCAN_SHORT_NAME_FILTER },
+		{ is_uuid_filter_enabled(), BT_SCAN_UUID_FILTER },
+		{ is_appearance_filter_enabled(), BT_SCAN_APPEARANCE_FILTER },
+		{ is_manufacturer_data_filter_enabled(),
+		  BT_SCAN_MANUFACTURER_DATA_FILTER },
+	};
+
+	filters->enabled_mask = 0;
+	filters->enabled_cnt = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(filter); i++) {
+		if (filter[i].enabled) {
+			filters->enabled_mask |= filter[i].type;
+			filters->enabled_cnt++;
+		}
+	}
+}
+
 void bt_scan_filter_disable(void)
 {
 	/* Disable all filters. */
@@ -1249,6 +1620,9 @@ void bt_scan_filter_disable(void)
 	bt_scan.scan_filters.uuid.enabled = false;
 	bt_scan.scan_filters.appearance.enabled = false;
 	bt_scan.scan_filters.manufacturer_data.enabled = false;
+
+	enabled_filters_update();
+	dedup_cache_invalidate();
 }
 
 int bt_scan_filter_enable(uint8_t mode, bool match_all)
@@ -1291,6 +1665,9 @@ int bt_scan_filter_enable(uint8_t mode, bool match_all)
 	/* Select the filter mode. */
 	filters->all_mode = match_all;
 
+	enabled_filters_update();
+	dedup_cache_invalidate();
+
 	return 0;
 }
 
@@ -1332,6 +1709,10 @@ void bt_scan_init(const struct bt_scan_init_param *init)
 	/* Disable all scanning filters. */
 	memset(&bt_scan.scan_filters, 0, sizeof(bt_scan.scan_filters));
 
+#if CONFIG_BT_SCAN_DEDUP
+	bt_scan_dedup_clear();
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 	/* If the pointer to the initialization structure exist,
 	 * use it to scan the configuration.
 	 */
@@ -1369,83 +1750,80 @@ void bt_scan_update_init_conn_params(struct bt_le_conn_param *new_conn_param)
 	bt_scan.conn_param = *new_conn_param;
 }
 
-static void check_enabled_filters(struct bt_scan_control *control)
+static bool filter_state_decided(const struct bt_scan_control *control)
 {
-	control->filter_cnt = 0;
-
-	if (is_addr_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_name_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_short_name_filter_enabled()) {
-		control->filter_cnt++;
+	if (control->all_mode) {
+		return control->filter_match_cnt == control->filter_cnt;
 	}
 
-	if (is_uuid_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_appearance_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_manufacturer_data_filter_enabled()) {
-		control->filter_cnt++;
-	}
+	return control->filter_match;
 }
 
 static bool adv_data_found(struct bt_data *data, void *user_data)
 {
 	struct bt_scan_control *scan_control =
 			(struct bt_scan_control *)user_data;
+	const uint8_t mask = bt_scan.scan_filters.enabled_mask &
+			     ~scan_control->filter_match_mask;
 
 	switch (data->type) {
 	case BT_DATA_NAME_COMPLETE:
 		/* Check the name filter. */
-		name_check(scan_control, data);
+		if (mask & BT_SCAN_NAME_FILTER) {
+			name_check(scan_control, data);
+		}
 		break;
 
 	case BT_DATA_NAME_SHORTENED:
 		/* Check the short name filter. */
-		short_name_check(scan_control, data);
+		if (mask & BT_SCAN_SHORT_NAME_FILTER) {
+			short_name_check(scan_control, data);
+		}
 		break;
 
 	case BT_DATA_GAP_APPEARANCE:
 		/* Check the appearance filter. */
-		appearance_check(scan_control, data);
+		if (mask & BT_SCAN_APPEARANCE_FILTER) {
+			appearance_check(scan_control, data);
+		}
 		break;
 
 	case BT_DATA_UUID16_SOME:
 	case BT_DATA_UUID16_ALL:
 		/* Check the UUID filter. */
-		uuid_check(scan_control, data, BT_UUID_TYPE_16);
+		if (mask & BT_SCAN_UUID_FILTER) {
+			uuid_check(scan_control, data, sizeof(uint16_t));
+		}
 		break;
 
 	case BT_DATA_UUID32_SOME:
 	case BT_DATA_UUID32_ALL:
-		uuid_check(scan_control, data, BT_UUID_TYPE_32);
+		if (mask & BT_SCAN_UUID_FILTER) {
+			uuid_check(scan_control, data, sizeof(uint32_t));
+		}
 		break;
 
 	case BT_DATA_UUID128_SOME:
 	case BT_DATA_UUID128_ALL:
 		/* Check the UUID filter. */
-		uuid_check(scan_control, data, BT_UUID_TYPE_128);
+		if (mask & BT_SCAN_UUID_FILTER) {
+			uuid_check(scan_control, data, BT_SCAN_UUID_128_SIZE);
+		}
 		break;
 
 	case BT_DATA_MANUFACTURER_DATA:
 		/* Check the manufacturer data filter. */
-		manufacturer_data_check(scan_control, data);
+		if (mask & BT_SCAN_MANUFACTURER_DATA_FILTER) {
+			manufacturer_data_check(scan_control, data);
+		}
 		break;
 
 	default:
 		break;
 	}
 
-	return true;
+	/* Stop parsing once the result cannot change anymore. */
+	return !filter_state_decided(scan_control);
 }
 
 static void filter_state_check(struct bt_scan_control *control,
@@ -1483,25 +1861,42 @@ static void scan_recv(const struct bt_le_scan_recv_info *info,
 	struct bt_scan_control scan_control;
 	struct net_buf_simple_state state;
 
+#if CONFIG_BT_SCAN_DEDUP
+	if (dedup_report_check(info, ad)) {
+		return;
+	}
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 	memset(&scan_control, 0, sizeof(scan_control));
 
 	scan_control.all_mode = bt_scan.scan_filters.all_mode;
-
-	check_enabled_filters(&scan_control);
+	scan_control.filter_cnt = bt_scan.scan_filters.enabled_cnt;
 
 	/* Check id device is connectable. */
 	scan_control.connectable =
 		(info->adv_props & BT_GAP_ADV_PROP_CONNECTABLE) != 0;
 
 	/* Check the address filter. */
-	check_addr(&scan_control, info->addr);
+	if (bt_scan.scan_filters.enabled_mask & BT_SCAN_ADDR_FILTER) {
+		check_addr(&scan_control, info->addr);
+	}
 
-	/* Save advertising buffer state to transfer it
-	 * data to application if futher processing is needed.
+	/* The advertising data is only parsed if a filter on it is enabled
+	 * and it can still change the result. In the multifilter mode,
+	 * a device with an unmatched address can not match anymore.
 	 */
-	net_buf_simple_save(ad, &state);
-	bt_data_parse(ad, adv_data_found, (void *)&scan_control);
-	net_buf_simple_restore(ad, &state);
+	if ((bt_scan.scan_filters.enabled_mask & ~BT_SCAN_ADDR_FILTER) &&
+	    !filter_state_decided(&scan_control) &&
+	    !(scan_control.all_mode &&
+	      (bt_scan.scan_filters.enabled_mask & BT_SCAN_ADDR_FILTER) &&
+	      !scan_control.filter_status.addr.match)) {
+		/* Save advertising buffer state to transfer it
+		 * data to application if futher processing is needed.
+		 */
+		net_buf_simple_save(ad, &state);
+		bt_data_parse(ad, adv_data_found, (void *)&scan_control);
+		net_buf_simple_restore(ad, &state);
+	}
 
 	scan_control.device_info.recv_info = info;
 	scan_control.device_info.conn_param = &bt_scan.conn_param;
@@ -1533,6 +1928,8 @@ int bt_scan_start(enum bt_scan_type scan_type)
 		return -EINVAL;
 	}
 
+	dedup_cache_invalidate();
+
 	/* Start the scanning. */
 	int err = bt_le_scan_start(&bt_scan.scan_param, NULL);
 
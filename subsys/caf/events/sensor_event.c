@@ -32,10 +32,10 @@ EVENT_INFO_DEFINE(sensor_event,
 		  ENCODE(),
 		  profile_sensor_event);
 
-EVENT_TYPE_DEFINE(sensor_event,
-		  IS_ENABLED(CONFIG_CAF_INIT_LOG_SENSOR_EVENTS),
-		  log_sensor_event,
-		  &sensor_event_info);
+EVENT_TYPE_DYNDATA_DEFINE(sensor_event,
+			  IS_ENABLED(CONFIG_CAF_INIT_LOG_SENSOR_EVENTS),
+			  log_sensor_event,
+			  &sensor_event_info);
 
 
 static int log_sensor_state_event(const struct event_header *eh, char *buf, size_t buf_len)
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MCUBOOT_VERIFY_H__
+#define MCUBOOT_VERIFY_H__
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <zephyr/types.h>
+#include <mbedtls/sha256.h>
+#include <dfu/dfu_target_mcuboot.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Incremental verification of an MCUboot image.
+ *
+ * The image is hashed as it is received, following the image header. The
+ * SHA-256 TLV found in the TLV area after the image is compared to the hash.
+ * If a manifest is given, each block of the file is compared to its digest
+ * as soon as the block is complete.
+ */
+struct mcuboot_verify {
+	mbedtls_sha256_context image_sha;
+	mbedtls_sha256_context block_sha;
+	const struct dfu_target_mcuboot_manifest *manifest;
+	/* Number of bytes received */
+	size_t off;
+	/* End of the hashed part of the image */
+	size_t hash_end;
+	/* End of the TLV area */
+	size_t tlv_end;
+	/* Number of bytes left in the current TLV */
+	size_t tlv_left;
+	/* Index of the current block of the manifest */
+	size_t block;
+	uint8_t state;
+	uint8_t scratch_len;
+	uint8_t scratch[32];
+	uint8_t hash[DFU_TARGET_MCUBOOT_DIGEST_LEN];
+	uint8_t expected[DFU_TARGET_MCUBOOT_DIGEST_LEN];
+	bool hash_done;
+	bool expected_found;
+};
+
+/**
+ * @brief Start verifying a new image.
+ *
+ * @param[out] v        Verification context.
+ * @param[in]  manifest Block digests of the image file, or NULL.
+ */
+void mcuboot_verify_init(struct mcuboot_verify *v,
+			 const struct dfu_target_mcuboot_manifest *manifest);
+
+/**
+ * @brief Verify the next bytes of the image.
+ *
+ * @retval 0 If no mismatch was found so far.
+ * @retval -EBADMSG If the image header is invalid, or the image does not
+ *		    match its SHA-256 TLV or the manifest.
+ */
+int mcuboot_verify_update(struct mcuboot_verify *v, const uint8_t *buf,
+			  size_t len);
+
+/**
+ * @brief Verify the complete image.
+ *
+ * @retval 0 If the image matches its SHA-256 TLV and the manifest.
+ * @retval -EBADMSG Otherwise, including when the image is incomplete.
+ */
+int mcuboot_verify_finish(struct mcuboot_verify *v);
+
+/**
+ * @brief Check whether a mismatch was found.
+ *
+ * @retval true If the image was rejected by a previous call.
+ */
+bool mcuboot_verify_failed(const struct mcuboot_verify *v);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MCUBOOT_VERIFY_H__ */
@@ -22,8 +22,14 @@
 #include <nrfx.h>
 #include <dfu/mcuboot.h>
 #include <dfu/dfu_target.h>
+#include <dfu/dfu_target_mcuboot.h>
 #include <dfu/dfu_target_stream.h>
 
+#ifdef CONFIG_DFU_TARGET_MCUBOOT_VERIFY
+#include <drivers/flash.h>
+#include "mcuboot_verify.h"
+#endif
+
 LOG_MODULE_REGISTER(dfu_target_mcuboot, CONFIG_DFU_TARGET_LOG_LEVEL);
 
 #define MAX_FILE_SEARCH_LEN 500
@@ -36,6 +42,62 @@ LOG_MODULE_REGISTER(dfu_target_mcuboot, CONFIG_DFU_TARGET_LOG_LEVEL);
 static uint8_t *stream_buf;
 static size_t stream_buf_len;
 
+#ifdef CONFIG_DFU_TARGET_MCUBOOT_VERIFY
+#define VERIFY_READ_LEN 64
+
+static const struct dfu_target_mcuboot_manifest *manifest;
+static struct mcuboot_verify verify;
+
+/**
+ * @brief Hash the part of the image that was written before a reset.
+ */
+static int verify_written(size_t len)
+{
+	const struct device *flash_dev;
+	uint8_t chunk[VERIFY_READ_LEN];
+	int err;
+
+	flash_dev = dfu_target_stream_get_stream()->fdev;
+	mcuboot_verify_init(&verify, manifest);
+
+	for (size_t off = 0; off < len; off += sizeof(chunk)) {
+		size_t chunk_len = MIN(sizeof(chunk), len - off);
+
+		err = flash_read(flash_dev, PM_MCUBOOT_SECONDARY_ADDRESS + off,
+				 chunk, chunk_len);
+		if (err != 0) {
+			LOG_ERR("flash_read error %d", err);
+			return err;
+		}
+
+		if (mcuboot_verify_update(&verify, chunk, chunk_len) != 0) {
+			/* Handled by the caller */
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Discard a rejected image, and its progress, to download it again.
+ */
+static int image_restart(void)
+{
+	int err;
+
+	err = dfu_target_stream_reset();
+	if (err != 0) {
+		LOG_ERR("dfu_target_stream_reset error %d", err);
+		return err;
+	}
+
+	mcuboot_verify_init(&verify, manifest);
+
+	return 0;
+}
+#endif /* CONFIG_DFU_TARGET_MCUBOOT_VERIFY */
+
 int dfu_ctx_mcuboot_set_b1_file(const char *file, bool s0_active,
 				const char **update)
 {
@@ -78,6 +140,24 @@ int dfu_ctx_mcuboot_set_b1_file(const char *file, bool s0_active,
 	return 0;
 }
 
+int dfu_target_mcuboot_manifest_set(
+	const struct dfu_target_mcuboot_manifest *m)
+{
+#ifdef CONFIG_DFU_TARGET_MCUBOOT_VERIFY
+	if (m != NULL && (m->block_size == 0 || m->digest == NULL)) {
+		return -EINVAL;
+	}
+
+	manifest = m;
+
+	return 0;
+#else
+	ARG_UNUSED(m);
+
+	return -ENOTSUP;
+#endif
+}
+
 bool dfu_target_mcuboot_identify(const void *const buf)
 {
 	/* MCUBoot headers starts with 4 byte magic word */
@@ -137,16 +217,47 @@ int dfu_target_mcuboot_init(size_t file_size, dfu_target_callback_t cb)
 		return err;
 	}
 
+#ifdef CONFIG_DFU_TARGET_MCUBOOT_VERIFY
+	mcuboot_verify_init(&verify, manifest);
+#endif
+
 	return 0;
 }
 
 int dfu_target_mcuboot_offset_get(size_t *out)
 {
-	return dfu_target_stream_offset_get(out);
+	int err = dfu_target_stream_offset_get(out);
+
+#ifdef CONFIG_DFU_TARGET_MCUBOOT_VERIFY
+	if (err == 0 && *out > verify.off) {
+		/* Resuming after a reset */
+		err = verify_written(*out);
+	}
+
+	if (err == 0 && mcuboot_verify_failed(&verify)) {
+		LOG_WRN("Image was rejected, starting over");
+		err = image_restart();
+		*out = 0;
+	}
+#endif
+
+	return err;
 }
 
 int dfu_target_mcuboot_write(const void *const buf, size_t len)
 {
+#ifdef CONFIG_DFU_TARGET_MCUBOOT_VERIFY
+	/* A fragment that completes a mismatching block, or that follows
+	 * a mismatch, is not written. The earlier fragments of the block are
+	 * already in flash, and are discarded with the rejected image.
+	 */
+	int err = mcuboot_verify_update(&verify, buf, len);
+
+	if (err != 0) {
+		return err;
+	}
+#endif
+
 	return dfu_target_stream_write(buf, len);
 }
 
@@ -154,6 +265,16 @@ int dfu_target_mcuboot_done(bool successful)
 {
 	int err = 0;
 
+#ifdef CONFIG_DFU_TARGET_MCUBOOT_VERIFY
+	if (successful && mcuboot_verify_finish(&verify) != 0) {
+		/* Do not schedule an upgrade to a corrupted image. The image
+		 * is discarded when the download is restarted.
+		 */
+		(void)dfu_target_stream_done(false);
+		return -EBADMSG;
+	}
+#endif
+
 	err = dfu_target_stream_done(successful);
 	if (err != 0) {
 		LOG_ERR("dfu_target_stream_done error %d", err);
@@ -10,6 +10,11 @@
 #include <stdio.h>
 #include <dfu/dfu_target_stream.h>
 
+#ifdef CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND
+#include <sys/ring_buffer.h>
+#include <sys/atomic.h>
+#endif /* CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND */
+
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
 #define MODULE "dfu"
 #define DFU_STREAM_OFFSET "stream/offset"
@@ -85,25 +90,320 @@ static int settings_set(const char *key, size_t len_rd,
 }
 #endif /* CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS */
 
-struct stream_flash_ctx *dfu_target_stream_get_stream(void)
+static int stream_write(const uint8_t *buf, size_t len)
 {
-	return &stream;
+	int err = stream_flash_buffered_write(&stream, buf, len, false);
+
+	if (err != 0) {
+		LOG_ERR("stream_flash_buffered_write error %d", err);
+		return err;
+	}
+
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
+	err = store_progress();
+	if (err != 0) {
+		/* Failing to store progress is not a critical error you'll just
+		 * be left to download a bit more if you fail and resume.
+		 */
+		LOG_WRN("Unable to store write progress: %d", err);
+	}
+#endif
+
+	return err;
 }
 
-int dfu_target_stream_init(const struct dfu_target_stream_init *init)
+#ifdef CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND
+
+#define WB_PRIORITY K_LOWEST_APPLICATION_THREAD_PRIO
+
+enum wb_flag {
+	/* Between dfu_target_stream_init() and dfu_target_stream_done() */
+	WB_ACTIVE,
+	/* Signal 'flushed' once the queue is empty */
+	WB_FLUSH,
+};
+
+static K_THREAD_STACK_DEFINE(wb_stack,
+			     CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND_STACK_SIZE);
+static struct k_thread wb_thread;
+RING_BUF_DECLARE(dfu_stream_wb_queue,
+		 CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND_BUF_SIZE);
+static K_MUTEX_DEFINE(wb_queue_lock);
+/* Given when data is queued or a flush is requested */
+static K_SEM_DEFINE(wb_data, 0, 1);
+/* Given when data is removed from the queue */
+static K_SEM_DEFINE(wb_space, 0, 1);
+static K_SEM_DEFINE(wb_flushed, 0, 1);
+
+static struct {
+	atomic_t flags;
+	/* First error of the write-behind thread */
+	int err;
+	/* Absolute offset up to which the stream area is erased */
+	size_t erased_end;
+	bool started;
+} wb;
+
+/**
+ * @brief Erase the page starting at 'erased_end'.
+ */
+static int page_erase_next(void)
 {
+	struct flash_pages_info page;
 	int err;
 
-	if (current_id != NULL) {
-		return -EFAULT;
+	err = flash_get_page_info_by_offs(stream.fdev, wb.erased_end, &page);
+	if (err != 0) {
+		LOG_ERR("Error %d while getting page info", err);
+		return err;
 	}
 
-	if (init == NULL || init->id == NULL || init->fdev == NULL ||
-	    init->buf == NULL) {
-		return -EINVAL;
+	err = stream_flash_erase_page(&stream, page.start_offset);
+	if (err != 0) {
+		LOG_ERR("stream_flash_erase_page error %d", err);
+		return err;
 	}
 
-	current_id = init->id;
+	wb.erased_end = page.start_offset + page.size;
+
+	return 0;
+}
+
+/**
+ * @brief Make sure the pages up to and including the one holding 'end' are
+ *	  erased before stream_flash writes its buffer, and keep stream_flash
+ *	  from erasing the last of them again.
+ *
+ * stream_flash only erases the page holding the last byte of a write, when it
+ * differs from the last page it erased. Since the pages are erased ahead of
+ * the writes here, that page is set just before each write.
+ */
+static int erase_until(size_t end)
+{
+	struct flash_pages_info page;
+	int err;
+
+	while (wb.erased_end <= end) {
+		err = page_erase_next();
+		if (err != 0) {
+			return err;
+		}
+	}
+
+	err = flash_get_page_info_by_offs(stream.fdev, end, &page);
+	if (err != 0) {
+		LOG_ERR("Error %d while getting page info", err);
+		return err;
+	}
+
+	stream.last_erased_page_start_offset = page.start_offset;
+
+	return 0;
+}
+
+static bool pre_erase_pending(void)
+{
+	struct flash_pages_info next;
+	struct flash_pages_info current;
+	size_t pos = stream.offset + stream.bytes_written + stream.buf_bytes;
+
+	if (wb.err != 0 || !atomic_test_bit(&wb.flags, WB_ACTIVE) ||
+	    wb.erased_end >= stream.offset + stream.available) {
+		return false;
+	}
+
+	if (flash_get_page_info_by_offs(stream.fdev, wb.erased_end, &next) ||
+	    flash_get_page_info_by_offs(stream.fdev, pos, &current)) {
+		return false;
+	}
+
+	return next.index <=
+	       current.index + CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND_ERASE_AHEAD;
+}
+
+/**
+ * @brief Write queued data to the stream, in pieces that make stream_flash
+ *	  write its buffer at most once.
+ */
+static int wb_stream_write(const uint8_t *buf, size_t len)
+{
+	int err;
+
+	while (len > 0) {
+		size_t room = stream.buf_len - stream.buf_bytes;
+		size_t piece = MIN(len, room);
+
+		if (piece == room) {
+			/* The buffer is full after this piece and is written */
+			err = erase_until(stream.offset + stream.bytes_written +
+					  stream.buf_len - 1);
+			if (err != 0) {
+				return err;
+			}
+		}
+
+		err = stream_write(buf, piece);
+		if (err != 0) {
+			return err;
+		}
+
+		buf += piece;
+		len -= piece;
+	}
+
+	return 0;
+}
+
+static void wb_drain(void)
+{
+	uint8_t *data;
+	uint32_t len;
+
+	while (true) {
+		k_mutex_lock(&wb_queue_lock, K_FOREVER);
+		len = ring_buf_get_claim(&dfu_stream_wb_queue, &data,
+					 dfu_stream_wb_queue.size);
+		k_mutex_unlock(&wb_queue_lock);
+
+		if (len == 0) {
+			return;
+		}
+
+		/* After an error, the data is dropped until the next init */
+		if (wb.err == 0) {
+			wb.err = wb_stream_write(data, len);
+		}
+
+		k_mutex_lock(&wb_queue_lock, K_FOREVER);
+		(void)ring_buf_get_finish(&dfu_stream_wb_queue, len);
+		k_mutex_unlock(&wb_queue_lock);
+
+		k_sem_give(&wb_space);
+	}
+}
+
+static void wb_thread_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_timeout_t timeout = pre_erase_pending() ? K_NO_WAIT :
+							    K_FOREVER;
+
+		if (k_sem_take(&wb_data, timeout) != 0) {
+			/* Nothing to write, erase the next page meanwhile */
+			wb.err = page_erase_next();
+			continue;
+		}
+
+		wb_drain();
+
+		if (atomic_test_and_clear_bit(&wb.flags, WB_FLUSH)) {
+			k_sem_give(&wb_flushed);
+		}
+	}
+}
+
+/**
+ * @brief Wait until all queued data has been given to stream_flash.
+ *
+ * Must only be called while the write-behind thread is running.
+ */
+static int wb_flush_wait(void)
+{
+	atomic_set_bit(&wb.flags, WB_FLUSH);
+	k_sem_give(&wb_data);
+	k_sem_take(&wb_flushed, K_FOREVER);
+
+	return wb.err;
+}
+
+static int wb_flush(void)
+{
+	/* Nothing can be queued unless the stream was started */
+	if (!atomic_test_bit(&wb.flags, WB_ACTIVE)) {
+		return wb.err;
+	}
+
+	return wb_flush_wait();
+}
+
+static int wb_start(void)
+{
+	struct flash_pages_info page;
+	size_t pos = stream.offset + stream.bytes_written;
+	int err;
+
+	err = flash_get_page_info_by_offs(stream.fdev, pos, &page);
+	if (err != 0) {
+		LOG_ERR("Error %d while getting page info", err);
+		return err;
+	}
+
+	/* When resuming within a page, that page has been erased already. */
+	if (stream.bytes_written == 0 || pos == page.start_offset) {
+		wb.erased_end = page.start_offset;
+		stream.last_erased_page_start_offset = -1;
+	} else {
+		wb.erased_end = page.start_offset + page.size;
+	}
+
+	wb.err = 0;
+	ring_buf_reset(&dfu_stream_wb_queue);
+	k_sem_reset(&wb_space);
+
+	if (!wb.started) {
+		k_thread_create(&wb_thread, wb_stack,
+				K_THREAD_STACK_SIZEOF(wb_stack),
+				wb_thread_fn, NULL, NULL, NULL,
+				WB_PRIORITY, 0, K_NO_WAIT);
+		k_thread_name_set(&wb_thread, "dfu_write_behind");
+		wb.started = true;
+	}
+
+	atomic_set_bit(&wb.flags, WB_ACTIVE);
+	/* Start erasing ahead */
+	k_sem_give(&wb_data);
+
+	return 0;
+}
+
+static int wb_write(const uint8_t *buf, size_t len)
+{
+	uint32_t put;
+
+	while (len > 0) {
+		if (wb.err != 0) {
+			return wb.err;
+		}
+
+		k_mutex_lock(&wb_queue_lock, K_FOREVER);
+		put = ring_buf_put(&dfu_stream_wb_queue, buf, len);
+		k_mutex_unlock(&wb_queue_lock);
+
+		if (put > 0) {
+			k_sem_give(&wb_data);
+			buf += put;
+			len -= put;
+		} else {
+			k_sem_take(&wb_space, K_FOREVER);
+		}
+	}
+
+	return wb.err;
+}
+#endif /* CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND */
+
+struct stream_flash_ctx *dfu_target_stream_get_stream(void)
+{
+	return &stream;
+}
+
+static int stream_init(const struct dfu_target_stream_init *init)
+{
+	int err;
 
 	err = stream_flash_init(&stream, init->fdev, init->buf, init->len,
 				init->offset, init->size, NULL);
@@ -145,11 +445,51 @@ int dfu_target_stream_init(const struct dfu_target_stream_init *init)
 	}
 #endif /* CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS */
 
+#ifdef CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND
+	err = wb_start();
+	if (err) {
+		return err;
+	}
+#endif /* CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND */
+
 	return 0;
 }
 
+int dfu_target_stream_init(const struct dfu_target_stream_init *init)
+{
+	int err;
+
+	if (current_id != NULL) {
+		return -EFAULT;
+	}
+
+	if (init == NULL || init->id == NULL || init->fdev == NULL ||
+	    init->buf == NULL) {
+		return -EINVAL;
+	}
+
+	current_id = init->id;
+
+	err = stream_init(init);
+	if (err) {
+		/* Allow a new init, and make 'done' a no-op until then */
+		current_id = NULL;
+	}
+
+	return err;
+}
+
 int dfu_target_stream_offset_get(size_t *out)
 {
+#ifdef CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND
+	/* Only report data that has been written */
+	int err = wb_flush();
+
+	if (err != 0) {
+		return err;
+	}
+#endif
+
 	*out = stream_flash_bytes_written(&stream);
 
 	return 0;
@@ -157,30 +497,87 @@ int dfu_target_stream_offset_get(size_t *out)
 
 int dfu_target_stream_write(const uint8_t *buf, size_t len)
 {
-	int err = stream_flash_buffered_write(&stream, buf, len, false);
+#ifdef CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND
+	return wb_write(buf, len);
+#else
+	return stream_write(buf, len);
+#endif
+}
 
-	if (err != 0) {
-		LOG_ERR("stream_flash_buffered_write error %d", err);
+int dfu_target_stream_reset(void)
+{
+	int err;
+
+	if (current_id == NULL) {
+		return -EFAULT;
+	}
+
+#ifdef CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND
+	/* Let the write-behind thread go idle. The queued data is written
+	 * before the stream is rewound, and overwritten later.
+	 */
+	if (atomic_test_and_clear_bit(&wb.flags, WB_ACTIVE)) {
+		(void)wb_flush_wait();
+	}
+#endif
+
+	err = stream_flash_init(&stream, stream.fdev, stream.buf,
+				stream.buf_len, stream.offset,
+				stream.available, stream.callback);
+	if (err) {
+		LOG_ERR("stream_flash_init failed (err %d)", err);
 		return err;
 	}
 
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
-	err = store_progress();
+	err = settings_delete(current_name_key);
 	if (err != 0) {
-		/* Failing to store progress is not a critical error you'll just
-		 * be left to download a bit more if you fail and resume.
-		 */
-		LOG_WRN("Unable to store write progress: %d", err);
+		LOG_ERR("setting_delete error %d", err);
+		return err;
 	}
 #endif
 
-	return err;
+#ifdef CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND
+	err = wb_start();
+	if (err) {
+		return err;
+	}
+#endif
+
+	return 0;
 }
 
 int dfu_target_stream_done(bool successful)
 {
 	int err = 0;
 
+	if (current_id == NULL) {
+		/* The stream was never initialized, or init failed */
+		return 0;
+	}
+
+#ifdef CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND
+	/* Stop erasing ahead and write out the queued data */
+	if (atomic_test_and_clear_bit(&wb.flags, WB_ACTIVE)) {
+		err = wb_flush_wait();
+	}
+
+	if (err != 0) {
+		LOG_ERR("Write-behind error %d", err);
+		current_id = NULL;
+		return err;
+	}
+
+	if (successful && stream.buf_bytes > 0) {
+		err = erase_until(stream.offset + stream.bytes_written +
+				  stream.buf_bytes - 1);
+		if (err != 0) {
+			current_id = NULL;
+			return err;
+		}
+	}
+#endif /* CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND */
+
 	if (successful) {
 		err = stream_flash_buffered_write(&stream, NULL, 0, true);
 		if (err != 0) {
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <logging/log.h>
+#include <sys/byteorder.h>
+
+#include "mcuboot_verify.h"
+
+LOG_MODULE_REGISTER(mcuboot_verify, CONFIG_DFU_TARGET_LOG_LEVEL);
+
+/* Image layout, see bootutil/image.h in MCUboot */
+#define IMAGE_MAGIC 0x96f3b83d
+#define IMAGE_HEADER_SIZE 32
+#define IMAGE_TLV_INFO_MAGIC 0x6907
+#define IMAGE_TLV_INFO_SIZE 4
+#define IMAGE_TLV_HEADER_SIZE 4
+#define IMAGE_TLV_SHA256 0x10
+
+enum verify_state {
+	STATE_HEADER,
+	/* Hashed part of the image, after the header */
+	STATE_BODY,
+	STATE_TLV_INFO,
+	STATE_TLV_HEADER,
+	STATE_TLV_SHA256,
+	STATE_TLV_SKIP,
+	/* Past the TLV area */
+	STATE_DONE,
+	STATE_INVALID,
+};
+
+/**
+ * @brief Copy up to 'need' bytes to the scratch buffer.
+ *
+ * @return Number of bytes consumed from 'buf'.
+ */
+static size_t collect(struct mcuboot_verify *v, const uint8_t *buf,
+		      size_t len, size_t need)
+{
+	size_t n = MIN(len, need - v->scratch_len);
+
+	memcpy(v->scratch + v->scratch_len, buf, n);
+	v->scratch_len += n;
+
+	return n;
+}
+
+static int header_parse(struct mcuboot_verify *v)
+{
+	const uint8_t *hdr = v->scratch;
+	uint16_t hdr_size = sys_get_le16(&hdr[8]);
+	uint16_t protect_tlv_size = sys_get_le16(&hdr[10]);
+	uint32_t img_size = sys_get_le32(&hdr[12]);
+
+	if (sys_get_le32(&hdr[0]) != IMAGE_MAGIC ||
+	    hdr_size < IMAGE_HEADER_SIZE) {
+		LOG_ERR("Invalid image header");
+		return -EBADMSG;
+	}
+
+	/* The header, the image and the protected TLVs are hashed */
+	v->hash_end = hdr_size + img_size + protect_tlv_size;
+
+	return 0;
+}
+
+/**
+ * @brief Go to the next TLV, or past the TLV area.
+ */
+static void tlv_next(struct mcuboot_verify *v, size_t off)
+{
+	v->scratch_len = 0;
+	v->state = (off < v->tlv_end) ? STATE_TLV_HEADER : STATE_DONE;
+}
+
+static int hash_check(struct mcuboot_verify *v)
+{
+	if (memcmp(v->hash, v->expected, sizeof(v->hash)) != 0) {
+		LOG_ERR("Image does not match its SHA-256 TLV");
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+
+static int image_update(struct mcuboot_verify *v, const uint8_t *buf,
+			size_t len)
+{
+	size_t off = v->off;
+	size_t n;
+	int err;
+
+	while (len > 0) {
+		err = 0;
+
+		switch (v->state) {
+		case STATE_HEADER:
+			n = collect(v, buf, len, IMAGE_HEADER_SIZE);
+			mbedtls_sha256_update_ret(&v->image_sha, buf, n);
+
+			if (v->scratch_len == IMAGE_HEADER_SIZE) {
+				err = header_parse(v);
+				v->state = STATE_BODY;
+			}
+			break;
+		case STATE_BODY:
+			n = MIN(len, v->hash_end - off);
+			mbedtls_sha256_update_ret(&v->image_sha, buf, n);
+
+			if (off + n == v->hash_end) {
+				mbedtls_sha256_finish_ret(&v->image_sha,
+							  v->hash);
+				v->hash_done = true;
+				v->scratch_len = 0;
+				v->state = STATE_TLV_INFO;
+			}
+			break;
+		case STATE_TLV_INFO:
+			n = collect(v, buf, len, IMAGE_TLV_INFO_SIZE);
+
+			if (v->scratch_len == IMAGE_TLV_INFO_SIZE) {
+				if (sys_get_le16(&v->scratch[0]) !=
+				    IMAGE_TLV_INFO_MAGIC) {
+					LOG_ERR("Invalid TLV area");
+					err = -EBADMSG;
+					break;
+				}
+
+				/* The size includes the TLV info */
+				v->tlv_end = v->hash_end +
+					     sys_get_le16(&v->scratch[2]);
+				tlv_next(v, off + n);
+			}
+			break;
+		case STATE_TLV_HEADER:
+			n = collect(v, buf, len, IMAGE_TLV_HEADER_SIZE);
+
+			if (v->scratch_len == IMAGE_TLV_HEADER_SIZE) {
+				uint8_t type = v->scratch[0];
+
+				v->tlv_left = sys_get_le16(&v->scratch[2]);
+				v->scratch_len = 0;
+
+				if (type == IMAGE_TLV_SHA256 &&
+				    v->tlv_left == sizeof(v->expected)) {
+					v->state = STATE_TLV_SHA256;
+				} else if (v->tlv_left > 0) {
+					v->state = STATE_TLV_SKIP;
+				} else {
+					tlv_next(v, off + n);
+				}
+			}
+			break;
+		case STATE_TLV_SHA256:
+			n = collect(v, buf, len, sizeof(v->expected));
+
+			if (v->scratch_len == sizeof(v->expected)) {
+				memcpy(v->expected, v->scratch,
+				       sizeof(v->expected));
+				v->expected_found = true;
+				tlv_next(v, off + n);
+				/* No need to wait for the end of the file */
+				err = hash_check(v);
+			}
+			break;
+		case STATE_TLV_SKIP:
+			n = MIN(len, v->tlv_left);
+			v->tlv_left -= n;
+
+			if (v->tlv_left == 0) {
+				tlv_next(v, off + n);
+			}
+			break;
+		case STATE_DONE:
+			/* Padding after the TLV area */
+			n = len;
+			break;
+		default:
+			return -EBADMSG;
+		}
+
+		if (err) {
+			v->state = STATE_INVALID;
+			return err;
+		}
+
+		buf += n;
+		len -= n;
+		off += n;
+	}
+
+	return 0;
+}
+
+static int block_check(struct mcuboot_verify *v)
+{
+	uint8_t digest[DFU_TARGET_MCUBOOT_DIGEST_LEN];
+
+	mbedtls_sha256_finish_ret(&v->block_sha, digest);
+
+	if (memcmp(digest, v->manifest->digest[v->block],
+		   sizeof(digest)) != 0) {
+		LOG_ERR("Block %u does not match the manifest",
+			(uint32_t)v->block);
+		return -EBADMSG;
+	}
+
+	v->block++;
+	mbedtls_sha256_starts_ret(&v->block_sha, false);
+
+	return 0;
+}
+
+static int block_update(struct mcuboot_verify *v, const uint8_t *buf,
+			size_t len)
+{
+	const size_t block_size = v->manifest->block_size;
+	size_t off = v->off;
+	int err;
+
+	while (len > 0) {
+		size_t block_end = (v->block + 1) * block_size;
+		size_t n = MIN(len, block_end - off);
+
+		if (v->block >= v->manifest->block_cnt) {
+			LOG_ERR("Image is larger than the manifest");
+			return -EBADMSG;
+		}
+
+		mbedtls_sha256_update_ret(&v->block_sha, buf, n);
+
+		buf += n;
+		len -= n;
+		off += n;
+
+		if (off == block_end) {
+			err = block_check(v);
+			if (err) {
+				return err;
+			}
+		}
+	}
+
+	return 0;
+}
+
+void mcuboot_verify_init(struct mcuboot_verify *v,
+			 const struct dfu_target_mcuboot_manifest *manifest)
+{
+	memset(v, 0, sizeof(*v));
+
+	v->manifest = manifest;
+	v->state = STATE_HEADER;
+
+	mbedtls_sha256_init(&v->image_sha);
+	mbedtls_sha256_starts_ret(&v->image_sha, false);
+
+	if (manifest) {
+		mbedtls_sha256_init(&v->block_sha);
+		mbedtls_sha256_starts_ret(&v->block_sha, false);
+	}
+}
+
+int mcuboot_verify_update(struct mcuboot_verify *v, const uint8_t *buf,
+			  size_t len)
+{
+	int err;
+
+	if (v->state == STATE_INVALID) {
+		return -EBADMSG;
+	}
+
+	if (v->manifest) {
+		err = block_update(v, buf, len);
+		if (err) {
+			v->state = STATE_INVALID;
+			return err;
+		}
+	}
+
+	err = image_update(v, buf, len);
+	if (err) {
+		return err;
+	}
+
+	v->off += len;
+
+	return 0;
+}
+
+static int finish(struct mcuboot_verify *v)
+{
+	int err;
+
+	if (v->manifest) {
+		/* The last block may be shorter */
+		if (v->off > v->block * v->manifest->block_size) {
+			err = block_check(v);
+			if (err) {
+				return err;
+			}
+		}
+
+		if (v->block != v->manifest->block_cnt) {
+			LOG_ERR("Image is smaller than the manifest");
+			return -EBADMSG;
+		}
+	}
+
+	if (!v->hash_done || !v->expected_found) {
+		LOG_ERR("Image is incomplete or has no SHA-256 TLV");
+		return -EBADMSG;
+	}
+
+	return hash_check(v);
+}
+
+int mcuboot_verify_finish(struct mcuboot_verify *v)
+{
+	int err;
+
+	if (v->state == STATE_INVALID) {
+		return -EBADMSG;
+	}
+
+	err = finish(v);
+	if (err) {
+		v->state = STATE_INVALID;
+	}
+
+	return err;
+}
+
+bool mcuboot_verify_failed(const struct mcuboot_verify *v)
+{
+	return v->state == STATE_INVALID;
+}
@@ -5,6 +5,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <zephyr.h>
 #include <spinlock.h>
 #include <sys/slist.h>
@@ -29,17 +30,80 @@ static void event_processor_fn(struct k_work *work);
 #define IDS_COUNT 0
 #endif
 
+#if CONFIG_EVENT_MANAGER_DISPATCH_TABLE
+#define DISPATCH_EVENT_CNT CONFIG_EVENT_MANAGER_DISPATCH_MAX_EVENT_CNT
+#define DISPATCH_LISTENER_CNT CONFIG_EVENT_MANAGER_DISPATCH_TABLE_MAX_SUBSCRIBER_CNT
+#else
+#define DISPATCH_EVENT_CNT 0
+#define DISPATCH_LISTENER_CNT 0
+#endif
+
 #ifdef CONFIG_SHELL
 extern uint32_t event_manager_displayed_events;
 #else
 static uint32_t event_manager_displayed_events;
 #endif
 
+/* Listeners of an event type are stored in dispatch_listeners array between
+ * bounds[0] and bounds[SUBS_PRIO_COUNT]. Listeners of priority prio start at
+ * bounds[prio].
+ */
+struct dispatch_entry {
+	uint16_t bounds[SUBS_PRIO_COUNT + 1];
+};
+
 static uint16_t profiler_event_ids[IDS_COUNT];
-static K_WORK_DEFINE(event_processor, event_processor_fn);
-static sys_slist_t eventq = SYS_SLIST_STATIC_INIT(&eventq);
+static struct dispatch_entry dispatch_table[DISPATCH_EVENT_CNT];
+static const struct event_listener *dispatch_listeners[DISPATCH_LISTENER_CNT];
+static bool dispatch_table_ready;
 static struct k_spinlock lock;
 
+/* Queue of events processed by a single work item. With execution classes
+ * enabled, every execution class has its own queue.
+ */
+struct event_queue {
+	sys_slist_t events;
+	struct k_work work;
+	struct k_work_q *work_q;
+};
+
+#define EVENT_QUEUE_INITIALIZER(_queue, _work_q)			\
+	{								\
+		.events = SYS_SLIST_STATIC_INIT(&(_queue).events),	\
+		.work = Z_WORK_INITIALIZER(event_processor_fn),		\
+		.work_q = (_work_q),					\
+	}
+
+#if CONFIG_EVENT_MANAGER_EXEC_CLASSES
+static K_THREAD_STACK_DEFINE(exec_class_high_stack,
+			     CONFIG_EVENT_MANAGER_EXEC_CLASS_HIGH_STACK_SIZE);
+static K_THREAD_STACK_DEFINE(exec_class_low_stack,
+			     CONFIG_EVENT_MANAGER_EXEC_CLASS_LOW_STACK_SIZE);
+static struct k_work_q exec_class_high_work_q;
+static struct k_work_q exec_class_low_work_q;
+
+static struct event_queue event_queues[EVENT_EXEC_CLASS_COUNT] = {
+	[EVENT_EXEC_CLASS_HIGH] =
+		EVENT_QUEUE_INITIALIZER(event_queues[EVENT_EXEC_CLASS_HIGH],
+					&exec_class_high_work_q),
+	[EVENT_EXEC_CLASS_NORMAL] =
+		EVENT_QUEUE_INITIALIZER(event_queues[EVENT_EXEC_CLASS_NORMAL],
+					&k_sys_work_q),
+	[EVENT_EXEC_CLASS_LOW] =
+		EVENT_QUEUE_INITIALIZER(event_queues[EVENT_EXEC_CLASS_LOW],
+					&exec_class_low_work_q),
+};
+#else
+static struct event_queue event_queues[1] = {
+	EVENT_QUEUE_INITIALIZER(event_queues[0], &k_sys_work_q),
+};
+#endif /* CONFIG_EVENT_MANAGER_EXEC_CLASSES */
+
+#if CONFIG_EVENT_MANAGER_EXEC_CLASS_STATS
+struct event_exec_class_stats
+	event_manager_exec_class_stats[ARRAY_SIZE(event_queues)];
+#endif
+
 
 static bool log_is_event_displayed(const struct event_type *et)
 {
@@ -228,19 +292,278 @@ static int trace_event_init(void)
 	return 0;
 }
 
+static bool is_mem_slab_block(const struct k_mem_slab *slab, const void *mem)
+{
+	const char *start = slab->buffer;
+	const char *end = start + slab->num_blocks * slab->block_size;
+
+	return ((const char *)mem >= start) && ((const char *)mem < end);
+}
+
+void event_manager_free(struct event_header *eh)
+{
+	__ASSERT_NO_MSG(eh);
+	ASSERT_EVENT_ID(eh->type_id);
+
+	struct k_mem_slab *slab = eh->type_id->mem_slab;
+
+	/* Events with dynamic data are always allocated from the heap. */
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_EVENT_MEM_SLABS) &&
+	    (slab != NULL) && is_mem_slab_block(slab, eh)) {
+		k_mem_slab_free(slab, (void **)&eh);
+	} else {
+		k_free(eh);
+	}
+}
+
+static int dispatch_table_init(void)
+{
+	size_t event_cnt = __stop_event_types - __start_event_types;
+	size_t listener_idx = 0;
+
+	if (event_cnt > ARRAY_SIZE(dispatch_table)) {
+		LOG_ERR("Too many event types for dispatch table");
+		return -ENOMEM;
+	}
+
+	for (const struct event_type *et = __start_event_types;
+	     (et != NULL) && (et != __stop_event_types);
+	     et++) {
+		struct dispatch_entry *de =
+			&dispatch_table[et - __start_event_types];
+
+		for (size_t prio = SUBS_PRIO_MIN; prio <= SUBS_PRIO_MAX;
+		     prio++) {
+			de->bounds[prio] = listener_idx;
+
+			for (const struct event_subscriber *es =
+					et->subs_start[prio];
+			     es != et->subs_stop[prio];
+			     es++) {
+				if (listener_idx >=
+				    ARRAY_SIZE(dispatch_listeners)) {
+					LOG_ERR("Too many subscribers for "
+						"dispatch table");
+					return -ENOMEM;
+				}
+
+				__ASSERT_NO_MSG(es->listener != NULL);
+				__ASSERT_NO_MSG(es->listener->notification !=
+						NULL);
+
+				dispatch_listeners[listener_idx] =
+					es->listener;
+				listener_idx++;
+			}
+		}
+
+		de->bounds[SUBS_PRIO_COUNT] = listener_idx;
+	}
+
+	dispatch_table_ready = true;
+
+	return 0;
+}
+
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_STATS
+static struct event_dispatch_stats
+	dispatch_stats[CONFIG_EVENT_MANAGER_DISPATCH_MAX_EVENT_CNT];
+
+static int dispatch_stats_init(void)
+{
+	size_t event_cnt = __stop_event_types - __start_event_types;
+
+	if (event_cnt > ARRAY_SIZE(dispatch_stats)) {
+		LOG_ERR("Too many event types for dispatch statistics");
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static void dispatch_stats_update(const struct event_type *et,
+				  uint32_t cycles)
+{
+	size_t event_idx = et - __start_event_types;
+
+	if (event_idx < ARRAY_SIZE(dispatch_stats)) {
+		struct event_dispatch_stats *stats = &dispatch_stats[event_idx];
+
+		stats->event_cnt++;
+		stats->cycles_total += cycles;
+		stats->cycles_max = MAX(stats->cycles_max, cycles);
+	}
+}
+
+int event_manager_dispatch_stats_get(size_t idx,
+				     struct event_dispatch_stats *stats)
+{
+	if (idx >= ARRAY_SIZE(dispatch_stats)) {
+		return -EINVAL;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	*stats = dispatch_stats[idx];
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+void event_manager_dispatch_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	memset(dispatch_stats, 0, sizeof(dispatch_stats));
+	k_spin_unlock(&lock, key);
+}
+#else
+static inline int dispatch_stats_init(void)
+{
+	return 0;
+}
+
+static inline void dispatch_stats_update(const struct event_type *et,
+					 uint32_t cycles)
+{
+}
+#endif /* CONFIG_EVENT_MANAGER_DISPATCH_STATS */
+
+static bool notify_listeners_table(const struct event_header *eh)
+{
+	const struct event_type *et = eh->type_id;
+	const struct dispatch_entry *de =
+		&dispatch_table[et - __start_event_types];
+	const struct event_listener * const *el =
+		&dispatch_listeners[de->bounds[0]];
+	const struct event_listener * const *el_end =
+		&dispatch_listeners[de->bounds[SUBS_PRIO_COUNT]];
+
+	for (; el != el_end; el++) {
+		log_event_progress(et, *el);
+
+		if ((*el)->notification(eh)) {
+			log_event_consumed(et);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool notify_listeners_sections(const struct event_header *eh)
+{
+	const struct event_type *et = eh->type_id;
+	bool consumed = false;
+
+	for (size_t prio = SUBS_PRIO_MIN;
+	     (prio <= SUBS_PRIO_MAX) && !consumed;
+	     prio++) {
+		for (const struct event_subscriber *es =
+				et->subs_start[prio];
+		     (es != et->subs_stop[prio]) && !consumed;
+		     es++) {
+
+			__ASSERT_NO_MSG(es != NULL);
+
+			const struct event_listener *el = es->listener;
+
+			__ASSERT_NO_MSG(el != NULL);
+			__ASSERT_NO_MSG(el->notification != NULL);
+
+			log_event_progress(et, el);
+
+			consumed = el->notification(eh);
+
+			if (consumed) {
+				log_event_consumed(et);
+			}
+		}
+	}
+
+	return consumed;
+}
+
+static void notify_listeners(const struct event_header *eh)
+{
+	uint32_t start_time = 0;
+
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_DISPATCH_STATS)) {
+		start_time = k_cycle_get_32();
+	}
+
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_DISPATCH_TABLE) &&
+	    dispatch_table_ready) {
+		notify_listeners_table(eh);
+	} else {
+		notify_listeners_sections(eh);
+	}
+
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_DISPATCH_STATS)) {
+		dispatch_stats_update(eh->type_id,
+				      k_cycle_get_32() - start_time);
+	}
+}
+
+static size_t event_queue_idx(const struct event_type *et)
+{
+	if (!IS_ENABLED(CONFIG_EVENT_MANAGER_EXEC_CLASSES)) {
+		return 0;
+	}
+
+	__ASSERT_NO_MSG(et->exec_class < ARRAY_SIZE(event_queues));
+
+	return et->exec_class;
+}
+
+static void exec_class_stats_submit(struct event_header *eh, size_t queue_idx)
+{
+#if CONFIG_EVENT_MANAGER_EXEC_CLASS_STATS
+	struct event_exec_class_stats *stats =
+		&event_manager_exec_class_stats[queue_idx];
+
+	eh->submit_time = k_cycle_get_32();
+	stats->depth++;
+	stats->depth_max = MAX(stats->depth_max, stats->depth);
+#endif
+}
+
+static void exec_class_stats_process(const struct event_header *eh,
+				     size_t queue_idx)
+{
+#if CONFIG_EVENT_MANAGER_EXEC_CLASS_STATS
+	struct event_exec_class_stats *stats =
+		&event_manager_exec_class_stats[queue_idx];
+	uint32_t wait_cycles = k_cycle_get_32() - eh->submit_time;
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	stats->depth--;
+	stats->event_cnt++;
+	stats->wait_cycles_max = MAX(stats->wait_cycles_max, wait_cycles);
+
+	k_spin_unlock(&lock, key);
+#endif
+}
+
 static void event_processor_fn(struct k_work *work)
 {
+	struct event_queue *queue = CONTAINER_OF(work, struct event_queue,
+						 work);
+	size_t queue_idx = queue - event_queues;
 	sys_slist_t events = SYS_SLIST_STATIC_INIT(&events);
 
+	ARG_UNUSED(queue_idx);
+
 	/* Make current event list local. */
 	k_spinlock_key_t key = k_spin_lock(&lock);
 
-	if (sys_slist_is_empty(&eventq)) {
+	if (sys_slist_is_empty(&queue->events)) {
 		k_spin_unlock(&lock, key);
 		return;
 	}
 
-	sys_slist_merge_slist(&events, &eventq);
+	sys_slist_merge_slist(&events, &queue->events);
 
 	k_spin_unlock(&lock, key);
 
@@ -254,43 +577,40 @@ static void event_processor_fn(struct k_work *work)
 
 		ASSERT_EVENT_ID(eh->type_id);
 
-		const struct event_type *et = eh->type_id;
+		exec_class_stats_process(eh, queue_idx);
 
 		trace_event_execution(eh, true);
 
 		log_event(eh);
 
-		bool consumed = false;
+		notify_listeners(eh);
 
-		for (size_t prio = SUBS_PRIO_MIN;
-		     (prio <= SUBS_PRIO_MAX) && !consumed;
-		     prio++) {
-			for (const struct event_subscriber *es =
-					et->subs_start[prio];
-			     (es != et->subs_stop[prio]) && !consumed;
-			     es++) {
-
-				__ASSERT_NO_MSG(es != NULL);
+		trace_event_execution(eh, false);
 
-				const struct event_listener *el = es->listener;
+		event_manager_free(eh);
+	}
+}
 
-				__ASSERT_NO_MSG(el != NULL);
-				__ASSERT_NO_MSG(el->notification != NULL);
+static bool event_coalesce(struct event_queue *queue,
+			   const struct event_header *eh)
+{
+	const struct event_type *et = eh->type_id;
 
-				log_event_progress(et, el);
+	if (!IS_ENABLED(CONFIG_EVENT_MANAGER_EVENT_COALESCING) ||
+	    (et->coalesce_fn == NULL)) {
+		return false;
+	}
 
-				consumed = el->notification(eh);
+	struct event_header *queued;
 
-				if (consumed) {
-					log_event_consumed(et);
-				}
-			}
+	SYS_SLIST_FOR_EACH_CONTAINER(&queue->events, queued, node) {
+		if ((queued->type_id == et) && et->coalesce_fn(queued, eh)) {
+			(*et->coalesced_cnt)++;
+			return true;
 		}
-
-		trace_event_execution(eh, false);
-
-		k_free(eh);
 	}
+
+	return false;
 }
 
 void _event_submit(struct event_header *eh)
@@ -300,16 +620,70 @@ void _event_submit(struct event_header *eh)
 
 	trace_event_submission(eh);
 
+	size_t queue_idx = event_queue_idx(eh->type_id);
+	struct event_queue *queue = &event_queues[queue_idx];
+
 	k_spinlock_key_t key = k_spin_lock(&lock);
-	sys_slist_append(&eventq, &eh->node);
+
+	bool coalesced = event_coalesce(queue, eh);
+
+	if (!coalesced) {
+		exec_class_stats_submit(eh, queue_idx);
+		sys_slist_append(&queue->events, &eh->node);
+	}
+
 	k_spin_unlock(&lock, key);
 
-	k_work_submit(&event_processor);
+	if (coalesced) {
+		event_manager_free(eh);
+		return;
+	}
+
+	k_work_submit_to_queue(queue->work_q, &queue->work);
+}
+
+static void exec_classes_init(void)
+{
+#if CONFIG_EVENT_MANAGER_EXEC_CLASSES
+	k_work_queue_start(&exec_class_high_work_q, exec_class_high_stack,
+			   K_THREAD_STACK_SIZEOF(exec_class_high_stack),
+			   CONFIG_EVENT_MANAGER_EXEC_CLASS_HIGH_PRIORITY, NULL);
+	k_thread_name_set(&exec_class_high_work_q.thread, "em_high");
+
+	k_work_queue_start(&exec_class_low_work_q, exec_class_low_stack,
+			   K_THREAD_STACK_SIZEOF(exec_class_low_stack),
+			   CONFIG_EVENT_MANAGER_EXEC_CLASS_LOW_PRIORITY, NULL);
+	k_thread_name_set(&exec_class_low_work_q.thread, "em_low");
+
+	/* Process events submitted before the work queues were started. */
+	for (size_t i = 0; i < ARRAY_SIZE(event_queues); i++) {
+		k_work_submit_to_queue(event_queues[i].work_q,
+				       &event_queues[i].work);
+	}
+#endif
 }
 
 int event_manager_init(void)
 {
+	int err;
+
 	log_event_init();
 
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_DISPATCH_TABLE)) {
+		err = dispatch_table_init();
+		if (err) {
+			return err;
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_DISPATCH_STATS)) {
+		err = dispatch_stats_init();
+		if (err) {
+			return err;
+		}
+	}
+
+	exec_classes_init();
+
 	return trace_event_init();
 }
@@ -26,6 +26,34 @@ extern "C" {
 #define _SUBS_PRIO_FINAL  2
 
 
+/* Event dispatch statistics collected for every event type. */
+struct event_dispatch_stats {
+	uint32_t event_cnt;
+	uint32_t cycles_max;
+	uint64_t cycles_total;
+};
+
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_STATS
+/* Copy the dispatch statistics of the event type with the given index.
+ * Returns -EINVAL if statistics are not collected for the index.
+ */
+int event_manager_dispatch_stats_get(size_t idx,
+				     struct event_dispatch_stats *stats);
+
+/* Reset the dispatch statistics of all event types. */
+void event_manager_dispatch_stats_reset(void);
+#endif
+
+
+/* Statistics collected for every event execution class. */
+struct event_exec_class_stats {
+	uint32_t depth;
+	uint32_t depth_max;
+	uint32_t wait_cycles_max;
+	uint32_t event_cnt;
+};
+
+
 /* Convenience macros generating section names. */
 
 #define _SUBS_PRIO_ID(level) _CONCAT(_CONCAT(_prio, level), _)
@@ -82,6 +110,52 @@ extern "C" {
 #define _EVENT_ID(ename) (&_CONCAT(__event_type_, ename))
 
 
+/* Memory slab used to allocate events of the given type. */
+#define _EVENT_MEM_SLAB(ename) _CONCAT(__event_mem_slab_, ename)
+
+
+#ifdef CONFIG_EVENT_MANAGER_EVENT_MEM_SLABS
+
+#define _EVENT_MEM_SLAB_DECLARE(ename)					\
+	extern struct k_mem_slab _EVENT_MEM_SLAB(ename)
+
+#define _EVENT_MEM_SLAB_DEFINE(ename)					\
+	_EVENT_MEM_SLAB_DEFINE_NAMED(_EVENT_MEM_SLAB(ename), ename)
+
+/* Slab name is expanded here, as K_MEM_SLAB_DEFINE pastes it into the name of
+ * the slab buffer.
+ */
+#define _EVENT_MEM_SLAB_DEFINE_NAMED(sname, ename)			\
+	K_MEM_SLAB_DEFINE(sname,					\
+			  sizeof(struct ename),				\
+			  CONFIG_EVENT_MANAGER_EVENT_MEM_SLAB_BLOCK_COUNT,	\
+			  __alignof__(struct ename))
+
+#define _EVENT_MEM_SLAB_PTR(ename) (&_EVENT_MEM_SLAB(ename))
+
+#define _EVENT_ALLOC(ename) _event_mem_slab_alloc(&_EVENT_MEM_SLAB(ename))
+
+static inline void *_event_mem_slab_alloc(struct k_mem_slab *slab)
+{
+	void *mem;
+
+	if (k_mem_slab_alloc(slab, &mem, K_NO_WAIT)) {
+		return NULL;
+	}
+
+	return mem;
+}
+
+#else
+
+#define _EVENT_MEM_SLAB_DECLARE(ename)
+#define _EVENT_MEM_SLAB_DEFINE(ename)
+#define _EVENT_MEM_SLAB_PTR(ename) NULL
+#define _EVENT_ALLOC(ename) k_malloc(sizeof(struct ename))
+
+#endif /* CONFIG_EVENT_MANAGER_EVENT_MEM_SLABS */
+
+
 /* Macro generates a function of name new_ename where ename is provided as
  * an argument. Allocator function is used to create an event of the given
  * ename type.
@@ -89,7 +163,7 @@ extern "C" {
 #define _EVENT_ALLOCATOR_FN(ename)					\
 	static inline struct ename *_CONCAT(new_, ename)(void)		\
 	{								\
-		struct ename *event = (struct ename *)k_malloc(sizeof(*event));\
+		struct ename *event = (struct ename *)_EVENT_ALLOC(ename);\
 		BUILD_ASSERT(offsetof(struct ename, header) == 0,	\
 				 "");					\
 		if (unlikely(!event)) {					\
@@ -213,6 +287,7 @@ extern "C" {
 
 #define _EVENT_TYPE_DECLARE(ename)					\
 	_EVENT_TYPE_DECLARE_COMMON(ename);				\
+	_EVENT_MEM_SLAB_DECLARE(ename);					\
 	_EVENT_ALLOCATOR_FN(ename)
 
 
@@ -221,7 +296,28 @@ extern "C" {
 	_EVENT_ALLOCATOR_DYNDATA_FN(ename)
 
 
-#define _EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct)							\
+#define _EVENT_COALESCED_CNT(ename) _CONCAT(__event_coalesced_cnt_, ename)
+
+
+#define _EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct, class)						\
+	_EVENT_MEM_SLAB_DEFINE(ename);											\
+	_EVENT_TYPE_DEFINE_COMMON(ename, init_log_en, log_fn, ev_info_struct, class,					\
+				  _EVENT_MEM_SLAB_PTR(ename), NULL, NULL)
+
+
+/* Events with dynamic data are always allocated from the system heap. */
+#define _EVENT_TYPE_DYNDATA_DEFINE(ename, init_log_en, log_fn, ev_info_struct, class)					\
+	_EVENT_TYPE_DEFINE_COMMON(ename, init_log_en, log_fn, ev_info_struct, class, NULL, NULL, NULL)
+
+
+#define _EVENT_TYPE_COALESCABLE_DEFINE(ename, init_log_en, log_fn, ev_info_struct, class, coalesce_func)			\
+	static uint32_t _EVENT_COALESCED_CNT(ename);									\
+	_EVENT_MEM_SLAB_DEFINE(ename);											\
+	_EVENT_TYPE_DEFINE_COMMON(ename, init_log_en, log_fn, ev_info_struct, class,					\
+				  _EVENT_MEM_SLAB_PTR(ename), coalesce_func, &_EVENT_COALESCED_CNT(ename))
+
+
+#define _EVENT_TYPE_DEFINE_COMMON(ename, init_log_en, log_fn, ev_info_struct, class, slab, coalesce_func, coalesce_cnt)	\
 	_EVENT_SUBSCRIBERS_DEFINE(ename);										\
 	const struct event_type _CONCAT(__event_type_, ename) __used							\
 	__attribute__((__section__("event_types"))) = {									\
@@ -239,6 +335,10 @@ extern "C" {
 		.init_log_enable		= init_log_en,								\
 		.log_event			= log_fn,								\
 		.ev_info			= ev_info_struct,							\
+		.mem_slab			= slab,									\
+		.exec_class			= class,								\
+		.coalesce_fn			= coalesce_func,							\
+		.coalesced_cnt			= coalesce_cnt,								\
 	}
 
 
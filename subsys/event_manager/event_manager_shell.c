@@ -5,11 +5,17 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <shell/shell.h>
 #include <event_manager.h>
 
 uint32_t event_manager_displayed_events;
 
+#ifdef CONFIG_EVENT_MANAGER_EXEC_CLASS_STATS
+extern struct event_exec_class_stats
+	event_manager_exec_class_stats[EVENT_EXEC_CLASS_COUNT];
+#endif
+
 static int show_events(const struct shell *shell, size_t argc,
 		char **argv)
 {
@@ -89,6 +95,113 @@ static int show_subscribers(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_STATS
+static int show_dispatch_stats(const struct shell *shell, size_t argc,
+			       char **argv)
+{
+	size_t event_cnt = __stop_event_types - __start_event_types;
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "Dispatch statistics (count, avg/max [us]):\n");
+
+	for (size_t ev_id = 0; ev_id < event_cnt; ev_id++) {
+		const struct event_type *et = &__start_event_types[ev_id];
+		struct event_dispatch_stats stats;
+
+		if (event_manager_dispatch_stats_get(ev_id, &stats)) {
+			break;
+		}
+
+		uint32_t avg_cycles = (stats.event_cnt > 0) ?
+			(stats.cycles_total / stats.event_cnt) : 0;
+
+		shell_fprintf(shell,
+			      SHELL_NORMAL,
+			      "%d:\t%s\t%u\t%u/%u\n",
+			      ev_id,
+			      et->name,
+			      stats.event_cnt,
+			      (uint32_t)k_cyc_to_us_floor64(avg_cycles),
+			      (uint32_t)k_cyc_to_us_floor64(stats.cycles_max));
+	}
+
+	return 0;
+}
+
+static int reset_dispatch_stats(const struct shell *shell, size_t argc,
+				char **argv)
+{
+	event_manager_dispatch_stats_reset();
+
+	shell_fprintf(shell, SHELL_NORMAL, "Dispatch statistics reset\n");
+
+	return 0;
+}
+#endif /* CONFIG_EVENT_MANAGER_DISPATCH_STATS */
+
+#ifdef CONFIG_EVENT_MANAGER_EXEC_CLASS_STATS
+static int show_exec_class_stats(const struct shell *shell, size_t argc,
+				 char **argv)
+{
+	static const char * const class_names[] = {
+		[EVENT_EXEC_CLASS_HIGH] = "high",
+		[EVENT_EXEC_CLASS_NORMAL] = "normal",
+		[EVENT_EXEC_CLASS_LOW] = "low",
+	};
+
+	BUILD_ASSERT(ARRAY_SIZE(class_names) == EVENT_EXEC_CLASS_COUNT);
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "Execution classes (processed, depth cur/max, "
+		      "max wait [us]):\n");
+
+	for (size_t i = 0; i < EVENT_EXEC_CLASS_COUNT; i++) {
+		struct event_exec_class_stats stats;
+
+		unsigned int key = irq_lock();
+
+		stats = event_manager_exec_class_stats[i];
+		irq_unlock(key);
+
+		shell_fprintf(shell,
+			      SHELL_NORMAL,
+			      "%s:\t%u\t%u/%u\t%u\n",
+			      class_names[i],
+			      stats.event_cnt,
+			      stats.depth,
+			      stats.depth_max,
+			      (uint32_t)k_cyc_to_us_floor64(stats.wait_cycles_max));
+	}
+
+	return 0;
+}
+#endif /* CONFIG_EVENT_MANAGER_EXEC_CLASS_STATS */
+
+#ifdef CONFIG_EVENT_MANAGER_EVENT_COALESCING
+static int show_coalesce_stats(const struct shell *shell, size_t argc,
+			       char **argv)
+{
+	shell_fprintf(shell, SHELL_NORMAL, "Coalesced events:\n");
+
+	for (const struct event_type *et = __start_event_types;
+	     (et != NULL) && (et != __stop_event_types); et++) {
+
+		if (et->coalesced_cnt == NULL) {
+			continue;
+		}
+
+		shell_fprintf(shell,
+			      SHELL_NORMAL,
+			      "%d:\t%s\t%u\n",
+			      et - __start_event_types,
+			      et->name,
+			      *et->coalesced_cnt);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_EVENT_MANAGER_EVENT_COALESCING */
+
 static void set_event_displaying(const struct shell *shell, size_t argc,
 				 char **argv, bool enable)
 {
@@ -168,6 +281,22 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_event_manager,
 	SHELL_CMD_ARG(show_subscribers, NULL, "Show subscribers",
 		      show_subscribers, 0, 0),
 	SHELL_CMD_ARG(show_events, NULL, "Show events", show_events, 0, 0),
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_STATS
+	SHELL_CMD_ARG(show_dispatch_stats, NULL, "Show event dispatch statistics",
+		      show_dispatch_stats, 0, 0),
+	SHELL_CMD_ARG(reset_dispatch_stats, NULL,
+		      "Reset event dispatch statistics",
+		      reset_dispatch_stats, 0, 0),
+#endif
+#ifdef CONFIG_EVENT_MANAGER_EXEC_CLASS_STATS
+	SHELL_CMD_ARG(show_exec_class_stats, NULL,
+		      "Show execution class statistics",
+		      show_exec_class_stats, 0, 0),
+#endif
+#ifdef CONFIG_EVENT_MANAGER_EVENT_COALESCING
+	SHELL_CMD_ARG(show_coalesce_stats, NULL, "Show coalesced events",
+		      show_coalesce_stats, 0, 0),
+#endif
 	SHELL_CMD_ARG(disable, NULL, "Disable displaying event with given ID",
 		      disable_event_displaying, 0,
 		      sizeof(event_manager_displayed_events) * 8 - 1),
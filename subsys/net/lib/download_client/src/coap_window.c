@@ -0,0 +1,434 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#if defined(CONFIG_POSIX_API)
+#include <posix/poll.h>
+#include <posix/sys/socket.h>
+#else
+#include <net/socket.h>
+#endif
+#include <net/coap.h>
+#include <logging/log.h>
+#include <net/download_client.h>
+
+LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
+
+#define COAP_VER 1
+#define FILENAME_SIZE CONFIG_DOWNLOAD_CLIENT_MAX_FILENAME_SIZE
+#define WINDOW_SIZE CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE
+#define MAX_RETRANSMIT CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_RETRIES
+#define ACK_TIMEOUT_MS CONFIG_DOWNLOAD_CLIENT_UDP_SOCK_TIMEO_MS
+
+/* Block size exponent of the largest block */
+#define SZX_MAX CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE
+
+BUILD_ASSERT(ACK_TIMEOUT_MS > 0,
+	     "A receive timeout is needed to retransmit block requests");
+
+#define BLOCK2_NUM(opt) ((unsigned int)(opt) >> 4)
+#define BLOCK2_MORE(opt) (((opt) & 0x08) != 0)
+#define BLOCK2_SZX(opt) ((opt) & 0x07)
+#define BLOCK2(num, szx) (((num) << 4) | (szx))
+
+enum block_state {
+	/* No request pending */
+	BLOCK_FREE,
+	/* Waiting for the response */
+	BLOCK_PENDING,
+	/* Block received, waiting for its turn to be delivered */
+	BLOCK_READY,
+};
+
+int url_parse_file(const char *url, char *file, size_t len);
+int socket_send_buf(int fd, const char *buf, size_t len);
+int fragment_evt_send(struct download_client *client);
+
+static size_t szx_to_bytes(uint8_t szx)
+{
+	return coap_block_size_to_bytes((enum coap_block_size)szx);
+}
+
+/* Largest block size, up to the negotiated one, whose blocks
+ * are aligned with the given offset in the file.
+ */
+static uint8_t szx_at(size_t off, uint8_t szx)
+{
+	while (szx > 0 && (off % szx_to_bytes(szx)) != 0) {
+		szx--;
+	}
+
+	return szx;
+}
+
+static int block_request_send(struct download_client *dl,
+			      struct download_coap_block *b)
+{
+	int err;
+	char file[FILENAME_SIZE];
+	struct coap_packet request;
+	const size_t off = b->off + b->len;
+
+	err = coap_packet_init(&request, dl->buf, sizeof(dl->buf), COAP_VER,
+			       COAP_TYPE_CON, sizeof(b->token), b->token,
+			       COAP_METHOD_GET, b->id);
+	if (err) {
+		LOG_ERR("Failed to init CoAP message, err %d", err);
+		return err;
+	}
+
+	err = url_parse_file(dl->file, file, sizeof(file));
+	if (err) {
+		return err;
+	}
+
+	err = coap_packet_append_option(&request, COAP_OPTION_URI_PATH,
+					file, strlen(file));
+	if (err) {
+		LOG_ERR("Unable add option to request");
+		return err;
+	}
+
+	err = coap_append_option_int(&request, COAP_OPTION_BLOCK2,
+				     BLOCK2(off / szx_to_bytes(b->szx),
+					    b->szx));
+	if (err) {
+		LOG_ERR("Unable to add block2 option");
+		return err;
+	}
+
+	LOG_DBG("CoAP block request: %u (%u bytes)", off,
+		szx_to_bytes(b->szx));
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+		LOG_HEXDUMP_DBG(request.data, request.offset, "CoAP request");
+	}
+
+	b->sent = k_uptime_get();
+
+	err = socket_send_buf(dl->fd, dl->buf, request.offset);
+	if (err) {
+		LOG_ERR("Failed to send CoAP request, errno %d", errno);
+		return err;
+	}
+
+	return 0;
+}
+
+/* Request the part of the block not received yet, with a new message */
+static int block_request(struct download_client *dl,
+			 struct download_coap_block *b, uint8_t szx)
+{
+	b->szx = szx_at(b->off + b->len, szx);
+	b->id = coap_next_id();
+	memcpy(b->token, coap_next_token(), sizeof(b->token));
+	b->retries = 0;
+	b->state = BLOCK_PENDING;
+
+	return block_request_send(dl, b);
+}
+
+static int ack_send(struct download_client *dl, uint16_t id)
+{
+	int err;
+	uint8_t buf[4];
+	struct coap_packet ack;
+
+	err = coap_packet_init(&ack, buf, sizeof(buf), COAP_VER, COAP_TYPE_ACK,
+			       0, NULL, COAP_CODE_EMPTY, id);
+	if (err) {
+		return err;
+	}
+
+	return socket_send_buf(dl->fd, (const char *)buf, ack.offset);
+}
+
+static struct download_coap_block *block_find(struct download_client *dl,
+					      const struct coap_packet *pkt)
+{
+	uint8_t token[8];
+	uint8_t tkl;
+
+	tkl = coap_header_get_token(pkt, token);
+
+	for (size_t i = 0; i < WINDOW_SIZE; i++) {
+		struct download_coap_block *b = &dl->coap.window[i];
+
+		if (b->state != BLOCK_PENDING) {
+			continue;
+		}
+
+		if (coap_header_get_type(pkt) == COAP_TYPE_RESET ||
+		    coap_header_get_code(pkt) == COAP_CODE_EMPTY) {
+			if (coap_header_get_id(pkt) == b->id) {
+				return b;
+			}
+			continue;
+		}
+
+		if (tkl == sizeof(b->token) &&
+		    !memcmp(token, b->token, sizeof(token))) {
+			return b;
+		}
+	}
+
+	return NULL;
+}
+
+/* Returns:
+ *  0 on success, including for responses to requests
+ *    which are no longer pending
+ *  a negative error code if the response is not as expected
+ */
+static int block_response_handle(struct download_client *dl, size_t len,
+				 uint8_t *szx)
+{
+	int err;
+	int block2;
+	size_t off;
+	uint8_t code;
+	uint16_t payload_len;
+	const uint8_t *payload;
+	struct coap_packet response;
+	struct download_coap_block *b;
+
+	err = coap_packet_parse(&response, dl->buf, len, NULL, 0);
+	if (err) {
+		LOG_ERR("Failed to parse CoAP packet, err %d", err);
+		return -EBADMSG;
+	}
+
+	b = block_find(dl, &response);
+	if (!b) {
+		/* Response to a retransmitted request, already received */
+		LOG_DBG("Dropping duplicate CoAP response");
+		return 0;
+	}
+
+	if (coap_header_get_type(&response) == COAP_TYPE_RESET) {
+		LOG_ERR("Server reset the block request");
+		return -ECONNRESET;
+	}
+
+	if (coap_header_get_code(&response) == COAP_CODE_EMPTY) {
+		/* The response will follow separately, stop retransmitting */
+		LOG_DBG("Empty ACK, waiting for separate response");
+		b->sent = k_uptime_get();
+		b->retries = MAX_RETRANSMIT;
+		return 0;
+	}
+
+	if (coap_header_get_type(&response) == COAP_TYPE_CON) {
+		err = ack_send(dl, coap_header_get_id(&response));
+		if (err) {
+			return err;
+		}
+	}
+
+	code = coap_header_get_code(&response);
+	if (code != COAP_RESPONSE_CODE_OK &&
+	    code != COAP_RESPONSE_CODE_CONTENT) {
+		LOG_ERR("Server responded with code 0x%x", code);
+		return -EBADMSG;
+	}
+
+	block2 = coap_get_option_int(&response, COAP_OPTION_BLOCK2);
+	if (block2 < 0 || BLOCK2_SZX(block2) > b->szx) {
+		LOG_ERR("Invalid block2 option in response");
+		return -EBADMSG;
+	}
+
+	off = BLOCK2_NUM(block2) * szx_to_bytes(BLOCK2_SZX(block2));
+	if (off != b->off + b->len) {
+		LOG_ERR("Unexpected block in response: %u", off);
+		return -EBADMSG;
+	}
+
+	payload = coap_packet_get_payload(&response, &payload_len);
+	if (!payload || payload_len > b->size - b->len ||
+	    (payload_len != szx_to_bytes(BLOCK2_SZX(block2)) &&
+	     b->len + payload_len != b->size)) {
+		LOG_ERR("Unexpected CoAP payload length %u", payload_len);
+		return -EBADMSG;
+	}
+
+	memcpy(b->buf + b->len, payload, payload_len);
+	b->len += payload_len;
+
+	if (BLOCK2_SZX(block2) < *szx) {
+		/* The server prefers smaller blocks, use them from now on */
+		LOG_INF("Block size negotiated down to %u bytes",
+			szx_to_bytes(BLOCK2_SZX(block2)));
+		*szx = BLOCK2_SZX(block2);
+	}
+
+	if (b->len == b->size) {
+		b->state = BLOCK_READY;
+		return 0;
+	}
+
+	/* The block was served in smaller blocks, request the rest */
+	return block_request(dl, b, *szx);
+}
+
+/* Hand the received blocks to the application, in order */
+static int window_deliver(struct download_client *dl)
+{
+	bool delivered;
+
+	do {
+		delivered = false;
+
+		for (size_t i = 0; i < WINDOW_SIZE; i++) {
+			struct download_coap_block *b = &dl->coap.window[i];
+
+			if (b->state != BLOCK_READY ||
+			    b->off != dl->progress) {
+				continue;
+			}
+
+			memcpy(dl->buf, b->buf, b->len);
+			dl->offset = b->len;
+			dl->progress += b->len;
+			b->state = BLOCK_FREE;
+			delivered = true;
+
+			LOG_INF("Downloaded %u/%u bytes (%d%%)",
+				dl->progress, dl->file_size,
+				(dl->progress * 100) / dl->file_size);
+
+			if (fragment_evt_send(dl)) {
+				return -ECANCELED;
+			}
+		}
+	} while (delivered);
+
+	return 0;
+}
+
+/* Retransmit the requests whose response is overdue.
+ * Returns the time until the next retransmission, in milliseconds,
+ * or a negative error code.
+ */
+static int window_retransmit(struct download_client *dl)
+{
+	int err;
+	int64_t now = k_uptime_get();
+	int64_t next = ACK_TIMEOUT_MS;
+
+	for (size_t i = 0; i < WINDOW_SIZE; i++) {
+		struct download_coap_block *b = &dl->coap.window[i];
+		int64_t timeout;
+
+		if (b->state != BLOCK_PENDING) {
+			continue;
+		}
+
+		/* Exponential back-off, like CoAP confirmable messages */
+		timeout = (int64_t)ACK_TIMEOUT_MS << b->retries;
+
+		if (now - b->sent < timeout) {
+			next = MIN(next, b->sent + timeout - now);
+			continue;
+		}
+
+		if (b->retries == MAX_RETRANSMIT) {
+			LOG_ERR("No response for block at %u", b->off + b->len);
+			return -ETIMEDOUT;
+		}
+
+		b->retries++;
+		LOG_DBG("Retransmitting block request %u (%u/%u)",
+			b->off + b->len, b->retries, MAX_RETRANSMIT);
+
+		err = block_request_send(dl, b);
+		if (err) {
+			return err;
+		}
+
+		next = MIN(next, timeout << 1);
+	}
+
+	return (int)next;
+}
+
+int coap_window_download(struct download_client *dl)
+{
+	int rc;
+	ssize_t len;
+	size_t next = dl->progress;
+	/* Block size negotiated with the server in the first exchange */
+	uint8_t szx = MIN(dl->coap.block_ctx.block_size, SZX_MAX);
+	struct pollfd fd = {
+		.fd = dl->fd,
+		.events = POLLIN,
+	};
+
+	for (size_t i = 0; i < WINDOW_SIZE; i++) {
+		dl->coap.window[i].state = BLOCK_FREE;
+	}
+
+	while (dl->progress < dl->file_size) {
+		/* Request the next blocks on free window slots.
+		 * Blocks grow up to the negotiated size
+		 * as soon as the offset is aligned.
+		 */
+		for (size_t i = 0; i < WINDOW_SIZE && next < dl->file_size;
+		     i++) {
+			struct download_coap_block *b = &dl->coap.window[i];
+
+			if (b->state != BLOCK_FREE) {
+				continue;
+			}
+
+			b->off = next;
+			b->len = 0;
+			b->size = MIN(szx_to_bytes(szx_at(next, szx)),
+				      dl->file_size - next);
+			next += b->size;
+
+			rc = block_request(dl, b, szx);
+			if (rc) {
+				return rc;
+			}
+		}
+
+		rc = window_deliver(dl);
+		if (rc || dl->progress == dl->file_size) {
+			return rc;
+		}
+
+		rc = window_retransmit(dl);
+		if (rc < 0) {
+			return rc;
+		}
+
+		rc = poll(&fd, 1, rc);
+		if (rc < 0) {
+			LOG_ERR("Error in poll(), errno %d", errno);
+			return -errno;
+		}
+
+		if (rc == 0) {
+			/* Retransmission time */
+			continue;
+		}
+
+		len = recv(dl->fd, dl->buf, sizeof(dl->buf), 0);
+		if (len < 0) {
+			LOG_ERR("Error in recv(), errno %d", errno);
+			return -errno;
+		}
+
+		rc = block_response_handle(dl, len, &szx);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
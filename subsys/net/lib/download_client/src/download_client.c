@@ -38,6 +38,15 @@ int http_get_request_send(struct download_client *client);
 int coap_block_init(struct download_client *client, size_t from);
 int coap_parse(struct download_client *client, size_t len);
 int coap_request_send(struct download_client *client);
+int coap_window_download(struct download_client *client);
+
+void frag_queue_init(struct download_client *client);
+void frag_queue_reset(struct download_client *client);
+int frag_queue_put(struct download_client *client);
+int frag_queue_flush(struct download_client *client);
+
+int streams_download(struct download_client *client);
+void streams_init(struct download_client *client);
 
 static const char *str_family(int family)
 {
@@ -362,13 +371,43 @@ cleanup:
 	return err;
 }
 
-int socket_send(const struct download_client *client, size_t len)
+static int host_resolve(const char *host,
+			const struct download_client_cfg *config,
+			struct sockaddr *sa)
+{
+	int err = 0;
+
+	/* Attempt IPv6 connection if configured, fallback to IPv4 */
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_IPV6)) {
+		err = host_lookup(host, AF_INET6, config->pdn_id, config->apn, sa);
+	}
+	if (err || !IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_IPV6)) {
+		err = host_lookup(host, AF_INET, config->pdn_id, config->apn, sa);
+	}
+
+	return err;
+}
+
+int stream_connect(struct download_client *dl, int *fd)
+{
+	int err;
+	struct sockaddr sa;
+
+	err = host_resolve(dl->host, &dl->config, &sa);
+	if (err) {
+		return err;
+	}
+
+	return client_connect(dl, dl->host, &sa, fd);
+}
+
+int socket_send_buf(int fd, const char *buf, size_t len)
 {
 	int sent;
 	size_t off = 0;
 
 	while (len) {
-		sent = send(client->fd, client->buf + off, len, 0);
+		sent = send(fd, buf + off, len, 0);
 		if (sent <= 0) {
 			return -errno;
 		}
@@ -380,6 +419,11 @@ int socket_send(const struct download_client *client, size_t len)
 	return 0;
 }
 
+int socket_send(const struct download_client *client, size_t len)
+{
+	return socket_send_buf(client->fd, client->buf, len);
+}
+
 static int request_send(struct download_client *dl)
 {
 	switch (dl->proto) {
@@ -396,11 +440,18 @@ static int request_send(struct download_client *dl)
 	return 0;
 }
 
-static int fragment_evt_send(const struct download_client *client)
+int fragment_evt_send(struct download_client *client)
 {
 	__ASSERT(client->offset <= CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
 		 "Buffer overflow!");
 
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_FRAGMENT_QUEUE)) {
+		/* The fragment is handed to the application
+		 * while the next one is being received.
+		 */
+		return frag_queue_put(client);
+	}
+
 	const struct download_client_evt evt = {
 		.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
 		.fragment = {
@@ -412,11 +463,21 @@ static int fragment_evt_send(const struct download_client *client)
 	return client->callback(&evt);
 }
 
-static int error_evt_send(const struct download_client *dl, int error)
+static int error_evt_send(struct download_client *dl, int error)
 {
+	int rc;
+
 	/* Error will be sent as negative. */
 	__ASSERT_NO_MSG(error > 0);
 
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_FRAGMENT_QUEUE)) {
+		/* Report the error after the fragments received before it */
+		rc = frag_queue_flush(dl);
+		if (rc) {
+			return rc;
+		}
+	}
+
 	const struct download_client_evt evt = {
 		.id = DOWNLOAD_CLIENT_EVT_ERROR,
 		.error = -error
@@ -430,6 +491,12 @@ static int reconnect(struct download_client *dl)
 	int err;
 
 	LOG_INF("Reconnecting..");
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINING)
+	/* Any pipelined request is lost with the connection */
+	dl->http.pipelined = false;
+#endif
+
 	err = download_client_disconnect(dl);
 	if (err) {
 		return err;
@@ -448,9 +515,15 @@ void download_thread(void *client, void *a, void *b)
 	int rc = 0;
 	int error_cause;
 	size_t len;
+	size_t rx_len;
 	struct download_client *const dl = client;
 
 restart_and_suspend:
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_FRAGMENT_QUEUE)) {
+		/* Let the application process any queued fragment */
+		(void)frag_queue_flush(dl);
+	}
+
 	k_thread_suspend(dl->tid);
 
 	while (true) {
@@ -463,11 +536,18 @@ restart_and_suspend:
 			break;
 		}
 
+		rx_len = sizeof(dl->buf) - dl->offset;
+		if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINING) &&
+		    dl->http.has_header &&
+		    (dl->proto == IPPROTO_TCP || dl->proto == IPPROTO_TLS_1_2)) {
+			/* Do not read into the pipelined response */
+			rx_len = MIN(rx_len, dl->http.body_remaining);
+		}
+
 		LOG_DBG("Receiving up to %d bytes at %p...",
-			(sizeof(dl->buf) - dl->offset), (dl->buf + dl->offset));
+			rx_len, (dl->buf + dl->offset));
 
-		len = recv(dl->fd, dl->buf + dl->offset,
-			   sizeof(dl->buf) - dl->offset, 0);
+		len = recv(dl->fd, dl->buf + dl->offset, rx_len, 0);
 
 		if ((len == 0) || (len == -1)) {
 			/* We just had an unexpected socket error or closure */
@@ -561,7 +641,76 @@ restart_and_suspend:
 			break;
 		}
 
+		if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_STREAMS) &&
+		    dl->progress != dl->file_size &&
+		    (dl->proto == IPPROTO_TLS_1_2 ||
+		     (dl->proto == IPPROTO_TCP &&
+		      IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS)))) {
+			/* The file size is known now, download the rest
+			 * of the file over parallel range request streams.
+			 */
+			rc = streams_download(dl);
+			if (rc == -ECANCELED) {
+				/* Restart and suspend */
+				LOG_INF("Fragment refused, download stopped.");
+				break;
+			}
+			if (rc) {
+				rc = error_evt_send(dl, ECONNRESET);
+				if (rc) {
+					/* Restart and suspend */
+					break;
+				}
+
+				/* Resume with a single stream */
+				rc = download_client_connect(dl, dl->host,
+							     &dl->config);
+				if (rc) {
+					error_evt_send(dl, EHOSTDOWN);
+					break;
+				}
+
+				goto send_again;
+			}
+		}
+
+		if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW) &&
+		    dl->file_size != 0 && dl->progress != dl->file_size &&
+		    (dl->proto == IPPROTO_UDP ||
+		     dl->proto == IPPROTO_DTLS_1_2)) {
+			/* The file size and the block size are known now,
+			 * download the rest of the file with several
+			 * outstanding block requests.
+			 */
+			rc = coap_window_download(dl);
+			if (rc == -ECANCELED) {
+				/* Restart and suspend */
+				LOG_INF("Fragment refused, download stopped.");
+				break;
+			}
+			if (rc) {
+				rc = error_evt_send(dl, rc == -ETIMEDOUT ?
+						    ETIMEDOUT : EBADMSG);
+				if (rc) {
+					/* Restart and suspend */
+					break;
+				}
+
+				/* Resume one block at a time */
+				coap_block_init(dl, dl->progress);
+				goto send_again;
+			}
+		}
+
 		if (dl->progress == dl->file_size) {
+			if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_FRAGMENT_QUEUE)) {
+				rc = frag_queue_flush(dl);
+				if (rc) {
+					/* Restart and suspend */
+					break;
+				}
+			}
+
 			LOG_INF("Download complete");
 			const struct download_client_evt evt = {
 				.id = DOWNLOAD_CLIENT_EVT_DONE,
@@ -584,6 +733,14 @@ send_again:
 		   || IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS)) {
 			dl->http.has_header = false;
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINING)
+			if (dl->http.pipelined) {
+				/* Requested while receiving the last one */
+				dl->http.pipelined = false;
+				continue;
+			}
+#endif
+
 			rc = request_send(dl);
 			if (rc) {
 				rc = error_evt_send(dl, ECONNRESET);
@@ -617,6 +774,14 @@ int download_client_init(struct download_client *const client,
 	client->fd = -1;
 	client->callback = callback;
 
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_FRAGMENT_QUEUE)) {
+		frag_queue_init(client);
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_STREAMS)) {
+		streams_init(client);
+	}
+
 	/* The thread is spawned now, but it will suspend itself;
 	 * it is resumed when the download is started via the API.
 	 */
@@ -651,15 +816,7 @@ int download_client_connect(struct download_client *client, const char *host,
 		return -E2BIG;
 	}
 
-	err = 0;
-	/* Attempt IPv6 connection if configured, fallback to IPv4 */
-	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_IPV6)) {
-		err = host_lookup(host, AF_INET6, config->pdn_id, config->apn, &sa);
-	}
-	if (err || !IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_IPV6)) {
-		err = host_lookup(host, AF_INET, config->pdn_id, config->apn, &sa);
-	}
-
+	err = host_resolve(host, config, &sa);
 	if (err) {
 		return err;
 	}
@@ -713,6 +870,13 @@ int download_client_start(struct download_client *client, const char *file,
 
 	client->offset = 0;
 	client->http.has_header = false;
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINING)
+	client->http.pipelined = false;
+#endif
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_FRAGMENT_QUEUE)) {
+		frag_queue_reset(client);
+	}
 
 	if (client->proto == IPPROTO_UDP || client->proto == IPPROTO_DTLS_1_2) {
 		if (IS_ENABLED(CONFIG_COAP)) {
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <logging/log.h>
+#include <net/download_client.h>
+
+LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
+
+#define QUEUE_LEN CONFIG_DOWNLOAD_CLIENT_FRAGMENT_QUEUE_LEN
+
+static void frag_queue_thread(void *client, void *a, void *b)
+{
+	struct download_client *const dl = client;
+	size_t idx = 0;
+	int rc;
+
+	while (true) {
+		k_sem_take(&dl->frag_queue.ready, K_FOREVER);
+
+		/* Once a fragment has been refused, drop the queued ones */
+		if (dl->frag_queue.err == 0) {
+			const struct download_client_evt evt = {
+				.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
+				.fragment = {
+					.buf = dl->frag_queue.buf[idx],
+					.len = dl->frag_queue.len[idx],
+				}
+			};
+
+			rc = dl->callback(&evt);
+			if (rc) {
+				LOG_INF("Fragment refused, download stopped.");
+				dl->frag_queue.err = rc;
+			}
+		}
+
+		idx = (idx + 1) % QUEUE_LEN;
+		k_sem_give(&dl->frag_queue.free);
+	}
+}
+
+void frag_queue_init(struct download_client *client)
+{
+	client->frag_queue.head = 0;
+	client->frag_queue.err = 0;
+
+	k_sem_init(&client->frag_queue.free, QUEUE_LEN, QUEUE_LEN);
+	k_sem_init(&client->frag_queue.ready, 0, QUEUE_LEN);
+
+	client->frag_queue.tid =
+		k_thread_create(&client->frag_queue.thread,
+				client->frag_queue.thread_stack,
+				K_THREAD_STACK_SIZEOF(
+					client->frag_queue.thread_stack),
+				frag_queue_thread, client, NULL, NULL,
+				K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+
+	k_thread_name_set(client->frag_queue.tid, "download_client_frag");
+}
+
+void frag_queue_reset(struct download_client *client)
+{
+	client->frag_queue.err = 0;
+}
+
+int frag_queue_put(struct download_client *client)
+{
+	size_t idx = client->frag_queue.head;
+
+	/* Wait for a free buffer, if all of them are being processed */
+	k_sem_take(&client->frag_queue.free, K_FOREVER);
+
+	if (client->frag_queue.err) {
+		k_sem_give(&client->frag_queue.free);
+		return client->frag_queue.err;
+	}
+
+	memcpy(client->frag_queue.buf[idx], client->buf, client->offset);
+	client->frag_queue.len[idx] = client->offset;
+	client->frag_queue.head = (idx + 1) % QUEUE_LEN;
+
+	k_sem_give(&client->frag_queue.ready);
+
+	return 0;
+}
+
+int frag_queue_flush(struct download_client *client)
+{
+	/* All buffers are free once the queued fragments are processed */
+	for (size_t i = 0; i < QUEUE_LEN; i++) {
+		k_sem_take(&client->frag_queue.free, K_FOREVER);
+	}
+
+	for (size_t i = 0; i < QUEUE_LEN; i++) {
+		k_sem_give(&client->frag_queue.free);
+	}
+
+	return client->frag_queue.err;
+}
@@ -43,6 +43,7 @@ LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 int url_parse_host(const char *url, char *host, size_t len);
 int url_parse_file(const char *url, char *file, size_t len);
 int socket_send(const struct download_client *client, size_t len);
+int socket_send_buf(int fd, const char *buf, size_t len);
 
 int http_get_request_send(struct download_client *client)
 {
@@ -111,6 +112,220 @@ int http_get_request_send(struct download_client *client)
 	return 0;
 }
 
+int http_range_request_send(struct download_client *client, int fd,
+			    char *buf, size_t buf_len, size_t from, size_t to)
+{
+	int err;
+	int len;
+	char host[HOSTNAME_SIZE];
+	char file[FILENAME_SIZE];
+
+	__ASSERT_NO_MSG(client->host);
+	__ASSERT_NO_MSG(client->file);
+
+	err = url_parse_host(client->host, host, sizeof(host));
+	if (err) {
+		return err;
+	}
+
+	err = url_parse_file(client->file, file, sizeof(file));
+	if (err) {
+		return err;
+	}
+
+	len = snprintf(buf, buf_len, HTTP_GET_RANGE, file, host, from, to);
+	if (len < 0 || len >= buf_len) {
+		LOG_ERR("Cannot create GET request, buffer too small");
+		return -ENOMEM;
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+		LOG_HEXDUMP_DBG(buf, len, "HTTP request");
+	}
+
+	err = socket_send_buf(fd, buf, len);
+	if (err) {
+		LOG_ERR("Failed to send HTTP request, errno %d", errno);
+		return err;
+	}
+
+	return 0;
+}
+
+/* Match a header field name, case-insensitively, and return its value. */
+static bool hdr_field_match(const char *line, size_t len, const char *name,
+			    const char **value, size_t *value_len)
+{
+	const size_t name_len = strlen(name);
+	size_t i;
+
+	if (len <= name_len || line[name_len] != ':') {
+		return false;
+	}
+
+	for (i = 0; i < name_len; i++) {
+		if (tolower((unsigned char)line[i]) != name[i]) {
+			return false;
+		}
+	}
+
+	/* Skip the colon and any leading whitespace */
+	for (i = name_len + 1; i < len && line[i] == ' '; i++) {
+	}
+
+	*value = line + i;
+	*value_len = len - i;
+
+	return true;
+}
+
+/* Look for a token in a header field value, case-insensitively. */
+static bool hdr_value_has(const char *value, size_t len, const char *token)
+{
+	const size_t token_len = strlen(token);
+
+	for (size_t i = 0; i + token_len <= len; i++) {
+		size_t j;
+
+		for (j = 0; j < token_len; j++) {
+			if (tolower((unsigned char)value[i + j]) != token[j]) {
+				break;
+			}
+		}
+		if (j == token_len) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Parse a header line, excluding the line terminator.
+ * The line is always followed by its terminator in the buffer,
+ * so numbers can be parsed in place.
+ */
+static int hdr_line_parse(struct download_http_hdr *hdr, const char *line,
+			  size_t len)
+{
+	const char *value;
+	size_t value_len;
+	char *end;
+
+	if (hdr->status == 0) {
+		/* Status line, e.g. "HTTP/1.1 206 Partial Content" */
+		if (len < strlen("HTTP/1.1 200") ||
+		    !hdr_value_has(line, strlen("http/1.1 "), "http/1.1 ")) {
+			LOG_ERR("Server response missing HTTP/1.1");
+			return -1;
+		}
+		hdr->status = strtoul(line + strlen("http/1.1 "), &end, 10);
+		if (end == line + strlen("http/1.1 ") || hdr->status == 0) {
+			LOG_ERR("Server response malformed: "
+				"status code not found");
+			return -1;
+		}
+		return 0;
+	}
+
+	if (hdr_field_match(line, len, "content-length", &value, &value_len)) {
+		hdr->content_length = strtoul(value, &end, 10);
+		if (end == value) {
+			LOG_ERR("Server response malformed: Content-Length");
+			return -1;
+		}
+		hdr->has_content_length = true;
+	} else if (hdr_field_match(line, len, "content-range", &value,
+				   &value_len)) {
+		/* "bytes <first>-<last>/<complete length>" */
+		if (value_len < strlen("bytes ") ||
+		    !hdr_value_has(value, strlen("bytes "), "bytes ")) {
+			LOG_ERR("Server response malformed: Content-Range");
+			return -1;
+		}
+		hdr->range_start = strtoul(value + strlen("bytes "), &end, 10);
+		if (*end != '-') {
+			LOG_ERR("Server response malformed: Content-Range");
+			return -1;
+		}
+		hdr->range_end = strtoul(end + 1, &end, 10);
+		if (*end != '/' || hdr->range_end < hdr->range_start) {
+			LOG_ERR("Server response malformed: Content-Range");
+			return -1;
+		}
+		/* The complete length is "*" when unknown */
+		hdr->range_total = strtoul(end + 1, NULL, 10);
+		hdr->has_content_range = true;
+	} else if (hdr_field_match(line, len, "connection", &value,
+				   &value_len)) {
+		hdr->connection_close = hdr_value_has(value, value_len,
+						      "close");
+	} else if (hdr_field_match(line, len, "transfer-encoding", &value,
+				   &value_len)) {
+		hdr->chunked = hdr_value_has(value, value_len, "chunked");
+	}
+
+	return 0;
+}
+
+/* Parse the response header incrementally, starting where the previous
+ * call has stopped, so that each byte is examined only once regardless
+ * of how the header is split across recv() calls.
+ *
+ * Returns:
+ *  1 while the header is being received
+ *  0 if the header has been fully received, and sets @p hdr_len
+ * -1 on error
+ */
+int http_hdr_feed(struct download_http_hdr *hdr, const char *buf, size_t len,
+		  size_t *hdr_len)
+{
+	for (size_t i = hdr->scan; i < len; i++) {
+		size_t line_len;
+
+		if (buf[i] != '\n') {
+			continue;
+		}
+
+		line_len = i - hdr->line;
+		if (line_len > 0 && buf[i - 1] == '\r') {
+			line_len--;
+		}
+
+		if (line_len == 0 && hdr->status != 0) {
+			/* Empty line, end of the header */
+			hdr->scan = i + 1;
+			*hdr_len = i + 1;
+			return 0;
+		}
+
+		/* Empty lines before the status line are ignored */
+		if (line_len > 0 &&
+		    hdr_line_parse(hdr, buf + hdr->line, line_len)) {
+			return -1;
+		}
+
+		hdr->line = i + 1;
+	}
+
+	hdr->scan = len;
+
+	return 1;
+}
+
+static bool using_range_requests(const struct download_client *client)
+{
+	return (client->proto == IPPROTO_TLS_1_2 ||
+		IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS) ||
+		client->progress);
+}
+
+static size_t frag_size(const struct download_client *client)
+{
+	return client->config.frag_size_override != 0 ?
+	       client->config.frag_size_override :
+	       CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+}
+
 /* Returns:
  *  1 while the header is being received
  *  0 if the header has been fully received
@@ -118,105 +333,77 @@ int http_get_request_send(struct download_client *client)
  */
 static int http_header_parse(struct download_client *client, size_t *hdr_len)
 {
-	char *p;
-	char *q;
-	unsigned int http_status;
-	const bool using_range_requests =
-		(client->proto == IPPROTO_TLS_1_2 ||
-		 IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS) ||
-		 client->progress);
-
-	const unsigned int expected_status = using_range_requests ? 206 : 200;
-
-	p = strstr(client->buf, "\r\n\r\n");
-	if (!p || p > client->buf + client->offset) {
+	int rc;
+	struct download_http_hdr *hdr = &client->http.hdr;
+	const bool range = using_range_requests(client);
+	const unsigned int expected_status = range ? 206 : 200;
+
+	rc = http_hdr_feed(hdr, client->buf, client->offset, hdr_len);
+	if (rc > 0) {
 		/* Waiting full HTTP header */
 		LOG_DBG("Waiting full header in response");
 		return 1;
 	}
-
-	/* Offset of the end of the HTTP header in the buffer */
-	*hdr_len = p + strlen("\r\n\r\n") - client->buf;
+	if (rc < 0) {
+		return -1;
+	}
 
 	LOG_DBG("GET header size: %u", *hdr_len);
 	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
 		LOG_HEXDUMP_DBG(client->buf, *hdr_len, "HTTP response");
 	}
 
-	for (size_t i = 0; i < *hdr_len; i++) {
-		client->buf[i] = tolower(client->buf[i]);
-	}
-
-	/* Look for the status code just after "http/1.1 " */
-	p = strstr(client->buf, "http/1.1 ");
-	if (!p) {
-		LOG_ERR("Server response missing HTTP/1.1");
+	if (hdr->status != expected_status) {
+		LOG_ERR("Unexpected HTTP response: %u", hdr->status);
 		return -1;
 	}
-	p += strlen("http/1.1 ");
 
-	http_status = strtoul(p, &q, 10);
-	if (!q) {
-		LOG_ERR("Server response malformed: status code not found");
-		return -1;
-	}
-
-	if (http_status != expected_status) {
-		/* Truncate the server response at the first CR or LF after the
-		 * status and message so we can log it. Normally we can't
-		 * modify the response like this since we'd need to look at
-		 * data beyond this point, but we're already in a failing
-		 * condition.
-		 */
-		while ((*q != '\0') && (*q != '\r') && (*q != '\n')) {
-			q++;
-		}
-		*q = '\0';
-
-		LOG_ERR("Unexpected HTTP response: %s", log_strdup(p));
+	if (hdr->chunked) {
+		LOG_ERR("Chunked transfer coding is not supported");
 		return -1;
 	}
 
 	/* The file size is returned via "Content-Length" in case of HTTP,
 	 * and via "Content-Range" in case of HTTPS with range requests.
 	 */
-	if (client->file_size == 0) {
-		if (using_range_requests) {
-			p = strstr(client->buf, "content-range");
-			if (!p) {
-				LOG_ERR("Server did not send "
-					"\"Content-Range\" in response");
-				return -1;
-			}
-			p = strstr(p, "/");
-			if (!p) {
-				LOG_ERR("No file size in response");
-				return -1;
-			}
-		} else { /* proto == PROTO_HTTP */
-			p = strstr(client->buf, "content-length");
-			if (!p) {
-				LOG_WRN("Server did not send "
-					"\"Content-Length\" in response");
-					return -1;
-			}
-			p = strstr(p, ":");
-			if (!p) {
+	if (range) {
+		if (!hdr->has_content_range) {
+			LOG_ERR("Server did not send "
+				"\"Content-Range\" in response");
+			return -1;
+		}
+		if (hdr->range_start != client->progress) {
+			LOG_ERR("Unexpected range in response");
+			return -1;
+		}
+		if (client->file_size == 0) {
+			if (hdr->range_total == 0) {
 				LOG_ERR("No file size in response");
 				return -1;
 			}
+			client->file_size = hdr->range_total;
+		}
+		client->http.body_remaining =
+			hdr->range_end - hdr->range_start + 1;
+	} else {
+		if (!hdr->has_content_length) {
+			LOG_WRN("Server did not send "
+				"\"Content-Length\" in response");
+			return -1;
+		}
+		if (client->file_size == 0) {
 			/* Accumulate any eventual progress (starting offset)
 			 * when reading the file size from Content-Length
 			 */
-			client->file_size = client->progress;
+			client->file_size = client->progress +
+					    hdr->content_length;
 		}
-
-		client->file_size += atoi(p + 1);
-		LOG_DBG("File size = %u", client->file_size);
+		client->http.body_remaining = hdr->content_length;
 	}
 
-	p = strstr(client->buf, "connection: close");
-	if (p) {
+	LOG_DBG("File size = %u", client->file_size);
+
+	if (hdr->connection_close) {
 		LOG_WRN("Peer closed connection, will re-connect");
 		client->http.connection_close = true;
 	}
@@ -226,6 +413,42 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 	return 0;
 }
 
+/* Request the fragment following the current response on the same
+ * connection, so that the server sends it right after the current one.
+ * Called once the header of the current response has been received.
+ */
+static void http_next_request_send(struct download_client *client)
+{
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINING)
+	int err;
+	size_t from;
+	size_t to;
+
+	if (client->http.connection_close ||
+	    !(client->proto == IPPROTO_TLS_1_2 ||
+	      IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS))) {
+		return;
+	}
+
+	from = client->http.hdr.range_end + 1;
+	if (from >= client->file_size) {
+		return;
+	}
+
+	to = MIN(from + frag_size(client) - 1, client->file_size - 1);
+
+	err = http_range_request_send(client, client->fd,
+				      client->http.request,
+				      sizeof(client->http.request), from, to);
+	if (err) {
+		/* Request it once the current fragment is received */
+		return;
+	}
+
+	client->http.pipelined = true;
+#endif
+}
+
 /* Returns:
  *  1 if more data is expected
  *  0 if a whole fragment has been received
@@ -236,6 +459,11 @@ int http_parse(struct download_client *client, size_t len)
 	int rc;
 	size_t hdr_len;
 
+	if (!client->http.has_header && client->offset == 0) {
+		/* A new response begins */
+		memset(&client->http.hdr, 0, sizeof(client->http.hdr));
+	}
+
 	/* Accumulate buffer offset */
 	client->offset += len;
 
@@ -257,8 +485,8 @@ int http_parse(struct download_client *client, size_t len)
 			 */
 			LOG_DBG("Copying %u payload bytes",
 				client->offset - hdr_len);
-			memcpy(client->buf, client->buf + hdr_len,
-			       client->offset - hdr_len);
+			memmove(client->buf, client->buf + hdr_len,
+				client->offset - hdr_len);
 
 			client->offset -= hdr_len;
 		} else {
@@ -267,22 +495,32 @@ int http_parse(struct download_client *client, size_t len)
 			 */
 			client->offset = 0;
 		}
+
+		/* Only the payload bytes account for progress */
+		len = client->offset;
+
+		http_next_request_send(client);
 	}
 
-	/* Accumulate overall file progress.
-	 * If the last recv() call read an HTTP header,
-	 * `offset` has been moved at the end of any trailing
-	 * payload bytes by http_header_parse(). In this case,
-	 * `offset` is less than `len` and it represents
-	 * the actual payload bytes.
-	 */
-	client->progress += MIN(client->offset, len);
+	if (len > client->http.body_remaining) {
+		/* Discard anything past the end of the response body */
+		LOG_WRN("Discarding %u bytes past the response body",
+			len - client->http.body_remaining);
+		client->offset -= len - client->http.body_remaining;
+		len = client->http.body_remaining;
+	}
+
+	client->http.body_remaining -= len;
 
-	/* Have we received a whole fragment or the whole file? */
+	/* Accumulate overall file progress */
+	client->progress += len;
+
+	/* Have we received a whole fragment, the whole response,
+	 * or the whole file?
+	 */
 	if (client->progress != client->file_size &&
-	    client->offset < (client->config.frag_size_override != 0 ?
-			      client->config.frag_size_override :
-			      CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE)) {
+	    client->http.body_remaining > 0 &&
+	    client->offset < frag_size(client)) {
 		return 1;
 	}
 
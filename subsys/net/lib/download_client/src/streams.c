@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#if defined(CONFIG_POSIX_API)
+#include <posix/unistd.h>
+#include <posix/poll.h>
+#include <posix/sys/socket.h>
+#else
+#include <net/socket.h>
+#endif
+#include <logging/log.h>
+#include <net/download_client.h>
+
+LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
+
+#define STREAM_CNT CONFIG_DOWNLOAD_CLIENT_RANGE_STREAM_CNT
+#define STREAM_RETRIES CONFIG_DOWNLOAD_CLIENT_RANGE_STREAM_RETRIES
+
+enum stream_state {
+	/* No request pending */
+	STREAM_IDLE,
+	/* Receiving a fragment */
+	STREAM_BUSY,
+	/* Fragment received, waiting for its turn to be delivered */
+	STREAM_READY,
+};
+
+int stream_connect(struct download_client *dl, int *fd);
+int fragment_evt_send(struct download_client *client);
+int http_range_request_send(struct download_client *client, int fd,
+			    char *buf, size_t buf_len, size_t from, size_t to);
+int http_hdr_feed(struct download_http_hdr *hdr, const char *buf, size_t len,
+		  size_t *hdr_len);
+
+static size_t frag_size_get(const struct download_client *dl)
+{
+	return dl->config.frag_size_override ?
+	       dl->config.frag_size_override :
+	       CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+}
+
+static void stream_close(struct download_stream *s)
+{
+	if (s->fd >= 0) {
+		close(s->fd);
+		s->fd = -1;
+	}
+}
+
+static void stream_reset(struct download_stream *s)
+{
+	s->offset = 0;
+	s->has_header = false;
+	memset(&s->hdr, 0, sizeof(s->hdr));
+	s->state = STREAM_BUSY;
+}
+
+static int stream_request(struct download_client *dl,
+			  struct download_stream *s)
+{
+	int err;
+
+	if (s->fd < 0) {
+		err = stream_connect(dl, &s->fd);
+		if (err) {
+			return err;
+		}
+	}
+
+	stream_reset(s);
+
+	return http_range_request_send(dl, s->fd, s->buf, sizeof(s->buf),
+				       s->from, s->from + s->len - 1);
+}
+
+/* Reconnect a stream and request its fragment again */
+static int stream_retry(struct download_client *dl, struct download_stream *s)
+{
+	int err;
+
+	stream_close(s);
+
+	while (s->retries < STREAM_RETRIES) {
+		s->retries++;
+		LOG_WRN("Retrying bytes %u-%u (%u/%u)", s->from,
+			s->from + s->len - 1, s->retries, STREAM_RETRIES);
+
+		err = stream_request(dl, s);
+		if (!err) {
+			return 0;
+		}
+
+		stream_close(s);
+	}
+
+	LOG_ERR("Failed to download bytes %u-%u", s->from,
+		s->from + s->len - 1);
+
+	return -ECONNRESET;
+}
+
+/* Returns:
+ *  1 while the header is being received
+ *  0 if the header has been fully received
+ * -1 on error
+ */
+static int stream_header_parse(struct download_stream *s, size_t *hdr_len)
+{
+	int rc;
+
+	rc = http_hdr_feed(&s->hdr, s->buf, s->offset, hdr_len);
+	if (rc) {
+		return rc;
+	}
+
+	if (s->hdr.status != 206) {
+		LOG_ERR("Unexpected HTTP response on range stream");
+		return -1;
+	}
+
+	if (!s->hdr.has_content_range || s->hdr.range_start != s->from) {
+		LOG_ERR("Unexpected range in response");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int stream_recv(struct download_stream *s)
+{
+	size_t hdr_len;
+	ssize_t len;
+	int rc;
+
+	len = recv(s->fd, s->buf + s->offset, sizeof(s->buf) - s->offset, 0);
+	if (len <= 0) {
+		return -ECONNRESET;
+	}
+
+	s->offset += len;
+
+	if (!s->has_header) {
+		rc = stream_header_parse(s, &hdr_len);
+		if (rc < 0) {
+			return -EBADMSG;
+		}
+		if (rc > 0) {
+			if (s->offset == sizeof(s->buf)) {
+				LOG_ERR("Could not fit HTTP header from server");
+				return -E2BIG;
+			}
+			return 0;
+		}
+
+		/* Make room for a whole fragment by moving the payload
+		 * bytes to the beginning of the buffer:
+		 */
+		memmove(s->buf, s->buf + hdr_len, s->offset - hdr_len);
+		s->offset -= hdr_len;
+		s->has_header = true;
+	}
+
+	if (s->offset >= s->len) {
+		s->state = STREAM_READY;
+		s->retries = 0;
+
+		if (s->hdr.connection_close) {
+			/* Reconnect on the next request */
+			stream_close(s);
+		}
+	}
+
+	return 0;
+}
+
+/* Hand the received fragments to the application, in order */
+static int streams_deliver(struct download_client *dl)
+{
+	bool delivered;
+
+	do {
+		delivered = false;
+
+		for (size_t i = 0; i < STREAM_CNT; i++) {
+			struct download_stream *s = &dl->streams[i];
+
+			if (s->state != STREAM_READY ||
+			    s->from != dl->progress) {
+				continue;
+			}
+
+			memcpy(dl->buf, s->buf, s->len);
+			dl->offset = s->len;
+			dl->progress += s->len;
+			s->state = STREAM_IDLE;
+			delivered = true;
+
+			LOG_INF("Downloaded %u/%u bytes (%d%%)",
+				dl->progress, dl->file_size,
+				(dl->progress * 100) / dl->file_size);
+
+			if (fragment_evt_send(dl)) {
+				return -ECANCELED;
+			}
+		}
+	} while (delivered);
+
+	return 0;
+}
+
+void streams_init(struct download_client *client)
+{
+	for (size_t i = 0; i < STREAM_CNT; i++) {
+		client->streams[i].fd = -1;
+		client->streams[i].state = STREAM_IDLE;
+	}
+}
+
+int streams_download(struct download_client *dl)
+{
+	struct pollfd fds[STREAM_CNT];
+	struct download_stream *polled[STREAM_CNT];
+	size_t next = dl->progress;
+	size_t frag_size = frag_size_get(dl);
+	int nfds;
+	int rc = 0;
+
+	/* The first stream continues on the current connection */
+	dl->streams[0].fd = dl->fd;
+	dl->fd = -1;
+
+	for (size_t i = 0; i < STREAM_CNT; i++) {
+		dl->streams[i].state = STREAM_IDLE;
+	}
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINING)
+	if (dl->http.pipelined) {
+		/* The next fragment has been requested on the
+		 * current connection already, receive it there.
+		 */
+		struct download_stream *s = &dl->streams[0];
+
+		dl->http.pipelined = false;
+		s->from = next;
+		s->len = MIN(frag_size, dl->file_size - next);
+		s->retries = 0;
+		next += s->len;
+		stream_reset(s);
+	}
+#endif
+
+	while (dl->progress < dl->file_size) {
+		/* Request the next fragments on idle streams */
+		for (size_t i = 0; i < STREAM_CNT && next < dl->file_size; i++) {
+			struct download_stream *s = &dl->streams[i];
+
+			if (s->state != STREAM_IDLE) {
+				continue;
+			}
+
+			s->from = next;
+			s->len = MIN(frag_size, dl->file_size - next);
+			s->retries = 0;
+			next += s->len;
+
+			if (stream_request(dl, s)) {
+				rc = stream_retry(dl, s);
+				if (rc) {
+					goto out;
+				}
+			}
+		}
+
+		rc = streams_deliver(dl);
+		if (rc || dl->progress == dl->file_size) {
+			goto out;
+		}
+
+		nfds = 0;
+		for (size_t i = 0; i < STREAM_CNT; i++) {
+			if (dl->streams[i].state == STREAM_BUSY) {
+				fds[nfds].fd = dl->streams[i].fd;
+				fds[nfds].events = POLLIN;
+				fds[nfds].revents = 0;
+				polled[nfds] = &dl->streams[i];
+				nfds++;
+			}
+		}
+
+		rc = poll(fds, nfds, CONFIG_DOWNLOAD_CLIENT_TCP_SOCK_TIMEO_MS);
+		if (rc < 0) {
+			LOG_ERR("Error in poll(), errno %d", errno);
+			rc = -errno;
+			goto out;
+		}
+
+		if (rc == 0) {
+			LOG_WRN("Socket timeout, retrying pending fragments");
+		}
+
+		for (size_t i = 0; i < nfds; i++) {
+			/* Retry all pending fragments on timeout */
+			if (rc != 0 && fds[i].revents == 0) {
+				continue;
+			}
+
+			if (rc != 0 && stream_recv(polled[i]) == 0) {
+				continue;
+			}
+
+			if (stream_retry(dl, polled[i])) {
+				rc = -ECONNRESET;
+				goto out;
+			}
+		}
+
+		rc = 0;
+	}
+
+out:
+	/* Keep the connection of the first stream, if usable */
+	for (size_t i = 1; i < STREAM_CNT; i++) {
+		stream_close(&dl->streams[i]);
+	}
+
+	if (rc) {
+		stream_close(&dl->streams[0]);
+	}
+
+	dl->fd = dl->streams[0].fd;
+	dl->streams[0].fd = -1;
+
+	return rc;
+}
@@ -199,7 +199,14 @@ static int download_client_callback(const struct download_client_evt *event)
 
 	case DOWNLOAD_CLIENT_EVT_DONE:
 		err = dfu_target_done(true);
-		if (err != 0) {
+		if (err == -EBADMSG) {
+			/* The image does not match its hash */
+			LOG_ERR("Image verification failed");
+			(void)download_client_disconnect(&dlc);
+			first_fragment = true;
+			send_error_evt(FOTA_DOWNLOAD_ERROR_CAUSE_INVALID_UPDATE);
+			return err;
+		} else if (err != 0) {
 			LOG_ERR("dfu_target_done error: %d", err);
 			send_error_evt(FOTA_DOWNLOAD_ERROR_CAUSE_DOWNLOAD_FAILED);
 			return err;
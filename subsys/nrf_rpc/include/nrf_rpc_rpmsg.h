@@ -26,15 +26,24 @@ extern "C" {
 #endif
 
 #define NRF_RPC_TR_MAX_HEADER_SIZE 0
+
+#if defined(CONFIG_NRF_RPC_TR_RPMSG_HOLD_RX_BUF)
+#define NRF_RPC_TR_AUTO_FREE_RX_BUF 0
+#else
 #define NRF_RPC_TR_AUTO_FREE_RX_BUF 1
+#endif
 
 typedef void (*nrf_rpc_tr_receive_handler_t)(const uint8_t *packet, size_t len);
 
 int nrf_rpc_tr_init(nrf_rpc_tr_receive_handler_t callback);
 
+#if defined(CONFIG_NRF_RPC_TR_RPMSG_HOLD_RX_BUF)
+void nrf_rpc_tr_free_rx_buf(const uint8_t *buf);
+#else
 static inline void nrf_rpc_tr_free_rx_buf(const uint8_t *buf)
 {
 }
+#endif
 
 #define nrf_rpc_tr_alloc_tx_buf(buf, len)				       \
 	uint32_t _nrf_rpc_tr_buf_vla[(sizeof(uint32_t) - 1 + (len)) /	       \
@@ -88,6 +88,17 @@ void rp_ll_endpoint_uninit(struct rp_ll_endpoint *endpoint);
 int rp_ll_send(struct rp_ll_endpoint *endpoint, const uint8_t *buf,
 	       size_t buf_len);
 
+/** @brief Releases a buffer received with the RP_LL_EVENT_DATA event.
+ *
+ * If @option{CONFIG_NRF_RPC_TR_RPMSG_HOLD_RX_BUF} is enabled, received
+ * buffers are held after the event callback returns, until they are
+ * released with this function.
+ *
+ * @param endpoint  endpoint that received the buffer
+ * @param buf       received data buffer
+ */
+void rp_ll_free_rx_buf(struct rp_ll_endpoint *endpoint, const uint8_t *buf);
+
 #ifdef __cplusplus
 }
 #endif
@@ -115,6 +115,15 @@ error_exit:
 	return translate_error(err);
 }
 
+#if defined(CONFIG_NRF_RPC_TR_RPMSG_HOLD_RX_BUF)
+void nrf_rpc_tr_free_rx_buf(const uint8_t *buf)
+{
+	NRF_RPC_ASSERT(buf != NULL);
+
+	rp_ll_free_rx_buf(&ll_endpoint, buf);
+}
+#endif
+
 int nrf_rpc_tr_send(uint8_t *buf, size_t len)
 {
 	int err;
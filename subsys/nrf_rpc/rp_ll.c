@@ -148,6 +148,12 @@ static int endpoint_cb(struct rpmsg_endpoint *ept, void *data, size_t len,
 		return RPMSG_SUCCESS;
 	}
 
+#if defined(CONFIG_NRF_RPC_TR_RPMSG_HOLD_RX_BUF)
+	/* The packet may be processed after this callback returns, so the
+	 * buffer is held until rp_ll_free_rx_buf() is called.
+	 */
+	rpmsg_hold_rx_buffer(ept, data);
+#endif
 	my_ep->callback(my_ep, RP_LL_EVENT_DATA, data, len);
 
 	return RPMSG_SUCCESS;
@@ -176,6 +182,13 @@ int rp_ll_send(struct rp_ll_endpoint *endpoint, const uint8_t *buf,
 	return ret;
 }
 
+#if defined(CONFIG_NRF_RPC_TR_RPMSG_HOLD_RX_BUF)
+void rp_ll_free_rx_buf(struct rp_ll_endpoint *endpoint, const uint8_t *buf)
+{
+	rpmsg_release_rx_buffer(&endpoint->rpmsg_ep, (void *)buf);
+}
+#endif
+
 int rp_ll_init(void)
 {
 	int err;
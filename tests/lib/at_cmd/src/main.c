@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <kernel.h>
+
+#include <modem/at_cmd.h>
+
+#include "mock_at_socket.h"
+
+#define TEST_RESP_MAX_LEN 64
+#define TEST_TIMEOUT K_SECONDS(1)
+
+struct completion {
+	uintptr_t idx;
+	enum at_cmd_state state;
+	int code;
+	bool has_response;
+	char response[TEST_RESP_MAX_LEN];
+};
+
+static struct completion completions[CONFIG_AT_CMD_SUBMIT_QUEUE_LEN * 2];
+static size_t completion_cnt;
+static K_SEM_DEFINE(completion_sem, 0, ARRAY_SIZE(completions));
+
+static size_t notif_cnt;
+static char notif_buf[TEST_RESP_MAX_LEN];
+
+/* Modem configuration sent at boot. */
+static const char * const boot_cmds[] = {
+	"AT+CFUN=4",
+	"AT%XSYSTEMMODE=1,0,1,0",
+	"AT+CGDCONT=0,\"IP\",\"internet\"",
+	"AT+CEREG=5",
+	"AT+CSCON=1",
+	"AT%XDATAPRFL=0",
+	"AT+CPSMS=0",
+	"AT+CFUN=1",
+};
+
+BUILD_ASSERT(ARRAY_SIZE(boot_cmds) <= CONFIG_AT_CMD_SUBMIT_QUEUE_LEN);
+
+static void complete_handler(const char *response, enum at_cmd_state state,
+			     int code, void *user_data)
+{
+	struct completion *c;
+
+	zassert_true(completion_cnt < ARRAY_SIZE(completions),
+		     "Too many completions");
+
+	c = &completions[completion_cnt++];
+	c->idx = (uintptr_t)user_data;
+	c->state = state;
+	c->code = code;
+	c->has_response = (response != NULL);
+	if (response != NULL) {
+		strncpy(c->response, response, sizeof(c->response) - 1);
+		c->response[sizeof(c->response) - 1] = '\0';
+	}
+
+	k_sem_give(&completion_sem);
+}
+
+static void chain_handler(const char *response, enum at_cmd_state state,
+			  int code, void *user_data)
+{
+	uintptr_t idx = (uintptr_t)user_data;
+
+	complete_handler(response, state, code, user_data);
+
+	/* Submit the next command of the sequence from the completion. */
+	if (idx + 1 < ARRAY_SIZE(boot_cmds)) {
+		zassert_ok(at_cmd_submit(boot_cmds[idx + 1], chain_handler,
+					 (void *)(idx + 1)), NULL);
+	}
+}
+
+static void notif_handler(const char *response)
+{
+	notif_cnt++;
+	strncpy(notif_buf, response, sizeof(notif_buf) - 1);
+}
+
+static void wait_completions(size_t cnt)
+{
+	for (size_t i = 0; i < cnt; i++) {
+		zassert_ok(k_sem_take(&completion_sem, TEST_TIMEOUT),
+			   "Command not completed");
+	}
+}
+
+static void submit_boot_cmds(void)
+{
+	for (uintptr_t i = 0; i < ARRAY_SIZE(boot_cmds); i++) {
+		zassert_ok(at_cmd_submit(boot_cmds[i], complete_handler,
+					 (void *)i), "Submit failed");
+	}
+}
+
+static void check_boot_cmds(void)
+{
+	zassert_equal(completion_cnt, ARRAY_SIZE(boot_cmds), NULL);
+	zassert_equal(mock_at_sent_cnt_get(), ARRAY_SIZE(boot_cmds), NULL);
+
+	for (size_t i = 0; i < ARRAY_SIZE(boot_cmds); i++) {
+		zassert_equal(completions[i].idx, i, "Completed out of order");
+		zassert_equal(completions[i].state, AT_CMD_OK, NULL);
+		zassert_equal(completions[i].code, 0, NULL);
+		zassert_true(completions[i].has_response, NULL);
+		zassert_equal(strcmp(mock_at_sent_get(i), boot_cmds[i]), 0,
+			      "Written out of order");
+	}
+
+	zassert_equal(mock_at_overlap_cnt_get(), 0,
+		      "Command written before the previous one completed");
+}
+
+static void test_setup(void)
+{
+	mock_at_reset();
+	memset(completions, 0, sizeof(completions));
+	completion_cnt = 0;
+	notif_cnt = 0;
+	k_sem_reset(&completion_sem);
+}
+
+static void test_teardown(void)
+{
+	zassert_equal(k_sem_count_get(&completion_sem), 0,
+		      "Unexpected completion");
+}
+
+static void test_at_cmd_init(void)
+{
+	zassert_ok(at_cmd_init(), "Initialization failed");
+}
+
+static void test_submit_in_order(void)
+{
+	submit_boot_cmds();
+	wait_completions(ARRAY_SIZE(boot_cmds));
+	check_boot_cmds();
+}
+
+static void test_submit_from_callback(void)
+{
+	zassert_ok(at_cmd_submit(boot_cmds[0], chain_handler, (void *)0),
+		   NULL);
+	wait_completions(ARRAY_SIZE(boot_cmds));
+	check_boot_cmds();
+}
+
+static void test_submit_responses(void)
+{
+	static const struct mock_at_response table[] = {
+		{ "AT+CGSN", "351358811331351\r\nOK\r\n" },
+		{ "AT+CFUN=9", "ERROR\r\n" },
+		{ "AT+CPIN?", "+CME ERROR: 10\r\n" },
+		{ "AT+CMGS=21", "+CMS ERROR: 304\r\n" },
+	};
+
+	mock_at_responses_set(table, ARRAY_SIZE(table));
+
+	for (uintptr_t i = 0; i < ARRAY_SIZE(table); i++) {
+		zassert_ok(at_cmd_submit(table[i].cmd, complete_handler,
+					 (void *)i), NULL);
+	}
+	wait_completions(ARRAY_SIZE(table));
+
+	zassert_equal(completions[0].state, AT_CMD_OK, NULL);
+	zassert_equal(strcmp(completions[0].response, "351358811331351\r\n"),
+		      0, "Invalid response");
+	zassert_equal(completions[1].state, AT_CMD_ERROR, NULL);
+	zassert_equal(completions[1].code, -ENOEXEC, NULL);
+	zassert_equal(completions[2].state, AT_CMD_ERROR_CME, NULL);
+	zassert_equal(completions[2].code, 10, NULL);
+	zassert_equal(completions[3].state, AT_CMD_ERROR_CMS, NULL);
+	zassert_equal(completions[3].code, 304, NULL);
+}
+
+static void test_submit_limit(void)
+{
+	/* The AT thread does not run before the test thread blocks, so none
+	 * of the submitted commands complete in the meantime.
+	 */
+	for (uintptr_t i = 0; i < CONFIG_AT_CMD_SUBMIT_QUEUE_LEN; i++) {
+		zassert_ok(at_cmd_submit("AT", complete_handler, (void *)i),
+			   NULL);
+	}
+	zassert_equal(at_cmd_submit("AT", complete_handler, NULL), -EAGAIN,
+		      "Submit limit not enforced");
+
+	wait_completions(CONFIG_AT_CMD_SUBMIT_QUEUE_LEN);
+
+	zassert_ok(at_cmd_submit("AT", complete_handler, NULL), NULL);
+	wait_completions(1);
+}
+
+static void test_submit_invalid(void)
+{
+	zassert_equal(at_cmd_submit(NULL, complete_handler, NULL), -EINVAL,
+		      NULL);
+	zassert_equal(at_cmd_submit(" \r\n", complete_handler, NULL), -EINVAL,
+		      NULL);
+	zassert_equal(at_cmd_submit("AT", NULL, NULL), -EINVAL, NULL);
+}
+
+static void test_submit_write_error(void)
+{
+	mock_at_send_fail_set(EIO);
+
+	zassert_ok(at_cmd_submit("AT+CFUN=1", complete_handler, NULL), NULL);
+	wait_completions(1);
+
+	zassert_equal(completions[0].state, AT_CMD_ERROR_WRITE, NULL);
+	zassert_equal(completions[0].code, -EIO, NULL);
+	zassert_false(completions[0].has_response, NULL);
+
+	/* The driver recovers for the following commands. */
+	zassert_ok(at_cmd_submit("AT+CFUN=1", complete_handler, NULL), NULL);
+	wait_completions(1);
+	zassert_equal(completions[1].state, AT_CMD_OK, NULL);
+}
+
+static void test_submit_and_write(void)
+{
+	char buf[TEST_RESP_MAX_LEN];
+	enum at_cmd_state state;
+	static const struct mock_at_response table[] = {
+		{ "AT+CGSN", "351358811331351\r\nOK\r\n" },
+	};
+
+	mock_at_responses_set(table, ARRAY_SIZE(table));
+
+	submit_boot_cmds();
+
+	/* A synchronous command completes after the commands submitted
+	 * before it.
+	 */
+	zassert_ok(at_cmd_write("AT+CGSN", buf, sizeof(buf), &state), NULL);
+	zassert_equal(state, AT_CMD_OK, NULL);
+	zassert_equal(strcmp(buf, "351358811331351\r\n"), 0, NULL);
+	zassert_equal(completion_cnt, ARRAY_SIZE(boot_cmds),
+		      "Submitted commands not completed first");
+
+	wait_completions(ARRAY_SIZE(boot_cmds));
+	zassert_equal(mock_at_overlap_cnt_get(), 0, NULL);
+}
+
+static void test_submit_notification(void)
+{
+	at_cmd_set_notification_handler(notif_handler);
+
+	mock_at_notify("+CEREG: 1,\"76C1\",\"0102DA04\",7\r\n");
+	submit_boot_cmds();
+	wait_completions(ARRAY_SIZE(boot_cmds));
+
+	zassert_equal(notif_cnt, 1, "Notification not dispatched");
+	zassert_equal(strncmp(notif_buf, "+CEREG: 1", strlen("+CEREG: 1")), 0,
+		      NULL);
+	check_boot_cmds();
+
+	at_cmd_set_notification_handler(NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(at_cmd,
+			 ztest_unit_test(test_at_cmd_init),
+			 ztest_unit_test_setup_teardown(
+				test_submit_in_order,
+				test_setup, test_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_submit_from_callback,
+				test_setup, test_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_submit_responses,
+				test_setup, test_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_submit_limit,
+				test_setup, test_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_submit_invalid,
+				test_setup, test_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_submit_write_error,
+				test_setup, test_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_submit_and_write,
+				test_setup, test_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_submit_notification,
+				test_setup, test_teardown)
+			);
+
+	ztest_run_test_suite(at_cmd);
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MOCK_SOCKET_H_
+#define MOCK_SOCKET_H_
+
+#include <sys/types.h>
+#include <stddef.h>
+
+#define AF_LTE 102
+#define SOCK_DGRAM 2
+#define NPROTO_AT 513
+
+/* Route the socket calls of the AT command driver to the mocked AT socket
+ * instead of the host socket functions.
+ */
+#define socket mock_at_socket
+#define send mock_at_send
+#define recv mock_at_recv
+#define close mock_at_close
+
+int mock_at_socket(int family, int type, int proto);
+ssize_t mock_at_send(int sock, const void *buf, size_t len, int flags);
+ssize_t mock_at_recv(int sock, void *buf, size_t max_len, int flags);
+int mock_at_close(int sock);
+
+#endif /* MOCK_SOCKET_H_ */
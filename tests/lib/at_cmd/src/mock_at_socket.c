@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <errno.h>
+#include <net/socket.h>
+#include <modem/nrf_modem_lib.h>
+
+#include "mock_at_socket.h"
+
+#define MOCK_SOCKET_FD 1
+#define MOCK_MSG_MAX_LEN 128
+#define MOCK_QUEUE_LEN 32
+
+struct mock_msg {
+	char data[MOCK_MSG_MAX_LEN];
+	size_t len;
+	bool is_response;
+};
+
+K_MSGQ_DEFINE(mock_rx_queue, sizeof(struct mock_msg), MOCK_QUEUE_LEN, 4);
+
+static const struct mock_at_response *responses;
+static size_t response_cnt;
+static int send_err;
+static char sent[MOCK_QUEUE_LEN][MOCK_MSG_MAX_LEN];
+static size_t sent_cnt;
+static atomic_t pending_cnt;
+static size_t overlap_cnt;
+
+static void mock_rx_put(const char *data, bool is_response)
+{
+	struct mock_msg msg;
+	int err;
+
+	/* The modem terminates every message. */
+	msg.len = strlen(data) + 1;
+	__ASSERT_NO_MSG(msg.len <= sizeof(msg.data));
+	memcpy(msg.data, data, msg.len);
+	msg.is_response = is_response;
+
+	err = k_msgq_put(&mock_rx_queue, &msg, K_NO_WAIT);
+	__ASSERT_NO_MSG(err == 0);
+}
+
+static const char *response_get(const char *cmd)
+{
+	for (size_t i = 0; i < response_cnt; i++) {
+		if (strcmp(responses[i].cmd, cmd) == 0) {
+			return responses[i].resp;
+		}
+	}
+
+	return "OK\r\n";
+}
+
+int mock_at_socket(int family, int type, int proto)
+{
+	ARG_UNUSED(family);
+	ARG_UNUSED(type);
+	ARG_UNUSED(proto);
+
+	return MOCK_SOCKET_FD;
+}
+
+ssize_t mock_at_send(int sock, const void *buf, size_t len, int flags)
+{
+	ARG_UNUSED(sock);
+	ARG_UNUSED(flags);
+
+	if (send_err) {
+		errno = send_err;
+		send_err = 0;
+		return -1;
+	}
+
+	__ASSERT_NO_MSG(len < MOCK_MSG_MAX_LEN);
+	__ASSERT_NO_MSG(sent_cnt < ARRAY_SIZE(sent));
+
+	memcpy(sent[sent_cnt], buf, len);
+	sent[sent_cnt][len] = '\0';
+
+	if (atomic_inc(&pending_cnt) > 0) {
+		overlap_cnt++;
+	}
+
+	mock_rx_put(response_get(sent[sent_cnt]), true);
+	sent_cnt++;
+
+	return len;
+}
+
+ssize_t mock_at_recv(int sock, void *buf, size_t max_len, int flags)
+{
+	struct mock_msg msg;
+
+	ARG_UNUSED(sock);
+	ARG_UNUSED(flags);
+
+	k_msgq_get(&mock_rx_queue, &msg, K_FOREVER);
+
+	if (msg.is_response) {
+		atomic_dec(&pending_cnt);
+	}
+
+	msg.len = MIN(msg.len, max_len);
+	memcpy(buf, msg.data, msg.len);
+
+	return msg.len;
+}
+
+int mock_at_close(int sock)
+{
+	ARG_UNUSED(sock);
+
+	return 0;
+}
+
+void nrf_modem_lib_shutdown_wait(void)
+{
+}
+
+void mock_at_responses_set(const struct mock_at_response *table, size_t cnt)
+{
+	responses = table;
+	response_cnt = cnt;
+}
+
+void mock_at_send_fail_set(int err)
+{
+	send_err = err;
+}
+
+void mock_at_notify(const char *notif)
+{
+	mock_rx_put(notif, false);
+}
+
+size_t mock_at_sent_cnt_get(void)
+{
+	return sent_cnt;
+}
+
+const char *mock_at_sent_get(size_t idx)
+{
+	return (idx < sent_cnt) ? sent[idx] : NULL;
+}
+
+size_t mock_at_overlap_cnt_get(void)
+{
+	return overlap_cnt;
+}
+
+void mock_at_reset(void)
+{
+	responses = NULL;
+	response_cnt = 0;
+	send_err = 0;
+	sent_cnt = 0;
+	overlap_cnt = 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MOCK_AT_SOCKET_H_
+#define MOCK_AT_SOCKET_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+
+/* Response of the mocked modem to a given command. */
+struct mock_at_response {
+	const char *cmd;
+	const char *resp;
+};
+
+/* Set the responses of the mocked modem. Commands not present in the table
+ * are answered with OK.
+ */
+void mock_at_responses_set(const struct mock_at_response *table, size_t cnt);
+
+/* Make the next write to the socket fail with the given error. */
+void mock_at_send_fail_set(int err);
+
+/* Inject a notification, as if received from the modem. */
+void mock_at_notify(const char *notif);
+
+/* Get the commands written to the socket. */
+size_t mock_at_sent_cnt_get(void);
+const char *mock_at_sent_get(size_t idx);
+
+/* Number of commands written while a previous command was pending a
+ * response. The modem handles one command at a time on an AT socket.
+ */
+size_t mock_at_overlap_cnt_get(void);
+
+void mock_at_reset(void);
+
+#endif /* MOCK_AT_SOCKET_H_ */
@@ -778,6 +778,170 @@ static void test_at_cmd_test_teardown(void)
 	at_params_list_free(&test_list2);
 }
 
+static const char *stream_lines[] = {
+	"AT+CFUN",
+	"AT+CEREG",
+	"%XMONITOR",
+	"OK",
+};
+static size_t stream_line_cnt;
+
+static void stream_handler(int err, struct at_param_list *list,
+			   void *user_data)
+{
+	char tmpbuf[32];
+	uint32_t tmpbuf_len = sizeof(tmpbuf);
+
+	zassert_equal(err, 0, "Parsing line failed");
+	zassert_true(stream_line_cnt < ARRAY_SIZE(stream_lines),
+		     "Too many lines");
+	zassert_equal(0, at_params_string_get(list, 0, tmpbuf, &tmpbuf_len),
+		      "Get string should not fail");
+	zassert_equal(strlen(stream_lines[stream_line_cnt]), tmpbuf_len,
+		      "Invalid string length");
+	zassert_equal(0, memcmp(stream_lines[stream_line_cnt], tmpbuf,
+				tmpbuf_len),
+		      "Invalid string");
+
+	if (stream_line_cnt == 2) {
+		zassert_equal(at_params_valid_count_get(list), 4,
+			      "Invalid parameter count");
+	}
+
+	stream_line_cnt++;
+}
+
+static void test_parser_stream_setup(void)
+{
+	at_params_list_init(&test_list2, TEST_PARAMS2);
+}
+
+static void test_parser_stream(void)
+{
+	static const char response[] = "\r\nAT+CFUN\r\nAT+CEREG\r\n"
+				       "%XMONITOR: 1,\"EDAV\",\"EDAV\"\r\n"
+				       "\r\nOK\r\n";
+	struct at_parser parser;
+	char buf[64];
+	int ret;
+
+	ret = at_parser_init(&parser, &test_list2, buf, sizeof(buf),
+			     stream_handler, NULL);
+	zassert_equal(ret, 0, "at_parser_init should return 0");
+
+	/* Feed the response one character at a time. */
+	stream_line_cnt = 0;
+	for (size_t i = 0; i < sizeof(response) - 1; i++) {
+		ret = at_parser_feed(&parser, &response[i], 1);
+		zassert_equal(ret, 0, "at_parser_feed should return 0");
+	}
+	zassert_equal(stream_line_cnt, ARRAY_SIZE(stream_lines),
+		      "Not all lines parsed");
+
+	/* Feed the whole response at once. */
+	stream_line_cnt = 0;
+	ret = at_parser_feed(&parser, response, sizeof(response) - 1);
+	zassert_equal(ret, 0, "at_parser_feed should return 0");
+	zassert_equal(stream_line_cnt, ARRAY_SIZE(stream_lines),
+		      "Not all lines parsed");
+}
+
+static void test_parser_stream_teardown(void)
+{
+	at_params_list_free(&test_list2);
+}
+
+static void test_parser_stream_flush(void)
+{
+	static const char response[] = "AT+CFUN\r\nAT+CEREG\r\n"
+				       "%XMONITOR: 1,\"EDAV\",\"EDAV\"\r\nOK";
+	struct at_parser parser;
+	char buf[64];
+	int ret;
+
+	ret = at_parser_init(&parser, &test_list2, buf, sizeof(buf),
+			     stream_handler, NULL);
+	zassert_equal(ret, 0, "at_parser_init should return 0");
+
+	stream_line_cnt = 0;
+	ret = at_parser_feed(&parser, response, sizeof(response) - 1);
+	zassert_equal(ret, 0, "at_parser_feed should return 0");
+	zassert_equal(stream_line_cnt, ARRAY_SIZE(stream_lines) - 1,
+		      "Unterminated line parsed before flush");
+
+	at_parser_flush(&parser);
+	zassert_equal(stream_line_cnt, ARRAY_SIZE(stream_lines),
+		      "Unterminated line not parsed on flush");
+
+	/* Nothing is pending after the flush. */
+	at_parser_flush(&parser);
+	zassert_equal(stream_line_cnt, ARRAY_SIZE(stream_lines),
+		      "Line parsed twice");
+}
+
+/* Lines that do not fit in the line buffer are reported with NULL. */
+static const char *overflow_lines[] = {
+	"AT+CFUN",
+	NULL,
+	"OK",
+	NULL,
+};
+
+static void overflow_handler(int err, struct at_param_list *list,
+			     void *user_data)
+{
+	const char *line;
+	char tmpbuf[32];
+	uint32_t tmpbuf_len = sizeof(tmpbuf);
+
+	zassert_true(stream_line_cnt < ARRAY_SIZE(overflow_lines),
+		     "Too many lines");
+
+	line = overflow_lines[stream_line_cnt];
+	stream_line_cnt++;
+
+	if (line == NULL) {
+		zassert_equal(err, -ENOBUFS, "Overflow not reported");
+		return;
+	}
+
+	zassert_equal(err, 0, "Parsing line failed");
+	zassert_equal(0, at_params_string_get(list, 0, tmpbuf, &tmpbuf_len),
+		      "Get string should not fail");
+	zassert_equal(strlen(line), tmpbuf_len, "Invalid string length");
+	zassert_equal(0, memcmp(line, tmpbuf, tmpbuf_len), "Invalid string");
+}
+
+static void test_parser_stream_overflow(void)
+{
+	static const char response[] = "AT+CFUN\r\n"
+				       "%XMONITOR: 1,\"EDAV\",\"EDAV\"\r\n"
+				       "OK\r\n"
+				       "%XMONITOR: 1,\"EDAV\",\"EDAV\"";
+	struct at_parser parser;
+	char buf[16];
+	int ret;
+
+	ret = at_parser_init(&parser, &test_list2, buf, sizeof(buf),
+			     overflow_handler, NULL);
+	zassert_equal(ret, 0, "at_parser_init should return 0");
+
+	/* Feed the response in chunks that split the long lines. */
+	stream_line_cnt = 0;
+	for (size_t i = 0; i < sizeof(response) - 1; i += 5) {
+		ret = at_parser_feed(&parser, &response[i],
+				     MIN(5, sizeof(response) - 1 - i));
+		zassert_equal(ret, 0, "at_parser_feed should return 0");
+	}
+	zassert_equal(stream_line_cnt, ARRAY_SIZE(overflow_lines) - 1,
+		      "Invalid number of lines before flush");
+
+	/* The unterminated last line does not fit either. */
+	at_parser_flush(&parser);
+	zassert_equal(stream_line_cnt, ARRAY_SIZE(overflow_lines),
+		      "Invalid number of lines after flush");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(at_cmd_parser,
@@ -808,7 +972,19 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(
 				test_at_cmd_test,
 				test_at_cmd_test_setup,
-				test_at_cmd_test_teardown)
+				test_at_cmd_test_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_parser_stream,
+				test_parser_stream_setup,
+				test_parser_stream_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_parser_stream_flush,
+				test_parser_stream_setup,
+				test_parser_stream_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_parser_stream_overflow,
+				test_parser_stream_setup,
+				test_parser_stream_teardown)
 			);
 
 	ztest_run_test_suite(at_cmd_parser);
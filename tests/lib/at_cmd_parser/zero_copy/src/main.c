@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <stdio.h>
+#include <string.h>
+#include <kernel.h>
+
+#include <modem/at_cmd_parser.h>
+#include <modem/at_params.h>
+
+#define TEST_PARAMS 25
+#define TEST_ITERATIONS 100
+#define TEST_BUF_SIZE 128
+
+/* Notifications captured from the modem. */
+static const char * const notifications[] = {
+	"+CEREG: 5,\"76C1\",\"0102DA04\",7,,,\"00000010\",\"00010011\"\r\n",
+	"+CEREG: 2,\"76C1\",\"0102DA04\", 7\r\n",
+	"+CSCON: 1\r\n",
+	"+CSCON: 0\r\n",
+	"%CESQ: 54,2,16,2\r\n",
+	"+CGEV: ME PDN ACT 0\r\n",
+	"%XMONITOR: 1,\"EDAV\",\"EDAV\",\"26295\",\"00B7\",7,4,\"00011B07\","
+		"7,2300,63,39,\"\",\"11100000\",\"11100000\",\"01001001\"\r\n",
+	"%XSIM: 1\r\n",
+	"%NCELLMEAS: 0,\"0199F10A\",\"26202\",\"4E0E\",64,5300,170,48,21,"
+		"9345,6200,190,30,16,25,3350,195,16,5,25\r\n",
+	"+CEDRXP: 4,\"1000\",\"0101\",\"1011\"\r\n",
+	"%XT3412: 1,5000,0\r\n",
+	"%XMODEMSLEEP: 1,36000\r\n",
+	"+CPSMS: 1,,,\"10101111\",\"01101100\"\r\n",
+	"%XCBAND: (1,2,3,4,5,8,12,13,17,19,20,25,26,28,66)\r\n",
+};
+
+static struct at_param_list copy_list;
+static struct at_param_list zero_copy_list;
+static uint32_t alloc_cnt;
+
+void *__real_k_malloc(size_t size);
+
+void *__wrap_k_malloc(size_t size)
+{
+	alloc_cnt++;
+
+	return __real_k_malloc(size);
+}
+
+static void compare_params(const struct at_param_list *expected,
+			   const struct at_param_list *actual)
+{
+	uint32_t count = at_params_valid_count_get(expected);
+
+	zassert_equal(count, at_params_valid_count_get(actual),
+		      "Parameter count does not match");
+
+	for (size_t i = 0; i < count; i++) {
+		enum at_param_type type = at_params_type_get(expected, i);
+		size_t expected_len;
+		size_t actual_len;
+
+		zassert_equal(type, at_params_type_get(actual, i),
+			      "Parameter type does not match");
+
+		zassert_ok(at_params_size_get(expected, i, &expected_len),
+			   "Failed to get parameter size");
+		zassert_ok(at_params_size_get(actual, i, &actual_len),
+			   "Failed to get parameter size");
+		zassert_equal(expected_len, actual_len,
+			      "Parameter size does not match");
+
+		if (type == AT_PARAM_TYPE_NUM_INT) {
+			int64_t expected_val;
+			int64_t actual_val;
+
+			zassert_ok(at_params_int64_get(expected, i,
+						       &expected_val), NULL);
+			zassert_ok(at_params_int64_get(actual, i,
+						       &actual_val), NULL);
+			zassert_equal(expected_val, actual_val,
+				      "Parameter value does not match");
+		} else if (type == AT_PARAM_TYPE_STRING) {
+			char expected_buf[TEST_BUF_SIZE];
+			char actual_buf[TEST_BUF_SIZE];
+
+			expected_len = sizeof(expected_buf);
+			actual_len = sizeof(actual_buf);
+			zassert_ok(at_params_string_get(expected, i,
+							expected_buf,
+							&expected_len), NULL);
+			zassert_ok(at_params_string_get(actual, i,
+							actual_buf,
+							&actual_len), NULL);
+			zassert_equal(expected_len, actual_len, NULL);
+			zassert_mem_equal(expected_buf, actual_buf,
+					  expected_len,
+					  "Parameter value does not match");
+		} else if (type == AT_PARAM_TYPE_ARRAY) {
+			uint32_t expected_buf[TEST_BUF_SIZE];
+			uint32_t actual_buf[TEST_BUF_SIZE];
+
+			expected_len = sizeof(expected_buf);
+			actual_len = sizeof(actual_buf);
+			zassert_ok(at_params_array_get(expected, i,
+						       expected_buf,
+						       &expected_len), NULL);
+			zassert_ok(at_params_array_get(actual, i,
+						       actual_buf,
+						       &actual_len), NULL);
+			zassert_equal(expected_len, actual_len, NULL);
+			zassert_mem_equal(expected_buf, actual_buf,
+					  expected_len,
+					  "Parameter value does not match");
+		}
+	}
+}
+
+static void test_zero_copy_setup(void)
+{
+	zassert_ok(at_params_list_init(&copy_list, TEST_PARAMS), NULL);
+	zassert_ok(at_params_list_init_zero_copy(&zero_copy_list,
+						 TEST_PARAMS), NULL);
+}
+
+static void test_zero_copy_teardown(void)
+{
+	at_params_list_free(&copy_list);
+	at_params_list_free(&zero_copy_list);
+}
+
+static void test_zero_copy_params_match(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(notifications); i++) {
+		zassert_ok(at_parser_params_from_str(notifications[i], NULL,
+						     &copy_list),
+			   "Failed to parse %s", notifications[i]);
+		zassert_ok(at_parser_params_from_str(notifications[i], NULL,
+						     &zero_copy_list),
+			   "Failed to parse %s", notifications[i]);
+
+		compare_params(&copy_list, &zero_copy_list);
+	}
+}
+
+static void test_zero_copy_array_put(void)
+{
+	uint32_t array[] = { 1, 2, 3 };
+
+	zassert_equal(at_params_array_put(&zero_copy_list, 0, array,
+					  sizeof(array)),
+		      -ENOTSUP, "Array put should not be supported");
+}
+
+static void benchmark_list(struct at_param_list *list, const char *name)
+{
+	uint32_t total_allocs = 0;
+	uint64_t total_cycles = 0;
+
+	TC_PRINT("%s parameter list:\n", name);
+
+	for (size_t i = 0; i < ARRAY_SIZE(notifications); i++) {
+		uint64_t cycles = 0;
+
+		alloc_cnt = 0;
+
+		for (size_t j = 0; j < TEST_ITERATIONS; j++) {
+			uint32_t start = k_cycle_get_32();
+
+			at_parser_params_from_str(notifications[i], NULL, list);
+			cycles += k_cycle_get_32() - start;
+		}
+
+		TC_PRINT("  %.12s...: %u allocs, %u cycles\n",
+			 notifications[i], alloc_cnt / TEST_ITERATIONS,
+			 (uint32_t)(cycles / TEST_ITERATIONS));
+
+		total_allocs += alloc_cnt;
+		total_cycles += cycles;
+	}
+
+	TC_PRINT("  Average per notification: %u allocs, %u cycles\n",
+		 total_allocs / (TEST_ITERATIONS * ARRAY_SIZE(notifications)),
+		 (uint32_t)(total_cycles /
+			    (TEST_ITERATIONS * ARRAY_SIZE(notifications))));
+}
+
+static void test_zero_copy_benchmark(void)
+{
+	benchmark_list(&copy_list, "Copy");
+	benchmark_list(&zero_copy_list, "Zero-copy");
+
+	/* Parsing to a zero-copy list does not use the heap. */
+	for (size_t i = 0; i < ARRAY_SIZE(notifications); i++) {
+		alloc_cnt = 0;
+		at_parser_params_from_str(notifications[i], NULL,
+					  &zero_copy_list);
+		zassert_equal(alloc_cnt, 0, "Unexpected heap allocation");
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(at_cmd_parser_zero_copy,
+			 ztest_unit_test_setup_teardown(
+				test_zero_copy_params_match,
+				test_zero_copy_setup,
+				test_zero_copy_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_zero_copy_array_put,
+				test_zero_copy_setup,
+				test_zero_copy_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_zero_copy_benchmark,
+				test_zero_copy_setup,
+				test_zero_copy_teardown)
+			);
+
+	ztest_run_test_suite(at_cmd_parser_zero_copy);
+}
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <kernel.h>
+
+#include <modem/at_cmd.h>
+#include <modem/at_notif.h>
+
+#define TEST_ITERATIONS 100
+
+/* Prefixes of the notifications handled by the registered modules. */
+static const char * const prefixes[] = {
+	"+CEREG", "+CSCON", "+CGEV", "+CNEC_ESM", "+CEDRXP", "+CMT", "+CDS",
+	"+CIREG", "+CPSMS", "+CESQ", "+CPINR", "+CRSM", "%CESQ", "%XSIM",
+	"%XMONITOR", "%NCELLMEAS", "%XT3412", "%XMODEMSLEEP", "%MDMEV",
+	"%XTIME", "%XVBAT", "%XTEMP", "%CONEVAL", "%XCBAND",
+};
+
+#define TEST_HANDLER_CNT ARRAY_SIZE(prefixes)
+
+/* Notifications captured from the modem, one for every prefix. */
+static const char * const notifications[] = {
+	"+CEREG: 5,\"76C1\",\"0102DA04\",7,,,\"00000010\",\"00010011\"",
+	"+CSCON: 1",
+	"+CGEV: ME PDN ACT 0",
+	"+CNEC_ESM: 50,0",
+	"+CEDRXP: 4,\"1000\",\"0101\",\"1011\"",
+	"+CMT: \"+358401234567\",22",
+	"+CDS: 24",
+	"+CIREG: 2,1,0",
+	"+CPSMS: 1,,,\"10101111\",\"01101100\"",
+	"+CESQ: 99,99,255,255,31,62",
+	"+CPINR: \"SIM PIN\",3",
+	"+CRSM: 144,0,\"\"",
+	"%CESQ: 54,2,16,2",
+	"%XSIM: 1",
+	"%XMONITOR: 1,\"EDAV\",\"EDAV\",\"26295\",\"00B7\",7,4,\"00011B07\"",
+	"%NCELLMEAS: 0,\"0199F10A\",\"26202\",\"4E0E\",64,5300,170,48,21",
+	"%XT3412: 1,5000,0",
+	"%XMODEMSLEEP: 1,36000",
+	"%MDMEV: ME OVERHEATED",
+	"%XTIME: \"80\",\"1220321243\",\"01\"",
+	"%XVBAT: 3600",
+	"%XTEMP: 1",
+	"%CONEVAL: 0,1,5,8,2,14,\"011B0780\",\"26201\",7,1575,3,1,1,23,16,32,130",
+	"%XCBAND: 20",
+};
+
+BUILD_ASSERT(ARRAY_SIZE(notifications) == TEST_HANDLER_CNT);
+
+static at_cmd_handler_t dispatch;
+static uint32_t handler_calls[TEST_HANDLER_CNT];
+static uint32_t invocation_cnt;
+static uint32_t wildcard_calls;
+
+/* Stub of the AT command driver, capturing the notification dispatcher. */
+void at_cmd_set_notification_handler(at_cmd_handler_t handler)
+{
+	dispatch = handler;
+}
+
+/* Handler matching the notification prefix itself, the way modules do
+ * when registered for all notifications.
+ */
+static void filtering_handler(void *context, const char *response)
+{
+	size_t idx = (size_t)context;
+
+	invocation_cnt++;
+
+	if (strncmp(response, prefixes[idx], strlen(prefixes[idx])) == 0 &&
+	    response[strlen(prefixes[idx])] == ':') {
+		handler_calls[idx]++;
+	}
+}
+
+/* Handler registered for a prefix, trusting the dispatcher. */
+static void prefix_handler(void *context, const char *response)
+{
+	size_t idx = (size_t)context;
+
+	invocation_cnt++;
+	handler_calls[idx]++;
+}
+
+static void wildcard_handler(void *context, const char *response)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(response);
+
+	wildcard_calls++;
+}
+
+static void reset_counters(void)
+{
+	memset(handler_calls, 0, sizeof(handler_calls));
+	invocation_cnt = 0;
+	wildcard_calls = 0;
+}
+
+static void check_handler_calls(uint32_t expected)
+{
+	for (size_t i = 0; i < TEST_HANDLER_CNT; i++) {
+		zassert_equal(handler_calls[i], expected,
+			      "Invalid number of calls for %s", prefixes[i]);
+	}
+}
+
+static void register_filtering_handlers(void)
+{
+	for (size_t i = 0; i < TEST_HANDLER_CNT; i++) {
+		zassert_ok(at_notif_register_handler((void *)i,
+						     filtering_handler), NULL);
+	}
+}
+
+static void deregister_filtering_handlers(void)
+{
+	for (size_t i = 0; i < TEST_HANDLER_CNT; i++) {
+		zassert_ok(at_notif_deregister_handler((void *)i,
+						       filtering_handler), NULL);
+	}
+}
+
+static void register_prefix_handlers(void)
+{
+	for (size_t i = 0; i < TEST_HANDLER_CNT; i++) {
+		zassert_ok(at_notif_register_prefix_handler((void *)i,
+							    prefixes[i],
+							    prefix_handler),
+			   NULL);
+	}
+}
+
+static void deregister_prefix_handlers(void)
+{
+	for (size_t i = 0; i < TEST_HANDLER_CNT; i++) {
+		zassert_ok(at_notif_deregister_prefix_handler((void *)i,
+							      prefixes[i],
+							      prefix_handler),
+			   NULL);
+	}
+}
+
+static uint32_t dispatch_all(void)
+{
+	uint64_t cycles = 0;
+
+	for (size_t i = 0; i < TEST_ITERATIONS; i++) {
+		for (size_t j = 0; j < ARRAY_SIZE(notifications); j++) {
+			uint32_t start = k_cycle_get_32();
+
+			dispatch(notifications[j]);
+			cycles += k_cycle_get_32() - start;
+		}
+	}
+
+	return (uint32_t)(cycles /
+			  (TEST_ITERATIONS * ARRAY_SIZE(notifications)));
+}
+
+static void test_at_notif_init(void)
+{
+	zassert_ok(at_notif_init(), "Initialization failed");
+	zassert_not_null(dispatch, "Dispatcher not set");
+}
+
+static void test_prefix_dispatch(void)
+{
+	register_prefix_handlers();
+	zassert_ok(at_notif_register_handler(NULL, wildcard_handler), NULL);
+
+	reset_counters();
+	for (size_t i = 0; i < ARRAY_SIZE(notifications); i++) {
+		dispatch(notifications[i]);
+	}
+
+	/* Every prefix handler gets only its own notification, and the
+	 * wildcard handler gets all of them.
+	 */
+	check_handler_calls(1);
+	zassert_equal(invocation_cnt, TEST_HANDLER_CNT, NULL);
+	zassert_equal(wildcard_calls, ARRAY_SIZE(notifications), NULL);
+
+	/* Prefixes must match exactly. */
+	reset_counters();
+	dispatch("+CEREGX: 1");
+	dispatch("+CERE: 1");
+	dispatch("OK");
+	zassert_equal(invocation_cnt, 0, "Unexpected prefix handler call");
+	zassert_equal(wildcard_calls, 3, NULL);
+
+	/* Leading line breaks are ignored when matching. */
+	reset_counters();
+	dispatch("\r\n+CSCON: 0\r\n");
+	zassert_equal(handler_calls[1], 1, NULL);
+	zassert_equal(invocation_cnt, 1, NULL);
+
+	zassert_ok(at_notif_deregister_handler(NULL, wildcard_handler), NULL);
+	deregister_prefix_handlers();
+
+	reset_counters();
+	for (size_t i = 0; i < ARRAY_SIZE(notifications); i++) {
+		dispatch(notifications[i]);
+	}
+	zassert_equal(invocation_cnt, 0, "Handler called after removal");
+	zassert_equal(wildcard_calls, 0, "Handler called after removal");
+}
+
+static void test_prefix_register_invalid(void)
+{
+	zassert_equal(at_notif_register_prefix_handler(NULL, "+CEREG", NULL),
+		      -EINVAL, NULL);
+	zassert_equal(at_notif_register_prefix_handler(NULL, "+CEREG:",
+						       prefix_handler),
+		      -EINVAL, NULL);
+	zassert_equal(at_notif_register_prefix_handler(NULL, "+CEREG 5",
+						       prefix_handler),
+		      -EINVAL, NULL);
+}
+
+static void test_prefix_register_duplicate(void)
+{
+	/* Registering the same handler twice is ignored. */
+	for (size_t i = 0; i < 2; i++) {
+		zassert_ok(at_notif_register_prefix_handler((void *)1, "+CSCON",
+							    prefix_handler),
+			   NULL);
+	}
+
+	reset_counters();
+	dispatch(notifications[1]);
+	zassert_equal(handler_calls[1], 1, NULL);
+
+	zassert_ok(at_notif_deregister_prefix_handler((void *)1, "+CSCON",
+						      prefix_handler), NULL);
+
+	reset_counters();
+	dispatch(notifications[1]);
+	zassert_equal(invocation_cnt, 0, NULL);
+}
+
+static void test_dispatch_benchmark(void)
+{
+	uint32_t filtering_cycles;
+	uint32_t prefix_cycles;
+	uint32_t filtering_invocations;
+
+	register_filtering_handlers();
+	reset_counters();
+	filtering_cycles = dispatch_all();
+	check_handler_calls(TEST_ITERATIONS);
+	filtering_invocations = invocation_cnt;
+	deregister_filtering_handlers();
+
+	register_prefix_handlers();
+	reset_counters();
+	prefix_cycles = dispatch_all();
+	check_handler_calls(TEST_ITERATIONS);
+	deregister_prefix_handlers();
+
+	TC_PRINT("Dispatch to %zu handlers:\n", TEST_HANDLER_CNT);
+	TC_PRINT("  Handlers for all notifications: %u cycles, "
+		 "%u handler calls per notification\n", filtering_cycles,
+		 (uint32_t)(filtering_invocations /
+			    (TEST_ITERATIONS * ARRAY_SIZE(notifications))));
+	TC_PRINT("  Handlers for a prefix: %u cycles, "
+		 "%u handler calls per notification\n", prefix_cycles,
+		 (uint32_t)(invocation_cnt /
+			    (TEST_ITERATIONS * ARRAY_SIZE(notifications))));
+
+	zassert_equal(filtering_invocations,
+		      TEST_HANDLER_CNT * TEST_ITERATIONS *
+		      ARRAY_SIZE(notifications), NULL);
+	zassert_equal(invocation_cnt,
+		      TEST_ITERATIONS * ARRAY_SIZE(notifications),
+		      "Prefix handlers called for unrelated notifications");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(at_notif,
+			 ztest_unit_test(test_at_notif_init),
+			 ztest_unit_test(test_prefix_dispatch),
+			 ztest_unit_test(test_prefix_register_invalid),
+			 ztest_unit_test(test_prefix_register_duplicate),
+			 ztest_unit_test(test_dispatch_benchmark)
+			);
+
+	ztest_run_test_suite(at_notif);
+}
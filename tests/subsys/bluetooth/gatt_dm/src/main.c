@@ -11,6 +11,11 @@
 #include <bluetooth/gatt_dm.h>
 #include "../mock/gatt_discover_mock.h"
 
+#if CONFIG_SETTINGS
+#include <settings/settings.h>
+#include "gatt_dm_cache.h"
+#endif
+
 /* Timeout for the discovery in ms */
 #define SERVICE_DISCOVERY_TIMEOUT 2000
 
@@ -344,6 +349,48 @@ void test_gatt_HIDS_chrc_by_uuid(void)
 	zassert_equal(0, bt_gatt_dm_attr_cnt(dm), "Parameter count after clearing: %d", bt_gatt_dm_attr_cnt(dm));
 }
 
+/* UUIDs are found by their value, whatever the form they are given in */
+void test_gatt_HIDS_uuid_alias(void)
+{
+	struct bt_gatt_dm *dm;
+	const struct bt_gatt_dm_attr *attr_chrc;
+	const struct bt_gatt_dm_attr *attr_desc;
+
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+
+	/* ------------------------------------------------------ */
+	/* 128-bit form of HIDS_REPORT */
+	attr_chrc = bt_gatt_dm_char_by_uuid(dm, BT_UUID_DECLARE_128(
+		BT_UUID_128_ENCODE(0x00002a4d, 0x0000, 0x1000, 0x8000,
+				   0x00805f9b34fb)));
+	zassert_not_null(attr_chrc, "Unexpected NULL");
+	zassert_equal(6, attr_chrc->handle, "Unexpected handle: %d", attr_chrc->handle);
+	/* 32-bit form of CCC */
+	attr_desc = bt_gatt_dm_desc_by_uuid(dm, attr_chrc, BT_UUID_DECLARE_32(BT_UUID_GATT_CCC_VAL));
+	zassert_not_null(attr_desc, "Unexpected NULL");
+	zassert_equal(8, attr_desc->handle, "Unexpected handle: %d", attr_desc->handle);
+	/* The characteristic value has the characteristic UUID */
+	attr_desc = bt_gatt_dm_desc_by_uuid(dm, attr_chrc, BT_UUID_HIDS_REPORT);
+	zassert_not_null(attr_desc, "Unexpected NULL");
+	zassert_equal(7, attr_desc->handle, "Unexpected handle: %d", attr_desc->handle);
+	/* CCC is not present in other characteristics */
+	attr_chrc = bt_gatt_dm_char_by_uuid(dm, BT_UUID_HIDS_INFO);
+	zassert_not_null(attr_chrc, "Unexpected NULL");
+	attr_desc = bt_gatt_dm_desc_by_uuid(dm, attr_chrc, BT_UUID_GATT_CCC);
+	zassert_is_null(attr_desc, "Expected NULL handle");
+	/* 128-bit UUID that is not an alias of a 16-bit one */
+	attr_chrc = bt_gatt_dm_char_by_uuid(dm, BT_UUID_DECLARE_128(
+		BT_UUID_128_ENCODE(0x00002a4d, 0x0000, 0x1000, 0x8000,
+				   0x00805f9b34fc)));
+	zassert_is_null(attr_chrc, "Expected NULL");
+
+	/* ------------------------------------------------------ */
+	/* Clean up */
+	bt_gatt_dm_data_release(dm);
+	zassert_equal(0, bt_gatt_dm_attr_cnt(dm), "Parameter count after clearing: %d", bt_gatt_dm_attr_cnt(dm));
+}
+
 void test_gatt_generic_serv(void)
 {
 	struct bt_gatt_dm *dm;
@@ -376,6 +423,238 @@ void test_gatt_generic_serv(void)
 	/* No cleanup here - cleanup is done in run_dm_next */
 }
 
+#if CONFIG_SETTINGS
+
+static const bt_addr_le_t cache_peer = {
+	.type = BT_ADDR_LE_PUBLIC,
+	.a.val = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 }
+};
+static const bt_addr_le_t cache_other_peer = {
+	.type = BT_ADDR_LE_RANDOM,
+	.a.val = { 0x01, 0x02, 0x03, 0x04, 0x05, 0xc6 }
+};
+static const uint8_t cache_hash[GATT_DM_CACHE_HASH_LEN] = { 0x01 };
+static const uint8_t cache_other_hash[GATT_DM_CACHE_HASH_LEN] = { 0x02 };
+static bool cache_peer_bonded;
+
+/* Only the test peers are bonded, and cache_peer while cache_peer_bonded */
+bool __wrap_bt_addr_le_is_bonded(uint8_t id, const bt_addr_le_t *addr)
+{
+	if (!bt_addr_le_cmp(addr, &cache_peer)) {
+		return cache_peer_bonded;
+	}
+
+	return !bt_addr_le_cmp(addr, &cache_other_peer);
+}
+
+/* Let the system workqueue save and purge the cache records */
+static void cache_work_wait(void)
+{
+	k_sleep(K_MSEC(10));
+}
+
+void test_cache_setup(void)
+{
+	test_setup();
+	cache_peer_bonded = true;
+	zassert_ok(settings_subsys_init(), NULL);
+	zassert_ok(bt_gatt_dm_cache_clear(&cache_peer), NULL);
+	zassert_ok(bt_gatt_dm_cache_clear(&cache_other_peer), NULL);
+	zassert_ok(gatt_dm_cache_open(&cache_peer, cache_hash), NULL);
+}
+
+static void cache_store(struct bt_gatt_dm *dm, const struct bt_uuid *uuid,
+			uint16_t start_handle)
+{
+	zassert_ok(gatt_dm_cache_store(uuid, start_handle,
+				       bt_gatt_dm_service_get(dm),
+				       bt_gatt_dm_attr_cnt(dm)),
+		   NULL);
+}
+
+/* Compare the cached service with the discovered one */
+static void cache_check(struct bt_gatt_dm *dm, struct gatt_dm_cache_svc *svc)
+{
+	const struct bt_gatt_dm_attr *attr = bt_gatt_dm_service_get(dm);
+	const struct bt_gatt_dm_attr *end = attr + bt_gatt_dm_attr_cnt(dm);
+	struct gatt_dm_cache_attr cached;
+
+	for (; attr < end; attr++) {
+		const struct bt_gatt_service_val *svc_val =
+			bt_gatt_dm_attr_service_val(attr);
+		const struct bt_gatt_chrc *chrc_val =
+			bt_gatt_dm_attr_chrc_val(attr);
+
+		zassert_ok(gatt_dm_cache_attr_get(svc, &cached),
+			   "Attr handle: %d", attr->handle);
+		zassert_equal(attr->handle, cached.attr.handle, NULL);
+		zassert_equal(attr->perm, cached.attr.perm, NULL);
+		zassert_ok(bt_uuid_cmp(attr->uuid, cached.attr.uuid),
+			   "Attr handle: %d", attr->handle);
+
+		if (svc_val) {
+			const struct bt_gatt_service_val *val =
+				cached.attr.user_data;
+
+			zassert_equal(svc_val->end_handle, val->end_handle,
+				      NULL);
+			zassert_ok(bt_uuid_cmp(svc_val->uuid, val->uuid), NULL);
+		} else if (chrc_val) {
+			const struct bt_gatt_chrc *val = cached.attr.user_data;
+
+			zassert_equal(chrc_val->properties, val->properties,
+				      NULL);
+			zassert_equal(chrc_val->value_handle,
+				      val->value_handle, NULL);
+			zassert_ok(bt_uuid_cmp(chrc_val->uuid, val->uuid),
+				   NULL);
+		} else {
+			zassert_is_null(cached.attr.user_data, NULL);
+		}
+	}
+
+	zassert_equal(-ENOENT, gatt_dm_cache_attr_get(svc, &cached),
+		      "More attributes cached than discovered");
+}
+
+void test_cache_service(void)
+{
+	struct gatt_dm_cache_svc svc;
+	struct bt_gatt_dm *dm;
+
+	zassert_equal(-ENODATA, gatt_dm_cache_find(BT_UUID_HIDS, 1, &svc),
+		      NULL);
+
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	cache_store(dm, BT_UUID_HIDS, 1);
+
+	zassert_ok(gatt_dm_cache_find(BT_UUID_HIDS, 1, &svc), NULL);
+	zassert_equal(11, svc.end_handle, NULL);
+	cache_check(dm, &svc);
+	bt_gatt_dm_data_release(dm);
+
+	/* Other services are still unknown */
+	zassert_equal(-ENODATA, gatt_dm_cache_find(BT_UUID_DIS, 1, &svc),
+		      NULL);
+	zassert_equal(-ENODATA, gatt_dm_cache_find(BT_UUID_BAS, 1, &svc),
+		      NULL);
+	zassert_equal(-ENODATA, gatt_dm_cache_find(NULL, 1, &svc), NULL);
+}
+
+void test_cache_walk(void)
+{
+	struct gatt_dm_cache_svc svc;
+	struct bt_gatt_dm *dm;
+
+	dm = run_dm(NULL);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	cache_store(dm, NULL, 1);
+	zassert_ok(gatt_dm_cache_find(NULL, 1, &svc), NULL);
+	cache_check(dm, &svc);
+
+	/* The next service is not known until it is discovered */
+	zassert_equal(-ENODATA, gatt_dm_cache_find(NULL, 12, &svc), NULL);
+
+	dm = run_dm_next(dm);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	cache_store(dm, NULL, 12);
+	zassert_ok(gatt_dm_cache_find(NULL, 12, &svc), NULL);
+	cache_check(dm, &svc);
+
+	/* Services inside the walk are found by UUID */
+	zassert_ok(gatt_dm_cache_find(BT_UUID_DIS, 1, &svc), NULL);
+	cache_check(dm, &svc);
+	bt_gatt_dm_data_release(dm);
+
+	/* The last service ends at 0xffff, so there are no others */
+	zassert_equal(-ENOENT, gatt_dm_cache_find(BT_UUID_BAS, 1, &svc),
+		      NULL);
+}
+
+void test_cache_not_found(void)
+{
+	struct gatt_dm_cache_svc svc;
+	struct bt_gatt_dm *dm;
+
+	dm = run_dm(NULL);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	cache_store(dm, NULL, 1);
+	bt_gatt_dm_data_release(dm);
+
+	/* Only a service search that continues the walk ends it */
+	gatt_dm_cache_not_found(BT_UUID_BAS, 1);
+	gatt_dm_cache_not_found(NULL, 13);
+	zassert_equal(-ENODATA, gatt_dm_cache_find(NULL, 12, &svc), NULL);
+
+	gatt_dm_cache_not_found(NULL, 12);
+	zassert_equal(-ENOENT, gatt_dm_cache_find(NULL, 12, &svc), NULL);
+	zassert_equal(-ENOENT, gatt_dm_cache_find(BT_UUID_BAS, 1, &svc),
+		      NULL);
+	zassert_ok(gatt_dm_cache_find(BT_UUID_HIDS, 1, &svc), NULL);
+}
+
+void test_cache_persistence(void)
+{
+	struct gatt_dm_cache_svc svc;
+	struct bt_gatt_dm *dm;
+
+	dm = run_dm(BT_UUID_DIS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	cache_store(dm, BT_UUID_DIS, 1);
+
+	/* Reloaded from settings */
+	zassert_ok(gatt_dm_cache_open(&cache_other_peer, cache_hash), NULL);
+	zassert_equal(-ENODATA, gatt_dm_cache_find(BT_UUID_DIS, 1, &svc),
+		      NULL);
+	zassert_ok(gatt_dm_cache_open(&cache_peer, cache_hash), NULL);
+	zassert_ok(gatt_dm_cache_find(BT_UUID_DIS, 1, &svc), NULL);
+	cache_check(dm, &svc);
+	bt_gatt_dm_data_release(dm);
+
+	/* The database of the peer has changed */
+	zassert_ok(gatt_dm_cache_open(&cache_peer, cache_other_hash), NULL);
+	zassert_equal(-ENODATA, gatt_dm_cache_find(BT_UUID_DIS, 1, &svc),
+		      NULL);
+
+	/* Removed with the bond */
+	zassert_ok(gatt_dm_cache_open(&cache_peer, cache_hash), NULL);
+	zassert_ok(gatt_dm_cache_find(BT_UUID_DIS, 1, &svc), NULL);
+	zassert_ok(bt_gatt_dm_cache_clear(&cache_peer), NULL);
+	zassert_ok(gatt_dm_cache_open(&cache_peer, cache_hash), NULL);
+	zassert_equal(-ENODATA, gatt_dm_cache_find(BT_UUID_DIS, 1, &svc),
+		      NULL);
+}
+
+void test_cache_bond_removed(void)
+{
+	struct gatt_dm_cache_svc svc;
+	struct bt_gatt_dm *dm;
+
+	dm = run_dm(BT_UUID_DIS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	cache_store(dm, BT_UUID_DIS, 1);
+
+	/* The records of removed bonds are deleted when a record is opened */
+	cache_peer_bonded = false;
+	zassert_ok(gatt_dm_cache_open(&cache_other_peer, cache_hash), NULL);
+	cache_store(dm, BT_UUID_DIS, 1);
+	bt_gatt_dm_data_release(dm);
+	cache_work_wait();
+
+	cache_peer_bonded = true;
+	zassert_ok(gatt_dm_cache_open(&cache_peer, cache_hash), NULL);
+	zassert_equal(-ENODATA, gatt_dm_cache_find(BT_UUID_DIS, 1, &svc),
+		      NULL);
+	cache_work_wait();
+
+	/* The record of a bonded peer is kept */
+	zassert_ok(gatt_dm_cache_open(&cache_other_peer, cache_hash), NULL);
+	zassert_ok(gatt_dm_cache_find(BT_UUID_DIS, 1, &svc), NULL);
+}
+
+#endif /* CONFIG_SETTINGS */
+
 void test_main(void)
 {
 	ztest_test_suite(
@@ -387,8 +666,22 @@ void test_main(void)
 		ztest_unit_test_setup_teardown(test_gatt_HIDS_attr_by_handle, test_setup, unit_test_noop),
 		ztest_unit_test_setup_teardown(test_gatt_HIDS_next_chrc_access, test_setup, unit_test_noop),
 		ztest_unit_test_setup_teardown(test_gatt_HIDS_chrc_by_uuid, test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_gatt_HIDS_uuid_alias, test_setup, unit_test_noop),
 		ztest_unit_test_setup_teardown(test_gatt_generic_serv, test_setup, unit_test_noop)
 	);
 
 	ztest_run_test_suite(test_gatt);
+
+#if CONFIG_SETTINGS
+	ztest_test_suite(
+		test_gatt_cache,
+		ztest_unit_test_setup_teardown(test_cache_service, test_cache_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_cache_walk, test_cache_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_cache_not_found, test_cache_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_cache_persistence, test_cache_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_cache_bond_removed, test_cache_setup, unit_test_noop)
+	);
+
+	ztest_run_test_suite(test_gatt_cache);
+#endif
 }
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <ztest.h>
+#include <bluetooth/mesh.h>
+#include <bluetooth/mesh/models.h>
+#include <bluetooth/mesh/light_ctrl_srv.h>
+
+#define REG_INT CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG_INTERVAL
+/* Length of the simulation */
+#define SIM_DURATION (16 * MSEC_PER_SEC)
+/* Ambient illuminance contributed by the light at full level (in centilux) */
+#define LIGHT_CENTI_LUX 60000
+/* Largest deviation from the reference regulator (in light levels) */
+#define REG_TOLERANCE 1
+
+enum flags {
+	FLAG_ON,
+	FLAG_OCC_MODE,
+	FLAG_MANUAL,
+	FLAG_REGULATOR,
+	FLAG_OCC_PENDING,
+	FLAG_ON_PENDING,
+	FLAG_OFF_PENDING,
+	FLAG_TRANSITION,
+	FLAG_STORE_CFG,
+	FLAG_STORE_STATE,
+	FLAG_CTRL_SRV_MANUALLY_ENABLED,
+	FLAG_STARTED,
+	FLAG_RESUME_TIMER,
+};
+
+/** Mocks ******************************************/
+
+static struct bt_mesh_model mock_lightness_model = { .elem_idx = 0 };
+
+static struct bt_mesh_lightness_srv lightness_srv = {
+	.lightness_model = &mock_lightness_model
+};
+
+static struct bt_mesh_light_ctrl_srv light_ctrl_srv =
+	BT_MESH_LIGHT_CTRL_SRV_INIT(&lightness_srv);
+
+static struct bt_mesh_model mock_light_ctrl_model = {
+	.user_data = &light_ctrl_srv,
+	.elem_idx = 1
+};
+
+static uint16_t light_lvl;
+
+void lightness_srv_change_lvl(struct bt_mesh_lightness_srv *srv,
+			      struct bt_mesh_msg_ctx *ctx,
+			      struct bt_mesh_lightness_set *set,
+			      struct bt_mesh_lightness_status *status,
+			      bool publish)
+{
+	light_lvl = set->lvl;
+}
+
+int lightness_on_power_up(struct bt_mesh_lightness_srv *srv)
+{
+	return 0;
+}
+
+uint8_t model_transition_encode(int32_t transition_time)
+{
+	return 0;
+}
+
+int model_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+	       struct net_buf_simple *buf)
+{
+	return 0;
+}
+
+int bt_mesh_onoff_srv_pub(struct bt_mesh_onoff_srv *srv,
+			  struct bt_mesh_msg_ctx *ctx,
+			  const struct bt_mesh_onoff_status *status)
+{
+	return 0;
+}
+
+void bt_mesh_model_msg_init(struct net_buf_simple *msg, uint32_t opcode)
+{
+	net_buf_simple_init(msg, 0);
+}
+
+int bt_mesh_model_extend(struct bt_mesh_model *mod,
+			 struct bt_mesh_model *base_mod)
+{
+	return 0;
+}
+
+/** End Mocks **************************************/
+
+/* Floating point regulator, used as the reference for the output of the
+ * regulator under test.
+ */
+static float ref_i;
+
+static float sensor_to_float(const struct sensor_value *val)
+{
+	return val->val1 + val->val2 / 1000000.0f;
+}
+
+static float ref_target_get(void)
+{
+	struct bt_mesh_light_ctrl_srv *srv = &light_ctrl_srv;
+	float cfg = sensor_to_float(&srv->reg.cfg.lux[srv->state]);
+
+	if (!atomic_test_bit(&srv->flags, FLAG_TRANSITION) ||
+	    !srv->fade.duration) {
+		return cfg;
+	}
+
+	uint32_t remaining = k_ticks_to_ms_ceil32(
+		k_work_delayable_remaining_get(&srv->timer));
+	uint32_t delta = MAX(0, srv->fade.duration - remaining);
+	float init = sensor_to_float(&srv->fade.initial_lux);
+
+	return init + ((cfg - init) * delta) / srv->fade.duration;
+}
+
+static uint16_t ref_step(void)
+{
+	struct bt_mesh_light_ctrl_srv_reg_cfg *cfg = &light_ctrl_srv.reg.cfg;
+	float target = ref_target_get();
+	float error = target - sensor_to_float(&light_ctrl_srv.ambient_lux);
+	float accuracy = (cfg->accuracy * target) / (2 * 100.0f);
+	float input;
+
+	if (error > accuracy) {
+		input = error - accuracy;
+	} else if (error < -accuracy) {
+		input = error + accuracy;
+	} else {
+		input = 0.0f;
+	}
+
+	float kp = (input >= 0) ? cfg->kpu : cfg->kpd;
+	float ki = (input >= 0) ? cfg->kiu : cfg->kid;
+
+	ref_i += (input * ki) * ((float)REG_INT / (float)MSEC_PER_SEC);
+	ref_i = CLAMP(ref_i, 0, UINT16_MAX);
+
+	return CLAMP(ref_i + input * kp, 0, UINT16_MAX);
+}
+
+/* Daylight in the room (in centilux): Dark while the light fades in and
+ * settles, then the sun comes out and takes over.
+ */
+static uint32_t daylight_get(uint32_t time)
+{
+	if (time < 8 * MSEC_PER_SEC) {
+		return 5000;
+	}
+
+	if (time < 10 * MSEC_PER_SEC) {
+		return 5000 + (time - 8 * MSEC_PER_SEC) * 30;
+	}
+
+	return 65000;
+}
+
+static void ambient_set(uint32_t time)
+{
+	uint32_t centi_lux =
+		daylight_get(time) +
+		((uint32_t)light_lvl * LIGHT_CENTI_LUX) / UINT16_MAX;
+
+	light_ctrl_srv.ambient_lux.val1 = centi_lux / 100;
+	light_ctrl_srv.ambient_lux.val2 = (centi_lux % 100) * 10000;
+}
+
+static void test_reg_sim(void)
+{
+	struct k_work *reg_work = &light_ctrl_srv.reg.timer.work;
+	uint32_t cycles = 0;
+	uint32_t max_err = 0;
+	uint32_t steps = 0;
+	float target = sensor_to_float(
+		&light_ctrl_srv.reg.cfg.lux[LIGHT_CTRL_STATE_ON]);
+	float accuracy = (light_ctrl_srv.reg.cfg.accuracy * target) / 200.0f;
+
+	zassert_ok(bt_mesh_light_ctrl_srv_enable(&light_ctrl_srv), NULL);
+	k_sleep(K_MSEC(1));
+
+	/* The regulator steps are run by the test, to time them: */
+	k_work_cancel_delayable(&light_ctrl_srv.reg.timer);
+
+	zassert_ok(bt_mesh_light_ctrl_srv_on(&light_ctrl_srv), NULL);
+
+	for (uint32_t time = 0; time < SIM_DURATION; time += REG_INT) {
+		uint16_t ref;
+		uint32_t start;
+
+		ambient_set(time);
+		ref = ref_step();
+
+		start = k_cycle_get_32();
+		reg_work->handler(reg_work);
+		cycles += k_cycle_get_32() - start;
+		steps++;
+
+		k_work_cancel_delayable(&light_ctrl_srv.reg.timer);
+
+		max_err = MAX(max_err, abs(light_lvl - ref));
+		zassert_within(light_lvl, ref, REG_TOLERANCE,
+			       "Output %u at %u ms, expected %u", light_lvl,
+			       time, ref);
+
+		if (time == 8 * MSEC_PER_SEC) {
+			/* The light has settled on the target illuminance: */
+			zassert_within(
+				sensor_to_float(&light_ctrl_srv.ambient_lux),
+				target, accuracy + 1.0f, "Not settled");
+		}
+
+		k_sleep(K_MSEC(REG_INT));
+	}
+
+	/* The daylight alone exceeds the target illuminance: */
+	zassert_equal(light_lvl, 0, "Light still on");
+
+	TC_PRINT("Regulator step: %u cycles on average, max error %u\n",
+		 cycles / steps, max_err);
+}
+
+static void reg_step_run(uint32_t centi_lux)
+{
+	struct k_work *reg_work = &light_ctrl_srv.reg.timer.work;
+
+	light_ctrl_srv.ambient_lux.val1 = centi_lux / 100;
+	light_ctrl_srv.ambient_lux.val2 = (centi_lux % 100) * 10000;
+
+	reg_work->handler(reg_work);
+	k_work_cancel_delayable(&light_ctrl_srv.reg.timer);
+}
+
+static void test_reg_resume(void)
+{
+	uint16_t output;
+
+	zassert_ok(bt_mesh_light_ctrl_srv_enable(&light_ctrl_srv), NULL);
+	zassert_ok(bt_mesh_light_ctrl_srv_on(&light_ctrl_srv), NULL);
+
+	/* Let the fade finish, so the target illuminance stays the same: */
+	k_sleep(K_MSEC(CONFIG_BT_MESH_LIGHT_CTRL_SRV_TIME_FADE_ON + REG_INT));
+	k_work_cancel_delayable(&light_ctrl_srv.reg.timer);
+
+	/* The room is dark, the regulator turns on the light: */
+	light_ctrl_srv.reg.i = 0;
+	reg_step_run(0);
+	output = light_lvl;
+	zassert_true(output > 0, "Regulator did not take over");
+
+	/* Daylight exceeds the target, the regulator hands back control: */
+	reg_step_run(200000);
+	zassert_equal(light_lvl, 0, "Regulator did not hand back control");
+
+	/* Dark again, the regulator must take over with the same output: */
+	light_ctrl_srv.reg.i = 0;
+	reg_step_run(0);
+	zassert_equal(light_lvl, output, "Regulator did not take over again");
+}
+
+static void setup(void)
+{
+	zassert_ok(_bt_mesh_light_ctrl_srv_cb.init(&mock_light_ctrl_model),
+		   "Init failed");
+	zassert_ok(_bt_mesh_light_ctrl_srv_cb.start(&mock_light_ctrl_model),
+		   "Start failed");
+}
+
+static void teardown(void)
+{
+	_bt_mesh_light_ctrl_srv_cb.reset(&mock_light_ctrl_model);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(light_ctrl_reg_test,
+			 ztest_unit_test_setup_teardown(test_reg_sim, setup,
+							teardown),
+			 ztest_unit_test_setup_teardown(test_reg_resume, setup,
+							teardown));
+
+	ztest_run_test_suite(light_ctrl_reg_test);
+}
@@ -0,0 +1,636 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <ztest.h>
+#include <bluetooth/mesh/models.h>
+#include "model_utils.h"
+#include "mesh/access.h"
+
+#define TEST_MOD_ID_SMALL 0x7f00
+#define TEST_MOD_ID_LARGE 0x7f01
+#define TEST_MOD_ID_VND 0x0001
+#define TEST_COMPANY_ID 0x0059
+
+#define SMALL_MAXLEN 4
+#define LARGE_MAXLEN 48
+#define VND_MAXLEN 4
+
+/* Scene data of the large model that doesn't fit in a cache entry, along with
+ * the data of the other models:
+ */
+#define LARGE_OVERSIZED_LEN 48
+
+/* Number of pages written when storing a scene that isn't cached. */
+#define SCENE_PAGE_CNT 2
+
+#define CACHE_ENABLED (CONFIG_BT_MESH_SCENE_SRV_CACHE_COUNT > 0)
+
+/** Mocks ******************************************/
+
+struct test_mod {
+	uint8_t state[LARGE_MAXLEN];
+	size_t len;
+	uint8_t recalled[LARGE_MAXLEN];
+	size_t recalled_len;
+};
+
+static struct test_mod small_mod;
+static struct test_mod large_mod;
+static struct test_mod vnd_mod;
+static uint32_t recall_complete_cnt;
+
+static struct bt_mesh_scene_srv scene_srv;
+
+static struct bt_mesh_model sig_models[] = {
+	{
+		.id = BT_MESH_MODEL_ID_SCENE_SRV,
+		.mod_idx = 0,
+		.user_data = &scene_srv,
+	},
+	{
+		.id = BT_MESH_MODEL_ID_SCENE_SETUP_SRV,
+		.mod_idx = 1,
+		.user_data = &scene_srv,
+	},
+	{
+		.id = TEST_MOD_ID_SMALL,
+		.mod_idx = 2,
+		.user_data = &small_mod,
+	},
+	{
+		.id = TEST_MOD_ID_LARGE,
+		.mod_idx = 3,
+		.user_data = &large_mod,
+	},
+};
+
+static struct bt_mesh_model vnd_models[] = {
+	{
+		.vnd = {
+			.company = TEST_COMPANY_ID,
+			.id = TEST_MOD_ID_VND,
+		},
+		.mod_idx = 0,
+		.user_data = &vnd_mod,
+	},
+};
+
+static struct bt_mesh_model *const mock_scene_model = &sig_models[0];
+static struct bt_mesh_model *const mock_scene_setup_model = &sig_models[1];
+
+static struct bt_mesh_elem elem = {
+	.model_count = ARRAY_SIZE(sig_models),
+	.vnd_model_count = ARRAY_SIZE(vnd_models),
+	.models = sig_models,
+	.vnd_models = vnd_models,
+};
+
+static const struct bt_mesh_comp comp = {
+	.elem_count = 1,
+	.elem = &elem,
+};
+
+static ssize_t test_mod_store(struct bt_mesh_model *model, uint8_t data[])
+{
+	struct test_mod *mod = model->user_data;
+
+	memcpy(data, mod->state, mod->len);
+	return mod->len;
+}
+
+static void test_mod_recall(struct bt_mesh_model *model, const uint8_t data[],
+			    size_t len,
+			    struct bt_mesh_model_transition *transition)
+{
+	struct test_mod *mod = model->user_data;
+
+	zassert_true(len <= sizeof(mod->recalled), "Invalid length %zu", len);
+
+	memcpy(mod->recalled, data, len);
+	mod->recalled_len = len;
+}
+
+static void test_mod_recall_complete(struct bt_mesh_model *model)
+{
+	recall_complete_cnt++;
+}
+
+BT_MESH_SCENE_ENTRY_SIG(test_small) = {
+	.id.sig = TEST_MOD_ID_SMALL,
+	.maxlen = SMALL_MAXLEN,
+	.store = test_mod_store,
+	.recall = test_mod_recall,
+	.recall_complete = test_mod_recall_complete,
+};
+
+BT_MESH_SCENE_ENTRY_SIG(test_large) = {
+	.id.sig = TEST_MOD_ID_LARGE,
+	.maxlen = LARGE_MAXLEN,
+	.store = test_mod_store,
+	.recall = test_mod_recall,
+};
+
+BT_MESH_SCENE_ENTRY_VND(test_vnd) = {
+	.id.vnd = {
+		.company = TEST_COMPANY_ID,
+		.id = TEST_MOD_ID_VND,
+	},
+	.maxlen = VND_MAXLEN,
+	.store = test_mod_store,
+	.recall = test_mod_recall,
+};
+
+const struct bt_mesh_comp *bt_mesh_comp_get(void)
+{
+	return &comp;
+}
+
+uint8_t bt_mesh_elem_count(void)
+{
+	return comp.elem_count;
+}
+
+bool bt_mesh_is_provisioned(void)
+{
+	return true;
+}
+
+int bt_mesh_model_extend(struct bt_mesh_model *mod,
+			 struct bt_mesh_model *base_mod)
+{
+	return 0;
+}
+
+void bt_mesh_model_msg_init(struct net_buf_simple *msg, uint32_t opcode)
+{
+	net_buf_simple_init(msg, 0);
+}
+
+uint8_t model_transition_encode(int32_t transition_time)
+{
+	return 0;
+}
+
+int model_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+	       struct net_buf_simple *buf)
+{
+	return 0;
+}
+
+/* Persistent storage of the Scene Server data, indexed by the settings path
+ * relative to the model.
+ */
+static struct storage_entry {
+	char path[9];
+	uint8_t data[SETTINGS_MAX_VAL_LEN];
+	size_t len;
+} storage[8];
+static uint32_t write_cnt;
+static uint32_t load_cnt;
+static bool write_fail;
+static bool read_fail;
+
+static struct storage_entry *storage_find(const char *path)
+{
+	for (int i = 0; i < ARRAY_SIZE(storage); i++) {
+		if (!strcmp(storage[i].path, path)) {
+			return &storage[i];
+		}
+	}
+
+	return NULL;
+}
+
+int bt_mesh_model_data_store(struct bt_mesh_model *mod, bool vnd,
+			     const char *name, const void *data,
+			     size_t data_len)
+{
+	struct storage_entry *entry;
+
+	zassert_equal(mod, mock_scene_model, "Invalid model");
+	zassert_not_null(name, "Scene data stored without path");
+
+	if (write_fail) {
+		return -EIO;
+	}
+
+	entry = storage_find(name);
+
+	if (!data) {
+		if (entry) {
+			memset(entry, 0, sizeof(*entry));
+		}
+
+		return 0;
+	}
+
+	if (!entry) {
+		entry = storage_find("");
+		zassert_not_null(entry, "Out of storage");
+		strcpy(entry->path, name);
+	}
+
+	zassert_true(data_len <= sizeof(entry->data), "Invalid length %zu",
+		     data_len);
+
+	memcpy(entry->data, data, data_len);
+	entry->len = data_len;
+	write_cnt++;
+
+	return 0;
+}
+
+static ssize_t storage_read(void *cb_arg, void *data, size_t len)
+{
+	struct storage_entry *entry = cb_arg;
+
+	if (read_fail) {
+		return -EIO;
+	}
+
+	len = MIN(len, entry->len);
+	memcpy(data, entry->data, len);
+
+	return len;
+}
+
+int settings_load_subtree(const char *subtree)
+{
+	/* The subtree is the model data path, followed by the scene number: */
+	const char *scene = strrchr(subtree, '/') + 1;
+	size_t scene_len = strlen(scene);
+
+	load_cnt++;
+
+	for (int i = 0; i < ARRAY_SIZE(storage); i++) {
+		struct storage_entry *entry = &storage[i];
+
+		if (strncmp(entry->path, scene, scene_len) ||
+		    entry->path[scene_len] != '/') {
+			continue;
+		}
+
+		/* Like the settings subsystem, ignore the errors of the
+		 * handler:
+		 */
+		(void)_bt_mesh_scene_srv_cb.settings_set(mock_scene_model,
+							 entry->path,
+							 entry->len,
+							 storage_read, entry);
+	}
+
+	return 0;
+}
+
+int settings_name_next(const char *name, const char **next)
+{
+	const char *sep = strchr(name, '/');
+
+	if (next) {
+		*next = sep ? sep + 1 : NULL;
+	}
+
+	return sep ? sep - name : strlen(name);
+}
+
+/** End Mocks **************************************/
+
+static void mod_fill(struct test_mod *mod, size_t len, uint8_t seed)
+{
+	for (int i = 0; i < len; i++) {
+		mod->state[i] = seed + i;
+	}
+
+	mod->len = len;
+}
+
+/* Set the state of all models to a value given by the seed. */
+static void mods_fill(uint8_t seed)
+{
+	mod_fill(&small_mod, SMALL_MAXLEN, seed);
+	mod_fill(&large_mod, large_mod.len, seed + 0x40);
+	mod_fill(&vnd_mod, VND_MAXLEN, seed + 0x80);
+}
+
+static void mod_recall_check(const struct test_mod *mod, uint8_t seed)
+{
+	zassert_equal(mod->recalled_len, mod->len, "Recalled %zu bytes",
+		      mod->recalled_len);
+
+	for (int i = 0; i < mod->len; i++) {
+		zassert_equal(mod->recalled[i], (uint8_t)(seed + i),
+			      "Invalid data at %u", i);
+	}
+}
+
+/* Check that the recalled state of all models is the one given by the seed. */
+static void mods_recall_check(uint8_t seed)
+{
+	mod_recall_check(&small_mod, seed);
+	mod_recall_check(&large_mod, seed + 0x40);
+	mod_recall_check(&vnd_mod, seed + 0x80);
+}
+
+static void setup_op(uint32_t opcode, uint16_t scene)
+{
+	const struct bt_mesh_model_op *op;
+	struct bt_mesh_msg_ctx ctx = {};
+
+	NET_BUF_SIMPLE_DEFINE(buf, BT_MESH_SCENE_MSG_LEN_STORE);
+
+	for (op = _bt_mesh_scene_setup_srv_op; op->func; op++) {
+		if (op->opcode == opcode) {
+			break;
+		}
+	}
+
+	zassert_not_null(op->func, "Unknown opcode 0x%x", opcode);
+
+	net_buf_simple_add_le16(&buf, scene);
+	op->func(mock_scene_setup_model, &ctx, &buf);
+}
+
+/* Store a scene, and check the number of pages written. */
+static void store(uint16_t scene, uint32_t writes)
+{
+	uint32_t prev_write_cnt = write_cnt;
+
+	/* Without the cache, all pages are written: */
+	if (!CACHE_ENABLED && !write_fail) {
+		writes = SCENE_PAGE_CNT;
+	}
+
+	setup_op(BT_MESH_SCENE_OP_STORE, scene);
+
+	zassert_equal(write_cnt - prev_write_cnt, writes,
+		      "Scene 0x%x: %u pages written", scene,
+		      write_cnt - prev_write_cnt);
+}
+
+static void delete(uint16_t scene)
+{
+	setup_op(BT_MESH_SCENE_OP_DELETE, scene);
+}
+
+/* Recall a scene, and check whether the settings were read. */
+static void recall(uint16_t scene, bool cached)
+{
+	uint32_t prev_load_cnt = load_cnt;
+	uint32_t prev_recall_complete_cnt = recall_complete_cnt;
+	struct bt_mesh_scene_srv_stats prev_stats = scene_srv.stats;
+
+	cached = cached && CACHE_ENABLED;
+
+	small_mod.recalled_len = 0;
+	large_mod.recalled_len = 0;
+	vnd_mod.recalled_len = 0;
+
+	zassert_ok(bt_mesh_scene_srv_set(&scene_srv, scene, NULL),
+		   "Failed recalling 0x%x", scene);
+
+	zassert_equal(load_cnt - prev_load_cnt, cached ? 0 : 1,
+		      "Scene 0x%x %s", scene,
+		      cached ? "loaded" : "not loaded");
+	zassert_equal(recall_complete_cnt - prev_recall_complete_cnt, 1,
+		      "Recall of 0x%x not completed", scene);
+
+	zassert_equal(scene_srv.stats.cache_hits - prev_stats.cache_hits,
+		      cached ? 1 : 0, "Invalid cache hit count");
+	zassert_equal(scene_srv.stats.cache_misses - prev_stats.cache_misses,
+		      cached ? 0 : 1, "Invalid cache miss count");
+	zassert_true(scene_srv.stats.recall_us <= scene_srv.stats.recall_max_us,
+		     "Invalid recall duration");
+}
+
+static void test_lru(void)
+{
+	for (uint16_t scene = 1; scene <= 3; scene++) {
+		mods_fill(scene);
+		store(scene, 2);
+	}
+
+	/* The cache holds the two scenes that were used last: */
+	recall(2, true);
+	mods_recall_check(2);
+	recall(3, true);
+	mods_recall_check(3);
+	recall(1, false);
+	mods_recall_check(1);
+
+	/* Recalling scene 1 evicted scene 2: */
+	recall(3, true);
+	mods_recall_check(3);
+	recall(1, true);
+	mods_recall_check(1);
+	recall(2, false);
+	mods_recall_check(2);
+	recall(1, true);
+	mods_recall_check(1);
+}
+
+static void test_unchanged_pages(void)
+{
+	mods_fill(1);
+	store(1, 2);
+
+	/* Only the pages with changed data are written: */
+	store(1, 0);
+	mod_fill(&vnd_mod, VND_MAXLEN, 0x10);
+	store(1, 1);
+
+	recall(1, true);
+	mod_recall_check(&small_mod, 1);
+	mod_recall_check(&vnd_mod, 0x10);
+}
+
+static void test_oversized(void)
+{
+	large_mod.len = LARGE_OVERSIZED_LEN;
+	mods_fill(1);
+	store(1, 2);
+
+	/* Neither storing nor loading the scene caches it: */
+	recall(1, false);
+	mods_recall_check(1);
+	recall(1, false);
+	mods_recall_check(1);
+
+	/* All pages are written, as the scene isn't cached: */
+	store(1, 2);
+
+	/* Once the scene fits, it's cached: */
+	large_mod.len = 0;
+	mods_fill(2);
+	store(1, 2);
+	recall(1, true);
+	mods_recall_check(2);
+}
+
+static void test_write_fail(void)
+{
+	mods_fill(1);
+	store(1, 2);
+
+	/* The cache entry is dropped when the scene can't be written, so the
+	 * recall reads the data that is still stored:
+	 */
+	mods_fill(2);
+	write_fail = true;
+	store(1, 0);
+	write_fail = false;
+
+	recall(1, false);
+	mods_recall_check(1);
+
+	/* Storing the same data again after a failed write writes all pages: */
+	write_fail = true;
+	store(1, 0);
+	write_fail = false;
+
+	store(1, 2);
+	recall(1, true);
+	mods_recall_check(2);
+}
+
+static void test_delete(void)
+{
+	mods_fill(1);
+	store(1, 2);
+	store(2, 2);
+
+	delete(1);
+	zassert_equal(bt_mesh_scene_srv_set(&scene_srv, 1, NULL), -ENOENT,
+		      "Deleted scene recalled");
+	zassert_is_null(storage_find("1/s0"), "Scene data not deleted");
+
+	/* A scene stored with the same data as the deleted scene is written: */
+	store(1, 2);
+	recall(1, true);
+	mods_recall_check(1);
+
+	/* Scene 2 is still cached: */
+	recall(2, true);
+	mods_recall_check(1);
+}
+
+static void test_reset(void)
+{
+	mods_fill(1);
+	store(1, 2);
+	store(2, 2);
+
+	_bt_mesh_scene_srv_cb.reset(mock_scene_model);
+	zassert_is_null(storage_find("1/s0"), "Scene data not deleted");
+	zassert_is_null(storage_find("2/s0"), "Scene data not deleted");
+
+	/* Scenes stored with the same data after the reset are written: */
+	store(1, 2);
+	store(2, 2);
+	recall(1, true);
+	mods_recall_check(1);
+	recall(2, true);
+	mods_recall_check(1);
+}
+
+static void test_cached_recall(void)
+{
+	struct test_mod *mods[] = { &small_mod, &large_mod, &vnd_mod };
+	struct test_mod cached[ARRAY_SIZE(mods)];
+
+	large_mod.len = LARGE_MAXLEN / 4;
+	mods_fill(1);
+	store(1, 2);
+
+	recall(1, true);
+	mods_recall_check(1);
+
+	for (int i = 0; i < ARRAY_SIZE(mods); i++) {
+		cached[i] = *mods[i];
+	}
+
+	/* Evict scene 1 from the cache: */
+	mods_fill(2);
+	store(2, 2);
+	store(3, 2);
+
+	/* The models get the same data from the settings as from the cache: */
+	recall(1, false);
+
+	for (int i = 0; i < ARRAY_SIZE(mods); i++) {
+		zassert_equal(mods[i]->recalled_len, cached[i].recalled_len,
+			      "Model %u: recalled %zu bytes, cached %zu bytes", i,
+			      mods[i]->recalled_len, cached[i].recalled_len);
+		zassert_mem_equal(mods[i]->recalled, cached[i].recalled,
+				  cached[i].recalled_len,
+				  "Model %u: invalid data", i);
+	}
+}
+
+static void test_read_fail(void)
+{
+	mods_fill(1);
+	store(1, 2);
+
+	/* Evict scene 1 from the cache: */
+	mods_fill(2);
+	store(2, 2);
+	store(3, 2);
+
+	read_fail = true;
+	recall(1, false);
+	read_fail = false;
+
+	/* The scene that failed loading isn't cached: */
+	recall(1, false);
+	mods_recall_check(1);
+	recall(1, true);
+	mods_recall_check(1);
+}
+
+static void setup(void)
+{
+	large_mod.len = 0;
+	mods_fill(0);
+}
+
+static void teardown(void)
+{
+	_bt_mesh_scene_srv_cb.reset(mock_scene_model);
+
+	memset(storage, 0, sizeof(storage));
+	write_fail = false;
+	read_fail = false;
+}
+
+void test_main(void)
+{
+	zassert_ok(_bt_mesh_scene_srv_cb.init(mock_scene_model), NULL);
+	zassert_ok(_bt_mesh_scene_setup_srv_cb.init(mock_scene_setup_model),
+		   NULL);
+
+	ztest_test_suite(scene_srv_test,
+			 ztest_unit_test_setup_teardown(test_lru, setup,
+							teardown),
+			 ztest_unit_test_setup_teardown(test_unchanged_pages,
+							setup, teardown),
+			 ztest_unit_test_setup_teardown(test_oversized, setup,
+							teardown),
+			 ztest_unit_test_setup_teardown(test_write_fail, setup,
+							teardown),
+			 ztest_unit_test_setup_teardown(test_delete, setup,
+							teardown),
+			 ztest_unit_test_setup_teardown(test_reset, setup,
+							teardown),
+			 ztest_unit_test_setup_teardown(test_cached_recall,
+							setup, teardown),
+			 ztest_unit_test_setup_teardown(test_read_fail, setup,
+							teardown)
+			 );
+
+	ztest_run_test_suite(scene_srv_test);
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdint.h>
+#include <ztest.h>
+#include <bluetooth/mesh/models.h>
+#include <bluetooth/mesh/sensor_srv.h>
+#include "mesh/transport.h"
+#include "sensor.h"
+
+/* Base publication period of the server */
+#define PUB_PERIOD 4000
+/* Length of the simulated workload */
+#define SIM_DURATION (60 * MSEC_PER_SEC)
+
+/** Mocks ******************************************/
+
+static uint32_t now;
+
+static int motion_get(struct bt_mesh_sensor *sensor,
+		      struct bt_mesh_msg_ctx *ctx, struct sensor_value *rsp)
+{
+	rsp->val1 = ((now / 3000) % 2) ? 50 : 60;
+	return 0;
+}
+
+static int people_get(struct bt_mesh_sensor *sensor,
+		      struct bt_mesh_msg_ctx *ctx, struct sensor_value *rsp)
+{
+	rsp->val1 = 1 + now / 7000;
+	return 0;
+}
+
+static int light_get(struct bt_mesh_sensor *sensor,
+		     struct bt_mesh_msg_ctx *ctx, struct sensor_value *rsp)
+{
+	rsp->val1 = 100 + now / 5000;
+	return 0;
+}
+
+static int temp_get(struct bt_mesh_sensor *sensor,
+		    struct bt_mesh_msg_ctx *ctx, struct sensor_value *rsp)
+{
+	rsp->val1 = 20 + now / 11000;
+	return 0;
+}
+
+static struct bt_mesh_sensor motion_sensor = {
+	.type = &bt_mesh_sensor_motion_sensed,
+	.get = motion_get,
+};
+
+static struct bt_mesh_sensor people_sensor = {
+	.type = &bt_mesh_sensor_people_count,
+	.get = people_get,
+};
+
+static struct bt_mesh_sensor light_sensor = {
+	.type = &bt_mesh_sensor_present_amb_light_level,
+	.get = light_get,
+};
+
+static struct bt_mesh_sensor temp_sensor = {
+	.type = &bt_mesh_sensor_present_amb_temp,
+	.get = temp_get,
+};
+
+static struct bt_mesh_sensor *const sensors[] = {
+	&temp_sensor,
+	&light_sensor,
+	&people_sensor,
+	&motion_sensor,
+};
+
+static struct bt_mesh_sensor_srv sensor_srv =
+	BT_MESH_SENSOR_SRV_INIT(sensors, ARRAY_SIZE(sensors));
+
+static struct bt_mesh_model mock_sensor_model = {
+	.pub = &sensor_srv.pub,
+	.user_data = &sensor_srv,
+};
+
+int32_t bt_mesh_model_pub_period_get(struct bt_mesh_model *mod)
+{
+	if (mod->pub->fast_period) {
+		return PUB_PERIOD >> mod->pub->period_div;
+	}
+
+	return PUB_PERIOD;
+}
+
+int bt_mesh_model_send(struct bt_mesh_model *model,
+		       struct bt_mesh_msg_ctx *ctx,
+		       struct net_buf_simple *msg,
+		       const struct bt_mesh_send_cb *cb, void *cb_data)
+{
+	return 0;
+}
+
+int model_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+	       struct net_buf_simple *buf)
+{
+	return 0;
+}
+
+int bt_mesh_model_data_store(struct bt_mesh_model *mod, bool vnd,
+			     const char *name, const void *data,
+			     size_t data_len)
+{
+	return 0;
+}
+
+/** End Mocks **************************************/
+
+static uint32_t pdu_count(const struct bt_mesh_model_pub *pub, size_t len)
+{
+	size_t mic_size = BT_MESH_MIC_SHORT;
+
+	if (!pub->send_rel && len <= BT_MESH_SDU_UNSEG_MAX) {
+		return 1;
+	}
+
+	/* Segmented messages use the long TransMIC if it fits in the SDU */
+	if (len + BT_MESH_MIC_LONG <= BT_MESH_TX_SDU_MAX) {
+		mic_size = BT_MESH_MIC_LONG;
+	}
+
+	return ceiling_fraction(len + mic_size, BT_MESH_APP_SEG_SDU_MAX);
+}
+
+/* Check the sensors in a Sensor Status publication, and record when they
+ * were published.
+ */
+static void status_check(struct net_buf_simple *buf, uint32_t *pub_time)
+{
+	uint16_t prev_id = 0;
+
+	(void)net_buf_simple_pull_u8(buf);
+
+	while (buf->len) {
+		uint16_t id;
+		uint8_t len;
+		int i;
+
+		sensor_status_id_decode(buf, &len, &id);
+		zassert_true(id > prev_id, "Sensors out of order");
+		prev_id = id;
+
+		for (i = 0; i < ARRAY_SIZE(sensors); i++) {
+			if (sensor_srv.sensors[i]->type->id == id) {
+				break;
+			}
+		}
+
+		zassert_true(i < ARRAY_SIZE(sensors), "Unknown sensor 0x%04x",
+			     id);
+		zassert_true(buf->len >= len, "Truncated sensor 0x%04x", id);
+
+		pub_time[i] = now;
+		(void)net_buf_simple_pull_mem(buf, len);
+	}
+}
+
+/* Run the publication workload, and return the number of PDUs sent. */
+static uint32_t pub_sim(void)
+{
+	uint32_t pub_time[ARRAY_SIZE(sensors)] = {};
+	uint32_t msg_count = 0;
+	uint32_t pdus = 0;
+
+	for (int i = 0; i < ARRAY_SIZE(sensors); i++) {
+		memset(&sensors[i]->state, 0, sizeof(sensors[i]->state));
+	}
+
+	zassert_ok(_bt_mesh_sensor_srv_cb.init(&mock_sensor_model), NULL);
+
+	/* The motion sensor publishes four times per publication period,
+	 * while the other sensors publish once per period, or when their
+	 * values change.
+	 */
+	motion_sensor.state.pub_div = 2;
+	motion_sensor.state.threshold.range.cadence =
+		BT_MESH_SENSOR_CADENCE_FAST;
+	motion_sensor.state.threshold.range.high.val1 = 100;
+
+	for (now = 0; now < SIM_DURATION;
+	     now += bt_mesh_model_pub_period_get(&mock_sensor_model)) {
+		struct net_buf_simple buf;
+
+		if (sensor_srv.pub.update(&mock_sensor_model)) {
+			continue;
+		}
+
+		msg_count++;
+		pdus += pdu_count(&sensor_srv.pub, sensor_srv.pub.msg->len);
+
+		net_buf_simple_init_with_data(&buf, sensor_srv.pub.msg->data,
+					      sensor_srv.pub.msg->len);
+		status_check(&buf, pub_time);
+
+		for (int i = 0; i < ARRAY_SIZE(sensors); i++) {
+			zassert_true(now - pub_time[i] <= PUB_PERIOD,
+				     "Sensor 0x%04x not published at %u",
+				     sensor_srv.sensors[i]->type->id, now);
+		}
+	}
+
+	zassert_equal(msg_count, 60, "Sent %u publications", msg_count);
+
+	return pdus;
+}
+
+static void test_pub_pdu_count(void)
+{
+	/* Sending values that aren't due in the free space of the last segment
+	 * saves 7 of the 73 PDUs needed without it.
+	 */
+	uint32_t expected_pdus =
+		IS_ENABLED(CONFIG_BT_MESH_SENSOR_SRV_PUB_ALIGN) ? 66 : 73;
+	uint32_t pdus;
+
+	sensor_srv.pub.send_rel = false;
+	pdus = pub_sim();
+
+	zassert_equal(pdus, expected_pdus, "Sent %u PDUs", pdus);
+}
+
+static void test_pub_pdu_count_rel(void)
+{
+	/* Reliable publications are always segmented, and use the long
+	 * TransMIC, so the last segment has less free space.
+	 */
+	uint32_t expected_pdus =
+		IS_ENABLED(CONFIG_BT_MESH_SENSOR_SRV_PUB_ALIGN) ? 87 : 102;
+	uint32_t pdus;
+
+	sensor_srv.pub.send_rel = true;
+	pdus = pub_sim();
+
+	zassert_equal(pdus, expected_pdus, "Sent %u PDUs", pdus);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(sensor_srv_test,
+			 ztest_unit_test(test_pub_pdu_count),
+			 ztest_unit_test(test_pub_pdu_count_rel)
+			 );
+
+	ztest_run_test_suite(sensor_srv_test);
+}
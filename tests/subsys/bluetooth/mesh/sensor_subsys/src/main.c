@@ -2427,9 +2427,49 @@ static void test_present_rel_output_ripple_voltage(void)
 	percentage8_check(sensor_type);
 }
 
+/* Sensor type lookup */
+
+static void test_type_table_sorted(void)
+{
+	const struct bt_mesh_sensor_type *prev = NULL;
+	size_t count = 0;
+
+	/* bt_mesh_sensor_type_get() relies on the linker sorting the sensor
+	 * types by ID.
+	 */
+	Z_STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		if (prev) {
+			zassert_true(prev->id < type->id,
+				     "0x%04x placed before 0x%04x", prev->id,
+				     type->id);
+		}
+
+		zassert_equal_ptr(bt_mesh_sensor_type_get(type->id), type,
+				  "0x%04x not found", type->id);
+		prev = type;
+		count++;
+	}
+
+	zassert_true(count > 0, "No sensor types");
+}
+
+static void test_type_get_unknown(void)
+{
+	zassert_is_null(bt_mesh_sensor_type_get(BT_MESH_PROP_ID_PROHIBITED),
+			NULL);
+	zassert_is_null(bt_mesh_sensor_type_get(0xffff), NULL);
+	/* Device Property that is not a sensor type */
+	zassert_is_null(
+		bt_mesh_sensor_type_get(BT_MESH_PROP_ID_DEV_FW_REVISION), NULL);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(sensor_types_test,
+			/* Sensor type lookup */
+			ztest_unit_test(test_type_table_sorted),
+			ztest_unit_test(test_type_get_unknown),
+
 			/* Occupancy sensors */
 			ztest_unit_test(test_motion_sensor),
 			ztest_unit_test(test_motion_threshold),
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRF_RPC_CBOR_MOCK_H_
+#define NRF_RPC_CBOR_MOCK_H_
+
+/* The subset of the nRF RPC CBOR API used by the serialization module.
+ * Packets are decoded from a flat buffer, as nRF RPC does with the
+ * received transport buffer.
+ */
+
+#include <tinycbor/cbor.h>
+#include <tinycbor/cbor_buf_writer.h>
+
+#define NRF_RPC_ID_UNKNOWN 0xFF
+#define NRF_RPC_PACKET_TYPE_RSP 0x01
+
+#define NRF_RPC_MOCK_RSP_SIZE 16
+
+enum nrf_rpc_err_src {
+	NRF_RPC_ERR_SRC_RECV,
+	NRF_RPC_ERR_SRC_SEND,
+};
+
+struct nrf_rpc_group;
+
+#define NRF_RPC_GROUP_DECLARE(_name) extern const struct nrf_rpc_group _name
+
+typedef void (*nrf_rpc_cbor_handler_t)(CborValue *value, void *handler_data);
+
+struct nrf_rpc_cbor_ctx {
+	CborEncoder encoder;
+	struct cbor_buf_writer writer;
+	uint8_t buf[NRF_RPC_MOCK_RSP_SIZE];
+};
+
+#define NRF_RPC_CBOR_ALLOC(_ctx, _len)                                        \
+	do {                                                                  \
+		cbor_buf_writer_init(&(_ctx).writer, (_ctx).buf,              \
+				     sizeof((_ctx).buf));                     \
+		cbor_encoder_init(&(_ctx).encoder, &(_ctx).writer.enc, 0);    \
+	} while (0)
+
+void nrf_rpc_err(int code, enum nrf_rpc_err_src src,
+		 const struct nrf_rpc_group *group, uint8_t id,
+		 uint8_t packet_type);
+
+void nrf_rpc_cbor_decoding_done(CborValue *value);
+
+void nrf_rpc_cbor_rsp_no_err(struct nrf_rpc_cbor_ctx *ctx);
+
+/** @brief Start decoding a received packet.
+ *
+ * @param[out] value Value to decode the packet with.
+ * @param[in]  packet Packet data.
+ * @param[in]  len Packet length.
+ */
+void nrf_rpc_cbor_mock_recv(CborValue *value, const uint8_t *packet,
+			    size_t len);
+
+/** @brief Check if the packet being decoded was released.
+ *
+ * @retval True if nrf_rpc_cbor_decoding_done() was called for the packet.
+ */
+bool nrf_rpc_cbor_mock_released(void);
+
+#endif /* NRF_RPC_CBOR_MOCK_H_ */
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <tinycbor/cbor_buf_reader.h>
+
+#include "nrf_rpc_cbor.h"
+
+static struct cbor_buf_reader reader;
+static CborParser parser;
+static bool released;
+
+void nrf_rpc_err(int code, enum nrf_rpc_err_src src,
+		 const struct nrf_rpc_group *group, uint8_t id,
+		 uint8_t packet_type)
+{
+	ARG_UNUSED(src);
+	ARG_UNUSED(group);
+	ARG_UNUSED(id);
+	ARG_UNUSED(packet_type);
+
+	TC_PRINT("nRF RPC error %d\n", code);
+}
+
+void nrf_rpc_cbor_decoding_done(CborValue *value)
+{
+	ARG_UNUSED(value);
+
+	zassert_false(released, "Packet released twice");
+	released = true;
+}
+
+void nrf_rpc_cbor_rsp_no_err(struct nrf_rpc_cbor_ctx *ctx)
+{
+	ARG_UNUSED(ctx);
+}
+
+void nrf_rpc_cbor_mock_recv(CborValue *value, const uint8_t *packet,
+			    size_t len)
+{
+	CborError err;
+
+	released = false;
+
+	cbor_buf_reader_init(&reader, packet, len);
+	err = cbor_parser_init(&reader.r, 0, &parser, value);
+	zassert_equal(err, CborNoError, "Parser init failed: %d", err);
+}
+
+bool nrf_rpc_cbor_mock_released(void)
+{
+	return released;
+}
@@ -0,0 +1,618 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <kernel.h>
+#include <string.h>
+#include <tinycbor/cbor_buf_writer.h>
+
+#include <nrf_rpc_cbor.h>
+#include "serialize.h"
+#include "cbkproxy.h"
+#include "bt_rpc_common.h"
+
+/* Notification payload with the maximum ATT MTU of 247 bytes */
+#define NOTIFY_LEN 244
+#define NOTIFY_HANDLE 0x0010
+
+#define BENCHMARK_PACKETS 1000
+
+/* Number of distinct callbacks and operations of the callback proxy stress
+ * test. There are more callbacks than input slots.
+ */
+#define STRESS_CALLBACKS (4 * CONFIG_CBKPROXY_IN_SLOTS)
+#define STRESS_ITERATIONS 20000
+
+/* Number of registrations of the callback proxy cycle test */
+#define CYCLE_REGISTRATIONS (4 * CONFIG_CBKPROXY_IN_SLOTS)
+
+static uint8_t notify_data[NOTIFY_LEN];
+static uint8_t packet[NOTIFY_LEN + 16];
+static size_t packet_len;
+
+/* Encodes a notification as the sender does: the scratchpad size if the
+ * payload is copied on the receiving side, the attribute handle and the
+ * payload.
+ */
+static void notification_encode(const uint8_t *data, size_t len, bool in_place)
+{
+	struct cbor_buf_writer writer;
+	CborEncoder encoder;
+
+	cbor_buf_writer_init(&writer, packet, sizeof(packet));
+	cbor_encoder_init(&encoder, &writer.enc, 0);
+
+	if (!in_place) {
+		ser_encode_uint(&encoder, SCRATCHPAD_ALIGN(len));
+	}
+
+	ser_encode_uint(&encoder, NOTIFY_HANDLE);
+	ser_encode_buffer(&encoder, data, len);
+
+	packet_len = cbor_buf_writer_buffer_size(&writer, packet);
+}
+
+/* Models the application callback, which reads the whole payload */
+static uint32_t notification_consume(uint16_t handle, const uint8_t *data,
+				     size_t len)
+{
+	uint32_t sum = handle;
+
+	for (size_t i = 0; i < len; i++) {
+		sum += data[i];
+	}
+
+	return sum;
+}
+
+static uint32_t notification_recv_copy(void)
+{
+	CborValue value;
+	struct ser_scratchpad scratchpad;
+	uint16_t handle;
+	const uint8_t *data;
+	size_t len;
+
+	nrf_rpc_cbor_mock_recv(&value, packet, packet_len);
+
+	SER_SCRATCHPAD_DECLARE(&scratchpad, &value);
+
+	handle = ser_decode_uint(&value);
+	len = ser_decode_buffer_size(&value);
+	data = ser_decode_buffer_into_scratchpad(&scratchpad);
+
+	zassert_true(ser_decoding_done_and_check(&value), "Decoding failed");
+
+	return notification_consume(handle, data, len);
+}
+
+static uint32_t notification_recv_in_place(void)
+{
+	CborValue value;
+	uint16_t handle;
+	const uint8_t *data;
+	size_t len;
+	uint32_t sum;
+
+	nrf_rpc_cbor_mock_recv(&value, packet, packet_len);
+
+	handle = ser_decode_uint(&value);
+	data = ser_decode_buffer_in_place(&value, &len);
+
+	zassert_true(ser_decode_valid(&value), "Decoding failed");
+
+	sum = notification_consume(handle, data, len);
+
+	zassert_true(ser_decoding_done_and_check(&value), "Decoding failed");
+
+	return sum;
+}
+
+static void test_setup(void)
+{
+	for (size_t i = 0; i < sizeof(notify_data); i++) {
+		notify_data[i] = i;
+	}
+}
+
+static void test_buffer_in_place(void)
+{
+	CborValue value;
+	const uint8_t *data;
+	size_t len;
+
+	notification_encode(notify_data, sizeof(notify_data), true);
+	nrf_rpc_cbor_mock_recv(&value, packet, packet_len);
+
+	zassert_equal(ser_decode_uint(&value), NOTIFY_HANDLE, NULL);
+
+	data = ser_decode_buffer_in_place(&value, &len);
+	zassert_true(ser_decode_valid(&value), "Decoding failed");
+	zassert_equal(len, sizeof(notify_data), "Unexpected length %u", len);
+	zassert_true((data > packet) && (data + len == packet + packet_len),
+		     "Buffer not referenced in the packet");
+	zassert_mem_equal(data, notify_data, len, NULL);
+
+	/* The packet is held until the decoding is done */
+	zassert_false(nrf_rpc_cbor_mock_released(), NULL);
+	zassert_true(ser_decoding_done_and_check(&value), "Decoding failed");
+	zassert_true(nrf_rpc_cbor_mock_released(), NULL);
+}
+
+static void test_buffer_in_place_null(void)
+{
+	CborValue value;
+	const uint8_t *data;
+	size_t len = 1;
+
+	notification_encode(NULL, 0, true);
+	nrf_rpc_cbor_mock_recv(&value, packet, packet_len);
+
+	zassert_equal(ser_decode_uint(&value), NOTIFY_HANDLE, NULL);
+
+	data = ser_decode_buffer_in_place(&value, &len);
+	zassert_is_null(data, NULL);
+	zassert_equal(len, 0, NULL);
+	zassert_true(ser_decoding_done_and_check(&value), "Decoding failed");
+}
+
+static void test_buffer_in_place_invalid(void)
+{
+	CborValue value;
+	const uint8_t *data;
+	size_t len = 1;
+
+	notification_encode(notify_data, sizeof(notify_data), true);
+	nrf_rpc_cbor_mock_recv(&value, packet, packet_len);
+
+	/* The attribute handle is not a buffer */
+	data = ser_decode_buffer_in_place(&value, &len);
+	zassert_is_null(data, NULL);
+	zassert_equal(len, 0, NULL);
+	zassert_false(ser_decode_valid(&value), NULL);
+	zassert_false(ser_decoding_done_and_check(&value), NULL);
+}
+
+static void test_notification_benchmark(void)
+{
+	uint32_t expected;
+	uint32_t start;
+	uint32_t copy_cycles;
+	uint32_t in_place_cycles;
+	uint64_t copy_ns;
+	uint64_t in_place_ns;
+
+	expected = notification_consume(NOTIFY_HANDLE, notify_data,
+					sizeof(notify_data));
+
+	notification_encode(notify_data, sizeof(notify_data), false);
+	start = k_cycle_get_32();
+
+	for (size_t i = 0; i < BENCHMARK_PACKETS; i++) {
+		zassert_equal(notification_recv_copy(), expected, NULL);
+	}
+
+	copy_cycles = k_cycle_get_32() - start;
+
+	notification_encode(notify_data, sizeof(notify_data), true);
+	start = k_cycle_get_32();
+
+	for (size_t i = 0; i < BENCHMARK_PACKETS; i++) {
+		zassert_equal(notification_recv_in_place(), expected, NULL);
+	}
+
+	in_place_cycles = k_cycle_get_32() - start;
+
+	copy_ns = MAX(k_cyc_to_ns_floor64(copy_cycles), 1);
+	in_place_ns = MAX(k_cyc_to_ns_floor64(in_place_cycles), 1);
+
+	TC_PRINT("Received %u notifications of %u bytes\n",
+		 BENCHMARK_PACKETS, NOTIFY_LEN);
+	TC_PRINT("Scratchpad copy: %u us, %u kB/s\n",
+		 (uint32_t)(copy_ns / 1000),
+		 (uint32_t)((uint64_t)BENCHMARK_PACKETS * NOTIFY_LEN *
+			    1000000 / copy_ns));
+	TC_PRINT("In place: %u us, %u kB/s\n",
+		 (uint32_t)(in_place_ns / 1000),
+		 (uint32_t)((uint64_t)BENCHMARK_PACKETS * NOTIFY_LEN *
+			    1000000 / in_place_ns));
+}
+
+/* Thumb function addresses are odd, like the ones of real callbacks */
+static void *fake_callback(size_t i)
+{
+	return (void *)(uintptr_t)(0x20000001 + 4 * i);
+}
+
+static void test_cbkproxy_in_ref_count(void)
+{
+	void *cb = fake_callback(0);
+	int slot;
+
+	slot = cbkproxy_in_set(cb);
+	zassert_true(slot >= 0, "No slot");
+	zassert_equal(cbkproxy_in_set(cb), slot, "Slot not shared");
+	zassert_equal_ptr(cbkproxy_in_get(slot), cb, NULL);
+
+	/* The slot stays allocated until the last reference is released */
+	cbkproxy_in_release(cb);
+	zassert_equal_ptr(cbkproxy_in_get(slot), cb, NULL);
+
+	cbkproxy_in_release(cb);
+	zassert_is_null(cbkproxy_in_get(slot), NULL);
+
+	/* Releasing unknown callbacks has no effect */
+	cbkproxy_in_release(cb);
+	cbkproxy_in_release(NULL);
+
+	zassert_is_null(cbkproxy_in_get(-1), NULL);
+	zassert_is_null(cbkproxy_in_get(CONFIG_CBKPROXY_IN_SLOTS), NULL);
+}
+
+static void test_cbkproxy_in_reclaim(void)
+{
+	int slots[CONFIG_CBKPROXY_IN_SLOTS];
+	void *cb;
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		slots[i] = cbkproxy_in_set(fake_callback(i));
+		zassert_true(slots[i] >= 0, "No slot for callback %u", i);
+	}
+
+	cb = fake_callback(ARRAY_SIZE(slots));
+	zassert_equal(cbkproxy_in_set(cb), -1, "Too many slots");
+
+	/* A released slot is reused by another callback */
+	cbkproxy_in_release(fake_callback(3));
+	zassert_equal(cbkproxy_in_set(cb), slots[3], NULL);
+	zassert_equal_ptr(cbkproxy_in_get(slots[3]), cb, NULL);
+
+	/* The other callbacks are still found after the removal */
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		if (i != 3) {
+			zassert_equal(cbkproxy_in_set(fake_callback(i)),
+				      slots[i], NULL);
+			cbkproxy_in_release(fake_callback(i));
+		}
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		cbkproxy_in_release((i == 3) ? cb : fake_callback(i));
+		zassert_is_null(cbkproxy_in_get(slots[i]), NULL);
+	}
+}
+
+static void test_cbkproxy_in_stress(void)
+{
+	static uint32_t ref_cnt[STRESS_CALLBACKS];
+	static int slot[STRESS_CALLBACKS];
+	uint32_t rand = 1;
+	uint32_t used = 0;
+	uint32_t registered = 0;
+	uint32_t failed = 0;
+
+	memset(ref_cnt, 0, sizeof(ref_cnt));
+
+	for (size_t n = 0; n < STRESS_ITERATIONS; n++) {
+		size_t i;
+		void *cb;
+
+		rand = rand * 1103515245 + 12345;
+		i = (rand >> 16) % STRESS_CALLBACKS;
+		cb = fake_callback(i);
+
+		/* Three of four operations on a registered callback release it,
+		 * so that slots are freed and reused all the time.
+		 */
+		if ((rand & (BIT(30) | BIT(31))) && (ref_cnt[i] > 0)) {
+			cbkproxy_in_release(cb);
+
+			if (--ref_cnt[i] == 0) {
+				zassert_is_null(cbkproxy_in_get(slot[i]), NULL);
+				used--;
+			}
+		} else if (ref_cnt[i] > 0) {
+			zassert_equal(cbkproxy_in_set(cb), slot[i],
+				      "Callback %u moved", i);
+			ref_cnt[i]++;
+		} else if (used < CONFIG_CBKPROXY_IN_SLOTS) {
+			slot[i] = cbkproxy_in_set(cb);
+			zassert_true(slot[i] >= 0, "No slot for callback %u", i);
+			ref_cnt[i]++;
+			used++;
+			registered++;
+		} else {
+			zassert_equal(cbkproxy_in_set(cb), -1, "Too many slots");
+			failed++;
+		}
+
+		for (i = 0; i < STRESS_CALLBACKS; i++) {
+			if (ref_cnt[i] > 0) {
+				zassert_equal_ptr(cbkproxy_in_get(slot[i]),
+						  fake_callback(i), NULL);
+			}
+		}
+	}
+
+	TC_PRINT("%u operations, %u slots allocated, %u full table failures\n",
+		 STRESS_ITERATIONS, registered, failed);
+
+	for (size_t i = 0; i < STRESS_CALLBACKS; i++) {
+		while (ref_cnt[i] > 0) {
+			cbkproxy_in_release(fake_callback(i));
+			ref_cnt[i]--;
+		}
+	}
+
+	/* All slots are free again */
+	for (size_t i = 0; i < CONFIG_CBKPROXY_IN_SLOTS; i++) {
+		slot[i] = cbkproxy_in_set(fake_callback(STRESS_CALLBACKS + i));
+		zassert_true(slot[i] >= 0, "Slot leaked");
+	}
+
+	for (size_t i = 0; i < CONFIG_CBKPROXY_IN_SLOTS; i++) {
+		cbkproxy_in_release(fake_callback(STRESS_CALLBACKS + i));
+	}
+}
+
+#if CONFIG_CBKPROXY_OUT_SLOTS > 0
+typedef void (*cycle_cb_t)(int arg);
+
+static int cycle_type;
+static uint32_t cycle_slot;
+static int cycle_arg;
+
+static inline void cycle_a_callback(int arg, uint32_t callback_slot)
+{
+	cycle_type = 0;
+	cycle_slot = callback_slot;
+	cycle_arg = arg;
+}
+
+CBKPROXY_HANDLER(cycle_a_encoder, cycle_a_callback, (int arg), (arg));
+
+static inline void cycle_b_callback(int arg, uint32_t callback_slot)
+{
+	cycle_type = 1;
+	cycle_slot = callback_slot;
+	cycle_arg = arg;
+}
+
+CBKPROXY_HANDLER(cycle_b_encoder, cycle_b_callback, (int arg), (arg));
+
+static void *const cycle_encoders[] = {
+	(void *)cycle_a_encoder,
+	(void *)cycle_b_encoder,
+};
+#endif /* CONFIG_CBKPROXY_OUT_SLOTS > 0 */
+
+/* Registers callbacks as the client and the host do, keeping all slots in
+ * use, and unregisters the oldest one before each new registration. Each
+ * slot is then reused by a callback of the other type.
+ */
+static void test_cbkproxy_cycle(void)
+{
+	static void *proxy[CYCLE_REGISTRATIONS];
+	static int slot[CYCLE_REGISTRATIONS];
+
+	for (size_t i = 0; i < CYCLE_REGISTRATIONS + CONFIG_CBKPROXY_IN_SLOTS;
+	     i++) {
+		size_t old = i - CONFIG_CBKPROXY_IN_SLOTS;
+
+		if (i >= CONFIG_CBKPROXY_IN_SLOTS) {
+			cbkproxy_out_release(proxy[old]);
+			cbkproxy_in_release(fake_callback(old));
+		}
+
+		if (i >= CYCLE_REGISTRATIONS) {
+			continue;
+		}
+
+		slot[i] = cbkproxy_in_set(fake_callback(i));
+		zassert_true(slot[i] >= 0, "No slot for registration %u", i);
+		zassert_equal_ptr(cbkproxy_in_get(slot[i]), fake_callback(i),
+				  NULL);
+
+#if CONFIG_CBKPROXY_OUT_SLOTS > 0
+		size_t type = (i / CONFIG_CBKPROXY_IN_SLOTS) % 2;
+
+		proxy[i] = cbkproxy_out_get(slot[i], cycle_encoders[type]);
+		zassert_not_null(proxy[i], "Slot %d not rebound", slot[i]);
+
+		/* A slot in use is not bound to another handler */
+		zassert_is_null(cbkproxy_out_get(slot[i],
+						 cycle_encoders[!type]),
+				"Slot %d rebound while in use", slot[i]);
+
+		((cycle_cb_t)proxy[i])(i);
+		zassert_equal(cycle_type, type, "Wrong handler");
+		zassert_equal(cycle_slot, slot[i], "Wrong slot");
+		zassert_equal(cycle_arg, i, "Wrong argument");
+#else
+		proxy[i] = NULL;
+#endif
+	}
+
+	/* All slots are free again */
+	for (size_t i = 0; i < CONFIG_CBKPROXY_IN_SLOTS; i++) {
+		zassert_is_null(cbkproxy_in_get(i), "Slot %u leaked", i);
+	}
+}
+
+/* Round trip in the middle of a latency histogram bucket */
+static uint32_t latency_in_bucket(size_t bucket)
+{
+	if (bucket == 0) {
+		return bt_rpc_latency_bucket_bound(0) / 2;
+	}
+
+	if (bucket == CONFIG_BT_RPC_LATENCY_STATS_BUCKETS - 1) {
+		return bt_rpc_latency_bucket_bound(bucket - 1) * 2;
+	}
+
+	return (bt_rpc_latency_bucket_bound(bucket) / 4) * 3;
+}
+
+/* Latency as recorded, after the conversion to and from clock cycles */
+static uint32_t latency_record(uint8_t cmd, uint32_t us)
+{
+	uint32_t cycles = k_us_to_cyc_ceil32(us);
+
+	bt_rpc_latency_record(cmd, cycles);
+
+	return k_cyc_to_us_floor32(cycles);
+}
+
+/* Bucket of a latency, looked up independently of the recording code */
+static size_t latency_bucket(uint32_t us)
+{
+	size_t i = 0;
+
+	while (us >= bt_rpc_latency_bucket_bound(i)) {
+		i++;
+	}
+
+	return i;
+}
+
+static void test_latency_bucket_bounds(void)
+{
+	uint32_t expected[CONFIG_BT_RPC_LATENCY_STATS_BUCKETS] = { 0 };
+	struct bt_rpc_latency_stats stats;
+
+	bt_rpc_latency_reset();
+
+	/* Round trips just below and at the bound of each bucket */
+	for (size_t i = 0; i < CONFIG_BT_RPC_LATENCY_STATS_BUCKETS - 1; i++) {
+		uint32_t bound = bt_rpc_latency_bucket_bound(i);
+
+		expected[latency_bucket(
+			latency_record(BT_ENABLE_RPC_CMD, bound - 1))]++;
+		expected[latency_bucket(
+			latency_record(BT_ENABLE_RPC_CMD, bound))]++;
+	}
+
+	zassert_ok(bt_rpc_latency_get(BT_ENABLE_RPC_CMD, &stats), NULL);
+	zassert_mem_equal(stats.buckets, expected, sizeof(expected), NULL);
+}
+
+static void test_latency_buckets(void)
+{
+	const size_t bucket_cnt = CONFIG_BT_RPC_LATENCY_STATS_BUCKETS;
+	struct bt_rpc_latency_stats stats;
+	uint64_t total_us = 0;
+	uint32_t max_us = 0;
+	uint32_t us;
+
+	bt_rpc_latency_reset();
+
+	/* The bounds double from one bucket to the next */
+	zassert_equal(bt_rpc_latency_bucket_bound(0),
+		      CONFIG_BT_RPC_LATENCY_STATS_BUCKET_FIRST_US, NULL);
+	for (size_t i = 1; i < bucket_cnt - 1; i++) {
+		zassert_equal(bt_rpc_latency_bucket_bound(i),
+			      2 * bt_rpc_latency_bucket_bound(i - 1), NULL);
+	}
+	zassert_equal(bt_rpc_latency_bucket_bound(bucket_cnt - 1), UINT32_MAX,
+		      NULL);
+
+	/* Bucket i gets i + 1 round trips */
+	for (size_t i = 0; i < bucket_cnt; i++) {
+		for (size_t j = 0; j <= i; j++) {
+			us = latency_record(BT_ENABLE_RPC_CMD,
+					    latency_in_bucket(i));
+			total_us += us;
+			max_us = MAX(max_us, us);
+		}
+	}
+
+	/* Millisecond round trips are told apart */
+	us = latency_record(BT_LE_ADV_START_RPC_CMD, 3000);
+	zassert_ok(bt_rpc_latency_get(BT_LE_ADV_START_RPC_CMD, &stats), NULL);
+	zassert_equal(stats.cnt, 1, NULL);
+	zassert_true(us < bt_rpc_latency_bucket_bound(bucket_cnt - 2),
+		     "3 ms is in the unbounded bucket");
+	for (size_t i = 0; i < bucket_cnt; i++) {
+		bool in_bucket = (us < bt_rpc_latency_bucket_bound(i)) &&
+				 (i == 0 ||
+				  us >= bt_rpc_latency_bucket_bound(i - 1));
+
+		zassert_equal(stats.buckets[i], in_bucket ? 1 : 0,
+			      "Bucket %u", i);
+	}
+
+	zassert_ok(bt_rpc_latency_get(BT_ENABLE_RPC_CMD, &stats), NULL);
+	zassert_equal(stats.cnt, bucket_cnt * (bucket_cnt + 1) / 2, NULL);
+	zassert_equal(stats.max_us, max_us, NULL);
+	zassert_equal(stats.total_us, total_us, NULL);
+	for (size_t i = 0; i < bucket_cnt; i++) {
+		zassert_equal(stats.buckets[i], i + 1, "Bucket %u", i);
+	}
+
+	/* Commands that were not sent have no statistics */
+	zassert_ok(bt_rpc_latency_get(BT_SET_NAME_RPC_CMD, &stats), NULL);
+	zassert_equal(stats.cnt, 0, NULL);
+
+	zassert_equal(bt_rpc_latency_get(BT_RPC_CMD_FROM_CLI_TO_HOST_CNT,
+					 &stats), -EINVAL, NULL);
+	bt_rpc_latency_record(BT_RPC_CMD_FROM_CLI_TO_HOST_CNT, 1);
+}
+
+static void test_latency_reset(void)
+{
+	struct bt_rpc_latency_stats stats;
+
+	(void)latency_record(BT_ENABLE_RPC_CMD, 1000);
+	(void)latency_record(BT_LE_SCAN_START_RPC_CMD, 1000);
+
+	bt_rpc_latency_reset();
+
+	for (uint8_t cmd = 0; cmd < BT_RPC_CMD_FROM_CLI_TO_HOST_CNT; cmd++) {
+		zassert_ok(bt_rpc_latency_get(cmd, &stats), NULL);
+		zassert_equal(stats.cnt, 0, "Command %u", cmd);
+		zassert_equal(stats.max_us, 0, "Command %u", cmd);
+		zassert_equal(stats.total_us, 0, "Command %u", cmd);
+
+		for (size_t i = 0; i < ARRAY_SIZE(stats.buckets); i++) {
+			zassert_equal(stats.buckets[i], 0, "Command %u", cmd);
+		}
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(bt_rpc_serialize,
+			 ztest_unit_test_setup_teardown(test_buffer_in_place,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_buffer_in_place_null,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_buffer_in_place_invalid,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_notification_benchmark,
+							test_setup,
+							unit_test_noop)
+			 );
+
+	ztest_test_suite(bt_rpc_cbkproxy,
+			 ztest_unit_test(test_cbkproxy_in_ref_count),
+			 ztest_unit_test(test_cbkproxy_in_reclaim),
+			 ztest_unit_test(test_cbkproxy_in_stress),
+			 ztest_unit_test(test_cbkproxy_cycle)
+			 );
+
+	ztest_test_suite(bt_rpc_latency,
+			 ztest_unit_test(test_latency_buckets),
+			 ztest_unit_test(test_latency_bucket_bounds),
+			 ztest_unit_test(test_latency_reset)
+			 );
+
+	ztest_run_test_suite(bt_rpc_serialize);
+	ztest_run_test_suite(bt_rpc_cbkproxy);
+	ztest_run_test_suite(bt_rpc_latency);
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/conn.h>
+#include <ztest.h>
+
+#include "bt_scan_mock.h"
+
+static struct bt_le_scan_cb *scan_cb;
+
+void bt_le_scan_cb_register(struct bt_le_scan_cb *cb)
+{
+	scan_cb = cb;
+}
+
+int bt_le_scan_start(const struct bt_le_scan_param *param,
+		     bt_le_scan_cb_t cb)
+{
+	return 0;
+}
+
+int bt_le_scan_stop(void)
+{
+	return 0;
+}
+
+int bt_conn_le_create(const bt_addr_le_t *peer,
+		      const struct bt_conn_le_create_param *create_param,
+		      const struct bt_le_conn_param *conn_param,
+		      struct bt_conn **conn)
+{
+	return -ENOTSUP;
+}
+
+void bt_conn_unref(struct bt_conn *conn)
+{
+}
+
+/* Same as the implementation of the host. */
+void bt_data_parse(struct net_buf_simple *ad,
+		   bool (*func)(struct bt_data *data, void *user_data),
+		   void *user_data)
+{
+	while (ad->len > 1) {
+		struct bt_data data;
+		uint8_t len;
+
+		len = net_buf_simple_pull_u8(ad);
+		if (len == 0U) {
+			/* Early termination */
+			return;
+		}
+
+		if (len > ad->len) {
+			return;
+		}
+
+		data.type = net_buf_simple_pull_u8(ad);
+		data.data_len = len - 1;
+		data.data = ad->data;
+
+		if (!func(&data, user_data)) {
+			return;
+		}
+
+		net_buf_simple_pull(ad, len - 1);
+	}
+}
+
+void bt_scan_mock_recv(const struct bt_le_scan_recv_info *info,
+		       struct net_buf_simple *ad)
+{
+	zassert_not_null(scan_cb, "Scan callback not registered");
+
+	scan_cb->recv(info, ad);
+}
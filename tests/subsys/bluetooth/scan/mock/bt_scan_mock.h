@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BT_SCAN_MOCK_H_
+#define BT_SCAN_MOCK_H_
+
+#include <bluetooth/bluetooth.h>
+
+/**
+ * @brief Pass an advertising report to the registered scan callback.
+ *
+ * @param info Advertising report information.
+ * @param ad   Advertising data.
+ */
+void bt_scan_mock_recv(const struct bt_le_scan_recv_info *info,
+		       struct net_buf_simple *ad);
+
+#endif /* BT_SCAN_MOCK_H_ */
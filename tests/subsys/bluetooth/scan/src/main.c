@@ -0,0 +1,632 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/uuid.h>
+#include <bluetooth/scan.h>
+
+#include "../mock/bt_scan_mock.h"
+
+/* Number of times the recorded reports are passed to the filters. */
+#define BENCHMARK_PASSES 1000
+
+#define NUS_UUID_VAL \
+	BT_UUID_128_ENCODE(0x6e400001, 0xb5a3, 0xf393, 0xe0a9, 0xe50e24dcca9e)
+#define THINGY_UUID_VAL \
+	BT_UUID_128_ENCODE(0xef680100, 0x9b35, 0x4933, 0x9b10, 0x52ffa9740042)
+#define HRS_128_UUID_VAL \
+	BT_UUID_128_ENCODE(0x0000180d, 0x0000, 0x1000, 0x8000, 0x00805f9b34fb)
+
+#define ADDR(_type, _last) \
+	{ .type = (_type), .a.val = { (_last), 0x11, 0x22, 0x33, 0x44, 0xc5 } }
+
+/* Advertising report, as received from the host. */
+struct adv_report {
+	bt_addr_le_t addr;
+	const uint8_t *data;
+	uint8_t len;
+
+	/* Filter that is matched first, in the normal filter mode. */
+	uint8_t match;
+};
+
+#define REPORT(_addr, _match, ...)					\
+	{								\
+		.addr = _addr,						\
+		.data = (const uint8_t []){ __VA_ARGS__ },		\
+		.len = sizeof((const uint8_t []){ __VA_ARGS__ }),	\
+		.match = (_match),					\
+	}
+
+/* Advertising reports recorded in an office, one per advertiser. */
+static const struct adv_report reports[] = {
+	/* Heart rate sensor */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0x01), BT_SCAN_UUID_FILTER,
+	       0x02, BT_DATA_FLAGS, 0x06,
+	       0x05, BT_DATA_UUID16_ALL, 0x0d, 0x18, 0x0f, 0x18,
+	       0x0b, BT_DATA_NAME_COMPLETE,
+	       'N', 'o', 'r', 'd', 'i', 'c', '_', 'H', 'R', 'S'),
+	/* iBeacon */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0x02), BT_SCAN_MANUFACTURER_DATA_FILTER,
+	       0x02, BT_DATA_FLAGS, 0x06,
+	       0x1a, BT_DATA_MANUFACTURER_DATA, 0x4c, 0x00, 0x02, 0x15,
+	       0xe2, 0xc5, 0x6d, 0xb5, 0xdf, 0xfb, 0x48, 0xd2,
+	       0xb0, 0x60, 0xd0, 0xf5, 0xa7, 0x10, 0x96, 0xe0,
+	       0x00, 0x01, 0x00, 0x02, 0xc5),
+	/* Eddystone URL */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0x03), BT_SCAN_UUID_FILTER,
+	       0x02, BT_DATA_FLAGS, 0x06,
+	       0x03, BT_DATA_UUID16_ALL, 0xaa, 0xfe,
+	       0x0c, BT_DATA_SVC_DATA16, 0xaa, 0xfe, 0x10, 0xf8, 0x03,
+	       'n', 'o', 'r', 'd', 'i', 'c'),
+	/* UART service, with a shortened name */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0x04), BT_SCAN_SHORT_NAME_FILTER,
+	       0x02, BT_DATA_FLAGS, 0x06,
+	       0x08, BT_DATA_NAME_SHORTENED, 'N', 'o', 'r', 'd', 'i', 'c', '_'),
+	/* Keyboard */
+	REPORT(ADDR(BT_ADDR_LE_PUBLIC, 0x05), BT_SCAN_APPEARANCE_FILTER,
+	       0x02, BT_DATA_FLAGS, 0x05,
+	       0x03, BT_DATA_GAP_APPEARANCE, 0x03, 0xc1,
+	       0x03, BT_DATA_UUID16_SOME, 0x12, 0x18,
+	       0x09, BT_DATA_NAME_COMPLETE,
+	       'K', 'e', 'y', 'b', 'o', 'a', 'r', 'd'),
+	/* Swift Pair */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0x06), BT_SCAN_MANUFACTURER_DATA_FILTER,
+	       0x02, BT_DATA_FLAGS, 0x06,
+	       0x06, BT_DATA_MANUFACTURER_DATA, 0x06, 0x00, 0x03, 0x00, 0x80),
+	/* Tracker tag */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0x07), 0,
+	       0x02, BT_DATA_FLAGS, 0x06,
+	       0x03, BT_DATA_UUID16_ALL, 0xed, 0xfe,
+	       0x0b, BT_DATA_SVC_DATA16, 0xed, 0xfe, 0x02, 0x00, 0x0c,
+	       0x40, 0x18, 0x93, 0x05, 0x02),
+	/* Heart rate sensor, advertising the 128-bit form of its UUID */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0x08), BT_SCAN_UUID_FILTER,
+	       0x02, BT_DATA_FLAGS, 0x06,
+	       0x11, BT_DATA_UUID128_ALL, HRS_128_UUID_VAL,
+	       0x08, BT_DATA_NAME_COMPLETE, 'H', 'R', 'M', '-', '1', '2', '8'),
+	/* Thingy */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0x09), BT_SCAN_NAME_FILTER,
+	       0x02, BT_DATA_FLAGS, 0x06,
+	       0x07, BT_DATA_NAME_COMPLETE, 'T', 'h', 'i', 'n', 'g', 'y',
+	       0x11, BT_DATA_UUID128_ALL, THINGY_UUID_VAL),
+	/* Blinky, with Nordic manufacturer data */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0x0a), 0,
+	       0x02, BT_DATA_FLAGS, 0x06,
+	       0x05, BT_DATA_MANUFACTURER_DATA, 0x59, 0x00, 0x01, 0x02,
+	       0x0e, BT_DATA_NAME_COMPLETE,
+	       'N', 'o', 'r', 'd', 'i', 'c', '_', 'B', 'l', 'i', 'n', 'k',
+	       'y'),
+	/* Phone */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0x0b), 0,
+	       0x02, BT_DATA_FLAGS, 0x1a,
+	       0x0b, BT_DATA_MANUFACTURER_DATA, 0x4c, 0x00, 0x10, 0x06,
+	       0x1b, 0x1e, 0x5a, 0x8b, 0x19, 0x28),
+	/* Known device, without advertising data */
+	REPORT(ADDR(BT_ADDR_LE_PUBLIC, 0x0c), BT_SCAN_ADDR_FILTER,
+	       0x02, BT_DATA_FLAGS, 0x04),
+	/* UART service */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0x0d), BT_SCAN_UUID_FILTER,
+	       0x02, BT_DATA_FLAGS, 0x06,
+	       0x11, BT_DATA_UUID128_ALL, NUS_UUID_VAL),
+	/* Name that is longer than all filters */
+	REPORT(ADDR(BT_ADDR_LE_RANDOM, 0x0e), 0,
+	       0x02, BT_DATA_FLAGS, 0x06,
+	       0x0f, BT_DATA_NAME_COMPLETE,
+	       'N', 'o', 'r', 'd', 'i', 'c', '_', 'H', 'R', 'S', '_', 'l',
+	       'o', 'n'),
+};
+
+static const char * const names[] = {
+	"Nordic_HRS", "Thingy", "Nordic_LBS", "Nordic_Mouse", "Nordic_Keyboard",
+	"Nordic_Throughput", "HRM-128",
+};
+
+static const struct bt_scan_short_name short_name = {
+	.name = "Nordic_UART",
+	.min_len = 6,
+};
+
+static const bt_addr_le_t addrs[] = {
+	ADDR(BT_ADDR_LE_PUBLIC, 0x0c), ADDR(BT_ADDR_LE_PUBLIC, 0x20),
+	ADDR(BT_ADDR_LE_RANDOM, 0x21), ADDR(BT_ADDR_LE_RANDOM, 0x22),
+	ADDR(BT_ADDR_LE_RANDOM, 0x23), ADDR(BT_ADDR_LE_RANDOM, 0x24),
+	ADDR(BT_ADDR_LE_RANDOM, 0x25), ADDR(BT_ADDR_LE_RANDOM, 0x26),
+};
+
+static const struct bt_uuid_128 nus_uuid = BT_UUID_INIT_128(NUS_UUID_VAL);
+
+static const struct bt_uuid *uuids[] = {
+	BT_UUID_HRS, BT_UUID_DECLARE_16(0xfeaa), &nus_uuid.uuid, BT_UUID_BAS,
+	BT_UUID_DIS, BT_UUID_DECLARE_16(0xfe59), BT_UUID_DECLARE_32(0x12345),
+};
+
+static const uint16_t appearance = 0x03c1;
+
+static uint8_t ibeacon[] = { 0x4c, 0x00, 0x02, 0x15 };
+static uint8_t swift_pair[] = { 0x06, 0x00, 0x03 };
+
+static const struct bt_scan_manufacturer_data manufacturer_data[] = {
+	{ .data = ibeacon, .data_len = sizeof(ibeacon) },
+	{ .data = swift_pair, .data_len = sizeof(swift_pair) },
+};
+
+static size_t match_cnt;
+static size_t no_match_cnt;
+static struct bt_scan_filter_match last_match;
+
+static void scan_filter_match(struct bt_scan_device_info *device_info,
+			      struct bt_scan_filter_match *filter_match,
+			      bool connectable)
+{
+	match_cnt++;
+	last_match = *filter_match;
+}
+
+static void scan_filter_no_match(struct bt_scan_device_info *device_info,
+				 bool connectable)
+{
+	no_match_cnt++;
+}
+
+BT_SCAN_CB_INIT(scan_cb, scan_filter_match, scan_filter_no_match, NULL, NULL);
+
+static void report_rssi_recv(const struct adv_report *report, int8_t rssi)
+{
+	struct bt_le_scan_recv_info info = {
+		.addr = &report->addr,
+		.rssi = rssi,
+		.adv_props = BT_GAP_ADV_PROP_CONNECTABLE,
+	};
+	struct net_buf_simple ad;
+
+	net_buf_simple_init_with_data(&ad, (void *)report->data, report->len);
+	bt_scan_mock_recv(&info, &ad);
+}
+
+static void report_recv(const struct adv_report *report)
+{
+	report_rssi_recv(report, -60);
+}
+
+static uint8_t last_match_type(void)
+{
+	uint8_t type = 0;
+
+	type |= last_match.name.match ? BT_SCAN_NAME_FILTER : 0;
+	type |= last_match.short_name.match ? BT_SCAN_SHORT_NAME_FILTER : 0;
+	type |= last_match.addr.match ? BT_SCAN_ADDR_FILTER : 0;
+	type |= last_match.uuid.match ? BT_SCAN_UUID_FILTER : 0;
+	type |= last_match.appearance.match ? BT_SCAN_APPEARANCE_FILTER : 0;
+	type |= last_match.manufacturer_data.match ?
+		BT_SCAN_MANUFACTURER_DATA_FILTER : 0;
+
+	return type;
+}
+
+static void filters_add(void)
+{
+	int err;
+
+	bt_scan_filter_remove_all();
+
+	for (size_t i = 0; i < ARRAY_SIZE(names); i++) {
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, names[i]);
+		zassert_ok(err, "Failed to add name filter, err %d", err);
+	}
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_SHORT_NAME, &short_name);
+	zassert_ok(err, "Failed to add short name filter, err %d", err);
+
+	for (size_t i = 0; i < ARRAY_SIZE(addrs); i++) {
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addrs[i]);
+		zassert_ok(err, "Failed to add address filter, err %d", err);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(uuids); i++) {
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, uuids[i]);
+		zassert_ok(err, "Failed to add UUID filter, err %d", err);
+	}
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_APPEARANCE, &appearance);
+	zassert_ok(err, "Failed to add appearance filter, err %d", err);
+
+	for (size_t i = 0; i < ARRAY_SIZE(manufacturer_data); i++) {
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_MANUFACTURER_DATA,
+					 &manufacturer_data[i]);
+		zassert_ok(err, "Failed to add manufacturer data filter, err %d",
+			   err);
+	}
+}
+
+static void test_setup(void)
+{
+	bt_scan_init(NULL);
+
+	match_cnt = 0;
+	no_match_cnt = 0;
+}
+
+static void test_filter_duplicates(void)
+{
+	int err;
+
+	filters_add();
+
+	/* Adding the same filters again does not use any memory. */
+	filters_add();
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Nordic_UART");
+	zassert_ok(err, "Failed to add name filter, err %d", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Nordic_Blinky");
+	zassert_equal(err, -ENOMEM, "Unexpected result %d", err);
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID,
+				 BT_UUID_DECLARE_32(0x180d));
+	zassert_ok(err, "Failed to add UUID filter, err %d", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID,
+				 BT_UUID_DECLARE_16(0xfeed));
+	zassert_ok(err, "Failed to add UUID filter, err %d", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID,
+				 BT_UUID_DECLARE_16(0xfd6f));
+	zassert_equal(err, -ENOMEM, "Unexpected result %d", err);
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &reports[0].addr);
+	zassert_equal(err, -ENOMEM, "Unexpected result %d", err);
+}
+
+static void test_filter_match_any(void)
+{
+	uint8_t mode = BT_SCAN_NAME_FILTER | BT_SCAN_SHORT_NAME_FILTER |
+		       BT_SCAN_ADDR_FILTER | BT_SCAN_UUID_FILTER |
+		       BT_SCAN_APPEARANCE_FILTER |
+		       BT_SCAN_MANUFACTURER_DATA_FILTER;
+	int err;
+
+	filters_add();
+
+	err = bt_scan_filter_enable(mode, false);
+	zassert_ok(err, "Failed to enable filters, err %d", err);
+
+	for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+		size_t prev_match_cnt = match_cnt;
+
+		memset(&last_match, 0, sizeof(last_match));
+		report_recv(&reports[i]);
+
+		zassert_equal(match_cnt - prev_match_cnt,
+			      reports[i].match ? 1 : 0,
+			      "Unexpected result for report %u", i);
+		zassert_equal(last_match_type(), reports[i].match,
+			      "Unexpected filter matched by report %u", i);
+	}
+
+	/* The 128-bit form of the HRS UUID matches its 16-bit filter. */
+	memset(&last_match, 0, sizeof(last_match));
+	report_recv(&reports[7]);
+	zassert_equal(last_match.uuid.count, 1, NULL);
+	zassert_equal(bt_uuid_cmp(last_match.uuid.uuid[0], BT_UUID_HRS), 0,
+		      NULL);
+	zassert_equal(last_match.uuid.uuid[0]->type, BT_UUID_TYPE_16, NULL);
+
+	/* Only the matched filters are reported. */
+	bt_scan_filter_disable();
+	err = bt_scan_filter_enable(BT_SCAN_NAME_FILTER, false);
+	zassert_ok(err, "Failed to enable filters, err %d", err);
+
+	memset(&last_match, 0, sizeof(last_match));
+	report_recv(&reports[0]);
+	zassert_equal(last_match_type(), BT_SCAN_NAME_FILTER, NULL);
+	zassert_equal(strcmp(last_match.name.name, "Nordic_HRS"), 0, NULL);
+	zassert_equal(last_match.name.len, strlen("Nordic_HRS"), NULL);
+}
+
+static void test_filter_match_all(void)
+{
+	int err;
+
+	filters_add();
+
+	err = bt_scan_filter_enable(BT_SCAN_NAME_FILTER |
+				    BT_SCAN_MANUFACTURER_DATA_FILTER, true);
+	zassert_ok(err, "Failed to enable filters, err %d", err);
+
+	for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+		report_recv(&reports[i]);
+	}
+
+	/* No device has a matching name and manufacturer data. */
+	zassert_equal(match_cnt, 0, NULL);
+	zassert_equal(no_match_cnt, ARRAY_SIZE(reports), NULL);
+
+	/* All UUID filters must be found in one AD structure. */
+	bt_scan_filter_remove_all();
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Nordic_HRS");
+	zassert_ok(err, "Failed to add name filter, err %d", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_HRS);
+	zassert_ok(err, "Failed to add UUID filter, err %d", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_BAS);
+	zassert_ok(err, "Failed to add UUID filter, err %d", err);
+
+	err = bt_scan_filter_enable(BT_SCAN_NAME_FILTER | BT_SCAN_UUID_FILTER,
+				    true);
+	zassert_ok(err, "Failed to enable filters, err %d", err);
+
+	match_cnt = 0;
+	memset(&last_match, 0, sizeof(last_match));
+
+	for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+		report_recv(&reports[i]);
+	}
+
+	zassert_equal(match_cnt, 1, NULL);
+	zassert_equal(last_match_type(),
+		      BT_SCAN_NAME_FILTER | BT_SCAN_UUID_FILTER, NULL);
+	zassert_equal(last_match.uuid.count, 2, NULL);
+	zassert_equal(bt_uuid_cmp(last_match.uuid.uuid[0], BT_UUID_HRS), 0,
+		      NULL);
+	zassert_equal(bt_uuid_cmp(last_match.uuid.uuid[1], BT_UUID_BAS), 0,
+		      NULL);
+
+	/* With an address filter, the other devices are not parsed. */
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addrs[0]);
+	zassert_ok(err, "Failed to add address filter, err %d", err);
+	err = bt_scan_filter_enable(BT_SCAN_NAME_FILTER | BT_SCAN_UUID_FILTER |
+				    BT_SCAN_ADDR_FILTER, true);
+	zassert_ok(err, "Failed to enable filters, err %d", err);
+
+	match_cnt = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+		report_recv(&reports[i]);
+	}
+
+	zassert_equal(match_cnt, 0, NULL);
+}
+
+static void test_filter_benchmark(void)
+{
+	uint8_t mode = BT_SCAN_NAME_FILTER | BT_SCAN_SHORT_NAME_FILTER |
+		       BT_SCAN_ADDR_FILTER | BT_SCAN_UUID_FILTER |
+		       BT_SCAN_APPEARANCE_FILTER |
+		       BT_SCAN_MANUFACTURER_DATA_FILTER;
+	size_t expected_cnt = 0;
+	uint32_t start;
+	uint32_t cycles;
+	uint64_t ns;
+	int err;
+
+	filters_add();
+
+	err = bt_scan_filter_enable(mode, false);
+	zassert_ok(err, "Failed to enable filters, err %d", err);
+
+	for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+		expected_cnt += reports[i].match ? 1 : 0;
+	}
+
+	start = k_cycle_get_32();
+
+	for (size_t pass = 0; pass < BENCHMARK_PASSES; pass++) {
+		for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+			report_recv(&reports[i]);
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+	ns = k_cyc_to_ns_floor64(cycles);
+
+	zassert_equal(match_cnt, expected_cnt * BENCHMARK_PASSES, NULL);
+	zassert_equal(match_cnt + no_match_cnt,
+		      ARRAY_SIZE(reports) * BENCHMARK_PASSES, NULL);
+
+	TC_PRINT("Filtered %u reports in %u us, %u ns per report\n",
+		 (uint32_t)(ARRAY_SIZE(reports) * BENCHMARK_PASSES),
+		 (uint32_t)(ns / 1000),
+		 (uint32_t)(ns / (ARRAY_SIZE(reports) * BENCHMARK_PASSES)));
+}
+
+#if CONFIG_BT_SCAN_DEDUP
+static size_t reports_forwarded(void)
+{
+	return match_cnt + no_match_cnt;
+}
+
+static void test_dedup_suppress(void)
+{
+	struct bt_scan_dedup_stats stats;
+	int err;
+
+	/* A gateway receives each advertiser many times per interval. */
+	for (size_t pass = 0; pass < 10; pass++) {
+		for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+			report_recv(&reports[i]);
+		}
+	}
+
+	zassert_equal(reports_forwarded(), ARRAY_SIZE(reports), NULL);
+
+	err = bt_scan_dedup_stats_get(&stats);
+	zassert_ok(err, "Failed to get statistics, err %d", err);
+	zassert_equal(stats.reports, 10 * ARRAY_SIZE(reports), NULL);
+	zassert_equal(stats.suppressed, 9 * ARRAY_SIZE(reports), NULL);
+	zassert_equal(stats.evicted, 0, NULL);
+
+	TC_PRINT("Cache hit rate: %u%%\n",
+		 stats.suppressed * 100 / stats.reports);
+
+	/* Restarting the scan forwards all devices again. */
+	err = bt_scan_start(BT_SCAN_TYPE_SCAN_PASSIVE);
+	zassert_ok(err, "Failed to start scanning, err %d", err);
+
+	report_recv(&reports[0]);
+	zassert_equal(reports_forwarded(), ARRAY_SIZE(reports) + 1, NULL);
+
+	bt_scan_dedup_clear();
+
+	err = bt_scan_dedup_stats_get(&stats);
+	zassert_ok(err, "Failed to get statistics, err %d", err);
+	zassert_equal(stats.reports, 0, NULL);
+}
+
+static void test_dedup_payload(void)
+{
+	struct adv_report report = reports[0];
+
+	report_recv(&report);
+	report_recv(&report);
+	zassert_equal(reports_forwarded(), 1, NULL);
+
+	/* Same device, new advertising data */
+	report.data = reports[1].data;
+	report.len = reports[1].len;
+
+	report_recv(&report);
+	zassert_equal(reports_forwarded(), 2, NULL);
+
+	/* Both payloads are cached */
+	report_recv(&report);
+	report_recv(&reports[0]);
+	zassert_equal(reports_forwarded(), 2, NULL);
+}
+
+static void test_dedup_interval(void)
+{
+	report_recv(&reports[0]);
+	k_sleep(K_MSEC(CONFIG_BT_SCAN_DEDUP_INTERVAL_MS / 2));
+	report_recv(&reports[0]);
+	zassert_equal(reports_forwarded(), 1, NULL);
+
+	k_sleep(K_MSEC(CONFIG_BT_SCAN_DEDUP_INTERVAL_MS / 2));
+	report_recv(&reports[0]);
+	zassert_equal(reports_forwarded(), 2, NULL);
+
+	/* The interval restarts when the report is forwarded. */
+	report_recv(&reports[0]);
+	zassert_equal(reports_forwarded(), 2, NULL);
+}
+
+static void test_dedup_rssi(void)
+{
+	report_rssi_recv(&reports[0], -60);
+	report_rssi_recv(&reports[0],
+			 -60 - (CONFIG_BT_SCAN_DEDUP_RSSI_DELTA - 1));
+	zassert_equal(reports_forwarded(), 1, NULL);
+
+	report_rssi_recv(&reports[0], -60 + CONFIG_BT_SCAN_DEDUP_RSSI_DELTA);
+	zassert_equal(reports_forwarded(), 2, NULL);
+
+	/* Compared to the last forwarded report */
+	report_rssi_recv(&reports[0], -60 + CONFIG_BT_SCAN_DEDUP_RSSI_DELTA +
+				      CONFIG_BT_SCAN_DEDUP_RSSI_DELTA / 2);
+	zassert_equal(reports_forwarded(), 2, NULL);
+}
+
+static void test_dedup_eviction(void)
+{
+	struct bt_scan_dedup_stats stats;
+	struct adv_report report = reports[0];
+	int err;
+
+	/* Fill the cache, then receive the first report again, so that
+	 * the second one is the least recently received.
+	 */
+	for (size_t i = 0; i < CONFIG_BT_SCAN_DEDUP_CACHE_SIZE; i++) {
+		report.addr.a.val[1] = i;
+		report_recv(&report);
+	}
+
+	report.addr.a.val[1] = 0;
+	report_recv(&report);
+	zassert_equal(reports_forwarded(), CONFIG_BT_SCAN_DEDUP_CACHE_SIZE,
+		      NULL);
+
+	/* New device */
+	report.addr.a.val[1] = CONFIG_BT_SCAN_DEDUP_CACHE_SIZE;
+	report_recv(&report);
+
+	err = bt_scan_dedup_stats_get(&stats);
+	zassert_ok(err, "Failed to get statistics, err %d", err);
+	zassert_equal(stats.evicted, 1, NULL);
+
+	/* The first report is still cached, the second one is not. */
+	report.addr.a.val[1] = 0;
+	report_recv(&report);
+	zassert_equal(reports_forwarded(),
+		      CONFIG_BT_SCAN_DEDUP_CACHE_SIZE + 1, NULL);
+
+	report.addr.a.val[1] = 1;
+	report_recv(&report);
+	zassert_equal(reports_forwarded(),
+		      CONFIG_BT_SCAN_DEDUP_CACHE_SIZE + 2, NULL);
+}
+
+static void test_dedup_filters(void)
+{
+	int err;
+
+	report_recv(&reports[0]);
+	zassert_equal(no_match_cnt, 1, NULL);
+
+	/* Changing the filters forwards all devices again. */
+	filters_add();
+
+	err = bt_scan_filter_enable(BT_SCAN_NAME_FILTER, false);
+	zassert_ok(err, "Failed to enable filters, err %d", err);
+
+	report_recv(&reports[0]);
+	zassert_equal(match_cnt, 1, NULL);
+}
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
+void test_main(void)
+{
+	bt_scan_cb_register(&scan_cb);
+
+#if CONFIG_BT_SCAN_DEDUP
+	ztest_test_suite(bt_scan_dedup,
+			 ztest_unit_test_setup_teardown(test_dedup_suppress,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_dedup_payload,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_dedup_interval,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_dedup_rssi,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_dedup_eviction,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_dedup_filters,
+							test_setup,
+							unit_test_noop)
+			 );
+
+	ztest_run_test_suite(bt_scan_dedup);
+#else
+	ztest_test_suite(bt_scan,
+			 ztest_unit_test_setup_teardown(test_filter_duplicates,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_filter_match_any,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_filter_match_all,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_filter_benchmark,
+							test_setup,
+							unit_test_noop)
+			 );
+
+	ztest_run_test_suite(bt_scan);
+#endif /* CONFIG_BT_SCAN_DEDUP */
+}
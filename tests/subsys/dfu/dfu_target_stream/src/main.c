@@ -20,6 +20,12 @@
 
 #define BUF_LEN 14000 /* Note, not page aligned */
 
+#define TEST_IMAGE_SIZE (64 * 1024)
+#define TEST_FRAG_SIZE 512
+#define TEST_FRAG_CNT (TEST_IMAGE_SIZE / TEST_FRAG_SIZE)
+/* Time between two fragments received from the network. */
+#define TEST_FRAG_INTERVAL_MS 5
+
 static const struct device *fdev;
 static uint8_t sbuf[128];
 static uint8_t read_buf[BUF_LEN];
@@ -30,6 +36,33 @@ static uint8_t write_buf[BUF_LEN] = {[0 ... BUF_LEN - 1] = 0xaa};
 		.fdev = fdev_, .buf = buf_, .len = len_, .offset = offset_,  \
 		.size = size_, .cb = cb_})
 
+static void test_dfu_target_stream_init_failure(void)
+{
+	int err;
+
+	/* The stream does not fit in the flash, so stream_flash_init fails */
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, FLASH_SIZE, NULL);
+	zassert_true(err < 0, "Unexpected success: %d", err);
+
+	/* Resetting the target after the failed init must not wait for the
+	 * write-behind thread, which was never started.
+	 */
+	err = dfu_target_stream_done(false);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_offset_get(&(size_t){ 0 });
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	/* The failed init did not keep its id */
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+}
+
 static void test_dfu_target_stream_null_checks(void)
 {
 	int err;
@@ -95,6 +128,69 @@ static void test_dfu_target_stream(void)
 	zassert_mem_equal(read_buf, write_buf, BUF_LEN, "Incorrect value");
 }
 
+static void test_dfu_target_stream_reset(void)
+{
+	static uint8_t rewrite_buf[BUF_LEN] = {[0 ... BUF_LEN - 1] = 0x55};
+	int err;
+	size_t offset;
+
+	/* Reset state to avoid failure when initializing */
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	/* Resetting a stream that is not initialized fails */
+	err = dfu_target_stream_reset();
+	zassert_true(err < 0, "Unexpected success: %d", err);
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_write(write_buf, sizeof(write_buf));
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	/* The reset drops the buffered data and rewinds the stream */
+	err = dfu_target_stream_reset();
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_offset_get(&offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_equal(offset, 0, "Stream not rewound");
+
+	/* The written pages are erased again before they are rewritten */
+	err = dfu_target_stream_write(rewrite_buf, sizeof(rewrite_buf));
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = flash_read(fdev, FLASH_BASE, read_buf, BUF_LEN);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_mem_equal(read_buf, rewrite_buf, BUF_LEN, "Incorrect value");
+
+	/* The progress is not kept after a reset */
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_write(write_buf, sizeof(write_buf));
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_reset();
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_done(false);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_offset_get(&offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_equal(offset, 0, "Progress kept after reset");
+}
+
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
 static void test_dfu_target_stream_save_progress(void)
 {
@@ -200,14 +296,94 @@ static void test_dfu_target_stream_save_progress(void)
 
 #endif
 
+#ifdef CONFIG_FLASH_SIMULATOR_SIMULATE_TIMING
+static void test_dfu_target_stream_write_time(void)
+{
+	static uint8_t frag[TEST_FRAG_SIZE];
+	struct flash_pages_info page;
+	uint32_t receive_ms = TEST_FRAG_CNT * TEST_FRAG_INTERVAL_MS;
+	uint32_t erase_ms;
+	uint32_t elapsed;
+	int64_t start;
+	int err;
+
+	/* Reset state to avoid failure when initializing */
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = flash_get_page_info_by_offs(fdev, FLASH_BASE, &page);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	erase_ms = (TEST_IMAGE_SIZE / page.size) *
+		   CONFIG_FLASH_SIMULATOR_MIN_ERASE_TIME_US / 1000;
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, TEST_IMAGE_SIZE, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	start = k_uptime_get();
+
+	for (size_t i = 0; i < TEST_FRAG_CNT; i++) {
+		/* Emulate waiting for the next fragment */
+		k_sleep(K_MSEC(TEST_FRAG_INTERVAL_MS));
+
+		for (size_t j = 0; j < sizeof(frag); j++) {
+			frag[j] = (i * sizeof(frag) + j) % 251;
+		}
+
+		err = dfu_target_stream_write(frag, sizeof(frag));
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+	}
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	elapsed = (uint32_t)(k_uptime_get() - start);
+
+	/* Read out the image to ensure that it was written correctly */
+	for (size_t off = 0; off < TEST_IMAGE_SIZE; off += sizeof(frag)) {
+		err = flash_read(fdev, FLASH_BASE + off, frag, sizeof(frag));
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+		for (size_t j = 0; j < sizeof(frag); j++) {
+			zassert_equal(frag[j], (off + j) % 251,
+				      "Incorrect value at %u",
+				      (uint32_t)(off + j));
+		}
+	}
+
+	TC_PRINT("Write-behind: %s\n",
+		 IS_ENABLED(CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND) ?
+		 "enabled" : "disabled");
+	TC_PRINT("Wrote %u bytes in %u ms\n", TEST_IMAGE_SIZE, elapsed);
+	TC_PRINT("Receive time: %u ms, erase time: %u ms\n",
+		 receive_ms, erase_ms);
+
+	if (IS_ENABLED(CONFIG_DFU_TARGET_STREAM_WRITE_BEHIND)) {
+		/* The pages are erased while waiting for fragments. */
+		zassert_true(elapsed < receive_ms + erase_ms / 2,
+			     "Erasing did not overlap receiving");
+	}
+}
+
+#else
+
+static void test_dfu_target_stream_write_time(void)
+{
+	ztest_test_skip();
+}
+
+#endif
 
 void test_main(void)
 {
 	fdev = device_get_binding(FLASH_NAME);
 	ztest_test_suite(lib_dfu_target_stream,
+	     ztest_unit_test(test_dfu_target_stream_init_failure),
 	     ztest_unit_test(test_dfu_target_stream_null_checks),
 	     ztest_unit_test(test_dfu_target_stream),
-	     ztest_unit_test(test_dfu_target_stream_save_progress)
+	     ztest_unit_test(test_dfu_target_stream_reset),
+	     ztest_unit_test(test_dfu_target_stream_save_progress),
+	     ztest_unit_test(test_dfu_target_stream_write_time)
 	 );
 
 	ztest_run_test_suite(lib_dfu_target_stream);
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <sys/byteorder.h>
+#include <mbedtls/sha256.h>
+
+#include "mcuboot_verify.h"
+
+#define HDR_SIZE 32
+#define IMG_SIZE 3000
+/* Protected TLV info, and a TLV with 4 bytes of data */
+#define PROT_TLV_SIZE (4 + 4 + 4)
+/* TLV info, a key hash TLV and the SHA-256 TLV */
+#define TLV_SIZE (4 + (4 + 32) + (4 + 32))
+#define PAD_SIZE 100
+#define HASH_END (HDR_SIZE + IMG_SIZE + PROT_TLV_SIZE)
+#define FILE_SIZE (HASH_END + TLV_SIZE + PAD_SIZE)
+
+#define BLOCK_SIZE 512
+#define BLOCK_CNT ((FILE_SIZE + BLOCK_SIZE - 1) / BLOCK_SIZE)
+
+static uint8_t image[FILE_SIZE];
+static uint8_t digests[BLOCK_CNT][DFU_TARGET_MCUBOOT_DIGEST_LEN];
+static struct mcuboot_verify verify;
+
+static const struct dfu_target_mcuboot_manifest manifest = {
+	.block_size = BLOCK_SIZE,
+	.block_cnt = BLOCK_CNT,
+	.digest = digests,
+};
+
+static void image_build(void)
+{
+	uint8_t *p = image;
+
+	memset(image, 0, HASH_END);
+	memset(image + HASH_END, 0xff, sizeof(image) - HASH_END);
+
+	/* Header */
+	sys_put_le32(0x96f3b83d, &p[0]);
+	sys_put_le16(HDR_SIZE, &p[8]);
+	sys_put_le16(PROT_TLV_SIZE, &p[10]);
+	sys_put_le32(IMG_SIZE, &p[12]);
+	p += HDR_SIZE;
+
+	for (size_t i = 0; i < IMG_SIZE; i++) {
+		*p++ = (i * 7) % 251;
+	}
+
+	/* Protected TLVs */
+	sys_put_le16(0x6908, &p[0]);
+	sys_put_le16(PROT_TLV_SIZE, &p[2]);
+	p[4] = 0x50;
+	sys_put_le16(4, &p[6]);
+	sys_put_le32(0x12345678, &p[8]);
+	p += PROT_TLV_SIZE;
+
+	/* TLVs */
+	sys_put_le16(0x6907, &p[0]);
+	sys_put_le16(TLV_SIZE, &p[2]);
+	p += 4;
+
+	p[0] = 0x01;
+	sys_put_le16(32, &p[2]);
+	memset(&p[4], 0xab, 32);
+	p += 4 + 32;
+
+	p[0] = 0x10;
+	sys_put_le16(32, &p[2]);
+	mbedtls_sha256_ret(image, HASH_END, &p[4], false);
+
+	for (size_t i = 0; i < BLOCK_CNT; i++) {
+		size_t len = MIN(BLOCK_SIZE, FILE_SIZE - i * BLOCK_SIZE);
+
+		mbedtls_sha256_ret(&image[i * BLOCK_SIZE], len, digests[i],
+				   false);
+	}
+}
+
+/* Feed 'len' bytes of the image in fragments of 'frag_size' bytes.
+ * Returns the end of the fragment that failed, or 0.
+ */
+static size_t feed(size_t len, size_t frag_size)
+{
+	for (size_t off = 0; off < len; off += frag_size) {
+		size_t n = MIN(frag_size, len - off);
+
+		if (mcuboot_verify_update(&verify, &image[off], n) != 0) {
+			return off + n;
+		}
+	}
+
+	return 0;
+}
+
+static void test_verify_valid(void)
+{
+	const size_t frag_sizes[] = { 1, 3, 64, 100, 512, FILE_SIZE };
+
+	image_build();
+
+	for (size_t i = 0; i < ARRAY_SIZE(frag_sizes); i++) {
+		mcuboot_verify_init(&verify, NULL);
+		zassert_equal(feed(FILE_SIZE, frag_sizes[i]), 0,
+			      "Fragments of %u", (uint32_t)frag_sizes[i]);
+		zassert_ok(mcuboot_verify_finish(&verify),
+			   "Fragments of %u", (uint32_t)frag_sizes[i]);
+
+		mcuboot_verify_init(&verify, &manifest);
+		zassert_equal(feed(FILE_SIZE, frag_sizes[i]), 0,
+			      "Fragments of %u", (uint32_t)frag_sizes[i]);
+		zassert_ok(mcuboot_verify_finish(&verify),
+			   "Fragments of %u", (uint32_t)frag_sizes[i]);
+	}
+}
+
+static void test_verify_corrupted(void)
+{
+	const size_t corrupt_at[] = { 20, HDR_SIZE, 1234, HASH_END - 1 };
+	size_t failed_at;
+
+	for (size_t i = 0; i < ARRAY_SIZE(corrupt_at); i++) {
+		image_build();
+		image[corrupt_at[i]] ^= 0x01;
+
+		/* Detected when the SHA-256 TLV is received */
+		mcuboot_verify_init(&verify, NULL);
+		failed_at = feed(FILE_SIZE, 16);
+		zassert_true(failed_at > HASH_END &&
+			     failed_at <= HASH_END + TLV_SIZE,
+			     "Corrupted at %u, failed at %u",
+			     (uint32_t)corrupt_at[i], (uint32_t)failed_at);
+		zassert_true(mcuboot_verify_failed(&verify), NULL);
+		zassert_equal(mcuboot_verify_finish(&verify), -EBADMSG, NULL);
+
+		/* Detected at the end of the corrupted block */
+		mcuboot_verify_init(&verify, &manifest);
+		failed_at = feed(FILE_SIZE, 16);
+		zassert_equal(failed_at,
+			      MIN(ROUND_UP(corrupt_at[i] + 1, BLOCK_SIZE),
+				  FILE_SIZE),
+			      "Corrupted at %u, failed at %u",
+			      (uint32_t)corrupt_at[i], (uint32_t)failed_at);
+		zassert_equal(mcuboot_verify_finish(&verify), -EBADMSG, NULL);
+	}
+}
+
+static void test_verify_corrupted_tlv(void)
+{
+	image_build();
+	/* Last byte of the expected digest */
+	image[HASH_END + TLV_SIZE - 1] ^= 0x80;
+
+	mcuboot_verify_init(&verify, NULL);
+	zassert_equal(feed(FILE_SIZE, 64), ROUND_UP(HASH_END + TLV_SIZE, 64),
+		      NULL);
+	zassert_equal(mcuboot_verify_finish(&verify), -EBADMSG, NULL);
+}
+
+static void test_verify_incomplete(void)
+{
+	image_build();
+
+	/* The SHA-256 TLV is missing */
+	mcuboot_verify_init(&verify, NULL);
+	zassert_equal(feed(HASH_END + TLV_SIZE - 1, 64), 0, NULL);
+	zassert_equal(mcuboot_verify_finish(&verify), -EBADMSG, NULL);
+
+	/* Blocks are missing */
+	mcuboot_verify_init(&verify, &manifest);
+	zassert_equal(feed(FILE_SIZE - PAD_SIZE, 64), 0, NULL);
+	zassert_equal(mcuboot_verify_finish(&verify), -EBADMSG, NULL);
+}
+
+static void test_verify_invalid_header(void)
+{
+	image_build();
+	image[0] = 0;
+
+	mcuboot_verify_init(&verify, NULL);
+	zassert_equal(feed(FILE_SIZE, 64), 64, NULL);
+	zassert_equal(mcuboot_verify_update(&verify, image, 1), -EBADMSG,
+		      NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(mcuboot_verify,
+			 ztest_unit_test(test_verify_valid),
+			 ztest_unit_test(test_verify_corrupted),
+			 ztest_unit_test(test_verify_corrupted_tlv),
+			 ztest_unit_test(test_verify_incomplete),
+			 ztest_unit_test(test_verify_invalid_header)
+			);
+
+	ztest_run_test_suite(mcuboot_verify);
+}
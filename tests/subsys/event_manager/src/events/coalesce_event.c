@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "coalesce_event.h"
+
+
+static bool coalesce_coalesce_event(struct event_header *queued,
+				    const struct event_header *eh)
+{
+	struct coalesce_event *queued_event = cast_coalesce_event(queued);
+	const struct coalesce_event *event = cast_coalesce_event(eh);
+
+	if (queued_event->key != event->key) {
+		return false;
+	}
+
+	queued_event->val = event->val;
+
+	return true;
+}
+
+EVENT_TYPE_COALESCABLE_DEFINE(coalesce_event,
+			      false,
+			      NULL,
+			      NULL,
+			      EVENT_EXEC_CLASS_NORMAL,
+			      coalesce_coalesce_event);
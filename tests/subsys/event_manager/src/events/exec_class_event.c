@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "exec_class_event.h"
+
+
+EVENT_TYPE_EXEC_CLASS_DEFINE(exec_class_high_event,
+			     false,
+			     NULL,
+			     NULL,
+			     EVENT_EXEC_CLASS_HIGH);
+
+EVENT_TYPE_DEFINE(exec_class_normal_event,
+		  false,
+		  NULL,
+		  NULL);
+
+EVENT_TYPE_EXEC_CLASS_DEFINE(exec_class_low_event,
+			     false,
+			     NULL,
+			     NULL,
+			     EVENT_EXEC_CLASS_LOW);
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _EXEC_CLASS_EVENT_H_
+#define _EXEC_CLASS_EVENT_H_
+
+/**
+ * @brief Execution Class Events
+ * @defgroup exec_class_event Execution Class Events
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct exec_class_high_event {
+	struct event_header header;
+
+	size_t seq;
+};
+
+EVENT_TYPE_DECLARE(exec_class_high_event);
+
+struct exec_class_normal_event {
+	struct event_header header;
+
+	size_t seq;
+};
+
+EVENT_TYPE_DECLARE(exec_class_normal_event);
+
+struct exec_class_low_event {
+	struct event_header header;
+
+	size_t seq;
+};
+
+EVENT_TYPE_DECLARE(exec_class_low_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _EXEC_CLASS_EVENT_H_ */
@@ -27,6 +27,9 @@ enum test_id {
 	TEST_SUBSCRIBER_ORDER,
 	TEST_OOM_RESET,
 	TEST_MULTICONTEXT,
+	TEST_BENCHMARK,
+	TEST_COALESCE,
+	TEST_EXEC_CLASS,
 
 	TEST_CNT
 };
@@ -69,6 +69,21 @@ static void test_multicontext(void)
 	test_start(TEST_MULTICONTEXT);
 }
 
+static void test_benchmark(void)
+{
+	test_start(TEST_BENCHMARK);
+}
+
+static void test_coalesce(void)
+{
+	test_start(TEST_COALESCE);
+}
+
+static void test_exec_class(void)
+{
+	test_start(TEST_EXEC_CLASS);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(event_manager_tests,
@@ -78,7 +93,10 @@ void test_main(void)
 			 ztest_unit_test(test_event_order),
 			 ztest_unit_test(test_subs_order),
 			 ztest_unit_test(test_oom_reset),
-			 ztest_unit_test(test_multicontext)
+			 ztest_unit_test(test_multicontext),
+			 ztest_unit_test(test_benchmark),
+			 ztest_unit_test(test_coalesce),
+			 ztest_unit_test(test_exec_class)
 			 );
 
 	ztest_run_test_suite(event_manager_tests);
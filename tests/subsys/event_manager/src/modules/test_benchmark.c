@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <benchmark_event.h>
+
+#include "test_config.h"
+
+#define MODULE test_benchmark
+#define THREAD_STACK_SIZE 1024
+#define THREAD_PRIORITY K_PRIO_PREEMPT(1)
+#define HEAP_BLOCKS_MAX (2 * TEST_BENCHMARK_BURST_SIZE)
+
+#ifdef CONFIG_EVENT_MANAGER_EVENT_MEM_SLABS
+BUILD_ASSERT(TEST_BENCHMARK_BURST_SIZE <=
+	     CONFIG_EVENT_MANAGER_EVENT_MEM_SLAB_BLOCK_COUNT);
+#endif
+
+static K_THREAD_STACK_DEFINE(thread_stack, THREAD_STACK_SIZE);
+static K_SEM_DEFINE(burst_done_sem, 0, 1);
+
+static struct k_thread thread;
+
+static uint64_t latency_sum;
+static uint32_t latency_max;
+static size_t received_cnt;
+static size_t in_flight_cnt;
+static size_t in_flight_max;
+static uint32_t slab_used_max;
+
+/* Heap blocks allocated while the benchmark runs. The sizes are the
+ * requested ones, without the heap's own chunk overhead.
+ */
+static struct {
+	void *ptr;
+	size_t size;
+} heap_blocks[HEAP_BLOCKS_MAX];
+static bool heap_track;
+static size_t heap_used;
+static size_t heap_used_max;
+static size_t heap_untracked_cnt;
+
+void *__real_k_malloc(size_t size);
+void __real_k_free(void *ptr);
+
+void *__wrap_k_malloc(size_t size)
+{
+	void *ptr = __real_k_malloc(size);
+
+	if (!heap_track || !ptr) {
+		return ptr;
+	}
+
+	unsigned int key = irq_lock();
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(heap_blocks); i++) {
+		if (!heap_blocks[i].ptr) {
+			heap_blocks[i].ptr = ptr;
+			heap_blocks[i].size = size;
+			heap_used += size;
+			heap_used_max = MAX(heap_used_max, heap_used);
+			break;
+		}
+	}
+
+	if (i == ARRAY_SIZE(heap_blocks)) {
+		heap_untracked_cnt++;
+	}
+
+	irq_unlock(key);
+
+	return ptr;
+}
+
+void __wrap_k_free(void *ptr)
+{
+	unsigned int key = irq_lock();
+
+	for (size_t i = 0; ptr && (i < ARRAY_SIZE(heap_blocks)); i++) {
+		if (heap_blocks[i].ptr == ptr) {
+			heap_used -= heap_blocks[i].size;
+			heap_blocks[i].ptr = NULL;
+			break;
+		}
+	}
+
+	irq_unlock(key);
+
+	__real_k_free(ptr);
+}
+
+
+static void submit_burst(void)
+{
+	/* Queue the whole burst before the events start to be processed. */
+	k_sched_lock();
+
+	for (size_t i = 0; i < TEST_BENCHMARK_BURST_SIZE; i++) {
+		struct benchmark_event *ev = new_benchmark_event();
+
+		zassert_not_null(ev, "Failed to allocate event");
+
+		if (IS_ENABLED(CONFIG_EVENT_MANAGER_EVENT_MEM_SLABS)) {
+			struct k_mem_slab *slab = ev->header.type_id->mem_slab;
+
+			zassert_not_null(slab, "Event not allocated from slab");
+			slab_used_max = MAX(slab_used_max,
+					    k_mem_slab_num_used_get(slab));
+		}
+
+		unsigned int key = irq_lock();
+
+		in_flight_cnt++;
+		in_flight_max = MAX(in_flight_max, in_flight_cnt);
+		irq_unlock(key);
+
+		ev->submit_time = k_cycle_get_32();
+		EVENT_SUBMIT(ev);
+	}
+
+	k_sched_unlock();
+}
+
+static void report_results(void)
+{
+	TC_PRINT("Event allocation: %s\n",
+		 IS_ENABLED(CONFIG_EVENT_MANAGER_EVENT_MEM_SLABS) ?
+		 "memory slab" : "heap");
+	TC_PRINT("Events dispatched: %zu\n", received_cnt);
+	TC_PRINT("Submit to dispatch latency: avg %u ns, max %u ns\n",
+		 (uint32_t)k_cyc_to_ns_floor64(latency_sum / received_cnt),
+		 (uint32_t)k_cyc_to_ns_floor64(latency_max));
+	TC_PRINT("Events in flight: max %zu\n", in_flight_max);
+	TC_PRINT("Heap used: max %zu bytes\n", heap_used_max);
+
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_EVENT_MEM_SLABS)) {
+		TC_PRINT("Memory slab blocks used: max %u (%zu bytes)\n",
+			 slab_used_max,
+			 slab_used_max * sizeof(struct benchmark_event));
+	}
+}
+
+static void thread_fn(void)
+{
+	latency_sum = 0;
+	latency_max = 0;
+	received_cnt = 0;
+	in_flight_cnt = 0;
+	in_flight_max = 0;
+	slab_used_max = 0;
+	memset(heap_blocks, 0, sizeof(heap_blocks));
+	heap_used = 0;
+	heap_used_max = 0;
+	heap_untracked_cnt = 0;
+	heap_track = true;
+
+	for (size_t i = 0; i < TEST_BENCHMARK_BURST_CNT; i++) {
+		submit_burst();
+
+		int err = k_sem_take(&burst_done_sem, K_SECONDS(1));
+
+		zassert_equal(err, 0, "Burst not dispatched");
+	}
+
+	heap_track = false;
+
+	zassert_equal(received_cnt,
+		      TEST_BENCHMARK_BURST_CNT * TEST_BENCHMARK_BURST_SIZE,
+		      "Invalid number of dispatched events");
+	zassert_equal(heap_untracked_cnt, 0, "Too many heap blocks to track");
+
+	if (!IS_ENABLED(CONFIG_EVENT_MANAGER_EVENT_MEM_SLABS)) {
+		zassert_true(heap_used_max >= sizeof(struct benchmark_event),
+			     "Heap usage not measured");
+	}
+
+	report_results();
+
+	struct test_end_event *te = new_test_end_event();
+
+	zassert_not_null(te, "Failed to allocate event");
+	te->test_id = TEST_BENCHMARK;
+	EVENT_SUBMIT(te);
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_benchmark_event(eh)) {
+		const struct benchmark_event *ev = cast_benchmark_event(eh);
+		uint32_t latency = k_cycle_get_32() - ev->submit_time;
+
+		latency_sum += latency;
+		latency_max = MAX(latency_max, latency);
+		received_cnt++;
+
+		unsigned int key = irq_lock();
+
+		in_flight_cnt--;
+		bool burst_done = (in_flight_cnt == 0);
+
+		irq_unlock(key);
+
+		if (burst_done) {
+			k_sem_give(&burst_done_sem);
+		}
+
+		return false;
+	}
+
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		switch (st->test_id) {
+		case TEST_BENCHMARK:
+			k_thread_create(&thread, thread_stack,
+					THREAD_STACK_SIZE,
+					(k_thread_entry_t)thread_fn,
+					NULL, NULL, NULL,
+					THREAD_PRIORITY, 0, K_NO_WAIT);
+			break;
+
+		default:
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+			break;
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, benchmark_event);
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <coalesce_event.h>
+
+#include "test_config.h"
+
+#define MODULE test_coalesce
+#define KEY_CNT 2
+
+static size_t received_cnt;
+static int expected_val[KEY_CNT];
+
+
+static void submit_coalesce_events(void)
+{
+	/* Events are submitted from an event handler, so they stay queued
+	 * until the handler returns.
+	 */
+	for (int i = 0; i < TEST_COALESCE_EVENT_CNT; i++) {
+		for (int key = 0; key < KEY_CNT; key++) {
+			struct coalesce_event *event = new_coalesce_event();
+
+			zassert_not_null(event, "Failed to allocate event");
+			event->key = key;
+			event->val = i;
+			EVENT_SUBMIT(event);
+		}
+	}
+}
+
+static void check_coalesce_event(const struct coalesce_event *event)
+{
+	size_t expected_cnt = KEY_CNT;
+
+	zassert_true(event->key < KEY_CNT, "Invalid key");
+
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_EVENT_COALESCING)) {
+		/* Only the last value of every key is received. */
+		zassert_equal(event->val, TEST_COALESCE_EVENT_CNT - 1,
+			      "Event not coalesced");
+	} else {
+		zassert_equal(event->val, expected_val[event->key],
+			      "Invalid event order");
+		expected_val[event->key]++;
+		expected_cnt *= TEST_COALESCE_EVENT_CNT;
+	}
+
+	received_cnt++;
+
+	if (received_cnt == expected_cnt) {
+		struct test_end_event *te = new_test_end_event();
+
+		zassert_not_null(te, "Failed to allocate event");
+		te->test_id = TEST_COALESCE;
+		EVENT_SUBMIT(te);
+	}
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		switch (st->test_id) {
+		case TEST_COALESCE:
+			submit_coalesce_events();
+			break;
+
+		default:
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+			break;
+		}
+
+		return false;
+	}
+
+	if (is_coalesce_event(eh)) {
+		check_coalesce_event(cast_coalesce_event(eh));
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, coalesce_event);
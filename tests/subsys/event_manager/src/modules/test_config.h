@@ -19,3 +19,16 @@
 
 /* TEST_EVENT_ORDER */
 #define TEST_EVENT_ORDER_CNT 20
+
+
+/* TEST_BENCHMARK */
+#define TEST_BENCHMARK_BURST_CNT 100
+#define TEST_BENCHMARK_BURST_SIZE 8
+
+
+/* TEST_COALESCE */
+#define TEST_COALESCE_EVENT_CNT 5
+
+
+/* TEST_EXEC_CLASS */
+#define TEST_EXEC_CLASS_EVENT_CNT 5
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <exec_class_event.h>
+
+#include "test_config.h"
+
+#define MODULE test_exec_class
+#define EVENT_CNT (EVENT_EXEC_CLASS_COUNT * TEST_EXEC_CLASS_EVENT_CNT)
+
+#ifdef CONFIG_EVENT_MANAGER_EXEC_CLASS_STATS
+extern struct event_exec_class_stats
+	event_manager_exec_class_stats[EVENT_EXEC_CLASS_COUNT];
+
+static struct event_exec_class_stats start_stats[EVENT_EXEC_CLASS_COUNT];
+#endif
+
+static enum event_exec_class received[EVENT_CNT];
+static size_t received_cnt;
+static size_t class_received_cnt[EVENT_EXEC_CLASS_COUNT];
+
+
+static void submit_exec_class_events(void)
+{
+#ifdef CONFIG_EVENT_MANAGER_EXEC_CLASS_STATS
+	unsigned int key = irq_lock();
+
+	memcpy(start_stats, event_manager_exec_class_stats,
+	       sizeof(start_stats));
+	irq_unlock(key);
+#endif
+
+	/* Events are submitted from an event handler of the normal class, in
+	 * the reverse order of the class priority.
+	 */
+	for (size_t i = 0; i < TEST_EXEC_CLASS_EVENT_CNT; i++) {
+		struct exec_class_low_event *event = new_exec_class_low_event();
+
+		zassert_not_null(event, "Failed to allocate event");
+		event->seq = i;
+		EVENT_SUBMIT(event);
+	}
+
+	for (size_t i = 0; i < TEST_EXEC_CLASS_EVENT_CNT; i++) {
+		struct exec_class_normal_event *event =
+			new_exec_class_normal_event();
+
+		zassert_not_null(event, "Failed to allocate event");
+		event->seq = i;
+		EVENT_SUBMIT(event);
+	}
+
+	for (size_t i = 0; i < TEST_EXEC_CLASS_EVENT_CNT; i++) {
+		struct exec_class_high_event *event =
+			new_exec_class_high_event();
+
+		zassert_not_null(event, "Failed to allocate event");
+		event->seq = i;
+		EVENT_SUBMIT(event);
+	}
+}
+
+static void check_order(void)
+{
+	static const enum event_exec_class class_order[] = {
+		EVENT_EXEC_CLASS_HIGH,
+		EVENT_EXEC_CLASS_NORMAL,
+		EVENT_EXEC_CLASS_LOW,
+	};
+	static const enum event_exec_class submit_order[] = {
+		EVENT_EXEC_CLASS_LOW,
+		EVENT_EXEC_CLASS_NORMAL,
+		EVENT_EXEC_CLASS_HIGH,
+	};
+	const enum event_exec_class *order =
+		IS_ENABLED(CONFIG_EVENT_MANAGER_EXEC_CLASSES) ?
+		class_order : submit_order;
+
+	/* With execution classes, events of a higher class are processed
+	 * first. Without them, all events are processed in FIFO order.
+	 */
+	for (size_t i = 0; i < EVENT_CNT; i++) {
+		zassert_equal(received[i],
+			      order[i / TEST_EXEC_CLASS_EVENT_CNT],
+			      "Invalid dispatch order at %zu", i);
+	}
+}
+
+static void check_stats(void)
+{
+#ifdef CONFIG_EVENT_MANAGER_EXEC_CLASS_STATS
+	struct event_exec_class_stats stats[EVENT_EXEC_CLASS_COUNT];
+	unsigned int key = irq_lock();
+
+	memcpy(stats, event_manager_exec_class_stats, sizeof(stats));
+	irq_unlock(key);
+
+	for (size_t i = 0; i < EVENT_EXEC_CLASS_COUNT; i++) {
+		zassert_equal(stats[i].event_cnt - start_stats[i].event_cnt,
+			      TEST_EXEC_CLASS_EVENT_CNT,
+			      "Invalid processed count of class %zu", i);
+		zassert_equal(stats[i].depth, 0,
+			      "Events left in queue of class %zu", i);
+		zassert_true(stats[i].depth_max >= TEST_EXEC_CLASS_EVENT_CNT,
+			     "Invalid max queue depth of class %zu", i);
+	}
+#endif
+}
+
+static void exec_class_event_received(enum event_exec_class exec_class,
+				      size_t seq)
+{
+	static const int priority[] = {
+#ifdef CONFIG_EVENT_MANAGER_EXEC_CLASSES
+		[EVENT_EXEC_CLASS_HIGH] =
+			CONFIG_EVENT_MANAGER_EXEC_CLASS_HIGH_PRIORITY,
+		[EVENT_EXEC_CLASS_NORMAL] = CONFIG_SYSTEM_WORKQUEUE_PRIORITY,
+		[EVENT_EXEC_CLASS_LOW] =
+			CONFIG_EVENT_MANAGER_EXEC_CLASS_LOW_PRIORITY,
+#else
+		[EVENT_EXEC_CLASS_HIGH] = CONFIG_SYSTEM_WORKQUEUE_PRIORITY,
+		[EVENT_EXEC_CLASS_NORMAL] = CONFIG_SYSTEM_WORKQUEUE_PRIORITY,
+		[EVENT_EXEC_CLASS_LOW] = CONFIG_SYSTEM_WORKQUEUE_PRIORITY,
+#endif
+	};
+
+	zassert_equal(k_thread_priority_get(k_current_get()),
+		      priority[exec_class], "Invalid work queue");
+
+	unsigned int key = irq_lock();
+	size_t idx = received_cnt++;
+	size_t class_idx = class_received_cnt[exec_class]++;
+
+	irq_unlock(key);
+
+	zassert_true(idx < EVENT_CNT, "Too many events");
+	zassert_equal(seq, class_idx, "Invalid event order within class");
+	received[idx] = exec_class;
+
+	if (idx == (EVENT_CNT - 1)) {
+		check_order();
+		check_stats();
+
+		struct test_end_event *te = new_test_end_event();
+
+		zassert_not_null(te, "Failed to allocate event");
+		te->test_id = TEST_EXEC_CLASS;
+		EVENT_SUBMIT(te);
+	}
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		switch (st->test_id) {
+		case TEST_EXEC_CLASS:
+			submit_exec_class_events();
+			break;
+
+		default:
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+			break;
+		}
+
+		return false;
+	}
+
+	if (is_exec_class_high_event(eh)) {
+		const struct exec_class_high_event *event =
+			cast_exec_class_high_event(eh);
+
+		exec_class_event_received(EVENT_EXEC_CLASS_HIGH, event->seq);
+
+		return false;
+	}
+
+	if (is_exec_class_normal_event(eh)) {
+		const struct exec_class_normal_event *event =
+			cast_exec_class_normal_event(eh);
+
+		exec_class_event_received(EVENT_EXEC_CLASS_NORMAL, event->seq);
+
+		return false;
+	}
+
+	if (is_exec_class_low_event(eh)) {
+		const struct exec_class_low_event *event =
+			cast_exec_class_low_event(eh);
+
+		exec_class_event_received(EVENT_EXEC_CLASS_LOW, event->seq);
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, exec_class_high_event);
+EVENT_SUBSCRIBE(MODULE, exec_class_normal_event);
+EVENT_SUBSCRIBE(MODULE, exec_class_low_event);
@@ -45,9 +45,9 @@ static bool event_handler(const struct event_header *eh)
 			zassert_true(oom_error, "OOM error not detected");
 
 			/* Freeing memory to enable further testing. */
-			while (i >= 0) {
-				k_free(event_tab[i]);
+			while (i > 0) {
 				i--;
+				event_manager_free(&event_tab[i]->header);
 			}
 
 			struct test_end_event *et = new_test_end_event();
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <net/socket.h>
+#include <net/coap.h>
+
+#include "coap_server.h"
+#include "http_server.h"
+
+#define SERVER_STACK_SIZE 4096
+#define SERVER_PRIORITY K_PRIO_PREEMPT(5)
+/* Number of responses delayed at the same time. */
+#define PENDING_CNT 16
+#define MSG_MAX_LEN 600
+/* Largest block served. */
+#define SERVER_SZX COAP_BLOCK_512
+
+static K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+
+/* Response waiting for the emulated latency to elapse. */
+struct pending {
+	int64_t due;
+	struct sockaddr addr;
+	socklen_t addr_len;
+	uint8_t buf[MSG_MAX_LEN];
+	size_t len;
+	bool used;
+};
+
+static struct pending pending[PENDING_CNT];
+static size_t file_size;
+static uint32_t latency_ms;
+static uint32_t loss_every;
+static uint32_t request_cnt;
+static uint32_t dropped_cnt;
+
+static int response_build(struct pending *p, uint8_t *req_buf, size_t len)
+{
+	struct coap_packet req;
+	struct coap_packet resp;
+	uint8_t token[8];
+	uint8_t data[512];
+	uint8_t tkl;
+	int block2;
+	uint8_t szx;
+	size_t off;
+	size_t data_len;
+	bool more;
+	int err;
+
+	err = coap_packet_parse(&req, req_buf, len, NULL, 0);
+	if (err) {
+		return err;
+	}
+
+	tkl = coap_header_get_token(&req, token);
+
+	block2 = coap_get_option_int(&req, COAP_OPTION_BLOCK2);
+	if (block2 < 0) {
+		block2 = SERVER_SZX;
+	}
+
+	/* Serve at most SERVER_SZX blocks, starting at the requested offset */
+	off = (block2 >> 4) * coap_block_size_to_bytes(block2 & 0x07);
+	szx = MIN(block2 & 0x07, SERVER_SZX);
+	if (off >= file_size) {
+		return -EINVAL;
+	}
+
+	data_len = MIN(coap_block_size_to_bytes(szx), file_size - off);
+	more = (off + data_len < file_size);
+
+	for (size_t i = 0; i < data_len; i++) {
+		data[i] = http_server_file_byte(off + i);
+	}
+
+	err = coap_packet_init(&resp, p->buf, sizeof(p->buf), 1,
+			       COAP_TYPE_ACK, tkl, token,
+			       COAP_RESPONSE_CODE_CONTENT,
+			       coap_header_get_id(&req));
+	if (err) {
+		return err;
+	}
+
+	err = coap_append_option_int(&resp, COAP_OPTION_BLOCK2,
+				     ((off / coap_block_size_to_bytes(szx))
+				      << 4) | (more << 3) | szx);
+	if (err) {
+		return err;
+	}
+
+	if (coap_get_option_int(&req, COAP_OPTION_SIZE2) >= 0) {
+		err = coap_append_option_int(&resp, COAP_OPTION_SIZE2,
+					     file_size);
+		if (err) {
+			return err;
+		}
+	}
+
+	err = coap_packet_append_payload_marker(&resp);
+	if (err) {
+		return err;
+	}
+
+	err = coap_packet_append_payload(&resp, data, data_len);
+	if (err) {
+		return err;
+	}
+
+	p->len = resp.offset;
+
+	return 0;
+}
+
+static void request_handle(int fd)
+{
+	uint8_t buf[MSG_MAX_LEN];
+	struct pending *p = NULL;
+	ssize_t len;
+
+	for (size_t i = 0; i < PENDING_CNT; i++) {
+		if (!pending[i].used) {
+			p = &pending[i];
+			break;
+		}
+	}
+
+	__ASSERT(p, "Too many pending responses");
+
+	p->addr_len = sizeof(p->addr);
+	len = recvfrom(fd, buf, sizeof(buf), 0, &p->addr, &p->addr_len);
+	if (len <= 0) {
+		return;
+	}
+
+	request_cnt++;
+	if (loss_every && (request_cnt % loss_every) == 0) {
+		/* Emulate the loss of the request */
+		dropped_cnt++;
+		return;
+	}
+
+	if (response_build(p, buf, len)) {
+		return;
+	}
+
+	p->due = k_uptime_get() + latency_ms;
+	p->used = true;
+}
+
+static void server_thread_fn(void *a, void *b, void *c)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(COAP_SERVER_PORT),
+	};
+	struct pollfd fds;
+	int err;
+
+	fds.fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	fds.events = POLLIN;
+	__ASSERT(fds.fd >= 0, "Failed to create server socket");
+
+	inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+	err = bind(fds.fd, (struct sockaddr *)&addr, sizeof(addr));
+	__ASSERT(err == 0, "Failed to bind server socket");
+
+	while (true) {
+		int64_t now = k_uptime_get();
+		int timeout = -1;
+
+		/* Send the responses whose latency has elapsed */
+		for (size_t i = 0; i < PENDING_CNT; i++) {
+			struct pending *p = &pending[i];
+
+			if (!p->used) {
+				continue;
+			}
+
+			if (p->due <= now) {
+				(void)sendto(fds.fd, p->buf, p->len, 0,
+					     &p->addr, p->addr_len);
+				p->used = false;
+				continue;
+			}
+
+			if (timeout < 0 || p->due - now < timeout) {
+				timeout = p->due - now;
+			}
+		}
+
+		fds.revents = 0;
+		if (poll(&fds, 1, timeout) > 0) {
+			request_handle(fds.fd);
+		}
+	}
+}
+
+void coap_server_start(size_t size, uint32_t latency, uint32_t loss)
+{
+	file_size = size;
+	latency_ms = latency;
+	loss_every = loss;
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack),
+			server_thread_fn, NULL, NULL, NULL,
+			SERVER_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&server_thread, "coap_server");
+}
+
+uint32_t coap_server_dropped(void)
+{
+	return dropped_cnt;
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef COAP_SERVER_H_
+#define COAP_SERVER_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+
+#define COAP_SERVER_PORT 5683
+
+/* Start serving a file of the given size over CoAP block-wise transfer,
+ * on the loopback interface. The file content is the same as the one
+ * served by the HTTP server.
+ * Every response is delayed by the given latency, without delaying the
+ * responses to the other requests. One request out of loss_every is
+ * dropped, or none if loss_every is zero.
+ */
+void coap_server_start(size_t file_size, uint32_t latency_ms,
+		       uint32_t loss_every);
+
+/* Number of requests dropped so far. */
+uint32_t coap_server_dropped(void);
+
+#endif /* COAP_SERVER_H_ */
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <net/socket.h>
+
+#include "http_server.h"
+
+#define SERVER_STACK_SIZE 2048
+#define SERVER_PRIORITY K_PRIO_PREEMPT(5)
+/* Number of connections served at the same time. */
+#define SERVER_WORKER_CNT 5
+#define REQUEST_MAX_LEN 512
+#define CHUNK_SIZE 512
+
+static K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, SERVER_WORKER_CNT,
+				   SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+static struct k_thread worker_threads[SERVER_WORKER_CNT];
+
+/* Accepted connections, waiting for a worker. */
+K_MSGQ_DEFINE(connections, sizeof(int), SERVER_WORKER_CNT, 4);
+
+static size_t file_size;
+static uint32_t latency_ms;
+
+static int send_all(int fd, const void *buf, size_t len)
+{
+	const uint8_t *p = buf;
+
+	while (len) {
+		ssize_t sent = send(fd, p, len, 0);
+
+		if (sent <= 0) {
+			return -errno;
+		}
+
+		p += sent;
+		len -= sent;
+	}
+
+	return 0;
+}
+
+static int response_send(int fd, const char *request)
+{
+	char header[160];
+	uint8_t chunk[CHUNK_SIZE];
+	size_t from = 0;
+	size_t to = file_size - 1;
+	const char *range;
+	int len;
+	int err;
+
+	range = strstr(request, "Range: bytes=");
+	if (range) {
+		char *end;
+
+		from = strtoul(range + strlen("Range: bytes="), &end, 10);
+		if (*end == '-' && end[1] >= '0' && end[1] <= '9') {
+			to = MIN(strtoul(end + 1, NULL, 10), file_size - 1);
+		}
+
+		len = snprintf(header, sizeof(header),
+			       "HTTP/1.1 206 Partial Content\r\n"
+			       "Content-Range: bytes %zu-%zu/%zu\r\n"
+			       "Content-Length: %zu\r\n"
+			       "\r\n", from, to, file_size, to - from + 1);
+	} else {
+		len = snprintf(header, sizeof(header),
+			       "HTTP/1.1 200 OK\r\n"
+			       "Content-Length: %zu\r\n"
+			       "\r\n", file_size);
+	}
+
+	/* Emulate the round trip time of the link. */
+	k_sleep(K_MSEC(latency_ms));
+
+	err = send_all(fd, header, len);
+	if (err) {
+		return err;
+	}
+
+	for (size_t off = from; off <= to; off += sizeof(chunk)) {
+		size_t chunk_len = MIN(sizeof(chunk), to - off + 1);
+
+		for (size_t i = 0; i < chunk_len; i++) {
+			chunk[i] = http_server_file_byte(off + i);
+		}
+
+		err = send_all(fd, chunk, chunk_len);
+		if (err) {
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+static void connection_handle(int fd)
+{
+	char request[REQUEST_MAX_LEN + 1];
+	size_t len = 0;
+
+	while (true) {
+		ssize_t rcvd = recv(fd, request + len, REQUEST_MAX_LEN - len, 0);
+		char *end;
+
+		if (rcvd <= 0) {
+			return;
+		}
+
+		len += rcvd;
+		request[len] = '\0';
+
+		/* Serve every complete request, keeping the connection open */
+		while ((end = strstr(request, "\r\n\r\n")) != NULL) {
+			size_t req_len = end + strlen("\r\n\r\n") - request;
+
+			if (response_send(fd, request)) {
+				return;
+			}
+
+			len -= req_len;
+			memmove(request, request + req_len, len + 1);
+		}
+
+		if (len == REQUEST_MAX_LEN) {
+			return;
+		}
+	}
+}
+
+static void worker_thread_fn(void *a, void *b, void *c)
+{
+	int fd;
+
+	while (true) {
+		k_msgq_get(&connections, &fd, K_FOREVER);
+		connection_handle(fd);
+		close(fd);
+	}
+}
+
+static void server_thread_fn(void *a, void *b, void *c)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(HTTP_SERVER_PORT),
+	};
+	int server_fd;
+	int err;
+
+	server_fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	__ASSERT(server_fd >= 0, "Failed to create server socket");
+
+	inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+	err = bind(server_fd, (struct sockaddr *)&addr, sizeof(addr));
+	__ASSERT(err == 0, "Failed to bind server socket");
+
+	err = listen(server_fd, SERVER_WORKER_CNT);
+	__ASSERT(err == 0, "Failed to listen on server socket");
+
+	while (true) {
+		int fd = accept(server_fd, NULL, NULL);
+
+		if (fd < 0) {
+			continue;
+		}
+
+		if (k_msgq_put(&connections, &fd, K_NO_WAIT)) {
+			/* All workers are busy */
+			close(fd);
+		}
+	}
+}
+
+void http_server_start(size_t size, uint32_t latency)
+{
+	file_size = size;
+	latency_ms = latency;
+
+	for (size_t i = 0; i < SERVER_WORKER_CNT; i++) {
+		k_thread_create(&worker_threads[i], worker_stacks[i],
+				K_THREAD_STACK_SIZEOF(worker_stacks[i]),
+				worker_thread_fn, NULL, NULL, NULL,
+				SERVER_PRIORITY, 0, K_NO_WAIT);
+	}
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack),
+			server_thread_fn, NULL, NULL, NULL,
+			SERVER_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&server_thread, "http_server");
+}
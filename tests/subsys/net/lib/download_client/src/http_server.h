@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HTTP_SERVER_H_
+#define HTTP_SERVER_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+
+#define HTTP_SERVER_PORT 8080
+
+/* Byte of the served file at a given offset. */
+static inline uint8_t http_server_file_byte(size_t offset)
+{
+	return (uint8_t)(offset * 7 + (offset >> 8));
+}
+
+/* Start serving a file of the given size on the loopback interface.
+ * Every response is delayed by the given latency.
+ */
+void http_server_start(size_t file_size, uint32_t latency_ms);
+
+#endif /* HTTP_SERVER_H_ */
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <stdio.h>
+#include <net/download_client.h>
+
+#include "http_server.h"
+#include "coap_server.h"
+
+#define TEST_FILE_SIZE (64 * 1024)
+#define TEST_FRAG_SIZE CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE
+#define TEST_FRAG_CNT (TEST_FILE_SIZE / TEST_FRAG_SIZE)
+/* Round trip time of the emulated link. */
+#define TEST_LATENCY_MS 30
+/* Time taken by the application to process a fragment, like a flash write. */
+#define TEST_WRITE_TIME_MS 20
+#define TEST_TIMEOUT K_SECONDS(60)
+
+#define TEST_COAP_FILE_SIZE (16 * 1024)
+#define TEST_COAP_BLOCK_CNT (TEST_COAP_FILE_SIZE / 512)
+/* Round trip time of the emulated NB-IoT link. */
+#define TEST_COAP_LATENCY_MS 100
+/* One request out of TEST_COAP_LOSS_EVERY is lost. */
+#define TEST_COAP_LOSS_EVERY 10
+
+static struct download_client client;
+static K_SEM_DEFINE(download_done_sem, 0, 1);
+
+static size_t received;
+static size_t fragment_cnt;
+static int download_err;
+
+static int download_client_callback(const struct download_client_evt *event)
+{
+	switch (event->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT: {
+		const uint8_t *buf = event->fragment.buf;
+
+		for (size_t i = 0; i < event->fragment.len; i++) {
+			if (buf[i] != http_server_file_byte(received + i)) {
+				download_err = -EBADMSG;
+				k_sem_give(&download_done_sem);
+				return -1;
+			}
+		}
+
+		received += event->fragment.len;
+		fragment_cnt++;
+
+		/* Emulate the time needed to store the fragment. */
+		k_sleep(K_MSEC(TEST_WRITE_TIME_MS));
+		return 0;
+	}
+	case DOWNLOAD_CLIENT_EVT_DONE:
+		k_sem_give(&download_done_sem);
+		return 0;
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		download_err = event->error;
+		k_sem_give(&download_done_sem);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void test_download_throughput(void)
+{
+	const struct download_client_cfg config = {
+		.sec_tag = -1,
+	};
+	uint32_t sequential_ms = TEST_FRAG_CNT *
+				 (TEST_LATENCY_MS + TEST_WRITE_TIME_MS);
+	int64_t start;
+	uint32_t elapsed;
+	int err;
+
+	received = 0;
+	fragment_cnt = 0;
+	download_err = 0;
+
+	http_server_start(TEST_FILE_SIZE, TEST_LATENCY_MS);
+
+	err = download_client_connect(&client,
+				      "http://127.0.0.1:" STRINGIFY(HTTP_SERVER_PORT),
+				      &config);
+	zassert_ok(err, "Failed to connect, err %d", err);
+
+	start = k_uptime_get();
+
+	err = download_client_start(&client, "image.bin", 0);
+	zassert_ok(err, "Failed to start the download, err %d", err);
+
+	err = k_sem_take(&download_done_sem, TEST_TIMEOUT);
+	zassert_ok(err, "Download timed out");
+
+	elapsed = (uint32_t)(k_uptime_get() - start);
+
+	zassert_ok(download_err, "Download failed, err %d", download_err);
+	zassert_equal(received, TEST_FILE_SIZE, "Invalid download size");
+	zassert_equal(fragment_cnt, TEST_FRAG_CNT, "Invalid fragment count");
+
+	TC_PRINT("Fragment queue: %s\n",
+		 IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_FRAGMENT_QUEUE) ?
+		 "enabled" : "disabled");
+	TC_PRINT("Pipelining: %s\n",
+		 IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINING) ?
+		 "enabled" : "disabled");
+#if defined(CONFIG_DOWNLOAD_CLIENT_RANGE_STREAMS)
+	TC_PRINT("Range request streams: %u\n",
+		 CONFIG_DOWNLOAD_CLIENT_RANGE_STREAM_CNT);
+#endif
+	TC_PRINT("Downloaded %u bytes in %u ms (%u B/s)\n",
+		 TEST_FILE_SIZE, elapsed,
+		 (uint32_t)((TEST_FILE_SIZE * 1000ULL) / MAX(elapsed, 1)));
+	TC_PRINT("Sequential receive and write: %u ms\n", sequential_ms);
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_FRAGMENT_QUEUE)) {
+		/* Receiving and writing the fragments overlap. */
+		zassert_true(elapsed < sequential_ms * 3 / 4,
+			     "Receive and write did not overlap");
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINING)) {
+		/* The next request is served while writing a fragment. */
+		zassert_true(elapsed < sequential_ms * 3 / 4,
+			     "Range requests were not pipelined");
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_STREAMS)) {
+		/* The latency of the requests overlaps. */
+		zassert_true(elapsed < sequential_ms / 2,
+			     "Range requests did not overlap");
+	}
+
+	(void)download_client_disconnect(&client);
+}
+
+static void test_download_coap(void)
+{
+	const struct download_client_cfg config = {
+		.sec_tag = -1,
+	};
+	uint32_t sequential_ms;
+	int64_t start;
+	uint32_t elapsed;
+	int err;
+
+	received = 0;
+	fragment_cnt = 0;
+	download_err = 0;
+
+	coap_server_start(TEST_COAP_FILE_SIZE, TEST_COAP_LATENCY_MS,
+			  TEST_COAP_LOSS_EVERY);
+
+	err = download_client_connect(&client,
+				      "coap://127.0.0.1:" STRINGIFY(COAP_SERVER_PORT),
+				      &config);
+	zassert_ok(err, "Failed to connect, err %d", err);
+
+	start = k_uptime_get();
+
+	err = download_client_start(&client, "image.bin", 0);
+	zassert_ok(err, "Failed to start the download, err %d", err);
+
+	err = k_sem_take(&download_done_sem, TEST_TIMEOUT);
+	zassert_ok(err, "Download timed out");
+
+	elapsed = (uint32_t)(k_uptime_get() - start);
+
+	zassert_ok(download_err, "Download failed, err %d", download_err);
+	zassert_equal(received, TEST_COAP_FILE_SIZE, "Invalid download size");
+	zassert_equal(fragment_cnt, TEST_COAP_BLOCK_CNT,
+		      "Invalid fragment count");
+
+	/* One block at a time, each lost request costs a timeout */
+	sequential_ms = TEST_COAP_BLOCK_CNT *
+			(TEST_COAP_LATENCY_MS + TEST_WRITE_TIME_MS) +
+			coap_server_dropped() *
+			CONFIG_DOWNLOAD_CLIENT_UDP_SOCK_TIMEO_MS;
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW)
+	TC_PRINT("CoAP window: %u blocks\n",
+		 CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE);
+#endif
+	TC_PRINT("Downloaded %u bytes over CoAP in %u ms, %u requests lost\n",
+		 TEST_COAP_FILE_SIZE, elapsed, coap_server_dropped());
+	TC_PRINT("One block at a time: %u ms\n", sequential_ms);
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW)) {
+		/* The latency of the block requests overlaps. */
+		zassert_true(elapsed < sequential_ms * 3 / 4,
+			     "Block requests did not overlap");
+	}
+
+	(void)download_client_disconnect(&client);
+}
+
+static void test_download_init(void)
+{
+	int err;
+
+	err = download_client_init(&client, download_client_callback);
+	zassert_ok(err, "Failed to initialize the download client");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(download_client,
+			 ztest_unit_test(test_download_init),
+			 ztest_unit_test(test_download_throughput),
+			 ztest_unit_test(test_download_coap)
+			);
+
+	ztest_run_test_suite(download_client);
+}
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <net/socket.h>
+#include <net/download_client.h>
+
+#define TEST_HOST "https://example.com"
+#define TEST_FILE "image.bin"
+#define TEST_REQUEST_MAX_LEN 256
+
+int http_parse(struct download_client *client, size_t len);
+int socket_send_buf(int fd, const char *buf, size_t len);
+
+/* Responses captured from HTTP servers, replayed to the parser. */
+struct capture {
+	const char *name;
+	/* Download state when the response is received */
+	int proto;
+	size_t progress;
+	size_t file_size;
+	size_t frag_size;
+	const char *response;
+	/* Expected outcome */
+	int rc;
+	size_t file_size_expected;
+	bool connection_close;
+	/* Range of the pipelined request, if any */
+	const char *pipelined;
+};
+
+static const struct capture captures[] = {
+	{
+		.name = "range_first",
+		.proto = IPPROTO_TLS_1_2,
+		.frag_size = 16,
+		.response =
+			"HTTP/1.1 206 Partial Content\r\n"
+			"Server: nginx/1.18.0\r\n"
+			"Date: Mon, 12 Jul 2021 08:31:02 GMT\r\n"
+			"Content-Type: application/octet-stream\r\n"
+			"Content-Length: 16\r\n"
+			"Last-Modified: Fri, 09 Jul 2021 14:02:11 GMT\r\n"
+			"Connection: keep-alive\r\n"
+			"ETag: \"60e8565b-40\"\r\n"
+			"Content-Range: bytes 0-15/64\r\n"
+			"\r\n"
+			"0123456789abcdef",
+		.file_size_expected = 64,
+		.pipelined = "Range: bytes=16-31\r\n",
+	},
+	{
+		.name = "range_last",
+		.proto = IPPROTO_TLS_1_2,
+		.progress = 48,
+		.file_size = 64,
+		.frag_size = 16,
+		.response =
+			"http/1.1 206 partial content\r\n"
+			"content-range: bytes 48-63/64\r\n"
+			"content-length: 16\r\n"
+			"\r\n"
+			"FEDCBA9876543210",
+		.file_size_expected = 64,
+	},
+	{
+		.name = "range_close",
+		.proto = IPPROTO_TLS_1_2,
+		.progress = 16,
+		.frag_size = 16,
+		.response =
+			"HTTP/1.1 206 Partial Content\r\n"
+			"CONTENT-RANGE: bytes 16-31/64\r\n"
+			"Content-Length: 16\r\n"
+			"Connection: Close\r\n"
+			"\r\n"
+			"\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n",
+		.file_size_expected = 64,
+		.connection_close = true,
+	},
+	{
+		.name = "whole_file",
+		.proto = IPPROTO_TCP,
+		.response =
+			"HTTP/1.1 200 OK\r\n"
+			"Content-Type: application/octet-stream\r\n"
+			"Content-Length: 20\r\n"
+			"Accept-Ranges: bytes\r\n"
+			"\r\n"
+			"content-length: 99\r\n",
+		.file_size_expected = 20,
+	},
+	{
+		.name = "bare_lf",
+		.proto = IPPROTO_TCP,
+		.response =
+			"HTTP/1.1 200 OK\n"
+			"Content-Length:4\n"
+			"\n"
+			"abcd",
+		.file_size_expected = 4,
+	},
+	{
+		.name = "not_found",
+		.proto = IPPROTO_TCP,
+		.response =
+			"HTTP/1.1 404 Not Found\r\n"
+			"Content-Length: 0\r\n"
+			"\r\n",
+		.rc = -1,
+	},
+	{
+		.name = "chunked",
+		.proto = IPPROTO_TCP,
+		.response =
+			"HTTP/1.1 200 OK\r\n"
+			"Transfer-Encoding: chunked\r\n"
+			"\r\n"
+			"4\r\nabcd\r\n0\r\n\r\n",
+		.rc = -1,
+	},
+	{
+		.name = "missing_range",
+		.proto = IPPROTO_TLS_1_2,
+		.frag_size = 16,
+		.response =
+			"HTTP/1.1 206 Partial Content\r\n"
+			"Content-Length: 16\r\n"
+			"\r\n"
+			"0123456789abcdef",
+		.rc = -1,
+	},
+	{
+		.name = "wrong_range",
+		.proto = IPPROTO_TLS_1_2,
+		.frag_size = 16,
+		.response =
+			"HTTP/1.1 206 Partial Content\r\n"
+			"Content-Range: bytes 32-47/64\r\n"
+			"\r\n"
+			"0123456789abcdef",
+		.rc = -1,
+	},
+	{
+		.name = "not_http",
+		.proto = IPPROTO_TLS_1_2,
+		.response =
+			"SSH-2.0-OpenSSH_8.2p1\r\n"
+			"\r\n",
+		.rc = -1,
+	},
+};
+
+static struct download_client client;
+static char request[TEST_REQUEST_MAX_LEN];
+static size_t request_cnt;
+
+int socket_send(const struct download_client *client, size_t len)
+{
+	return socket_send_buf(client->fd, client->buf, len);
+}
+
+int socket_send_buf(int fd, const char *buf, size_t len)
+{
+	zassert_true(len < sizeof(request), "Request too long");
+
+	memcpy(request, buf, len);
+	request[len] = '\0';
+	request_cnt++;
+
+	return 0;
+}
+
+static void capture_setup(const struct capture *c)
+{
+	memset(&client, 0, sizeof(client));
+
+	client.fd = 1;
+	client.host = TEST_HOST;
+	client.file = TEST_FILE;
+	client.proto = c->proto;
+	client.progress = c->progress;
+	client.file_size = c->file_size;
+	client.config.frag_size_override = c->frag_size;
+
+	request_cnt = 0;
+}
+
+/* Copy received bytes in the buffer, like recv() would */
+static int feed(const char *data, size_t len)
+{
+	zassert_true(client.offset + len <= sizeof(client.buf),
+		     "Buffer overflow");
+
+	memcpy(client.buf + client.offset, data, len);
+
+	return http_parse(&client, len);
+}
+
+static void result_check(const struct capture *c, int rc, size_t split)
+{
+	const char *body;
+	size_t body_len;
+
+	zassert_equal(rc, c->rc, "%s, split at %u: rc %d", c->name,
+		      (uint32_t)split, rc);
+
+	if (c->rc) {
+		return;
+	}
+
+	body = strstr(c->response, "\r\n\r\n");
+	if (body) {
+		body += strlen("\r\n\r\n");
+	} else {
+		body = strstr(c->response, "\n\n") + strlen("\n\n");
+	}
+	body_len = strlen(body);
+
+	zassert_equal(client.offset, body_len, "%s, split at %u: offset %u",
+		      c->name, (uint32_t)split, (uint32_t)client.offset);
+	zassert_mem_equal(client.buf, body, body_len,
+			  "%s, split at %u: payload mismatch", c->name,
+			  (uint32_t)split);
+	zassert_equal(client.progress, c->progress + body_len,
+		      "%s, split at %u: progress %u", c->name,
+		      (uint32_t)split, (uint32_t)client.progress);
+	zassert_equal(client.file_size, c->file_size_expected,
+		      "%s, split at %u: file size %u", c->name,
+		      (uint32_t)split, (uint32_t)client.file_size);
+	zassert_equal(client.http.connection_close, c->connection_close,
+		      "%s, split at %u: connection close", c->name,
+		      (uint32_t)split);
+
+	if (c->pipelined) {
+		zassert_equal(request_cnt, 1, "%s, split at %u: %u requests",
+			      c->name, (uint32_t)split, (uint32_t)request_cnt);
+		zassert_not_null(strstr(request, c->pipelined),
+				 "%s: unexpected request %s", c->name,
+				 request);
+	} else {
+		zassert_equal(request_cnt, 0, "%s, split at %u: %u requests",
+			      c->name, (uint32_t)split, (uint32_t)request_cnt);
+	}
+}
+
+static void test_http_parse_split(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(captures); i++) {
+		const struct capture *c = &captures[i];
+		const size_t len = strlen(c->response);
+
+		/* Receive the response in two parts,
+		 * split at every byte boundary.
+		 */
+		for (size_t split = 0; split <= len; split++) {
+			int rc = 1;
+
+			capture_setup(c);
+
+			if (split > 0) {
+				rc = feed(c->response, split);
+			}
+			if (rc == 1 && split < len) {
+				rc = feed(c->response + split, len - split);
+			}
+
+			result_check(c, rc, split);
+		}
+	}
+}
+
+static void test_http_parse_bytewise(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(captures); i++) {
+		const struct capture *c = &captures[i];
+		const size_t len = strlen(c->response);
+		size_t off;
+		int rc = 1;
+
+		capture_setup(c);
+
+		/* Receive the response one byte at a time */
+		for (off = 0; off < len && rc == 1; off++) {
+			rc = feed(c->response + off, 1);
+		}
+
+		if (c->rc == 0) {
+			zassert_equal(off, len, "%s: parsing ended at %u",
+				      c->name, (uint32_t)off);
+		}
+
+		result_check(c, rc, 1);
+	}
+}
+
+static void test_http_parse_next_response(void)
+{
+	const struct capture *c = &captures[0];
+
+	/* The parser starts over on the next response */
+	capture_setup(c);
+	zassert_equal(feed(c->response, strlen(c->response)), 0, NULL);
+
+	client.offset = 0;
+	client.http.has_header = false;
+
+	zassert_equal(feed(captures[2].response,
+			   strlen(captures[2].response)), 0, NULL);
+	zassert_equal(client.progress, 32, "Invalid progress");
+	zassert_true(client.http.connection_close, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(download_client_http,
+			 ztest_unit_test(test_http_parse_split),
+			 ztest_unit_test(test_http_parse_bytewise),
+			 ztest_unit_test(test_http_parse_next_response)
+			);
+
+	ztest_run_test_suite(download_client_http);
+}